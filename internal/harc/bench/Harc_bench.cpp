@@ -0,0 +1,616 @@
+#include <harc/Translation_unit.hpp>
+#include <harc/prepass/Prepass.hpp>
+#include <harc/lexer/Lexer.hpp>
+#include <harc/lexer/Cache.hpp>
+#include <harc/parser/Parser.hpp>
+#include <harc/common/Algorithms.hpp>
+
+#include <harc/Caching.hpp>
+#include <harc/Message_buffer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+///
+/// Microbenchmarks for Harc's front-end stages and the utilities they lean
+/// on. Each benchmark is run over a synthetic corpus of each requested size
+/// and reports throughput in megabytes and tokens per second.
+///
+/// Usage:
+///     harc_bench [--sizes 64K,1M,16M] [--iterations N] [--filter substring]
+///                [--corpus path] [--json path]
+///
+namespace harc::bench {
+
+    //=====================================================
+    // Configuration
+    //=====================================================
+
+    struct Config {
+
+        ///
+        /// Sizes of synthetic corpora to benchmark, in bytes
+        ///
+        std::vector<std::size_t> corpus_sizes{std::size_t{1} << 20, std::size_t{16} << 20};
+
+        ///
+        /// Number of timed runs of each benchmark. Preceded by one untimed
+        /// run.
+        ///
+        std::uint32_t iterations = 5;
+
+        ///
+        /// Only benchmarks whose names contain this string are run
+        ///
+        std::string filter;
+
+        ///
+        /// Source file to benchmark instead of synthetic corpora. Ignored if
+        /// empty.
+        ///
+        std::string corpus_path;
+
+        ///
+        /// File to which JSON results are written. Ignored if empty. "-" for
+        /// stdout.
+        ///
+        std::string json_path;
+
+    };
+
+    ///
+    /// \param str Size such as "4096", "64K", "16M", or "1G"
+    /// \return Size in bytes. 0 if str is malformed.
+    std::size_t parse_size(std::string_view str) {
+        std::size_t ret = 0;
+        std::size_t i = 0;
+        for (; i < str.size() && '0' <= str[i] && str[i] <= '9'; ++i) {
+            ret = ret * 10 + (str[i] - '0');
+        }
+
+        if (i == 0 || str.size() - i > 1) {
+            return 0;
+        }
+
+        if (i == str.size()) {
+            return ret;
+        }
+
+        switch (str[i]) {
+            case 'k': case 'K': return ret << 10;
+            case 'm': case 'M': return ret << 20;
+            case 'g': case 'G': return ret << 30;
+            default: return 0;
+        }
+    }
+
+    ///
+    /// \return True if arguments were well-formed
+    bool parse_arguments(int argc, char* argv[], Config& config) {
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            if (i + 1 == argc) {
+                std::cerr << "Missing value for " << arg << '\n';
+                return false;
+            }
+            std::string_view value = argv[++i];
+
+            if (arg == "--sizes") {
+                config.corpus_sizes.clear();
+                while (!value.empty()) {
+                    auto comma = std::min(value.find(','), value.size());
+                    auto size = parse_size(value.substr(0, comma));
+                    if (size == 0) {
+                        std::cerr << "Malformed corpus size: " << value.substr(0, comma) << '\n';
+                        return false;
+                    }
+
+                    config.corpus_sizes.push_back(size);
+                    value.remove_prefix(std::min(comma + 1, value.size()));
+                }
+            } else if (arg == "--iterations") {
+                config.iterations = std::max<std::uint32_t>(1, std::stoul(std::string{value}));
+            } else if (arg == "--filter") {
+                config.filter = value;
+            } else if (arg == "--corpus") {
+                config.corpus_path = value;
+            } else if (arg == "--json") {
+                config.json_path = value;
+            } else {
+                std::cerr << "Unrecognized argument: " << arg << '\n';
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    //=====================================================
+    // Corpus generation
+    //=====================================================
+
+    ///
+    /// Small deterministic PRNG so that corpora are identical across runs
+    /// and platforms
+    ///
+    class Corpus_rng {
+    public:
+
+        explicit Corpus_rng(std::uint64_t seed):
+            state(seed) {}
+
+        std::uint32_t next(std::uint32_t bound) {
+            state = state * 6364136223846793005 + 1442695040888963407;
+            return static_cast<std::uint32_t>((state >> 33) % bound);
+        }
+
+    private:
+
+        std::uint64_t state;
+
+    };
+
+    ///
+    /// \param rng Source of randomness
+    /// \return Identifier of a shape typical of real code
+    std::string generate_identifier(Corpus_rng& rng) {
+        static constexpr std::string_view stems[] = {
+            "index", "count", "value", "result", "buffer", "offset", "length",
+            "node", "token", "source", "width", "height", "scale", "vector",
+            "matrix", "element", "total", "limit", "entry", "state"
+        };
+
+        std::string ret{stems[rng.next(std::size(stems))]};
+        if (rng.next(2)) {
+            ret.push_back('_');
+            ret.append(stems[rng.next(std::size(stems))]);
+        }
+
+        if (rng.next(4) == 0) {
+            ret.append(std::to_string(rng.next(100)));
+        }
+
+        return ret;
+    }
+
+    ///
+    /// Appends a function definition with a representative mix of
+    /// statements, literals, operators, and comments
+    ///
+    void generate_function(Corpus_rng& rng, std::string& out) {
+        auto name = generate_identifier(rng);
+        auto a = generate_identifier(rng);
+        auto b = generate_identifier(rng);
+        auto x = generate_identifier(rng);
+
+        out += "/// Computes ";
+        out += name;
+        out += " from its arguments\n";
+
+        out += "func[] " + name + "(" + a + ": int, " + b + ": Array<int>) -> int {\n";
+        out += "    let " + x + " = (" + a + " + " + b + "[" + std::to_string(rng.next(16)) + "]) * 0x";
+        out += std::to_string(rng.next(0x10000));
+        out += ";\n";
+
+        auto statement_count = 2 + rng.next(6);
+        for (std::uint32_t i = 0; i < statement_count; ++i) {
+            switch (rng.next(6)) {
+                case 0:
+                    out += "    if " + x + " > " + std::to_string(rng.next(1000)) + " {\n";
+                    out += "        " + x + " -= " + a + " << 2;\n";
+                    out += "    } else {\n";
+                    out += "        " + x + " += 1;\n";
+                    out += "    }\n";
+                    break;
+                case 1:
+                    out += "    while " + x + " < " + a + " && !(" + b + "[0] == 'c') {\n";
+                    out += "        " + x + " *= 3;\n";
+                    out += "    }\n";
+                    break;
+                case 2:
+                    out += "    for let i = 0; i < " + std::to_string(rng.next(64)) + "; ++i {\n";
+                    out += "        " + x + " ^= " + b + "[i];\n";
+                    out += "    }\n";
+                    break;
+                case 3:
+                    out += "    let " + generate_identifier(rng) + " = \"" + generate_identifier(rng) + " \\t\\n\";\n";
+                    break;
+                case 4:
+                    out += "    /* " + generate_identifier(rng) + " /* nested */ */\n";
+                    break;
+                default:
+                    out += "    let " + generate_identifier(rng) + " = lambda (y: int) -> int { return y % 7; };\n";
+                    break;
+            }
+        }
+
+        out += "    return " + x + ";\n";
+        out += "}\n\n";
+    }
+
+    ///
+    /// \param size Approximate size of corpus in bytes
+    /// \return Synthetic Harmonia source of roughly the requested size
+    std::string generate_corpus(std::size_t size) {
+        Corpus_rng rng{size};
+
+        std::string ret;
+        ret.reserve(size + 1024);
+        ret += "module bench.corpus;\n\n";
+
+        while (ret.size() < size) {
+            generate_function(rng, ret);
+        }
+
+        return ret;
+    }
+
+    //=====================================================
+    // Measurement
+    //=====================================================
+
+    struct Result {
+        std::string name;
+
+        std::size_t corpus_bytes = 0;
+
+        ///
+        /// Bytes processed by a single run
+        ///
+        std::uint64_t bytes = 0;
+
+        ///
+        /// Tokens processed by a single run. 0 if not meaningful.
+        ///
+        std::uint64_t tokens = 0;
+
+        ///
+        /// Duration of each timed run, in seconds
+        ///
+        std::vector<double> seconds;
+
+        ///
+        /// True if the benchmarked function gave up before processing all of
+        /// its input, in which case throughput figures are inflated
+        ///
+        bool is_partial = false;
+
+        [[nodiscard]]
+        double best() const {
+            return *std::min_element(seconds.begin(), seconds.end());
+        }
+
+        [[nodiscard]]
+        double median() const {
+            auto sorted = seconds;
+            std::sort(sorted.begin(), sorted.end());
+            return sorted[sorted.size() / 2];
+        }
+
+        [[nodiscard]]
+        double megabytes_per_second() const {
+            return double(bytes) / 1e6 / best();
+        }
+
+        [[nodiscard]]
+        double tokens_per_second() const {
+            return double(tokens) / best();
+        }
+
+    };
+
+    ///
+    /// Written to by benchmarks so that their work is not optimized away
+    ///
+    volatile std::uint64_t sink = 0;
+
+    class Runner {
+    public:
+
+        explicit Runner(const Config& config):
+            config(config) {}
+
+        ///
+        /// Runs func once untimed and then config.iterations times timed
+        ///
+        /// \param name Name of benchmark
+        /// \param corpus_bytes Size of corpus benchmark was run over
+        /// \param bytes Bytes processed by each call to func
+        /// \param tokens Tokens processed by each call to func
+        /// \param func Callable which performs a single run
+        /// \param is_partial True if func does not process all of its input
+        template<class F>
+        void run(std::string_view name, std::size_t corpus_bytes, std::uint64_t bytes, std::uint64_t tokens, F func, bool is_partial = false) {
+            if (name.find(config.filter) == std::string_view::npos) {
+                return;
+            }
+
+            Result result{std::string{name}, corpus_bytes, bytes, tokens};
+            result.is_partial = is_partial;
+
+            func();
+            for (std::uint32_t i = 0; i < config.iterations; ++i) {
+                auto t0 = std::chrono::steady_clock::now();
+                func();
+                auto t1 = std::chrono::steady_clock::now();
+
+                result.seconds.push_back(std::chrono::duration<double>(t1 - t0).count());
+            }
+
+            print(result);
+            results.push_back(std::move(result));
+        }
+
+        [[nodiscard]]
+        const std::vector<Result>& get_results() const {
+            return results;
+        }
+
+    private:
+
+        const Config& config;
+
+        std::vector<Result> results;
+
+        ///
+        /// Prints result as a row of a human-readable table. Written to
+        /// stderr when JSON is written to stdout so the two don't mix.
+        ///
+        void print(const Result& result) const {
+            auto* out = (config.json_path == "-") ? stderr : stdout;
+
+            std::fprintf(
+                out,
+                "%-28s %10zu B %10.3f ms %10.1f MB/s",
+                result.name.c_str(),
+                result.corpus_bytes,
+                result.best() * 1e3,
+                result.megabytes_per_second()
+            );
+
+            if (result.tokens != 0) {
+                std::fprintf(out, " %10.2f Mtok/s", result.tokens_per_second() / 1e6);
+            }
+
+            std::fprintf(out, result.is_partial ? " (partial)\n" : "\n");
+        }
+
+    };
+
+    void write_json(std::ostream& out, const Config& config, const std::vector<Result>& results) {
+        out << "{\n";
+        out << "  \"iterations\": " << config.iterations << ",\n";
+        out << "  \"prepass_kernel\": " << static_cast<int>(prepass::selected_kernel()) << ",\n";
+        out << "  \"benchmarks\": [\n";
+
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto& result = results[i];
+
+            out << "    {";
+            out << "\"name\": \"" << result.name << "\", ";
+            out << "\"corpus_bytes\": " << result.corpus_bytes << ", ";
+            out << "\"bytes\": " << result.bytes << ", ";
+            out << "\"tokens\": " << result.tokens << ", ";
+            out << "\"best_seconds\": " << result.best() << ", ";
+            out << "\"median_seconds\": " << result.median() << ", ";
+            out << "\"is_partial\": " << (result.is_partial ? "true" : "false") << ", ";
+            out << "\"mb_per_second\": " << result.megabytes_per_second() << ", ";
+            out << "\"tokens_per_second\": ";
+            if (result.tokens != 0) {
+                out << result.tokens_per_second();
+            } else {
+                out << "null";
+            }
+            out << "}";
+            out << ((i + 1 == results.size()) ? "\n" : ",\n");
+        }
+
+        out << "  ]\n";
+        out << "}\n";
+    }
+
+    //=====================================================
+    // Benchmarks
+    //=====================================================
+
+    void bench_prepass(Runner& runner, std::string_view source, std::uint64_t token_count) {
+        static constexpr std::pair<prepass::Prepass_kernel, std::string_view> kernels[] = {
+            {prepass::Prepass_kernel::SCALAR, "prepass/scalar"},
+            {prepass::Prepass_kernel::AVX2,   "prepass/avx2"},
+            {prepass::Prepass_kernel::AVX512, "prepass/avx512"}
+        };
+
+        for (auto [kernel, name] : kernels) {
+            if (kernel > prepass::selected_kernel()) {
+                break;
+            }
+
+            runner.run(name, source.size(), source.size(), token_count, [&] {
+                auto results = prepass::prepass(source, kernel);
+                sink = sink + results.codepoint_count;
+            });
+        }
+    }
+
+    void bench_lex(Runner& runner, std::string_view source, std::uint64_t token_count) {
+        runner.run("lex", source.size(), source.size(), token_count, [&] {
+            auto tokenization = lex::lex("bench.hmn", source);
+            sink = sink + tokenization.types.size();
+        });
+    }
+
+    ///
+    /// \param name Name of benchmark
+    /// \param body_parsing Whether function bodies are parsed or skipped
+    void bench_parse(Runner& runner, std::string_view source, std::string_view name, parser::Body_parsing body_parsing) {
+        Translation_unit unit;
+        unit.source_path = "bench.hmn";
+        unit.set_source(std::string{source});
+        unit.tokenization = lex::lex(unit.source_path, unit.source);
+        unit.tokens = lex::Tokenization_view{unit.tokenization};
+
+        // The parser stops at the first construct it cannot handle, in which
+        // case only a prefix of the corpus is measured
+        auto parse = [&] {
+            unit.parse_tree = parser::Parse_tree{};
+            unit.identifiers = Identifier_table{};
+
+            return parser::parse(unit, body_parsing);
+        };
+        bool is_partial = (parse() != Error_code::NO_ERROR);
+
+        runner.run(name, source.size(), source.size(), unit.tokens.size(), [&] {
+            sink = sink + static_cast<std::uint64_t>(parse());
+        }, is_partial);
+    }
+
+    void bench_markup(Runner& runner, const Translation_unit& unit) {
+        std::uint64_t token_bytes = 0;
+        for (std::uint32_t i = 0; i < unit.tokens.size(); ++i) {
+            token_bytes += unit.tokens.lengths[i];
+        }
+
+        Message_markup_builder builder;
+        runner.run("markup_append", unit.source.size(), token_bytes, unit.tokens.size(), [&] {
+            builder.clear();
+            for (std::uint32_t i = 0; i < unit.tokens.size(); ++i) {
+                auto tag = (unit.tokens.types[i] == Token_type::TEXT) ?
+                    Message_markup_tag::PLAIN :
+                    Message_markup_tag::INFO_HEADER;
+
+                builder.append(unit.token_source(i), tag);
+            }
+
+            sink = sink + builder.contents().size();
+        });
+    }
+
+    void bench_assemble_serialization(Runner& runner, const Translation_unit& unit) {
+        // Treat the corpus's serialized tokens as though they belonged to
+        // many units of a build cache
+        static constexpr std::size_t unit_size = 64 * 1024;
+
+        auto serialization = lex::serialize_tokenization(unit.tokens);
+
+        std::vector<std::string> paths;
+        std::vector<Cache_entry_info> infos;
+        for (std::size_t i = 0; i < serialization.size(); i += unit_size) {
+            paths.push_back("bench/unit_" + std::to_string(infos.size()) + ".hmn");
+
+            Cache_entry_info info{};
+            info.timestamp = i;
+            info.hash = {i, ~i};
+            info.tokenization_serialization = std::span<const std::byte>{serialization}.subspan(
+                i,
+                std::min(unit_size, serialization.size() - i)
+            );
+            infos.push_back(info);
+        }
+
+        for (std::size_t i = 0; i < infos.size(); ++i) {
+            infos[i].path = paths[i];
+        }
+
+        runner.run("assemble_serialization", unit.source.size(), serialization.size(), unit.tokens.size(), [&] {
+            auto bytes = assemble_serialization(infos);
+            sink = sink + bytes.size();
+        });
+    }
+
+    void bench_edit_distance(Runner& runner, const Translation_unit& unit) {
+        // Mimics searching for a suggestion for a misspelled identifier by
+        // comparing each identifier against those which follow it
+        static constexpr std::size_t window = 8;
+
+        std::vector<std::string_view> identifiers;
+        for (std::uint32_t i = 0; i < unit.tokens.size(); ++i) {
+            if (unit.tokens.types[i] == Token_type::TEXT) {
+                identifiers.push_back(unit.token_source(i));
+            }
+        }
+
+        std::uint64_t bytes = 0;
+        for (std::size_t i = 0; i < identifiers.size(); ++i) {
+            for (std::size_t j = i + 1; j < std::min(i + 1 + window, identifiers.size()); ++j) {
+                bytes += identifiers[i].size() + identifiers[j].size();
+            }
+        }
+
+        runner.run("levenstein_edit_distance", unit.source.size(), bytes, identifiers.size(), [&] {
+            std::uint64_t total = 0;
+            for (std::size_t i = 0; i < identifiers.size(); ++i) {
+                for (std::size_t j = i + 1; j < std::min(i + 1 + window, identifiers.size()); ++j) {
+                    total += levenstein_edit_distance_ascii(identifiers[i], identifiers[j]);
+                }
+            }
+
+            sink = sink + total;
+        });
+    }
+
+    void bench_corpus(Runner& runner, std::string source) {
+        Translation_unit unit;
+        unit.source_path = "bench.hmn";
+        unit.set_source(std::move(source));
+        unit.tokenization = lex::lex(unit.source_path, unit.source);
+        unit.tokens = lex::Tokenization_view{unit.tokenization};
+
+        bench_prepass(runner, unit.source, unit.tokens.size());
+        bench_lex(runner, unit.source, unit.tokens.size());
+        bench_parse(runner, unit.source, "parse", parser::Body_parsing::EAGER);
+        bench_parse(runner, unit.source, "parse_declarations", parser::Body_parsing::DEFERRED);
+        bench_markup(runner, unit);
+        bench_assemble_serialization(runner, unit);
+        bench_edit_distance(runner, unit);
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    using namespace harc::bench;
+
+    Config config;
+    if (!parse_arguments(argc, argv, config)) {
+        return 1;
+    }
+
+    Runner runner{config};
+
+    if (!config.corpus_path.empty()) {
+        std::ifstream file{config.corpus_path, std::ios::binary};
+        if (!file) {
+            std::cerr << "Could not open corpus: " << config.corpus_path << '\n';
+            return 1;
+        }
+
+        std::stringstream stream;
+        stream << file.rdbuf();
+        bench_corpus(runner, std::move(stream).str());
+    } else {
+        for (auto size : config.corpus_sizes) {
+            bench_corpus(runner, generate_corpus(size));
+        }
+    }
+
+    if (config.json_path == "-") {
+        write_json(std::cout, config, runner.get_results());
+    } else if (!config.json_path.empty()) {
+        std::ofstream file{config.json_path};
+        if (!file) {
+            std::cerr << "Could not open JSON output: " << config.json_path << '\n';
+            return 1;
+        }
+
+        write_json(file, config, runner.get_results());
+    }
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+#ifndef HARC_BUILD_CACHE_HPP
+#define HARC_BUILD_CACHE_HPP
+
+#include <harc/Caching.hpp>
+#include <harc/Config.hpp>
+#include <harc/Errors.hpp>
+#include <harc/Translation_unit.hpp>
+#include <harc/common/OS_utils.hpp>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace harc {
+
+    ///
+    /// Name of the file within the cache directory which holds the build
+    /// cache
+    ///
+    constexpr std::string_view build_cache_file_name = "harc.cache";
+
+    ///
+    /// Owns the build cache left behind by the previous build and collects
+    /// the results of the current build so that they may be written back.
+    ///
+    /// The previous cache is memory mapped and its entries are handed out as
+    /// views into the mapping, so nothing is copied out of it. Lookups are
+    /// safe to perform concurrently once load() has returned. record() may
+    /// be called concurrently from worker threads.
+    ///
+    class Build_cache {
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        Build_cache() = default;
+        Build_cache(const Build_cache&) = delete;
+        Build_cache(Build_cache&&) = delete;
+
+        ~Build_cache() {
+            unmap_file(mapping);
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Build_cache& operator=(const Build_cache&) = delete;
+        Build_cache& operator=(Build_cache&&) = delete;
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// Maps the cache file in the specified directory and indexes its
+        /// entries, discarding everything held from an earlier call. A
+        /// missing or malformed cache leaves the cache empty.
+        ///
+        /// \param cache_directory Directory containing cache file
+        /// \param policy Policy used to decide whether entries are current
+        /// \return INACCESSIBLE_BUILD_CACHE if no cache could be read,
+        /// INVALID_BUILD_CACHE if the cache could not be parsed
+        Error_code load(std::string_view cache_directory, Caching_policy policy);
+
+        ///
+        /// Records the state of a unit which has made it through the build
+        /// so that it will be written out by store()
+        ///
+        /// \param unit Translation unit to record
+        void record(const Translation_unit& unit);
+
+        ///
+        /// Writes all recorded units to the cache file in the specified
+        /// directory, replacing any existing cache. Does nothing if caching
+        /// is disabled.
+        ///
+        /// \param cache_directory Directory to write cache file to
+        /// \return Error code indicating whether the cache was written
+        Error_code store(std::string_view cache_directory);
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// \param path Path of source file
+        /// \param timestamp Current modification time of source file
+        /// \return Entry for path if one exists and passes the timestamp
+        /// check required by the caching policy. Null otherwise.
+        [[nodiscard]]
+        const Cache_entry_info* find(std::string_view path, std::uint64_t timestamp) const;
+
+        ///
+        /// \param entry Entry previously returned by find()
+        /// \param hash Hash of the source file's current contents
+        /// \return True if the caching policy does not require the hash to
+        /// be checked or if the hash matches the entry's
+        [[nodiscard]]
+        bool is_hash_current(const Cache_entry_info& entry, const std::array<std::uint64_t, 2>& hash) const;
+
+        [[nodiscard]]
+        Caching_policy caching_policy() const {
+            return policy;
+        }
+
+    private:
+
+        //=================================================
+        // Helper classes
+        //=================================================
+
+        ///
+        /// State of a unit from the current build. Owns its data since units
+        /// are destroyed before the cache is stored.
+        ///
+        struct Record {
+            std::string path;
+            std::uint64_t timestamp = 0;
+            std::array<std::uint64_t, 2> hash{};
+            std::vector<std::byte> tokenization_serialization;
+
+            ///
+            /// Left empty. Parse trees point into their unit's arena and
+            /// token storage, and have no serialized form to restore them
+            /// from.
+            ///
+            std::vector<std::byte> parsing_serialization;
+        };
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        Caching_policy policy = Caching_policy::DISABLED;
+
+        ///
+        /// Mapping of the cache from the previous build
+        ///
+        Binary_file_mapping mapping{};
+
+        ///
+        /// Entries of the previous cache, keyed by source path. Views point
+        /// into mapping.
+        ///
+        std::unordered_map<std::string_view, Cache_entry_info> entries;
+
+        std::vector<Record> records;
+
+        std::mutex records_mutex;
+
+    };
+
+}
+
+#endif //HARC_BUILD_CACHE_HPP
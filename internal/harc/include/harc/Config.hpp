@@ -150,6 +150,35 @@ namespace harc {
         ///
         std::uint16_t thread_count = std::thread::hardware_concurrency();
 
+        ///
+        /// Target number of source bytes per task when batching translation
+        /// units. Units smaller than this are grouped together so that a
+        /// single task lexes and parses several of them, amortizing the cost
+        /// of scheduling. Larger units always get a task of their own.
+        /// Batching is disabled if 0.
+        ///
+        std::uint32_t task_batch_byte_budget = 0;
+
+        ///
+        /// Sources of at least twice this many bytes are split into chunks of
+        /// roughly this size which idle workers help lex concurrently, so that
+        /// a single large source does not hold up the build. Disabled if 0.
+        ///
+        std::uint32_t lex_chunk_size = 0;
+
+        ///
+        /// Units of at least twice this many tokens have their top-level
+        /// declarations split into chunks of roughly this many tokens which
+        /// idle workers help parse concurrently. Disabled if 0.
+        ///
+        std::uint32_t parse_chunk_size = 0;
+
+        ///
+        /// Fault in every page of a source file when it is mapped rather than
+        /// when it is first read by the lexer. Only has an effect on Linux.
+        ///
+        bool populate_source_mappings = false;
+
         #if HARC_USE_CUDA
         ///
         /// Indices of CUDA devices to use for compilation
@@ -182,6 +211,13 @@ namespace harc {
         ///
         Level file_timing_data_report = Level::NONE;
 
+        ///
+        /// Path of file to which a trace of worker activity is written in the
+        /// Chrome trace event format, viewable in chrome://tracing or
+        /// Perfetto. Tracing is disabled if empty.
+        ///
+        std::string_view trace_path{};
+
         //=================================================
         // Networking configuration
         //=================================================
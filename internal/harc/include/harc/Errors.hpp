@@ -18,6 +18,9 @@ namespace harc {
         INACCESSIBLE_SOURCE_FILE_PATH,
         INVALID_SOURCE_FILE,
         EXCESSIVE_SOURCE_FILE_LENGTH,
+        INACCESSIBLE_BUILD_CACHE,
+        INVALID_BUILD_CACHE,
+        INACCESSIBLE_TRACE_FILE,
         TOKENIZATION_ERROR,
         PARSING_ERROR,
         SEMANTIC_ANALYSIS_ERROR,
@@ -0,0 +1,277 @@
+#ifndef HARC_PIPELINE_HPP
+#define HARC_PIPELINE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace harc {
+
+    ///
+    /// An enum which is used to indicate which stage within the compilation
+    /// process should be performed next for the associated translation unit.
+    ///
+    enum class Stage : std::uint8_t {
+        NULL_STEP,
+        TOKENIZATION,
+        PARSING,
+        BACKEND
+    };
+
+    ///
+    /// Number of enumerators in the Stage enum
+    ///
+    constexpr std::size_t stage_count = 4;
+
+    ///
+    /// Tracks the progress of every translation unit through the compilation
+    /// stages and holds back tasks for stages which depend on all units having
+    /// completed an earlier stage.
+    ///
+    /// A stage may be given a prerequisite stage. Tasks for such a stage are
+    /// parked until every unit in the build has either completed the
+    /// prerequisite or been retired before reaching it, at which point all
+    /// parked tasks are released at once. Stages without a prerequisite are
+    /// released immediately, which allows, for example, lexing of late files
+    /// to overlap with parsing of early ones.
+    ///
+    /// \tparam T Move-constructible task type
+    template<class T>
+    class Pipeline {
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        Pipeline() = default;
+        Pipeline(const Pipeline&) = delete;
+        Pipeline(Pipeline&&) = delete;
+        ~Pipeline() = default;
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Pipeline& operator=(const Pipeline&) = delete;
+        Pipeline& operator=(Pipeline&&) = delete;
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// Resets all counters and parked tasks. Must be called before any
+        /// tasks are submitted.
+        ///
+        /// \param unit_count Number of translation units in the build
+        void initialize(std::uint32_t unit_count) {
+            total_units = unit_count;
+
+            for (std::size_t i = 0; i < stage_count; ++i) {
+                entered[i] = 0;
+                completed[i] = 0;
+                passed[i] = 0;
+                prerequisites[i] = Stage::NULL_STEP;
+                barrier_open[i] = true;
+                parked[i].clear();
+            }
+        }
+
+        ///
+        /// Prevents tasks for a stage from being released until all units
+        /// have passed another stage.
+        ///
+        /// \param stage Stage to hold back
+        /// \param prerequisite Stage that all units must pass first
+        void set_prerequisite(Stage stage, Stage prerequisite) {
+            auto s = index(stage);
+            prerequisites[s] = prerequisite;
+            barrier_open[s] = (passed[index(prerequisite)] == total_units);
+        }
+
+        ///
+        /// Increases the number of units in the build. Used when work arrives
+        /// after the pipeline was initialized, such as in client mode.
+        ///
+        /// \param unit_count Number of units to add
+        void add_units(std::uint32_t unit_count) {
+            total_units.fetch_add(unit_count);
+        }
+
+        ///
+        /// Hands a task for its stage to the pipeline. The task is passed to
+        /// submit immediately if its stage is ready to run and parked
+        /// otherwise.
+        ///
+        /// \param task Task to run
+        /// \param submit Callable which enqueues a task for execution
+        /// \param unit_count Number of units the task operates on
+        template<class F>
+        void advance(T&& task, F&& submit, std::uint32_t unit_count = 1) {
+            auto s = index(task.stage);
+            entered[s].fetch_add(unit_count);
+
+            {
+                std::scoped_lock lk{parked_mutex};
+                if (!barrier_open[s]) {
+                    parked[s].push_back(std::move(task));
+                    return;
+                }
+            }
+
+            submit(std::move(task));
+        }
+
+        ///
+        /// Records that units completed the specified stage. Releases parked
+        /// tasks through submit if this completion satisfies their barrier.
+        ///
+        /// \param stage Stage that was completed
+        /// \param submit Callable which enqueues a task for execution
+        /// \param unit_count Number of units which completed the stage
+        template<class F>
+        void complete(Stage stage, F&& submit, std::uint32_t unit_count = 1) {
+            completed[index(stage)].fetch_add(unit_count);
+            pass(index(stage), submit, unit_count);
+        }
+
+        ///
+        /// Records that a unit will not proceed past the specified stage,
+        /// for example because of an error. The unit is considered to have
+        /// passed this and every later stage for the purpose of barriers.
+        ///
+        /// \param stage Stage at which the unit left the pipeline
+        /// \param submit Callable which enqueues a task for execution
+        /// \param unit_count Number of units which left the pipeline
+        template<class F>
+        void retire(Stage stage, F&& submit, std::uint32_t unit_count = 1) {
+            for (std::size_t s = index(stage); s < stage_count; ++s) {
+                pass(s, submit, unit_count);
+            }
+        }
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// \param stage Arbitrary stage
+        /// \return Number of tasks that have been handed to the pipeline for
+        /// the specified stage
+        [[nodiscard]]
+        std::uint32_t entered_count(Stage stage) const {
+            return entered[index(stage)].load();
+        }
+
+        ///
+        /// \param stage Arbitrary stage
+        /// \return Number of units which have completed the specified stage
+        [[nodiscard]]
+        std::uint32_t completed_count(Stage stage) const {
+            return completed[index(stage)].load();
+        }
+
+        ///
+        /// \param stage Arbitrary stage
+        /// \return Number of units which have entered the specified stage but
+        /// not yet completed it, including parked units
+        [[nodiscard]]
+        std::uint32_t in_flight_count(Stage stage) const {
+            return entered_count(stage) - completed_count(stage);
+        }
+
+        ///
+        /// \return Number of units in the build
+        [[nodiscard]]
+        std::uint32_t unit_count() const {
+            return total_units.load();
+        }
+
+        ///
+        /// \param stage Arbitrary stage
+        /// \return True if every unit has either completed or been retired
+        /// before the specified stage
+        [[nodiscard]]
+        bool is_stage_finished(Stage stage) const {
+            return passed[index(stage)].load() == total_units.load();
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::atomic<std::uint32_t> total_units = 0;
+
+        std::array<std::atomic<std::uint32_t>, stage_count> entered{};
+
+        std::array<std::atomic<std::uint32_t>, stage_count> completed{};
+
+        ///
+        /// Number of units that have completed, or been retired at or before,
+        /// each stage
+        ///
+        std::array<std::atomic<std::uint32_t>, stage_count> passed{};
+
+        std::array<Stage, stage_count> prerequisites{};
+
+        ///
+        /// Indicates whether tasks for each stage may run. Protected by
+        /// parked_mutex.
+        ///
+        std::array<bool, stage_count> barrier_open{};
+
+        ///
+        /// Tasks waiting for their stage's barrier to open. Protected by
+        /// parked_mutex.
+        ///
+        std::array<std::vector<T>, stage_count> parked{};
+
+        std::mutex parked_mutex;
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        static std::size_t index(Stage stage) {
+            return static_cast<std::size_t>(stage);
+        }
+
+        template<class F>
+        void pass(std::size_t stage_index, F& submit, std::uint32_t unit_count) {
+            auto passed_count = passed[stage_index].fetch_add(unit_count) + unit_count;
+            if (passed_count != total_units.load()) {
+                return;
+            }
+
+            // Open every barrier which was waiting on this stage
+            std::vector<T> released;
+            {
+                std::scoped_lock lk{parked_mutex};
+                for (std::size_t s = 0; s < stage_count; ++s) {
+                    if (barrier_open[s] || index(prerequisites[s]) != stage_index) {
+                        continue;
+                    }
+
+                    barrier_open[s] = true;
+                    for (auto& task : parked[s]) {
+                        released.push_back(std::move(task));
+                    }
+                    parked[s].clear();
+                }
+            }
+
+            for (auto& task : released) {
+                submit(std::move(task));
+            }
+        }
+
+    };
+
+}
+
+#endif //HARC_PIPELINE_HPP
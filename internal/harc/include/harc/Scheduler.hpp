@@ -0,0 +1,274 @@
+#ifndef HARC_SCHEDULER_HPP
+#define HARC_SCHEDULER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace harc {
+
+    ///
+    /// A task scheduler which maintains one double-ended queue per worker
+    /// thread.
+    ///
+    /// Workers push and pop tasks at the back of their own queue, so that work
+    /// spawned by a task, such as the next compilation stage of a translation
+    /// unit, is picked up by the same thread while its data is still in cache.
+    /// When a worker's own queue is empty, it steals the oldest task from the
+    /// front of another worker's queue.
+    ///
+    /// Idle workers block on an atomic wait instead of polling, and are woken
+    /// whenever new work is pushed or when the scheduler becomes idle while
+    /// configured to terminate once idle.
+    ///
+    /// \tparam T Move-constructible task type
+    template<class T>
+    class Work_stealing_scheduler {
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        Work_stealing_scheduler() = default;
+        Work_stealing_scheduler(const Work_stealing_scheduler&) = delete;
+        Work_stealing_scheduler(Work_stealing_scheduler&&) = delete;
+        ~Work_stealing_scheduler() = default;
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Work_stealing_scheduler& operator=(const Work_stealing_scheduler&) = delete;
+        Work_stealing_scheduler& operator=(Work_stealing_scheduler&&) = delete;
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// Allocates one queue per worker. Any previously queued tasks are
+        /// discarded.
+        ///
+        /// Must be called before any tasks are pushed and before any worker
+        /// threads are launched.
+        ///
+        /// \param worker_count Number of worker threads which will pop tasks
+        /// from this scheduler. Values of 0 are treated as 1.
+        void initialize(std::size_t worker_count) {
+            queue_count = (worker_count == 0) ? 1 : worker_count;
+            queues = std::make_unique<Worker_queue[]>(queue_count);
+
+            outstanding_tasks = 0;
+            next_external_queue = 0;
+        }
+
+        ///
+        /// Controls whether pop() returns false once no tasks remain queued
+        /// or in flight. When false, idle workers sleep until more work
+        /// arrives.
+        ///
+        /// \param value New value of setting
+        void set_terminate_once_idle(bool value) {
+            terminate_once_idle.store(value);
+            wake_all();
+        }
+
+        ///
+        /// Pushes a task onto the queue owned by the specified worker. Meant
+        /// to be called by the worker itself for tasks that it spawns.
+        ///
+        /// \param worker_index Index of worker whose queue should receive task
+        /// \param task Task to enqueue
+        void push(std::size_t worker_index, T&& task) {
+            // Increment before the task becomes visible so that the scheduler
+            // is never observed as idle while a task is queued
+            outstanding_tasks.fetch_add(1);
+
+            Worker_queue& queue = queues[worker_index % queue_count];
+            {
+                std::scoped_lock lk{queue.mutex};
+                queue.tasks.push_back(std::move(task));
+            }
+
+            wake_one();
+        }
+
+        ///
+        /// Pushes a task from a thread which is not a worker. Tasks are
+        /// distributed across worker queues in a round-robin fashion.
+        ///
+        /// \param task Task to enqueue
+        void push(T&& task) {
+            push(next_external_queue.fetch_add(1), std::move(task));
+        }
+
+        ///
+        /// Retrieves a task for the specified worker, blocking until one is
+        /// available.
+        ///
+        /// Each successful call must be followed by a call to complete() once
+        /// the task, including the pushing of any follow-up tasks, is done.
+        ///
+        /// \param worker_index Index of calling worker
+        /// \param out Object to move the retrieved task into
+        /// \return True if a task was retrieved. False if the scheduler is
+        /// configured to terminate once idle and no work remains.
+        [[nodiscard]]
+        bool pop(std::size_t worker_index, T& out) {
+            while (true) {
+                if (try_pop(worker_index, out, false)) {
+                    return true;
+                }
+
+                // The epoch must be read before the queues are re-examined
+                // so that a push which lands after the re-examination is
+                // guaranteed to change the epoch and end the wait below
+                std::uint32_t epoch = wakeup_epoch.load();
+
+                if (terminate_once_idle.load() && outstanding_tasks.load() == 0) {
+                    return false;
+                }
+
+                // Victims whose locks were contended above were skipped, so
+                // every queue is locked before the worker goes to sleep
+                if (try_pop(worker_index, out, true)) {
+                    return true;
+                }
+
+                sleeping_workers.fetch_add(1);
+                wakeup_epoch.wait(epoch);
+                sleeping_workers.fetch_sub(1);
+            }
+        }
+
+        ///
+        /// Marks a task previously returned by pop() as finished.
+        ///
+        void complete() {
+            if (outstanding_tasks.fetch_sub(1) == 1) {
+                wake_all();
+            }
+        }
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// \return Number of tasks which are queued or currently executing
+        [[nodiscard]]
+        std::uint64_t outstanding() const {
+            return outstanding_tasks.load();
+        }
+
+        ///
+        /// \return Number of worker queues
+        [[nodiscard]]
+        std::size_t worker_count() const {
+            return queue_count;
+        }
+
+    private:
+
+        //=================================================
+        // Helper classes
+        //=================================================
+
+        ///
+        /// Queue owned by a single worker. Aligned to avoid false sharing
+        /// between the locks of neighbouring workers.
+        ///
+        struct alignas(64) Worker_queue {
+            std::mutex mutex;
+            std::deque<T> tasks;
+        };
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::unique_ptr<Worker_queue[]> queues;
+
+        std::size_t queue_count = 0;
+
+        ///
+        /// Number of tasks which have been pushed but not yet completed
+        ///
+        std::atomic<std::uint64_t> outstanding_tasks = 0;
+
+        ///
+        /// Counter which idle workers wait on. Incremented to wake them.
+        ///
+        std::atomic<std::uint32_t> wakeup_epoch = 0;
+
+        std::atomic<std::uint32_t> sleeping_workers = 0;
+
+        std::atomic<std::size_t> next_external_queue = 0;
+
+        std::atomic_bool terminate_once_idle = false;
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        ///
+        /// \param worker_index Index of calling worker
+        /// \param out Object to move the retrieved task into
+        /// \param waits_for_victims If false, queues of other workers whose
+        /// locks are held are skipped rather than waited on
+        /// \return True if a task was retrieved
+        bool try_pop(std::size_t worker_index, T& out, bool waits_for_victims) {
+            // Newest task from own queue
+            {
+                Worker_queue& queue = queues[worker_index % queue_count];
+                std::scoped_lock lk{queue.mutex};
+                if (!queue.tasks.empty()) {
+                    out = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                    return true;
+                }
+            }
+
+            // Oldest task from another worker's queue
+            for (std::size_t i = 1; i < queue_count; ++i) {
+                Worker_queue& victim = queues[(worker_index + i) % queue_count];
+
+                std::unique_lock lk{victim.mutex, std::defer_lock};
+                if (waits_for_victims) {
+                    lk.lock();
+                } else if (!lk.try_lock()) {
+                    continue;
+                }
+
+                if (victim.tasks.empty()) {
+                    continue;
+                }
+
+                out = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+
+            return false;
+        }
+
+        void wake_one() {
+            wakeup_epoch.fetch_add(1);
+            if (sleeping_workers.load() != 0) {
+                wakeup_epoch.notify_one();
+            }
+        }
+
+        void wake_all() {
+            wakeup_epoch.fetch_add(1);
+            wakeup_epoch.notify_all();
+        }
+
+    };
+
+}
+
+#endif //HARC_SCHEDULER_HPP
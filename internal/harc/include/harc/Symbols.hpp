@@ -1,55 +1,229 @@
 #ifndef HARC_SYMBOLS_HPP
 #define HARC_SYMBOLS_HPP
 
-#include <aul/containers/Array_map.hpp>
+#include <harc/common/String_pool.hpp>
 
-#include <string_view>
+#include <bit>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace harc::symbols {
 
+    ///
+    /// ID of a symbol's name within a String_pool
+    ///
+    using Symbol_id = std::uint32_t;
+
+    ///
+    /// \param id Arbitrary symbol ID
+    /// \return Hash of id. Computed once per lookup and shared by every
+    /// table visited along a parent chain.
+    [[nodiscard]]
+    constexpr std::uint64_t symbol_hash(Symbol_id id) {
+        return std::uint64_t{id} * 0x9e3779b97f4a7c15;
+    }
+
+    ///
+    /// Open-addressing hash map from symbol IDs to values.
+    ///
+    /// Keys are held in an array of their own so that probing touches as
+    /// little memory as possible. Slots are selected by the high bits of the
+    /// key's hash, which lets tables of different capacities share a hash.
+    ///
+    template<class V>
+    class Symbol_map {
+    public:
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// \param id ID of symbol's name. Must not be String_pool::null_id
+        /// \param value Value to associate with id
+        /// \return Pointer to value associated with id and true if it was
+        /// inserted. The existing value and false if id was already present.
+        std::pair<V*, bool> insert(Symbol_id id, V value) {
+            auto hash = symbol_hash(id);
+
+            // Existing keys are looked up before growing so that inserting
+            // one again never triggers a rehash
+            std::size_t i = 0;
+            if (count != 0) {
+                i = probe(id, hash);
+                if (keys[i] == id) {
+                    return {&values[i], false};
+                }
+            }
+
+            if (2 * (count + 1) > keys.size()) {
+                grow();
+                i = probe(id, hash);
+            }
+
+            keys[i] = id;
+            values[i] = std::move(value);
+            ++count;
+
+            return {&values[i], true};
+        }
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// \param id ID of symbol's name
+        /// \param hash symbol_hash(id)
+        /// \return Pointer to value associated with id. Null if not present.
+        [[nodiscard]]
+        const V* find(Symbol_id id, std::uint64_t hash) const {
+            if (count == 0) {
+                return nullptr;
+            }
+
+            auto i = probe(id, hash);
+            return (keys[i] == id) ? &values[i] : nullptr;
+        }
+
+        ///
+        /// \param id ID of symbol's name
+        /// \return Pointer to value associated with id. Null if not present.
+        [[nodiscard]]
+        const V* find(Symbol_id id) const {
+            return find(id, symbol_hash(id));
+        }
+
+        ///
+        /// \return Number of symbols in map
+        [[nodiscard]]
+        std::size_t size() const {
+            return count;
+        }
+
+    private:
+
+        static constexpr Symbol_id empty_key = String_pool::null_id;
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::vector<Symbol_id> keys;
+
+        std::vector<V> values;
+
+        std::size_t count = 0;
+
+        ///
+        /// 64 minus log2 of capacity
+        ///
+        std::uint32_t shift = 64;
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        ///
+        /// \return Index of slot holding id, or of the empty slot at which
+        /// id would be inserted
+        std::size_t probe(Symbol_id id, std::uint64_t hash) const {
+            auto mask = keys.size() - 1;
+            auto i = static_cast<std::size_t>(hash >> shift);
+            while (keys[i] != id && keys[i] != empty_key) {
+                i = (i + 1) & mask;
+            }
+
+            return i;
+        }
+
+        void grow() {
+            auto capacity = keys.empty() ? std::size_t{8} : 2 * keys.size();
+
+            auto old_keys = std::exchange(keys, std::vector<Symbol_id>(capacity, empty_key));
+            auto old_values = std::exchange(values, std::vector<V>(capacity));
+            shift = 64 - std::countr_zero(capacity);
+
+            for (std::size_t i = 0; i < old_keys.size(); ++i) {
+                if (old_keys[i] == empty_key) {
+                    continue;
+                }
+
+                auto j = probe(old_keys[i], symbol_hash(old_keys[i]));
+                keys[j] = old_keys[i];
+                values[j] = std::move(old_values[i]);
+            }
+        }
+
+    };
+
     struct Type {
 
     };
 
     struct Variable {
-        const Type* type;
+        const Type* type = nullptr;
 
-        std::uint64_t implementation_hash;
+        std::uint64_t implementation_hash = 0;
     };
 
     struct Subroutine {
-        const Type* return_type;
+        const Type* return_type = nullptr;
 
-        std::uint64_t implementation_hash;
+        std::uint64_t implementation_hash = 0;
     };
 
     struct Structure {
-        aul::Array_map<std::string_view, Variable> public_variables;
-        aul::Array_map<std::string_view, Variable> private_variables;
+        Symbol_map<Variable> public_variables;
+        Symbol_map<Variable> private_variables;
 
-        aul::Array_map<std::string_view, Subroutine> public_subroutines;
-        aul::Array_map<std::string_view, Subroutine> private_subroutines;
+        Symbol_map<Subroutine> public_subroutines;
+        Symbol_map<Subroutine> private_subroutines;
     };
 
     struct Symbol_table {
 
         ///
-        ///
+        /// Table of enclosing scope. Null for the outermost scope.
         ///
         Symbol_table* parent = nullptr;
 
-        aul::Array_map<std::string_view, Variable> public_variables;
-        aul::Array_map<std::string_view, Variable> private_variables;
+        Symbol_map<Variable> public_variables;
+        Symbol_map<Variable> private_variables;
+
+        Symbol_map<Subroutine> public_subroutines;
+        Symbol_map<Subroutine> private_subroutines;
 
-        aul::Array_map<std::string_view, Subroutine> public_subroutines;
-        aul::Array_map<std::string_view, Subroutine> private_subroutines;
+        Symbol_map<Variable> public_structures;
+        Symbol_map<Variable> private_structures;
 
-        aul::Array_map<std::string_view, Variable> public_structures;
-        aul::Array_map<std::string_view, Variable> private_structures;
+        Symbol_map<Type> public_types;
+        Symbol_map<Type> private_types;
+
+        ///
+        /// Searches this table and then each of its ancestors in turn. The
+        /// name's hash is computed once for the whole search.
+        ///
+        /// \param map Map to search within each table, e.g.
+        /// &Symbol_table::public_variables
+        /// \param id ID of symbol's name
+        /// \return Pointer to value within the innermost table which
+        /// contains id. Null if no table does.
+        template<class V>
+        [[nodiscard]]
+        const V* find(Symbol_map<V> Symbol_table::* map, Symbol_id id) const {
+            auto hash = symbol_hash(id);
+
+            for (const auto* table = this; table; table = table->parent) {
+                if (const auto* value = (table->*map).find(id, hash)) {
+                    return value;
+                }
+            }
+
+            return nullptr;
+        }
 
-        aul::Array_map<std::string_view, Type> public_types;
-        aul::Array_map<std::string_view, Type> private_types;
     };
 
 }
@@ -0,0 +1,170 @@
+#ifndef HARC_TIMING_HPP
+#define HARC_TIMING_HPP
+
+#include <harc/Config.hpp>
+#include <harc/Pipeline.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace harc {
+
+    ///
+    /// Number of files listed in the file timing report
+    ///
+    constexpr std::size_t slowest_file_count = 20;
+
+    ///
+    /// Time spent by a single translation unit in a single stage
+    ///
+    struct File_stage_timing {
+        std::string_view path{};
+        std::uint64_t bytes = 0;
+        Stage stage = Stage::NULL_STEP;
+
+        ///
+        /// Duration in nanoseconds
+        ///
+        std::uint64_t duration = 0;
+    };
+
+    ///
+    /// Timing data accumulated by a single worker thread.
+    ///
+    /// Only ever written by the thread which owns it and only read once all
+    /// workers have been joined, so no synchronization is required. Aligned
+    /// so that neighbouring threads never write to the same cache line.
+    ///
+    struct alignas(64) Thread_timing_data {
+
+        ///
+        /// Cumulative time in nanoseconds spent on each stage
+        ///
+        std::array<std::uint64_t, stage_count> stage_durations{};
+
+        ///
+        /// Cumulative size of the sources processed by each stage
+        ///
+        std::array<std::uint64_t, stage_count> stage_bytes{};
+
+        ///
+        /// Number of units processed by each stage
+        ///
+        std::array<std::uint32_t, stage_count> stage_unit_counts{};
+
+        ///
+        /// Per-unit timings. Only populated when a file timing report was
+        /// requested.
+        ///
+        std::vector<File_stage_timing> file_timings{};
+
+    };
+
+    ///
+    /// Collects the time spent on each stage and each translation unit by the
+    /// worker threads and produces the reports requested by the Config's
+    /// stage_timing_data_report and file_timing_data_report fields.
+    ///
+    /// Each worker records into its own Thread_timing_data so that recording
+    /// never takes a lock. Reports merge the per-thread data and must only be
+    /// produced once all workers have been joined.
+    ///
+    class Timing_collector {
+    public:
+
+        using clock = std::chrono::steady_clock;
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// Discards any previously collected data and prepares one
+        /// accumulator per worker
+        ///
+        /// \param worker_count Number of worker threads which will record
+        /// \param stage_report_level Level of stage timing report
+        /// \param file_report_level Level of file timing report
+        void initialize(std::size_t worker_count, Level stage_report_level, Level file_report_level);
+
+        ///
+        /// Marks the start of the build for the purposes of measuring total
+        /// build time
+        ///
+        void begin_build();
+
+        ///
+        /// Marks the end of the build for the purposes of measuring total
+        /// build time
+        ///
+        void end_build();
+
+        ///
+        /// Records the time taken by a unit in a stage. Does nothing if no
+        /// report was requested.
+        ///
+        /// \param worker_index Index of the calling worker thread
+        /// \param stage Stage which was performed
+        /// \param path Path of the unit's source file. Must outlive the
+        /// collector.
+        /// \param bytes Size of the unit's source
+        /// \param duration Time spent on the stage
+        void record(
+            std::size_t worker_index,
+            Stage stage,
+            std::string_view path,
+            std::uint64_t bytes,
+            clock::duration duration
+        );
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// \return True if either report was requested
+        [[nodiscard]]
+        bool is_enabled() const {
+            return stage_level != Level::NONE || file_level != Level::NONE;
+        }
+
+        ///
+        /// \return Human-readable report of collected timing data, at the
+        /// levels specified to initialize(). Empty if no report was
+        /// requested.
+        [[nodiscard]]
+        std::string report() const;
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::vector<Thread_timing_data> threads;
+
+        Level stage_level = Level::NONE;
+
+        Level file_level = Level::NONE;
+
+        clock::time_point build_begin{};
+
+        clock::time_point build_end{};
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        void append_stage_report(std::string& out) const;
+
+        void append_file_report(std::string& out) const;
+
+    };
+
+}
+
+#endif //HARC_TIMING_HPP
@@ -0,0 +1,200 @@
+#ifndef HARC_TRACING_HPP
+#define HARC_TRACING_HPP
+
+#include <harc/Errors.hpp>
+#include <harc/Pipeline.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace harc {
+
+    ///
+    /// Number of events retained per worker. Once a worker's buffer is full,
+    /// its oldest events are overwritten.
+    ///
+    constexpr std::size_t trace_events_per_worker = 1 << 14;
+
+    enum class Trace_event_type : std::uint8_t {
+        ///
+        /// Worker was executing a task
+        ///
+        TASK,
+
+        ///
+        /// Worker was waiting on the scheduler for a task, including time
+        /// spent contending for queue locks and sleeping
+        ///
+        IDLE
+    };
+
+    ///
+    /// Span of time spent by a worker on a single activity
+    ///
+    struct Trace_event {
+        Trace_event_type type = Trace_event_type::TASK;
+        Stage stage = Stage::NULL_STEP;
+
+        ///
+        /// Path of unit which the task operated on, or of the first unit if
+        /// the task operated on a batch. Empty for idle events.
+        ///
+        std::string_view path{};
+
+        ///
+        /// Number of units which the task operated on
+        ///
+        std::uint32_t unit_count = 0;
+
+        std::chrono::steady_clock::time_point begin{};
+        std::chrono::steady_clock::time_point end{};
+
+        ///
+        /// Time between the task being pushed onto the scheduler and being
+        /// popped by the worker
+        ///
+        std::chrono::steady_clock::duration queue_wait{};
+    };
+
+    ///
+    /// Fixed-capacity buffer of trace events written by a single worker.
+    /// Aligned so that neighbouring workers never write to the same cache
+    /// line.
+    ///
+    struct alignas(64) Trace_ring_buffer {
+
+        std::vector<Trace_event> events{};
+
+        ///
+        /// Total number of events ever pushed. Events are stored at index
+        /// push_count % capacity.
+        ///
+        std::uint64_t push_count = 0;
+
+        void push(const Trace_event& event) {
+            events[push_count % events.size()] = event;
+            ++push_count;
+        }
+
+        ///
+        /// \return Number of events which were overwritten
+        [[nodiscard]]
+        std::uint64_t dropped_count() const {
+            return (push_count > events.size()) ? push_count - events.size() : 0;
+        }
+
+    };
+
+    ///
+    /// Records what each worker spends its time on and writes it out in the
+    /// Chrome trace event format, which may be loaded by chrome://tracing or
+    /// Perfetto.
+    ///
+    /// Each worker records into its own ring buffer so that recording never
+    /// takes a lock. Traces must only be written once all workers have been
+    /// joined.
+    ///
+    class Trace_recorder {
+    public:
+
+        using clock = std::chrono::steady_clock;
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// Discards any previously recorded events. Allocates one ring buffer
+        /// per worker if enabled.
+        ///
+        /// \param worker_count Number of worker threads which will record
+        /// \param enabled Whether events should be recorded
+        void initialize(std::size_t worker_count, bool enabled);
+
+        ///
+        /// Records that a worker executed a task. Does nothing if disabled.
+        ///
+        /// \param worker_index Index of the calling worker thread
+        /// \param stage Stage of the task
+        /// \param path Path of the task's first unit. Must outlive the
+        /// recorder.
+        /// \param unit_count Number of units the task operated on
+        /// \param begin Time at which the worker began the task
+        /// \param end Time at which the worker finished the task
+        /// \param queue_wait Time the task spent queued before being popped
+        void record_task(
+            std::size_t worker_index,
+            Stage stage,
+            std::string_view path,
+            std::uint32_t unit_count,
+            clock::time_point begin,
+            clock::time_point end,
+            clock::duration queue_wait
+        ) {
+            if (!enabled) {
+                return;
+            }
+
+            buffers[worker_index].push(Trace_event{Trace_event_type::TASK, stage, path, unit_count, begin, end, queue_wait});
+        }
+
+        ///
+        /// Records that a worker waited on the scheduler. Does nothing if
+        /// disabled.
+        ///
+        /// \param worker_index Index of the calling worker thread
+        /// \param begin Time at which the worker began waiting
+        /// \param end Time at which the worker received a task
+        void record_idle(std::size_t worker_index, clock::time_point begin, clock::time_point end) {
+            if (!enabled) {
+                return;
+            }
+
+            buffers[worker_index].push(Trace_event{Trace_event_type::IDLE, Stage::NULL_STEP, {}, 0, begin, end, {}});
+        }
+
+        ///
+        /// Writes the recorded events to the specified path as a Chrome
+        /// trace
+        ///
+        /// \param path Path of file to write
+        /// \return INACCESSIBLE_TRACE_FILE if the file could not be written
+        Error_code write(std::string_view path) const;
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        bool is_enabled() const {
+            return enabled;
+        }
+
+        ///
+        /// \return Recorded events in the Chrome trace event JSON format
+        [[nodiscard]]
+        std::string to_json() const;
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::vector<Trace_ring_buffer> buffers;
+
+        bool enabled = false;
+
+        ///
+        /// Time relative to which event timestamps are written
+        ///
+        clock::time_point origin{};
+
+    };
+
+}
+
+#endif //HARC_TRACING_HPP
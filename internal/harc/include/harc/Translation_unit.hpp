@@ -4,13 +4,20 @@
 #include <harc/lexer/Lexer.hpp>
 #include <harc/parser/Parse_tree.hpp>
 #include <harc/Symbols.hpp>
+#include <harc/common/Identifier_table.hpp>
+#include <harc/common/OS_utils.hpp>
 
 #include "lexer_cuda/Lexing_cuda.hpp"
 
 #include <string_view>
+#include <string>
+#include <memory>
+#include <array>
 
 namespace harc {
 
+    struct Cache_entry_info;
+
     ///
     /// Enum used to indicate success status in attempt to process translation
     /// unit.
@@ -71,15 +78,58 @@ namespace harc {
         std::string_view source_path;
 
         ///
-        /// String containing contents of source
+        /// View over contents of source. Points into either source_mapping
+        /// or source_buffer, neither of which move when the unit is moved.
         ///
-        std::string source;
+        std::string_view source;
 
         ///
-        /// Token sequence and necessary metadata
+        /// Memory mapping of source file. Empty if the source did not come
+        /// from a file.
+        ///
+        Mapped_text_file source_mapping;
+
+        ///
+        /// Heap allocated copy of source for sources which do not come from
+        /// a file, such as stdin or in-memory sources
+        ///
+        std::unique_ptr<std::string> source_buffer;
+
+        ///
+        /// Modification time of source file in nanoseconds since the epoch.
+        /// 0 if unknown.
+        ///
+        std::uint64_t source_timestamp = 0;
+
+        ///
+        /// 128-bit MurmurHash3 of source, as computed by the prepass
+        ///
+        std::array<std::uint64_t, 2> source_hash{};
+
+        ///
+        /// Entry for this unit within the build cache from the previous
+        /// build. Null if there is no entry or if the entry is out of date.
+        ///
+        const Cache_entry_info* cache_entry = nullptr;
+
+        ///
+        /// Token sequence and necessary metadata. Left empty if the tokens
+        /// were taken from the build cache.
         ///
         lex::Tokenization tokenization;
 
+        ///
+        /// Tokens consumed by later stages. Views either tokenization or a
+        /// serialized tokenization within the build cache. Neither moves when
+        /// the unit is moved.
+        ///
+        lex::Tokenization_view tokens;
+
+        ///
+        /// IDs of the identifiers which appear in the parse tree
+        ///
+        Identifier_table identifiers;
+
         ///
         /// Parse tree
         ///
@@ -95,6 +145,31 @@ namespace harc {
         ///
         Translation_unit_status status = Translation_unit_status::NO_ERROR;
 
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// Takes ownership of a file mapping and uses its contents as the
+        /// unit's source without copying them
+        ///
+        /// \param mapping Mapping of source file
+        void set_source(Mapped_text_file&& mapping) {
+            source_mapping = std::move(mapping);
+            source_buffer.reset();
+            source = source_mapping.text();
+        }
+
+        ///
+        /// Takes ownership of an in-memory source
+        ///
+        /// \param str String containing source
+        void set_source(std::string&& str) {
+            source_mapping = Mapped_text_file{};
+            source_buffer = std::make_unique<std::string>(std::move(str));
+            source = *source_buffer;
+        }
+
         //=================================================
         // Accessors
         //=================================================
@@ -106,8 +181,8 @@ namespace harc {
         [[nodiscard]]
         std::string_view token_source(std::uint32_t token_index) const {
             return std::string_view{
-                source.data() + tokenization.source_indices[token_index],
-                tokenization.lengths[token_index]
+                source.data() + tokens.source_indices[token_index],
+                tokens.lengths[token_index]
             };
         }
 
@@ -2,6 +2,7 @@
 #define HARMONIA_CLI_ERRORS_HPP
 
 #include <cstdint>
+#include <string>
 #include <string_view>
 
 #include <aul/Span.hpp>
@@ -17,6 +18,7 @@ namespace harc::cli {
         NO_ERROR,
         UNRECOGNIZED_KEY,
         UNRECOGNIZED_VALUE,
+        MISSING_VALUE,
 
         VALUE_NOT_UNSIGNED_INTEGER,
         VALUE_NOT_SIGNED_INTEGER,
@@ -37,6 +39,8 @@ namespace harc::cli {
         IPV4_OCTET_VALUE_TOO_LARGE,
         EXCESS_DIGITS,
         INVALID_DIGITS,
+        INACCESSIBLE_TRACE_DIRECTORY,
+        DIRECTORY_AS_TRACE_PATH,
         //INACCESSIBLE_ASSEMBLER_PATH,
         //DIRECTORY_AS_ASSEMBLER_PATH,
         //UNRECOGNIZED_ASSEMBLER_WITHOUT_SPECIFIED_SYNTAX,
@@ -51,6 +55,8 @@ namespace harc::cli {
         NO_WARNING,
         PRIVILEGED_PORT_NUMBER,
         MORE_THREADS_REQUESTED_THAN_AVAILABLE,
+        LARGE_TASK_BATCH_BYTE_BUDGET,
+        SMALL_CHUNK_SIZE,
     };
 
     ///
@@ -0,0 +1,221 @@
+#ifndef HARC_ARENA_HPP
+#define HARC_ARENA_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace harc {
+
+    ///
+    /// A bump allocator which hands out memory from a chain of large blocks.
+    ///
+    /// Objects allocated from an arena are never freed individually. Instead,
+    /// every allocation is released at once when the arena is destroyed or
+    /// release() is called. Destructors of objects created through create()
+    /// are run at that point, in reverse order of construction, but only for
+    /// types which are not trivially destructible.
+    ///
+    /// Moving an arena does not move the objects allocated from it, so
+    /// pointers to those objects remain valid in the new owner.
+    ///
+    class Arena {
+    public:
+
+        ///
+        /// Size of the first block allocated by a default-constructed arena
+        ///
+        static constexpr std::size_t default_block_size = 16 * 1024;
+
+        ///
+        /// Size beyond which block sizes stop growing geometrically
+        ///
+        static constexpr std::size_t max_block_size = 1024 * 1024;
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        explicit Arena(std::size_t initial_block_size = default_block_size):
+            next_block_size(initial_block_size) {}
+
+        Arena(const Arena&) = delete;
+
+        Arena(Arena&& other) noexcept:
+            blocks(std::exchange(other.blocks, nullptr)),
+            destructors(std::exchange(other.destructors, nullptr)),
+            cursor(std::exchange(other.cursor, nullptr)),
+            limit(std::exchange(other.limit, nullptr)),
+            next_block_size(other.next_block_size),
+            used(std::exchange(other.used, 0)),
+            reserved(std::exchange(other.reserved, 0)) {}
+
+        ~Arena() {
+            release();
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Arena& operator=(const Arena&) = delete;
+
+        Arena& operator=(Arena&& rhs) noexcept {
+            if (this == &rhs) {
+                return *this;
+            }
+
+            release();
+
+            blocks = std::exchange(rhs.blocks, nullptr);
+            destructors = std::exchange(rhs.destructors, nullptr);
+            cursor = std::exchange(rhs.cursor, nullptr);
+            limit = std::exchange(rhs.limit, nullptr);
+            next_block_size = rhs.next_block_size;
+            used = std::exchange(rhs.used, 0);
+            reserved = std::exchange(rhs.reserved, 0);
+
+            return *this;
+        }
+
+        //=================================================
+        // Allocation methods
+        //=================================================
+
+        ///
+        /// \param size Number of bytes to allocate
+        /// \param alignment Alignment of allocation. Must be a power of two
+        /// \return Pointer to uninitialized storage which lives until the
+        /// arena is released
+        [[nodiscard]]
+        void* allocate(std::size_t size, std::size_t alignment) {
+            auto address = reinterpret_cast<std::uintptr_t>(cursor);
+            auto aligned = (address + alignment - 1) & ~(alignment - 1);
+            auto end = aligned + size;
+
+            if (cursor == nullptr || end > reinterpret_cast<std::uintptr_t>(limit)) {
+                return allocate_from_new_block(size, alignment);
+            }
+
+            cursor = reinterpret_cast<std::byte*>(end);
+            used += size;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        ///
+        /// Constructs an object within the arena
+        ///
+        /// \tparam T Type of object to construct
+        /// \param args Arguments to forward to T's constructor
+        /// \return Pointer to newly constructed object
+        template<class T, class...Args>
+        [[nodiscard]]
+        T* create(Args&&...args) {
+            void* storage = allocate(sizeof(T), alignof(T));
+            T* ret = ::new (storage) T(std::forward<Args>(args)...);
+
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                register_destructor(ret, [] (void* p) {
+                    static_cast<T*>(p)->~T();
+                });
+            }
+
+            return ret;
+        }
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// Runs the destructors of all objects created within the arena and
+        /// returns all blocks to the system. The arena may be reused
+        /// afterwards.
+        ///
+        void release();
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// \return Number of bytes handed out by the arena, not including
+        /// padding or bookkeeping
+        [[nodiscard]]
+        std::size_t bytes_used() const {
+            return used;
+        }
+
+        ///
+        /// \return Number of bytes requested from the system by the arena
+        [[nodiscard]]
+        std::size_t bytes_reserved() const {
+            return reserved;
+        }
+
+    private:
+
+        //=================================================
+        // Helper classes
+        //=================================================
+
+        struct Block_header {
+            Block_header* previous = nullptr;
+            std::size_t size = 0;
+        };
+
+        struct Destructor_entry {
+            Destructor_entry* previous = nullptr;
+            void (*destroy)(void*) = nullptr;
+            void* object = nullptr;
+        };
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        ///
+        /// Most recently allocated block. Blocks form a singly linked list
+        /// through their headers.
+        ///
+        Block_header* blocks = nullptr;
+
+        ///
+        /// Most recently registered destructor. Entries are themselves
+        /// allocated from the arena.
+        ///
+        Destructor_entry* destructors = nullptr;
+
+        std::byte* cursor = nullptr;
+
+        std::byte* limit = nullptr;
+
+        std::size_t next_block_size = default_block_size;
+
+        std::size_t used = 0;
+
+        std::size_t reserved = 0;
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        void* allocate_from_new_block(std::size_t size, std::size_t alignment);
+
+        void register_destructor(void* object, void (*destroy)(void*)) {
+            auto* entry = static_cast<Destructor_entry*>(
+                allocate(sizeof(Destructor_entry), alignof(Destructor_entry))
+            );
+            entry->previous = destructors;
+            entry->destroy = destroy;
+            entry->object = object;
+            destructors = entry;
+        }
+
+    };
+
+}
+
+#endif //HARC_ARENA_HPP
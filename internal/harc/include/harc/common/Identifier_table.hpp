@@ -0,0 +1,76 @@
+#ifndef HARC_IDENTIFIER_TABLE_HPP
+#define HARC_IDENTIFIER_TABLE_HPP
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace harc {
+
+    ///
+    /// Maps each distinct identifier to a small integer so that later stages
+    /// may compare identifiers without comparing their text.
+    ///
+    /// IDs are assigned densely, in order of first appearance. The table
+    /// stores views rather than copies, so interned text must outlive the
+    /// table, as is the case for the source of a translation unit.
+    ///
+    class Identifier_table {
+    public:
+
+        ///
+        /// Value which is never assigned to an identifier
+        ///
+        static constexpr std::uint32_t null_id = UINT32_MAX;
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// \param text Identifier to intern
+        /// \return ID of text. The same text always produces the same ID.
+        std::uint32_t intern(std::string_view text);
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// \param text Identifier to look up
+        /// \return ID of text if it was previously interned. null_id
+        /// otherwise.
+        [[nodiscard]]
+        std::uint32_t find(std::string_view text) const;
+
+        ///
+        /// \param id ID returned from intern()
+        /// \return Text of identifier
+        [[nodiscard]]
+        std::string_view text(std::uint32_t id) const {
+            return names[id];
+        }
+
+        ///
+        /// \return Number of distinct identifiers interned
+        [[nodiscard]]
+        std::uint32_t size() const {
+            return static_cast<std::uint32_t>(names.size());
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::unordered_map<std::string_view, std::uint32_t> ids;
+
+        std::vector<std::string_view> names;
+
+    };
+
+}
+
+#endif //HARC_IDENTIFIER_TABLE_HPP
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <string_view>
+#include <utility>
 
 #include <aul/Span.hpp>
 
@@ -29,6 +30,26 @@ namespace harc {
 
 
 
+    ///
+    /// Options which control how a file is memory mapped
+    ///
+    struct File_mapping_options {
+
+        ///
+        /// Advise the OS that the mapping will be read sequentially so that
+        /// it may read ahead more aggressively and drop pages behind the
+        /// reader
+        ///
+        bool sequential = true;
+
+        ///
+        /// Fault in all pages of the mapping before returning so that later
+        /// reads do not stall on page faults. Only supported on Linux.
+        ///
+        bool populate = false;
+
+    };
+
     ///
     /// Utility struct used as the output of the map_binary_file subroutine.
     ///
@@ -41,14 +62,15 @@ namespace harc {
     /// Memory map a file to be interpreted as a sequence of bytes.
     ///
     /// \param view View over null-terminated string containing path to file
+    /// \param options Options controlling how the file is mapped
     /// \return
     [[nodiscard]]
-    Binary_file_mapping map_binary_file(std::string_view path);
+    Binary_file_mapping map_binary_file(std::string_view path, File_mapping_options options = {});
 
     ///
     /// \param bytes Span over bytes that was returned by an earlier call to
     ///  map_binary_file
-    void unmap_file(aul::Span<std::byte> bytes);
+    void unmap_file(aul::Span<const std::byte> bytes);
 
     ///
     /// \param mapping Span over bytes that was returned by an earlier call to
@@ -69,9 +91,10 @@ namespace harc {
     /// Memory map a file to be interpreted as containing ASCII/UTF-8 text
     ///
     /// \param view View over null-terminated string containing path to file
+    /// \param options Options controlling how the file is mapped
     /// \return
     [[nodiscard]]
-    Text_file_mapping map_text_file(std::string_view path);
+    Text_file_mapping map_text_file(std::string_view path, File_mapping_options options = {});
 
     ///
     /// \param bytes
@@ -81,6 +104,72 @@ namespace harc {
     /// \param mapping
     void unmap_file(Text_file_mapping mapping);
 
+    ///
+    /// \param path View over null-terminated string containing path to file
+    /// \return Last modification time of file in nanoseconds since the
+    /// epoch. 0 if the file could not be queried.
+    [[nodiscard]]
+    std::uint64_t file_modification_time(std::string_view path);
+
+    ///
+    /// RAII wrapper which owns a memory mapped text file and unmaps it upon
+    /// destruction. Moving the object does not move the mapped text, so
+    /// views into it remain valid for as long as some object owns it.
+    ///
+    class Mapped_text_file {
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        explicit Mapped_text_file(Text_file_mapping mapping):
+            mapping(mapping.text) {}
+
+        Mapped_text_file() = default;
+        Mapped_text_file(const Mapped_text_file&) = delete;
+        Mapped_text_file(Mapped_text_file&& other) noexcept:
+            mapping(std::exchange(other.mapping, {})) {}
+
+        ~Mapped_text_file() {
+            unmap_file(mapping);
+        }
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        Mapped_text_file& operator=(const Mapped_text_file&) = delete;
+        Mapped_text_file& operator=(Mapped_text_file&& rhs) noexcept {
+            if (this != &rhs) {
+                unmap_file(mapping);
+                mapping = std::exchange(rhs.mapping, {});
+            }
+
+            return *this;
+        }
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// \return View over mapped text. Empty if nothing is mapped.
+        [[nodiscard]]
+        std::string_view text() const {
+            return mapping;
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::string_view mapping{};
+
+    };
+
 }
 
 #endif //HARC_OS_UTILS_HPP
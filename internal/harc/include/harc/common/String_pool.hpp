@@ -0,0 +1,190 @@
+#ifndef HARC_STRING_POOL_HPP
+#define HARC_STRING_POOL_HPP
+
+#include <harc/common/Arena.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+
+namespace harc {
+
+    ///
+    /// A thread-safe pool of interned strings which assigns each distinct
+    /// string a stable 32-bit ID. Intended to be shared by all translation
+    /// units so that symbols may be keyed by ID across module boundaries.
+    ///
+    /// Strings are spread across shards by hash. Each shard holds an
+    /// open-addressing table which is only ever replaced as a whole, never
+    /// modified in place except to fill empty slots, so lookups of strings
+    /// which are already present take no locks. Inserting takes the lock of
+    /// a single shard.
+    ///
+    /// Interned text is copied into the pool, so views returned by text()
+    /// remain valid for the life of the pool.
+    ///
+    class String_pool {
+    public:
+
+        ///
+        /// Value which is never assigned to a string
+        ///
+        static constexpr std::uint32_t null_id = UINT32_MAX;
+
+        ///
+        /// Number of shards. The low bits of an ID identify its shard.
+        ///
+        static constexpr std::uint32_t shard_count = 64;
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        String_pool();
+
+        String_pool(const String_pool&) = delete;
+        String_pool(String_pool&&) = delete;
+
+        ~String_pool() = default;
+
+        //=================================================
+        // Assignment operators
+        //=================================================
+
+        String_pool& operator=(const String_pool&) = delete;
+        String_pool& operator=(String_pool&&) = delete;
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// \param text String to intern
+        /// \return ID of text. The same text always produces the same ID.
+        /// null_id if the shard which text falls in is full.
+        std::uint32_t intern(std::string_view text);
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// Takes no locks
+        ///
+        /// \param text String to look up
+        /// \return ID of text if it was previously interned. null_id
+        /// otherwise.
+        [[nodiscard]]
+        std::uint32_t find(std::string_view text) const;
+
+        ///
+        /// Takes no locks
+        ///
+        /// \param id ID returned from intern()
+        /// \return Text of interned string
+        [[nodiscard]]
+        std::string_view text(std::uint32_t id) const;
+
+        ///
+        /// \return Number of distinct strings interned
+        [[nodiscard]]
+        std::size_t size() const;
+
+    private:
+
+        //=================================================
+        // Helper classes
+        //=================================================
+
+        struct Entry {
+            std::uint64_t hash = 0;
+            std::string_view text{};
+            std::uint32_t id = null_id;
+        };
+
+        ///
+        /// Fixed-capacity open-addressing table of entries. Tables which are
+        /// replaced by larger ones are retained until the pool is destroyed
+        /// since readers may still be probing them.
+        ///
+        struct Slot_table {
+            std::atomic<const Entry*>* slots = nullptr;
+            std::size_t capacity = 0;
+        };
+
+        ///
+        /// Number of entries in the first chunk of a shard's entries. Each
+        /// subsequent chunk is twice as large as the last so that chunks
+        /// never move and are few enough to be held in a fixed array.
+        ///
+        static constexpr std::uint32_t first_chunk_size = 64;
+
+        ///
+        /// Enough chunks to hold every ID which a shard may assign
+        ///
+        static constexpr std::uint32_t max_chunk_count = 21;
+
+        struct alignas(64) Shard {
+
+            ///
+            /// Serializes insertions into the shard
+            ///
+            std::mutex mutex;
+
+            std::atomic<const Slot_table*> table = nullptr;
+
+            std::array<std::atomic<const Entry*>, max_chunk_count> chunks{};
+
+            std::atomic<std::uint32_t> entry_count = 0;
+
+            ///
+            /// Holds the text, entries, and tables of the shard
+            ///
+            Arena arena;
+
+        };
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::unique_ptr<Shard[]> shards;
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        ///
+        /// \param local_index Index of entry within its shard
+        /// \return Index of chunk holding the entry and the entry's offset
+        /// within that chunk
+        [[nodiscard]]
+        static std::array<std::uint32_t, 2> locate(std::uint32_t local_index);
+
+        ///
+        /// \param table Table to search
+        /// \param hash Hash of text
+        /// \param text String to look up
+        /// \return Entry for text. Null if not present.
+        [[nodiscard]]
+        static const Entry* probe(const Slot_table& table, std::uint64_t hash, std::string_view text);
+
+        ///
+        /// \param table Table with at least one empty slot
+        /// \param entry Entry to add to table
+        static void insert(const Slot_table& table, const Entry* entry);
+
+        ///
+        /// \param shard Shard whose mutex is held
+        /// \param capacity Number of slots in new table. Power of two
+        /// \return New table containing all of the shard's entries
+        static const Slot_table* create_table(Shard& shard, std::size_t capacity);
+
+    };
+
+}
+
+#endif //HARC_STRING_POOL_HPP
@@ -0,0 +1,238 @@
+#ifndef HARC_FLAT_PARSE_TREE_HPP
+#define HARC_FLAT_PARSE_TREE_HPP
+
+#include "Parse_tree_fwd.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace harc::parser {
+
+    enum class Node_type : std::uint8_t {
+        GENERIC_NODE,
+        TEXT,
+        RESOLVED_IDENTIFIER,
+        IDENTIFIER,
+        STATEMENT,
+        IF_STATEMENT,
+        WHILE_STATEMENT,
+        FOR_LOOP,
+        RANGED_FOR_LOOP,
+        DO_WHILE_LOOP,
+        EXPRESSION_STATEMENT,
+        EXPRESSION,
+        IDENTIFIER_EXPRESSION,
+        EXPRESSION_LIST,
+        EXPRESSION_SEQUENCE,
+        TYPE_EXPRESSION,
+        RESOLVED_TEMPLATE,
+        NUMERIC_LITERAL_EXPRESSION,
+        STRING_LITERAL_EXPRESSION,
+        CODEPOINT_LITERAL_EXPRESSION,
+        TUPLE_LITERAL,
+        PARENTHESIZED_EXPRESSION,
+        UNARY_OPERATOR_EXPRESSION,
+        BINARY_OPERATOR_EXPRESSION,
+        BINARY_TEXT_OPERATOR_EXPRESSION,
+        FUNCTION_CALL,
+        SUBSCRIPT_CALL,
+        RETURN_STATEMENT,
+        VARIABLE_DECLARATION,
+        CONSTANT_DECLARATION,
+        MODULE_DECLARATION,
+        ATTRIBUTE,
+        ATTRIBUTE_LIST,
+        CODE_BODY,
+        PARAMETER,
+        PARAMETER_LIST,
+        SOURCE_BODY,
+        FUNCTION_DEFINITION,
+        LAMBDA,
+        STRUCT_DEFINITION,
+        ALIAS_DEFINITION,
+        SOURCE_BODY_LIST,
+        SOURCE_FILE
+    };
+
+    ///
+    /// Compact representation of a parse tree, stored as parallel arrays in
+    /// the same manner as lex::Tokenization.
+    ///
+    /// Nodes are stored in pre-order, so the root is node 0 and every
+    /// subtree occupies a contiguous range of indices. The pointer-linked
+    /// lists of the node hierarchy in Parse_tree.hpp, such as
+    /// Source_body_list, are flattened into a single node whose elements are
+    /// its children.
+    ///
+    struct Flat_parse_tree {
+
+        ///
+        /// Index used in place of a child or sibling which does not exist
+        ///
+        static constexpr std::uint32_t null_index = UINT32_MAX;
+
+        ///
+        /// Type of each node
+        ///
+        std::vector<Node_type> types{};
+
+        ///
+        /// Index of each node's first child
+        ///
+        std::vector<std::uint32_t> first_children{};
+
+        ///
+        /// Index of the node which follows each node within its parent
+        ///
+        std::vector<std::uint32_t> next_siblings{};
+
+        ///
+        /// Index of first token spanned by each node
+        ///
+        std::vector<std::uint32_t> first_tokens{};
+
+        ///
+        /// Index one past the last token spanned by each node. Equal to the
+        /// first token for nodes which span no tokens.
+        ///
+        std::vector<std::uint32_t> end_tokens{};
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        std::uint32_t size() const {
+            return static_cast<std::uint32_t>(types.size());
+        }
+
+        [[nodiscard]]
+        bool empty() const {
+            return types.empty();
+        }
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        void clear() {
+            types.clear();
+            first_children.clear();
+            next_siblings.clear();
+            first_tokens.clear();
+            end_tokens.clear();
+        }
+
+        void reserve(std::size_t n) {
+            types.reserve(n);
+            first_children.reserve(n);
+            next_siblings.reserve(n);
+            first_tokens.reserve(n);
+            end_tokens.reserve(n);
+        }
+
+        ///
+        /// Appends a node without any children or siblings
+        ///
+        /// \param type Type of new node
+        /// \return Index of new node
+        std::uint32_t append(Node_type type) {
+            auto ret = size();
+            types.push_back(type);
+            first_children.push_back(null_index);
+            next_siblings.push_back(null_index);
+            first_tokens.push_back(UINT32_MAX);
+            end_tokens.push_back(0);
+            return ret;
+        }
+
+    };
+
+    ///
+    /// Base class for passes over a Flat_parse_tree. Dispatch is resolved at
+    /// compile time via CRTP, so no virtual calls are made.
+    ///
+    /// Derived classes may define either of the following, which are
+    /// otherwise no-ops:
+    ///
+    ///     bool enter(const Flat_parse_tree&, std::uint32_t node);
+    ///     void leave(const Flat_parse_tree&, std::uint32_t node);
+    ///
+    /// enter() is called before a node's children are visited and may
+    /// return false to skip them. leave() is called after.
+    ///
+    /// \tparam Derived Derived visitor class
+    template<class Derived>
+    class Flat_visitor {
+    public:
+
+        //=================================================
+        // Visit methods
+        //=================================================
+
+        ///
+        /// Visits every node in the tree in pre-order. Uses an explicit
+        /// stack rather than recursion so that deeply nested sources cannot
+        /// overflow the call stack.
+        ///
+        /// \param tree Tree to traverse
+        void traverse(const Flat_parse_tree& tree) {
+            if (tree.empty()) {
+                return;
+            }
+
+            auto& derived = static_cast<Derived&>(*this);
+            constexpr auto null_index = Flat_parse_tree::null_index;
+
+            stack.clear();
+            std::uint32_t node = 0;
+            while (true) {
+                bool descend = derived.enter(tree, node);
+
+                if (descend && tree.first_children[node] != null_index) {
+                    stack.push_back(node);
+                    node = tree.first_children[node];
+                    continue;
+                }
+
+                derived.leave(tree, node);
+
+                while (tree.next_siblings[node] == null_index) {
+                    if (stack.empty()) {
+                        return;
+                    }
+
+                    node = stack.back();
+                    stack.pop_back();
+                    derived.leave(tree, node);
+                }
+
+                node = tree.next_siblings[node];
+            }
+        }
+
+        bool enter(const Flat_parse_tree&, std::uint32_t) {
+            return true;
+        }
+
+        void leave(const Flat_parse_tree&, std::uint32_t) {}
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        std::vector<std::uint32_t> stack;
+
+    };
+
+    ///
+    /// \param root Root of pointer-based parse tree. May be null
+    /// \return Flattened copy of the tree rooted at root
+    [[nodiscard]]
+    Flat_parse_tree flatten(Parse_tree_node* root);
+
+}
+
+#endif //HARC_FLAT_PARSE_TREE_HPP
@@ -1,8 +1,11 @@
 #ifndef HARMONIA_OPERATORS_HPP
 #define HARMONIA_OPERATORS_HPP
 
+#include <harc/lexer/Tokens.hpp>
+
+#include <algorithm>
+#include <array>
 #include <cstdint>
-#include <harc/Logging.hpp>
 
 namespace harc::parser {
 
@@ -92,12 +95,17 @@ namespace harc::parser {
     };
 
 
+    enum class Associativity : std::uint8_t {
+        LEFT,
+        RIGHT
+    };
+
     ///
     /// \param op Operator to check precedence of
     /// \return Precedence of operator. Lower value mean the operator should be
     /// prioritized first.
     [[nodiscard]]
-    inline std::uint32_t operator_precedence(Operator op) {
+    constexpr std::uint32_t operator_precedence(Operator op) {
         switch (op) {
             case Operator::PARENTHESES: return 1;
 
@@ -185,11 +193,234 @@ namespace harc::parser {
             case Operator::SHIFT_RIGHT_EQUALS: return 18;
 
             default:
-                HARC_LOG_ERROR("Unrecognized operator enum value");
                 return INT32_MAX;
         }
     }
 
+    ///
+    /// Precedence of the most loosely binding operators
+    ///
+    inline constexpr std::uint32_t loosest_precedence = [] {
+        std::uint32_t ret = 0;
+        for (auto i = 0; i <= static_cast<int>(Operator::SHIFT_RIGHT_EQUALS); ++i) {
+            ret = std::max(ret, operator_precedence(static_cast<Operator>(i)));
+        }
+
+        return ret;
+    }();
+
+    ///
+    /// \param op Operator to check associativity of
+    /// \return Associativity of operator. Prefix operators and assignments
+    /// group right to left. All other operators group left to right.
+    [[nodiscard]]
+    constexpr Associativity operator_associativity(Operator op) {
+        auto precedence = operator_precedence(op);
+        bool is_right_associative =
+            (precedence == operator_precedence(Operator::UNARY_MINUS)) ||
+            (precedence == operator_precedence(Operator::ASSIGN)) ||
+            (precedence == operator_precedence(Operator::EQUALS));
+
+        return is_right_associative ? Associativity::RIGHT : Associativity::LEFT;
+    }
+
+    //=====================================================
+    // Token to operator tables
+    //=====================================================
+
+    ///
+    /// Operator which a token represents in a particular position within an
+    /// expression, along with how that operator binds
+    ///
+    struct Operator_binding {
+
+        Operator op = Operator::PARENTHESES;
+
+        ///
+        /// Precedence of op. 0 if the token is not an operator in this
+        /// position.
+        ///
+        std::uint8_t precedence = 0;
+
+        Associativity associativity = Associativity::LEFT;
+
+    };
+
+    ///
+    /// \param type Token type
+    /// \return Operator which a token of the specified type represents when
+    /// it appears between two operands. PARENTHESES if none.
+    [[nodiscard]]
+    constexpr Operator infix_operator(Token_type type) {
+        switch (type) {
+            case Token_type::SPACED_PLUS:      return Operator::BINARY_PLUS;
+            case Token_type::SPACED_MINUS:     return Operator::BINARY_MINUS;
+            case Token_type::SPACED_ASTERISK:  return Operator::BINARY_ASTERISK;
+            case Token_type::SPACED_SLASH:     return Operator::SLASH;
+            case Token_type::SPACED_PERCENT:   return Operator::MODULO;
+
+            case Token_type::SPACED_LOGICAL_AND: return Operator::LOGICAL_AND;
+            case Token_type::SPACED_LOGICAL_OR:  return Operator::LOGICAL_OR;
+            case Token_type::SPACED_LOGICAL_XOR: return Operator::LOGICAL_XOR;
+
+            case Token_type::SPACED_AMPERSAND: return Operator::BITWISE_AND;
+            case Token_type::SPACED_PIPE:      return Operator::BITWISE_OR;
+            case Token_type::SPACED_CARET:     return Operator::BITWISE_XOR;
+
+            case Token_type::SPACED_MODULAR_LEFT_SHIFT:     return Operator::SHIFT_LEFT;
+            case Token_type::SPACED_SATURATING_LEFT_SHIFT:  return Operator::SHIFT_LEFT;
+            case Token_type::SPACED_MODULAR_RIGHT_SHIFT:    return Operator::SHIFT_RIGHT;
+            case Token_type::SPACED_SATURATING_RIGHT_SHIFT: return Operator::SHIFT_RIGHT;
+
+            case Token_type::SPACED_COMPARE_EQ: return Operator::CMP_EQ;
+            case Token_type::SPACED_COMPARE_NE: return Operator::CMP_NE;
+            case Token_type::SPACED_COMPARE_LT: return Operator::CMP_LT;
+            case Token_type::SPACED_COMPARE_GT: return Operator::CMP_GT;
+            case Token_type::SPACED_COMPARE_LE: return Operator::CMP_LE;
+            case Token_type::SPACED_COMPARE_GE: return Operator::CMP_GE;
+
+            case Token_type::JOINED_DOUBLE_PERIOD: return Operator::RANGE;
+
+            case Token_type::SPACED_EQUALS:       return Operator::EQUALS;
+            case Token_type::SPACED_PLUS_EQUALS:  return Operator::PLUS_EQUALS;
+            case Token_type::SPACED_MINUS_EQUALS: return Operator::MINUS_EQUALS;
+            case Token_type::SPACED_TIMES_EQUALS: return Operator::ASTERISK_EQUALS;
+            case Token_type::SPACED_DIV_EQUALS:   return Operator::SLASH_EQUALS;
+            case Token_type::SPACED_REM_EQUALS:   return Operator::MODULO_EQUALS;
+
+            case Token_type::SPACED_BITWISE_AND_EQUALS: return Operator::ASSIGN_BITWISE_AND;
+            case Token_type::SPACED_BITWISE_OR_EQUALS:  return Operator::ASSIGN_BITWISE_OR;
+            case Token_type::SPACED_BITWISE_XOR_EQUALS: return Operator::ASSIGN_BITWISE_XOR;
+
+            case Token_type::SPACED_LOGICAL_AND_EQUALS: return Operator::ASSIGN_LOGICAL_AND;
+            case Token_type::SPACED_LOGICAL_OR_EQUALS:  return Operator::ASSIGN_LOGICAL_OR;
+            case Token_type::SPACED_LOGICAL_XOR_EQUALS: return Operator::ASSIGN_LOGICAL_XOR;
+
+            case Token_type::SPACED_MODULAR_LEFT_SHIFT_EQUALS:     return Operator::SHIFT_LEFT_EQUALS;
+            case Token_type::SPACED_SATURATING_LEFT_SHIFT_EQUALS:  return Operator::SHIFT_LEFT_EQUALS;
+            case Token_type::SPACED_MODULAR_RIGHT_SHIFT_EQUALS:    return Operator::SHIFT_RIGHT_EQUALS;
+            case Token_type::SPACED_SATURATING_RIGHT_SHIFT_EQuALS: return Operator::SHIFT_RIGHT_EQUALS;
+
+            default: return Operator::PARENTHESES;
+        }
+    }
+
+    ///
+    /// \param type Token type
+    /// \return Operator which a token of the specified type represents when
+    /// it appears before an operand. PARENTHESES if none.
+    [[nodiscard]]
+    constexpr Operator prefix_operator(Token_type type) {
+        switch (type) {
+            case Token_type::PREFIX_PLUS:        return Operator::UNARY_PLUS;
+            case Token_type::PREFIX_MINUS:       return Operator::UNARY_MINUS;
+            case Token_type::PREFIX_INCREMENT:   return Operator::PRE_INCREMENT;
+            case Token_type::PREFIX_DECREMENT:   return Operator::PRE_DECREMENT;
+            case Token_type::PREFIX_EXCLAMATION: return Operator::LOGICAL_NOT;
+            case Token_type::PREFIX_TILDE:       return Operator::BITWISE_NOT;
+
+            default: return Operator::PARENTHESES;
+        }
+    }
+
+    ///
+    /// \param type Token type
+    /// \return Operator which a token of the specified type represents when
+    /// it follows an operand. PARENTHESES if none.
+    [[nodiscard]]
+    constexpr Operator postfix_operator(Token_type type) {
+        switch (type) {
+            // Whether ++ and -- are lexed as prefix or suffix depends on the
+            // surrounding whitespace, but directly after an operand they can
+            // only be postfix
+            case Token_type::SUFFIX_INCREMENT: return Operator::POST_INCREMENT;
+            case Token_type::PREFIX_INCREMENT: return Operator::POST_INCREMENT;
+            case Token_type::SUFFIX_DECREMENT: return Operator::POST_DECREMENT;
+            case Token_type::PREFIX_DECREMENT: return Operator::POST_DECREMENT;
+
+            case Token_type::LEFT_PARENTHESIS:    return Operator::FUNCTION_CALL;
+            case Token_type::LEFT_SQUARE_BRACKET: return Operator::SUBSCRIPT;
+            case Token_type::SPACED_PERIOD:       return Operator::MEMBER_ACCESS;
+
+            default: return Operator::PARENTHESES;
+        }
+    }
+
+    ///
+    /// \param classify Function mapping token types to operators
+    /// \return Table of operator bindings indexed by token type
+    template<class F>
+    constexpr std::array<Operator_binding, 256> make_operator_table(F classify) {
+        std::array<Operator_binding, 256> ret{};
+
+        for (std::size_t i = 0; i < ret.size(); ++i) {
+            auto op = classify(static_cast<Token_type>(i));
+            if (op == Operator::PARENTHESES) {
+                continue;
+            }
+
+            ret[i].op = op;
+            ret[i].precedence = static_cast<std::uint8_t>(operator_precedence(op));
+            ret[i].associativity = operator_associativity(op);
+        }
+
+        return ret;
+    }
+
+    ///
+    /// Bindings of tokens which appear between two operands
+    ///
+    inline constexpr auto infix_operator_table = make_operator_table(infix_operator);
+
+    ///
+    /// Bindings of tokens which appear before an operand
+    ///
+    inline constexpr auto prefix_operator_table = make_operator_table(prefix_operator);
+
+    ///
+    /// Bindings of tokens which appear after an operand
+    ///
+    inline constexpr auto postfix_operator_table = make_operator_table(postfix_operator);
+
+    ///
+    /// \param keyword Keyword of a textual token
+    /// \return Operator which the keyword represents when it appears between
+    /// two operands. PARENTHESES if none.
+    [[nodiscard]]
+    constexpr Operator text_operator(Keyword keyword) {
+        switch (keyword) {
+            case Keyword::AS: return Operator::AS;
+            case Keyword::IS: return Operator::IS;
+            case Keyword::IN: return Operator::IN;
+            default: return Operator::PARENTHESES;
+        }
+    }
+
+    ///
+    /// \param keyword Keyword of a textual token
+    /// \return Binding of the keyword when it appears between two operands.
+    /// Precedence is 0 if the keyword is not an operator.
+    [[nodiscard]]
+    constexpr Operator_binding text_operator_binding(Keyword keyword) {
+        auto op = text_operator(keyword);
+        if (op == Operator::PARENTHESES) {
+            return {};
+        }
+
+        return {
+            op,
+            static_cast<std::uint8_t>(operator_precedence(op)),
+            operator_associativity(op)
+        };
+    }
+
+    static_assert(infix_operator_table[std::size_t(Token_type::SPACED_ASTERISK)].precedence < infix_operator_table[std::size_t(Token_type::SPACED_PLUS)].precedence);
+    static_assert(infix_operator_table[std::size_t(Token_type::SPACED_EQUALS)].associativity == Associativity::RIGHT);
+    static_assert(prefix_operator_table[std::size_t(Token_type::PREFIX_MINUS)].associativity == Associativity::RIGHT);
+    static_assert(infix_operator_table[std::size_t(Token_type::SEMICOLON)].precedence == 0);
+    static_assert(text_operator_binding(Keyword::AS).precedence < infix_operator_table[std::size_t(Token_type::SPACED_ASTERISK)].precedence);
+    static_assert(text_operator_binding(Keyword::NONE).precedence == 0);
+
 }
 
 #endif //HARMONIA_OPERATORS_HPP
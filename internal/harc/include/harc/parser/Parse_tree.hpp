@@ -2,37 +2,13 @@
 #define HARC_PARSE_TREE_HPP
 
 #include "Parse_tree_visitor.hpp"
+#include "Flat_parse_tree.hpp"
 
-namespace harc::parser {
+#include <harc/common/Arena.hpp>
 
-    enum class Node_type {
-        GENERIC_NODE,
-        TEXT,
-        RESOLVED_IDENTIFIER,
-        IDENTIFIER,
-        STATEMENT,
-        EXPRESSION,
-        EXPRESSION_LIST,
-        EXPRESSION_SEQUENCE,
-        TYPE_EXPRESSION,
-        FUNCTION_CALL,
-        RETURN_STATEMENT,
-        VARIABLE_DECLARATION,
-        CONSTANT_DECLARATION,
-        MODULE_DECLARATION,
-        ATTRIBUTE,
-        ATTRIBUTE_LIST,
-        CODE_BODY,
-        PARAMETER,
-        PARAMETER_LIST,
-        SOURCE_BODY,
-        FUNCTION_DECLARATION,
-        LAMBDA,
-        CLASS_DEFINITION,
-        ALIAS_DEFINITION,
-        SOURCE_BODY_LIST,
-        SOURCE_FILE
-    };
+#include <harc/Message_buffer.hpp>
+
+namespace harc::parser {
 
     struct Parse_tree_node {
         std::int32_t index = -1;
@@ -45,6 +21,12 @@ namespace harc::parser {
     struct Text : Parse_tree_node {
         std::uint32_t text_token = -1;
 
+        ///
+        /// ID of the token's text within the translation unit's identifier
+        /// table
+        ///
+        std::uint32_t identifier = -1;
+
         void accept(Visitor& visitor) override {
             visitor.visit(this);
         }
@@ -93,6 +75,7 @@ namespace harc::parser {
 
         std::vector<Text*> else_keywords{};
         std::vector<Text*> else_if_keywords{};
+        std::vector<Expression*> else_if_conditions{};
         std::vector<Code_body*> else_if_branches{};
 
         Text* else_keyword = nullptr;
@@ -105,6 +88,7 @@ namespace harc::parser {
 
     struct While_statement : Statement {
         Text* while_keyword = nullptr;
+        Expression* condition = nullptr;
         Code_body* loop_body = nullptr;
 
         void accept(Visitor& visitor) override {
@@ -116,6 +100,7 @@ namespace harc::parser {
         Text* for_keyword = nullptr;
         Statement_sequence* initializers = nullptr;
         Expression* condition = nullptr;
+        std::uint32_t semicolon_token = -1;
         Statement_sequence* incrementer = nullptr;
         Code_body* loop_body = nullptr;
 
@@ -141,6 +126,7 @@ namespace harc::parser {
         Code_body* code_body = nullptr;
         Text* while_keyword = nullptr;
         Expression* condition = nullptr;
+        std::uint32_t semicolon_token = -1;
 
         void accept(Visitor& visitor) override {
             visitor.visit(this);
@@ -164,6 +150,17 @@ namespace harc::parser {
         }
     };
 
+    ///
+    /// Use of a named entity as an operand
+    ///
+    struct Identifier_expression : Expression {
+        Resolved_identifier* identifier = nullptr;
+
+        void accept(Visitor& visitor) override {
+            visitor.visit(this);
+        }
+    };
+
     struct Expression_list : Parse_tree_node {
         Expression* head = nullptr;
         std::uint32_t semicolon_token = -1;
@@ -193,7 +190,7 @@ namespace harc::parser {
     };
 
     struct Resolved_template : Expression {
-        Type_expression* template_expression = nullptr;
+        Expression* template_expression = nullptr;
         std::uint32_t l_template_bracket = -1;
         Expression_sequence* parameters = nullptr;
         std::uint32_t r_template_bracket = -1;
@@ -248,7 +245,7 @@ namespace harc::parser {
         Expression_sequence* expression_sequence = nullptr;
         std::uint32_t r_curly_bracket_token = -1;
         std::uint32_t colon_token = -1;
-        Type_expression* type_expression = nullptr;
+        Expression* type_expression = nullptr;
 
         void accept(Visitor& visitor) override {
             visitor.visit(this);
@@ -297,7 +294,7 @@ namespace harc::parser {
     struct Function_call : Expression {
         Expression* name = nullptr;
         std::uint32_t l_paren_token = -1;
-        Expression_list* parameters = nullptr;
+        Expression_sequence* parameters = nullptr;
         std::uint32_t r_paren_token = -1;
 
         void accept(Visitor& visitor) override {
@@ -306,9 +303,9 @@ namespace harc::parser {
     };
 
     struct Subscript_call : Expression {
-        Resolved_identifier* name = nullptr;
+        Expression* name = nullptr;
         std::uint32_t l_square_bracket_token = -1;
-        Expression_list* parameter = nullptr;
+        Expression_sequence* parameters = nullptr;
         std::uint32_t r_square_bracket_token = -1;
 
         void accept(Visitor& visitor) override {
@@ -331,6 +328,18 @@ namespace harc::parser {
         }
     };
 
+    ///
+    /// Expression evaluated for its side effects
+    ///
+    struct Expression_statement : Statement {
+        Expression* expression = nullptr;
+        std::uint32_t semicolon_token = -1;
+
+        void accept(Visitor& visitor) override {
+            visitor.visit(this);
+        }
+    };
+
     struct Return_statement : Statement {
         Text* return_keyword = nullptr;
         Expression* expression = nullptr;
@@ -343,7 +352,9 @@ namespace harc::parser {
 
     struct Variable_declaration : Statement {
         Text* var_keyword = nullptr;
-        Type_expression* type = nullptr;
+        Text* name = nullptr;
+        std::uint32_t colon_token = -1;
+        Expression* type = nullptr;
         std::uint32_t equals_token = -1;
         Expression* initializer = nullptr;
         std::uint32_t semicolon_token = -1;
@@ -355,7 +366,9 @@ namespace harc::parser {
 
     struct Constant_declaration : Statement {
         Text* let_keyword = nullptr;
-        Type_expression* type = nullptr;
+        Text* name = nullptr;
+        std::uint32_t colon_token = -1;
+        Expression* type = nullptr;
         std::uint32_t equals_token = -1;
         Expression* initializer = nullptr;
         std::uint32_t semicolon_token = -1;
@@ -408,7 +421,7 @@ namespace harc::parser {
 
     struct Statement_sequence : Parse_tree_node {
         Statement* head = nullptr;
-        Code_body* tail = nullptr;
+        Statement_sequence* tail = nullptr;
 
         void accept(Visitor& visitor) override {
             visitor.visit(this);
@@ -428,8 +441,9 @@ namespace harc::parser {
 
     struct Parameter : Parse_tree_node {
         Text* input_qualifier = nullptr;
-        Type_expression* type = nullptr;
         Text* name = nullptr;
+        std::uint32_t colon_token = -1;
+        Expression* type = nullptr;
 
         void accept(Visitor& visitor) override {
             visitor.visit(this);
@@ -439,7 +453,7 @@ namespace harc::parser {
     struct Parameter_sequence : Parse_tree_node {
         Parameter* head = nullptr;
         std::uint32_t comma_token = -1;
-        Parameter* tail = nullptr;
+        Parameter_sequence* tail = nullptr;
 
         void accept(Visitor& visitor) override {
             visitor.visit(this);
@@ -471,7 +485,20 @@ namespace harc::parser {
         std::uint32_t l_paren_token = -1;
         Parameter_list* parameter_list = nullptr;
         std::uint32_t r_paren_token = -1;
-        Type_expression* return_type = nullptr;
+        std::uint32_t arrow_token = -1;
+        Expression* return_type = nullptr;
+
+        ///
+        /// Indices of the curly brackets which delimit the body. Recorded
+        /// even while the body's parsing is deferred.
+        ///
+        std::uint32_t l_curly_bracket = -1;
+        std::uint32_t r_curly_bracket = -1;
+
+        ///
+        /// Null if parsing of the body was deferred and has not yet
+        /// happened
+        ///
         Code_body* body = nullptr;
 
         void accept(Visitor& visitor) override {
@@ -486,7 +513,8 @@ namespace harc::parser {
         std::uint32_t l_paren_token = -1;
         Parameter_list* parameter_list = nullptr;
         std::uint32_t r_paren_token = -1;
-        Type_expression* return_type = nullptr;
+        std::uint32_t arrow_token = -1;
+        Expression* return_type = nullptr;
         std::uint32_t l_curly_bracket = -1;
         Code_body* body = nullptr;
         std::uint32_t r_curly_bracket = -1;
@@ -509,8 +537,10 @@ namespace harc::parser {
     struct Alias_definition : Source_body, Statement {
         Text* alias_keyword = nullptr;
         Attribute_list* attribute_list = nullptr;
+        Text* name = nullptr;
         std::uint32_t equals_token = -1;
-        Type_expression* type = nullptr;
+        Expression* type = nullptr;
+        std::uint32_t semicolon_token = -1;
 
         void accept(Visitor& visitor) override {
             visitor.visit(this);
@@ -536,8 +566,42 @@ namespace harc::parser {
     };
 
     struct Parse_tree {
-        //TODO: Handle deleting nodes in constructor
-        Parse_tree_node* root;
+
+        ///
+        /// Storage for every node in the tree. Nodes are never freed
+        /// individually; they are all released together with the arena when
+        /// the tree is destroyed.
+        ///
+        Arena arena{};
+
+        ///
+        /// Storage for the nodes of declarations which were parsed in
+        /// chunks, one arena per chunk
+        ///
+        std::vector<Arena> chunk_arenas{};
+
+        ///
+        /// Root of the tree. Points into arena.
+        ///
+        Parse_tree_node* root = nullptr;
+
+        ///
+        /// Flattened copy of the tree rooted at root, for passes which
+        /// walk the whole tree
+        ///
+        Flat_parse_tree flat{};
+
+        ///
+        /// Functions whose bodies were skipped over by a parse with
+        /// Body_parsing::DEFERRED and have yet to be parsed, in source order
+        ///
+        std::vector<Function_definition*> deferred_bodies{};
+
+        ///
+        /// Contains messages produced by the parsing process
+        ///
+        Message_buffer message_buffer;
+
     };
 
 }
@@ -7,12 +7,16 @@ namespace harc::parser {
 
     struct Text;
 
+    struct Text_sequence;
+
     struct Resolved_identifier;
 
     struct Identifier;
 
     struct Expression;
 
+    struct Identifier_expression;
+
     struct Expression_list;
 
     struct Expression_sequence;
@@ -39,8 +43,22 @@ namespace harc::parser {
 
     struct Function_call;
 
+    struct Subscript_call;
+
     struct Statement;
 
+    struct If_statement;
+
+    struct While_statement;
+
+    struct For_loop;
+
+    struct Ranged_for_loop;
+
+    struct Do_while_loop;
+
+    struct Expression_statement;
+
     struct Return_statement;
 
     struct Variable_declaration;
@@ -18,18 +18,56 @@ namespace harc::parser {
 
         virtual void visit(Text*) = 0;
 
+        virtual void visit(Text_sequence* node) = 0;
+
         virtual void visit(Resolved_identifier* node) = 0;
 
         virtual void visit(Identifier* node) = 0;
 
         virtual void visit(Expression* node) = 0;
 
+        virtual void visit(Identifier_expression* node) = 0;
+
         virtual void visit(Expression_list* node) = 0;
 
+        virtual void visit(Expression_sequence* node) = 0;
+
+        virtual void visit(Resolved_template* node) = 0;
+
+        virtual void visit(Numeric_literal_expression* node) = 0;
+
+        virtual void visit(String_literal_expression* node) = 0;
+
+        virtual void visit(Codepoint_literal_expression* node) = 0;
+
+        virtual void visit(Tuple_literal* node) = 0;
+
+        virtual void visit(Parenthesized_expression* node) = 0;
+
+        virtual void visit(Unary_operator_expression* node) = 0;
+
+        virtual void visit(Binary_operator_expression* node) = 0;
+
+        virtual void visit(Binary_text_operator_expression* node) = 0;
+
         virtual void visit(Function_call* node) = 0;
 
+        virtual void visit(Subscript_call* node) = 0;
+
         virtual void visit(Statement* node) = 0;
 
+        virtual void visit(If_statement* node) = 0;
+
+        virtual void visit(While_statement* node) = 0;
+
+        virtual void visit(For_loop* node) = 0;
+
+        virtual void visit(Ranged_for_loop* node) = 0;
+
+        virtual void visit(Do_while_loop* node) = 0;
+
+        virtual void visit(Expression_statement* node) = 0;
+
         virtual void visit(Return_statement* node) = 0;
 
         virtual void visit(Variable_declaration* node) = 0;
@@ -3,13 +3,162 @@
 
 #include <harc/Translation_unit.hpp>
 #include <harc/Errors.hpp>
+#include <harc/common/Arena.hpp>
+#include <harc/common/Identifier_table.hpp>
+
+#include <cstdint>
+#include <vector>
 
 namespace harc::parser {
 
+    ///
+    /// Controls whether function bodies are parsed along with the
+    /// declarations which contain them
+    ///
+    enum class Body_parsing : std::uint8_t {
+        EAGER,
+
+        ///
+        /// Only declarations are parsed. Each function body is skipped in
+        /// constant time using the pair index of its opening curly bracket,
+        /// and the function is appended to the parse tree's
+        /// deferred_bodies. Suited to passes which only need a module's
+        /// interface, such as dependency discovery.
+        ///
+        DEFERRED
+    };
+
     ///
     /// \param unit Translation unit to parse.
+    /// \param body_parsing Whether function bodies are parsed now or left
+    /// for parse_body() and parse_deferred_bodies()
     /// \return
-    Error_code parse(Translation_unit& unit);
+    Error_code parse(Translation_unit& unit, Body_parsing body_parsing = Body_parsing::EAGER);
+
+    ///
+    /// Parses the body of a function whose parsing was deferred. The
+    /// function remains in the parse tree's deferred_bodies and the
+    /// flattened tree is not updated.
+    ///
+    /// \param unit Translation unit which function belongs to
+    /// \param function Function definition from unit's parse tree
+    /// \return PARSING_ERROR if the body could not be parsed
+    Error_code parse_body(Translation_unit& unit, Function_definition& function);
+
+    ///
+    /// Parses every deferred function body of a unit, in source order,
+    /// then empties the list of deferred bodies and rebuilds the flattened
+    /// tree. A body which fails to parse does not stop the others from
+    /// being parsed.
+    ///
+    /// \param unit Translation unit previously parsed with
+    /// Body_parsing::DEFERRED
+    /// \return PARSING_ERROR if any body could not be parsed
+    Error_code parse_deferred_bodies(Translation_unit& unit);
+
+    ///
+    /// Range of tokens holding whole top-level declarations, which may be
+    /// parsed independently of the rest of a source
+    ///
+    struct Source_body_chunk {
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+    };
+
+    ///
+    /// Declarations produced by parsing a single chunk of a source. Nothing
+    /// is shared with the translation unit until the chunks are stitched
+    /// together, so chunks may be parsed concurrently.
+    ///
+    struct Chunk_parse {
+
+        Source_body_chunk chunk{};
+
+        ///
+        /// Storage for the chunk's nodes. Moved into the parse tree when
+        /// the chunks are stitched together.
+        ///
+        Arena arena{};
+
+        ///
+        /// Declarations within the chunk, in source order
+        ///
+        Source_body_list* body = nullptr;
+
+        ///
+        /// IDs held by the chunk's Text nodes. Replaced by IDs from the
+        /// unit's own table when the chunks are stitched together.
+        ///
+        Identifier_table identifiers{};
+
+        ///
+        /// Every Text node within the chunk, so that their IDs may be
+        /// remapped
+        ///
+        std::vector<Text*> texts{};
+
+        Message_buffer message_buffer{};
+
+        Error_code error_code = Error_code::NO_ERROR;
+
+    };
+
+    ///
+    /// Splits a unit's top-level declarations into chunks of roughly the
+    /// specified number of tokens which may be parsed concurrently.
+    ///
+    /// Chunks begin at a func or alias keyword which is not enclosed by any
+    /// brackets. Bracketed tokens are skipped over using their pair indices,
+    /// so finding the chunks takes time proportional to the number of
+    /// top-level tokens rather than to the number of tokens.
+    ///
+    /// \param tokens Tokens of a unit, with brackets paired
+    /// \param chunk_size Target number of tokens per chunk
+    /// \return Contiguous chunks, covering everything from the first
+    /// top-level declaration to the last token. Empty if there are no
+    /// declarations.
+    [[nodiscard]]
+    std::vector<Source_body_chunk> split_source_bodies(const lex::Tokenization_view& tokens, std::uint32_t chunk_size);
+
+    ///
+    /// Parses the declarations of a single chunk of a unit, as produced by
+    /// split_source_bodies(). Bodies are always parsed eagerly. Safe to call
+    /// concurrently for different chunks of the same unit.
+    ///
+    /// Only views of the unit's path and tokens are taken so that callers
+    /// need not keep the unit itself reachable from shared state.
+    ///
+    /// \param source_path Path of unit which chunk belongs to
+    /// \param tokens Tokens of unit, along with a view of its source
+    /// \param chunk Chunk of tokens to parse
+    /// \return Declarations within chunk
+    [[nodiscard]]
+    Chunk_parse parse_chunk(std::string_view source_path, const lex::Tokenization_view& tokens, Source_body_chunk chunk);
+
+    ///
+    /// Parses the module declaration which precedes the first chunk, then
+    /// links the declarations of each chunk into a single Source_body_list.
+    ///
+    /// The resulting tree, including the IDs assigned to identifiers, is
+    /// identical to the one parse() would produce. As with parse(),
+    /// declarations after the first which fails to parse are discarded
+    /// along with their messages, though the first failure in a malformed
+    /// source may be reported differently.
+    ///
+    /// \param unit Translation unit whose chunks were parsed
+    /// \param chunks Results of parse_chunk() for every chunk, in order
+    /// \return PARSING_ERROR if the module declaration or any chunk could
+    /// not be parsed
+    Error_code stitch_chunk_parses(Translation_unit& unit, std::vector<Chunk_parse> chunks);
+
+    ///
+    /// Parses the entirety of a unit's tokens as a single expression rather
+    /// than as a source file. Allows expressions to be checked in isolation.
+    ///
+    /// \param unit Translation unit to parse
+    /// \return PARSING_ERROR if the tokens do not form exactly one
+    /// expression
+    Error_code parse_expression(Translation_unit& unit);
 
 }
 
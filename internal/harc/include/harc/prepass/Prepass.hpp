@@ -6,6 +6,8 @@
 
 #include <cstdint>
 #include <array>
+#include <string_view>
+#include <vector>
 
 namespace harc::prepass {
 
@@ -29,20 +31,55 @@ namespace harc::prepass {
         std::array<std::uint64_t, 2> hash{};
 
         ///
-        /// List of errors encountered while completing pre-pass information
+        /// Byte index at which each line begins. The first element is always
+        /// 0. Suitable for use as a tokenization's line_indices.
+        ///
+        std::vector<std::uint32_t> line_indices{};
+
+        ///
+        /// List of errors encountered while completing pre-pass information,
+        /// i.e. locations at which the source is not valid UTF-8
         ///
         std::vector<Error> errors{};
 
     };
 
+    ///
+    /// Instruction set used by prepass kernels
+    ///
+    enum class Prepass_kernel : std::uint8_t {
+        SCALAR,
+        AVX2,
+        AVX512
+    };
+
+    ///
+    /// \return Widest prepass kernel which is supported by the host CPU.
+    /// Determined once and then cached.
+    [[nodiscard]]
+    Prepass_kernel selected_kernel();
+
     ///
     /// Extracts all prepass information from source file in a single pass over
     /// the source data.
     ///
+    /// Classification of bytes, UTF-8 validation, and line detection use the
+    /// widest kernel supported by the host CPU, as reported by
+    /// selected_kernel(). The hash is computed in the same pass.
+    ///
     /// \param unit Translation unit to preform prepass on
     /// \return Struct containing results of prepass stage
     Prepass_results prepass(const Translation_unit& unit);
 
+    ///
+    /// Equivalent to prepass() but uses the specified kernel. Exposed so that
+    /// kernels may be tested against each other.
+    ///
+    /// \param source Source to perform prepass on
+    /// \param kernel Kernel to use. Must be supported by the host CPU.
+    /// \return Struct containing results of prepass stage
+    Prepass_results prepass(std::string_view source, Prepass_kernel kernel);
+
 }
 
 #endif //HARMONIA_PREPASS_HPP
@@ -2,6 +2,7 @@
 #define HARMONIA_PREPASS_ERRORS_HPP
 
 #include <cstdint>
+#include <string_view>
 
 namespace harc::prepass {
 
@@ -17,6 +18,12 @@ namespace harc::prepass {
         INVALID_UTF8_CODEPOINT_GREATER_THAN_U10FFFF
     };
 
+    ///
+    /// \param error Arbitrary Error_code enum value
+    /// \return Message describing error
+    [[nodiscard]]
+    std::string_view to_string(Error_code error);
+
     struct Error {
         Error_code error_code = Error_code::NO_ERROR;
 
@@ -0,0 +1,155 @@
+#include <harc/Build_cache.hpp>
+
+#include <harc/lexer/Cache.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+namespace harc {
+
+    //=====================================================
+    // Mutators
+    //=====================================================
+
+    Error_code Build_cache::load(std::string_view cache_directory, Caching_policy caching_policy) {
+        // Nothing from an earlier build may outlive the mapping it came from
+        unmap_file(mapping);
+        mapping = {};
+        entries.clear();
+        records.clear();
+
+        policy = caching_policy;
+        if (policy == Caching_policy::DISABLED) {
+            return Error_code::NO_ERROR;
+        }
+
+        std::string path{cache_directory};
+        path += '/';
+        path += build_cache_file_name;
+
+        // Only the index and the entries of files being compiled are touched
+        mapping = map_binary_file(path, File_mapping_options{.sequential = false});
+        if (mapping.error_code != Error_code::NO_ERROR) {
+            mapping = {};
+            return Error_code::INACCESSIBLE_BUILD_CACHE;
+        }
+
+        std::span<const std::byte> bytes{mapping.bytes.data(), mapping.bytes.size()};
+        auto infos = parse_serialization(bytes);
+        if (infos.empty() && !bytes.empty()) {
+            return Error_code::INVALID_BUILD_CACHE;
+        }
+
+        entries.reserve(infos.size());
+        for (const auto& info : infos) {
+            entries.emplace(info.path, info);
+        }
+
+        return Error_code::NO_ERROR;
+    }
+
+    void Build_cache::record(const Translation_unit& unit) {
+        if (policy == Caching_policy::DISABLED) {
+            return;
+        }
+
+        Record record{};
+        record.path = std::string{unit.source_path};
+        record.timestamp = unit.source_timestamp;
+        record.hash = unit.source_hash;
+        record.tokenization_serialization = lex::serialize_tokenization(unit.tokens);
+
+        std::scoped_lock lk{records_mutex};
+        records.push_back(std::move(record));
+    }
+
+    Error_code Build_cache::store(std::string_view cache_directory) {
+        if (policy == Caching_policy::DISABLED) {
+            return Error_code::NO_ERROR;
+        }
+
+        namespace fs = std::filesystem;
+
+        std::error_code ec;
+        fs::create_directories(fs::path{cache_directory}, ec);
+        if (ec) {
+            return Error_code::INACCESSIBLE_BUILD_CACHE;
+        }
+
+        // Sorted so that identical builds produce identical caches
+        std::sort(records.begin(), records.end(), [] (const Record& a, const Record& b) {
+            return a.path < b.path;
+        });
+
+        std::vector<Cache_entry_info> infos;
+        infos.reserve(records.size());
+        for (const auto& record : records) {
+            Cache_entry_info info{};
+            info.path = record.path;
+            info.timestamp = record.timestamp;
+            info.hash = record.hash;
+            info.tokenization_serialization = record.tokenization_serialization;
+            info.parsing_serialization = record.parsing_serialization;
+            infos.push_back(info);
+        }
+
+        auto bytes = assemble_serialization(infos);
+
+        // Written to a temporary file first so that an interrupted build
+        // never leaves a truncated cache behind, and so that the mapping of
+        // the previous cache remains intact
+        fs::path path = fs::path{cache_directory} / build_cache_file_name;
+        fs::path temporary_path = path;
+        temporary_path += ".tmp";
+
+        {
+            std::ofstream fout{temporary_path, std::ios::binary | std::ios::trunc};
+            fout.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            if (!fout) {
+                return Error_code::INACCESSIBLE_BUILD_CACHE;
+            }
+        }
+
+        fs::rename(temporary_path, path, ec);
+        if (ec) {
+            return Error_code::INACCESSIBLE_BUILD_CACHE;
+        }
+
+        return Error_code::NO_ERROR;
+    }
+
+    //=====================================================
+    // Accessors
+    //=====================================================
+
+    const Cache_entry_info* Build_cache::find(std::string_view path, std::uint64_t timestamp) const {
+        if (policy == Caching_policy::DISABLED) {
+            return nullptr;
+        }
+
+        auto it = entries.find(path);
+        if (it == entries.end()) {
+            return nullptr;
+        }
+
+        bool check_timestamp =
+            policy == Caching_policy::TIMESTAMP ||
+            policy == Caching_policy::TIMESTAMP_AND_HASH;
+
+        if (check_timestamp && (timestamp == 0 || it->second.timestamp != timestamp)) {
+            return nullptr;
+        }
+
+        return &it->second;
+    }
+
+    bool Build_cache::is_hash_current(const Cache_entry_info& entry, const std::array<std::uint64_t, 2>& hash) const {
+        bool check_hash =
+            policy == Caching_policy::HASH ||
+            policy == Caching_policy::TIMESTAMP_AND_HASH;
+
+        return !check_hash || entry.hash == hash;
+    }
+
+}
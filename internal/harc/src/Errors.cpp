@@ -16,6 +16,12 @@ namespace harc {
                 return "Invalid command line arguments";
             case Error_code::INVALID_SOURCE_FILE:
                 return "Invalid source file";
+            case Error_code::INACCESSIBLE_BUILD_CACHE:
+                return "Build cache could not be read or written";
+            case Error_code::INVALID_BUILD_CACHE:
+                return "Build cache is malformed or from a different version";
+            case Error_code::INACCESSIBLE_TRACE_FILE:
+                return "Trace file could not be written";
             case Error_code::TOKENIZATION_ERROR:
                 return "Tokenization error";
             case Error_code::PARSING_ERROR:
@@ -8,16 +8,28 @@
 #include <harc/Error_reporting.hpp>
 
 #include <harc/lexer/Lexer.hpp>
+#include <harc/lexer/Cache.hpp>
+#include <harc/prepass/Prepass.hpp>
 //#include <harc/Harc_cuda.hpp>
 
 #include <harc/parser/Parser.hpp>
 #include <harc/parser/Printer.hpp>
 
 #include <harc/Errors.hpp>
+#include <harc/Message_collector.hpp>
+#include <harc/Build_cache.hpp>
+#include <harc/Scheduler.hpp>
+#include <harc/Pipeline.hpp>
+#include <harc/Timing.hpp>
+#include <harc/Tracing.hpp>
 
 #include <thread>
-#include <mutex>
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
 
 #include <vector>
 
@@ -33,14 +45,163 @@
 namespace harc {
 
     ///
-    /// An enum which is used to indicate which stage within the compilation
-    /// process should be performed next for the associated translation unit.
+    /// State shared by the workers which lex the chunks of a single large
+    /// source
     ///
-    enum class Stage : std::uint8_t {
-        NULL_STEP,
-        TOKENIZATION,
-        PARSING,
-        BACKEND
+    struct Chunked_lexing_job {
+
+        std::string_view source_id{};
+        std::string_view source{};
+        std::span<const std::uint32_t> line_indices{};
+        bool is_ascii = false;
+
+        std::vector<lex::Source_chunk> chunks{};
+        std::vector<lex::Chunk_tokenization> results{};
+
+        ///
+        /// Index of the next chunk to be claimed by a worker
+        ///
+        std::atomic<std::uint32_t> next_chunk = 0;
+
+        ///
+        /// Number of chunks which have been lexed
+        ///
+        std::atomic<std::uint32_t> finished_chunk_count = 0;
+
+        ///
+        /// Claims and lexes chunks until none remain unclaimed
+        ///
+        void lex_remaining_chunks() {
+            auto chunk_count = static_cast<std::uint32_t>(chunks.size());
+
+            for (auto i = next_chunk.fetch_add(1); i < chunk_count; i = next_chunk.fetch_add(1)) {
+                results[i] = lex::lex_chunk(source_id, source, chunks[i], line_indices, is_ascii);
+
+                if (finished_chunk_count.fetch_add(1) + 1 == chunk_count) {
+                    finished_chunk_count.notify_all();
+                }
+            }
+        }
+
+        ///
+        /// Blocks until every chunk has been lexed. Every chunk must have
+        /// been claimed, so this only waits on chunks which are in progress.
+        ///
+        void wait() {
+            auto chunk_count = static_cast<std::uint32_t>(chunks.size());
+
+            for (auto n = finished_chunk_count.load(); n != chunk_count; n = finished_chunk_count.load()) {
+                finished_chunk_count.wait(n);
+            }
+        }
+
+    };
+
+    ///
+    /// State shared by the workers which run the iterations of a single
+    /// parallel loop, such as one pass of bracket pairing over a large
+    /// source
+    ///
+    struct Parallel_for_job {
+
+        std::string_view source_id{};
+
+        ///
+        /// Work of a single iteration. Only invoked for iterations claimed
+        /// before the loop finished, while the state it refers to is alive.
+        ///
+        std::function<void(std::size_t)> body{};
+
+        std::size_t count = 0;
+
+        ///
+        /// Index of the next iteration to be claimed by a worker
+        ///
+        std::atomic<std::size_t> next_index = 0;
+
+        ///
+        /// Number of iterations which have finished
+        ///
+        std::atomic<std::size_t> finished_count = 0;
+
+        ///
+        /// Claims and runs iterations until none remain unclaimed
+        ///
+        void run_remaining_iterations() {
+            for (auto i = next_index.fetch_add(1); i < count; i = next_index.fetch_add(1)) {
+                body(i);
+
+                if (finished_count.fetch_add(1) + 1 == count) {
+                    finished_count.notify_all();
+                }
+            }
+        }
+
+        ///
+        /// Blocks until every iteration has finished. Every iteration must
+        /// have been claimed, so this only waits on those in progress.
+        ///
+        void wait() {
+            for (auto n = finished_count.load(); n != count; n = finished_count.load()) {
+                finished_count.wait(n);
+            }
+        }
+
+    };
+
+    ///
+    /// State shared by the workers which parse the chunks of a single large
+    /// unit
+    ///
+    struct Chunked_parsing_job {
+
+        ///
+        /// Views rather than the unit itself, since helpers which find no
+        /// chunk left to claim may run after the unit has been destroyed
+        ///
+        std::string_view source_id{};
+        lex::Tokenization_view tokens{};
+
+        std::vector<parser::Source_body_chunk> chunks{};
+        std::vector<parser::Chunk_parse> results{};
+
+        ///
+        /// Index of the next chunk to be claimed by a worker
+        ///
+        std::atomic<std::uint32_t> next_chunk = 0;
+
+        ///
+        /// Number of chunks which have been parsed
+        ///
+        std::atomic<std::uint32_t> finished_chunk_count = 0;
+
+        ///
+        /// Claims and parses chunks until none remain unclaimed
+        ///
+        void parse_remaining_chunks() {
+            auto chunk_count = static_cast<std::uint32_t>(chunks.size());
+
+            for (auto i = next_chunk.fetch_add(1); i < chunk_count; i = next_chunk.fetch_add(1)) {
+                results[i] = parser::parse_chunk(source_id, tokens, chunks[i]);
+
+                if (finished_chunk_count.fetch_add(1) + 1 == chunk_count) {
+                    finished_chunk_count.notify_all();
+                }
+            }
+        }
+
+        ///
+        /// Blocks until every chunk has been parsed. Every chunk must have
+        /// been claimed, so this only waits on chunks which are in progress.
+        ///
+        void wait() {
+            auto chunk_count = static_cast<std::uint32_t>(chunks.size());
+
+            for (auto n = finished_chunk_count.load(); n != chunk_count; n = finished_chunk_count.load()) {
+                finished_chunk_count.wait(n);
+            }
+        }
+
     };
 
     ///
@@ -57,7 +218,36 @@ namespace harc {
         Task& operator=(Task&&) noexcept = default;
 
         Stage stage = Stage::NULL_STEP;
-        Translation_unit unit;
+
+        ///
+        /// Units which the task operates on. Holds a single unit unless small
+        /// units were batched together, in which case they are processed one
+        /// after another by the same worker.
+        ///
+        std::vector<Translation_unit> units;
+
+        ///
+        /// Set for tasks which help another worker lex a large source, in
+        /// which case units is empty
+        ///
+        std::shared_ptr<Chunked_lexing_job> lexing_job;
+
+        ///
+        /// Set for tasks which help another worker run a parallel loop, in
+        /// which case units is empty
+        ///
+        std::shared_ptr<Parallel_for_job> parallel_for_job;
+
+        ///
+        /// Set for tasks which help another worker parse a large unit, in
+        /// which case units is empty
+        ///
+        std::shared_ptr<Chunked_parsing_job> parsing_job;
+
+        ///
+        /// Time at which the task was last pushed onto the scheduler
+        ///
+        std::chrono::steady_clock::time_point enqueue_time{};
     };
 
     ///
@@ -77,23 +267,68 @@ namespace harc {
     //=====================================================
 
     ///
-    /// Queue containing units that need to be processed
+    /// Scheduler holding the tasks that need to be processed. Each worker
+    /// thread owns one of its queues.
     ///
-    std::vector<Task> work_queue;
+    /// Configured to terminate once idle, except when Harc is run as a client
+    /// since Harc should then wait for the host to send more work in the
+    /// future.
+    ///
+    Work_stealing_scheduler<Task> scheduler;
 
     ///
-    /// Mutex used to protect work_queue variable
+    /// Tracks how many units are in each stage and holds back backend tasks
+    /// until the front end has run on all units.
     ///
-    std::mutex work_queue_mutex;
+    Pipeline<Task> pipeline;
 
     ///
-    /// Used to indicate if worker threads should terminate once there is no
-    /// more work available for them to do.
+    /// Cache left behind by the previous build, along with the results of
+    /// this build which will replace it
+    ///
+    Build_cache build_cache;
+
     ///
-    /// Set to false, when Harc is run as a client since Harc should then wait
-    /// for the host to send more work in the future.
+    /// Time spent by each worker on each stage and unit
     ///
-    std::atomic_bool terminate_once_idle = false;
+    Timing_collector timing_collector;
+
+    ///
+    /// Trace of worker activity, recorded if a trace path was configured
+    ///
+    Trace_recorder trace_recorder;
+
+    ///
+    /// Messages reported for all units. Each worker moves the messages of
+    /// the units it processes into a buffer of its own.
+    ///
+    Message_collector message_collector;
+
+    ///
+    /// Target size of chunks which large sources are lexed in. 0 if sources
+    /// are never split.
+    ///
+    std::uint32_t lex_chunk_size = 0;
+
+    ///
+    /// Least number of workers for which the brackets of large sources are
+    /// paired across workers
+    ///
+    constexpr std::size_t min_parallel_pairing_workers = 4;
+
+    ///
+    /// Target number of tokens in the chunks which the declarations of large
+    /// units are parsed in. 0 if units are never split.
+    ///
+    std::uint32_t parse_chunk_size = 0;
+
+    ///
+    /// Enqueues a task from a thread which is not a worker
+    ///
+    void submit_external(Task&& task) {
+        task.enqueue_time = std::chrono::steady_clock::now();
+        scheduler.push(std::move(task));
+    }
 
     //=====================================================
     // CPU Worker State
@@ -126,101 +361,336 @@ namespace harc {
     //=====================================================
 
     ///
-    /// Function which is run for CPU threads used in compilation process
+    /// Runs a loop on the calling worker. Helper tasks are pushed so that
+    /// idle workers may run iterations alongside it.
     ///
-    void cpu_worker() {
-        while (true) {
-            // Retrieve task from queue
-            Task task{};
-            {
-                std::lock_guard lk{work_queue_mutex};
+    /// \param worker_index Index of the calling worker
+    /// \param source_id Path of the source which the loop works on
+    /// \param count Number of iterations
+    /// \param body Work of a single iteration
+    void parallel_for_on_workers(
+        std::size_t worker_index,
+        std::string_view source_id,
+        std::size_t count,
+        const std::function<void(std::size_t)>& body
+    ) {
+        auto job = std::make_shared<Parallel_for_job>();
+        job->source_id = source_id;
+        job->body = body;
+        job->count = count;
+
+        auto helper_count = std::min(count, scheduler.worker_count());
+        helper_count = (helper_count == 0) ? 0 : helper_count - 1;
+        for (std::size_t i = 0; i < helper_count; ++i) {
+            Task helper{};
+            helper.stage = Stage::TOKENIZATION;
+            helper.parallel_for_job = job;
+            helper.enqueue_time = std::chrono::steady_clock::now();
+            scheduler.push(worker_index, std::move(helper));
+        }
 
-                if (!work_queue.empty()) {
-                    task = std::move(work_queue.back());
-                    work_queue.pop_back();
-                }
-            }
+        job->run_remaining_iterations();
+        job->wait();
+    }
 
-            // Respond to empty queue.
-            if (Stage::NULL_STEP == task.stage) {
-                if (terminate_once_idle) {
-                    break;
-                } else {
-                    //TODO: Replace with wait for wake-up event
-                    using namespace std::chrono_literals;
-                    std::this_thread::sleep_for(100ms);
-                    continue;
-                }
-            }
+    ///
+    /// Lexes a large unit in chunks. Helper tasks are pushed so that idle
+    /// workers may lex chunks alongside the calling worker.
+    ///
+    /// \param worker_index Index of the calling worker
+    /// \param unit Translation unit to lex
+    /// \param prepass_results Results of the prepass over the unit
+    /// \return Tokenization of unit's source
+    lex::Tokenization lex_in_chunks(
+        std::size_t worker_index,
+        const Translation_unit& unit,
+        prepass::Prepass_results& prepass_results
+    ) {
+        auto job = std::make_shared<Chunked_lexing_job>();
+        job->source_id = unit.source_path;
+        job->source = unit.source;
+        job->line_indices = prepass_results.line_indices;
+        job->is_ascii = prepass_results.is_ascii;
+        job->chunks = lex::split_into_chunks(unit.source, prepass_results.line_indices, lex_chunk_size);
+        job->results.resize(job->chunks.size());
+
+        // The calling worker lexes chunks as well, so one fewer helper is
+        // needed than there are chunks or workers
+        auto helper_count = std::min(job->chunks.size(), scheduler.worker_count());
+        helper_count = (helper_count == 0) ? 0 : helper_count - 1;
+        for (std::size_t i = 0; i < helper_count; ++i) {
+            Task helper{};
+            helper.stage = Stage::TOKENIZATION;
+            helper.lexing_job = job;
+            helper.enqueue_time = std::chrono::steady_clock::now();
+            scheduler.push(worker_index, std::move(helper));
+        }
 
-            using clk = std::chrono::steady_clock;
+        job->lex_remaining_chunks();
+        job->wait();
 
-            // Compile on CPU
-            auto& unit = task.unit;
-            if (Stage::TOKENIZATION == task.stage) {
+        // Pairing brackets block-wise does several times the work of pairing
+        // them with a stack, so only pays off given enough workers
+        lex::Parallel_for parallel_for{};
+        if (scheduler.worker_count() >= min_parallel_pairing_workers) {
+            parallel_for = [worker_index, &unit] (std::size_t count, const std::function<void(std::size_t)>& body) {
+                parallel_for_on_workers(worker_index, unit.source_path, count, body);
+            };
+        }
 
-                //TODO: Time work
-                auto begin = clk::now();
-                auto tokenization = lex::lex(unit.source_path, std::string_view{unit.source});
-                auto end = clk::now();
+        return lex::stitch_chunks(
+            unit.source_path,
+            unit.source,
+            std::move(job->results),
+            std::move(prepass_results.line_indices),
+            prepass_results.is_ascii,
+            lex::Config{},
+            parallel_for
+        );
+    }
 
-                std::uint64_t duration = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    ///
+    /// Reports the encoding errors found by the prepass alongside the unit's
+    /// lexing errors
+    ///
+    /// \param unit Translation unit which has been lexed
+    /// \param errors Errors found by the prepass
+    void report_prepass_errors(Translation_unit& unit, const std::vector<prepass::Error>& errors) {
+        auto& line_indices = unit.tokenization.line_indices;
+        for (const auto& error : errors) {
+            auto it = std::upper_bound(line_indices.begin(), line_indices.end(), error.start_location);
+            std::uint32_t line = it - line_indices.begin();
+            std::uint32_t column = error.start_location - *(it - 1) + 1;
+
+            unit.tokenization.message_buffer.error(prepass::to_string(error.error_code), unit.source_path, line, column);
+        }
+    }
 
-                //TODO: Report duration
-                //TODO: Create parsing task
-                {
-                    std::scoped_lock lk{work_queue_mutex};
+    ///
+    /// Runs the prepass over a unit and then either lexes it or takes its
+    /// tokens from the build cache
+    ///
+    /// \param worker_index Index of the calling worker
+    /// \param unit Translation unit to tokenize
+    void tokenize_unit(std::size_t worker_index, Translation_unit& unit) {
+        using clk = std::chrono::steady_clock;
 
-                    work_queue.emplace_back();
-                    work_queue.back().stage = Stage::PARSING;
-                    work_queue.back().unit = std::move(unit);
-                }
-            }
+        auto begin = clk::now();
+
+        // Sources which are pure ASCII take a tokenizer path with all
+        // multi-byte decoding compiled out
+        auto prepass_results = prepass::prepass(unit);
+
+        unit.source_hash = prepass_results.hash;
+        if (unit.cache_entry && !build_cache.is_hash_current(*unit.cache_entry, unit.source_hash)) {
+            unit.cache_entry = nullptr;
+        }
 
-            if (Stage::PARSING == task.stage) {
-                auto begin = clk::now();
-                auto tokenization = parser::parse(unit);
+        // Tokens from the build cache are used in place
+        std::optional<lex::Tokenization_view> cached_tokens;
+        if (unit.cache_entry) {
+            cached_tokens = lex::parse_binary_tokenization(
+                unit.cache_entry->tokenization_serialization,
+                unit.source
+            );
+        }
+
+        if (cached_tokens) {
+            unit.tokens = *cached_tokens;
+        } else {
+            // Line starts were already found by the prepass
+            auto& line_indices = prepass_results.line_indices;
+            bool is_large = (lex_chunk_size != 0) && (unit.source.size() / 2 >= lex_chunk_size);
+
+            if (is_large) {
+                unit.tokenization = lex_in_chunks(worker_index, unit, prepass_results);
+            } else if (prepass_results.is_ascii) {
+                unit.tokenization = lex::lex_ascii(unit.source_path, unit.source, std::move(line_indices));
+            } else {
+                unit.tokenization = lex::lex(unit.source_path, unit.source, std::move(line_indices));
             }
 
-            //TODO: Wait for the front end to run on all modules
-            if (Stage::BACKEND == task.stage) {
-                //TODO: Invoke compiler back end
+            unit.tokens = lex::Tokenization_view{unit.tokenization};
+            report_prepass_errors(unit, prepass_results.errors);
+            if (!unit.tokenization.success || !prepass_results.errors.empty()) {
+                unit.status = Translation_unit_status::TOKENIZATION_FAILED;
             }
         }
+
+        auto end = clk::now();
+        timing_collector.record(worker_index, Stage::TOKENIZATION, unit.source_path, unit.source.size(), end - begin);
     }
 
-    #if HARC_CUDA
     ///
-    /// Function which is run to assign work to CUDA streams
+    /// Parses a large unit's top-level declarations in chunks. Helper tasks
+    /// are pushed so that idle workers may parse chunks alongside the
+    /// calling worker.
     ///
-    void cuda_worker(int device_index, cudaStream_t stream) {
-        cudaSetDevice(device_index);
+    /// \param worker_index Index of the calling worker
+    /// \param unit Translation unit to parse
+    /// \return Error code
+    Error_code parse_in_chunks(std::size_t worker_index, Translation_unit& unit) {
+        auto job = std::make_shared<Chunked_parsing_job>();
+        job->source_id = unit.source_path;
+        job->tokens = unit.tokens;
+        job->chunks = parser::split_source_bodies(unit.tokens, parse_chunk_size);
+        job->results.resize(job->chunks.size());
+
+        // The calling worker parses chunks as well, so one fewer helper is
+        // needed than there are chunks or workers
+        auto helper_count = std::min(job->chunks.size(), scheduler.worker_count());
+        helper_count = (helper_count == 0) ? 0 : helper_count - 1;
+        for (std::size_t i = 0; i < helper_count; ++i) {
+            Task helper{};
+            helper.stage = Stage::PARSING;
+            helper.parsing_job = job;
+            helper.enqueue_time = std::chrono::steady_clock::now();
+            scheduler.push(worker_index, std::move(helper));
+        }
+
+        job->parse_remaining_chunks();
+        job->wait();
+
+        return parser::stitch_chunk_parses(unit, std::move(job->results));
+    }
+
+    ///
+    /// \param worker_index Index of the calling worker
+    /// \param unit Translation unit to parse
+    void parse_unit(std::size_t worker_index, Translation_unit& unit) {
+        using clk = std::chrono::steady_clock;
+
+        auto begin = clk::now();
+
+        bool is_large = (parse_chunk_size != 0) && (unit.tokens.size() / 2 >= parse_chunk_size);
+        auto error_code = is_large ? parse_in_chunks(worker_index, unit) : parser::parse(unit);
+        if (error_code != Error_code::NO_ERROR) {
+            unit.status = Translation_unit_status::PARSING_FAILED;
+        }
+        auto end = clk::now();
+        timing_collector.record(worker_index, Stage::PARSING, unit.source_path, unit.source.size(), end - begin);
+    }
+
+    ///
+    /// \param worker_index Index of the calling worker
+    /// \param unit Translation unit to run back end on
+    void finish_unit(std::size_t worker_index, Translation_unit& unit) {
+        using clk = std::chrono::steady_clock;
+
+        auto begin = clk::now();
+        //TODO: Invoke compiler back end
+        if (unit.status == Translation_unit_status::NO_ERROR) {
+            build_cache.record(unit);
+        }
+        auto end = clk::now();
+        timing_collector.record(worker_index, Stage::BACKEND, unit.source_path, unit.source.size(), end - begin);
+    }
+
+    ///
+    /// Function which is run for CPU threads used in compilation process
+    ///
+    /// \param worker_index Index of the scheduler queue owned by this thread
+    void cpu_worker(std::size_t worker_index) {
+        using clk = std::chrono::steady_clock;
+
+        auto& messages = message_collector.register_buffer();
+
+        Task task{};
+        auto idle_begin = clk::now();
+        while (scheduler.pop(worker_index, task)) {
+            auto task_begin = clk::now();
+            trace_recorder.record_idle(worker_index, idle_begin, task_begin);
+
+            // Captured up front since the units are moved into follow-up
+            // tasks
+            Stage task_stage = task.stage;
+            std::string_view task_path{};
+            if (!task.units.empty()) {
+                task_path = task.units.front().source_path;
+            } else if (task.lexing_job) {
+                task_path = task.lexing_job->source_id;
+            } else if (task.parallel_for_job) {
+                task_path = task.parallel_for_job->source_id;
+            } else if (task.parsing_job) {
+                task_path = task.parsing_job->source_id;
+            }
+            auto unit_count = static_cast<std::uint32_t>(task.units.size());
+            auto queue_wait = task_begin - task.enqueue_time;
+
+            // Tasks spawned by this worker go onto its own queue so that a
+            // unit's next stage runs on the core whose cache already holds
+            // its data. Since workers pop from the back of their own queue,
+            // this is normally the next task the worker runs.
+            auto submit_local = [worker_index] (Task&& t) {
+                t.enqueue_time = clk::now();
+                scheduler.push(worker_index, std::move(t));
+            };
 
-        while (true) {
-            Task task{};
-            {
-                std::lock_guard lk{work_queue_mutex};
+            // Compile on CPU
+            if (task.lexing_job) {
+                // Chunks may all have been claimed by the time this runs
+                task.lexing_job->lex_remaining_chunks();
+            } else if (task.parallel_for_job) {
+                task.parallel_for_job->run_remaining_iterations();
+            } else if (task.parsing_job) {
+                task.parsing_job->parse_remaining_chunks();
+            } else if (Stage::TOKENIZATION == task.stage) {
+                for (auto& unit : task.units) {
+                    tokenize_unit(worker_index, unit);
+                    messages.append(std::move(unit.tokenization.message_buffer));
+                }
 
-                if (!work_queue.empty()) {
-                    task = work_queue.back();
-                    work_queue.pop_back();
+                Task next{};
+                next.stage = Stage::PARSING;
+                next.units = std::move(task.units);
+                pipeline.advance(std::move(next), submit_local, unit_count);
+                pipeline.complete(Stage::TOKENIZATION, submit_local, unit_count);
+            } else if (Stage::PARSING == task.stage) {
+                for (auto& unit : task.units) {
+                    parse_unit(worker_index, unit);
+                    messages.append(std::move(unit.parse_tree.message_buffer));
                 }
+
+                // Parked by the pipeline until all units have been parsed
+                Task next{};
+                next.stage = Stage::BACKEND;
+                next.units = std::move(task.units);
+                pipeline.advance(std::move(next), submit_local, unit_count);
+                pipeline.complete(Stage::PARSING, submit_local, unit_count);
             }
 
-            if (Stage::NULL_STEP == task.step) {
-                if (terminate_once_idle) {
-                    break;
-                } else {
-                    //TODO: Replace with wait for wake-up event
-                    using namespace std::chrono_literals;
-                    std::this_thread::sleep_for(100ms);
-                    continue;
+            if (Stage::BACKEND == task.stage) {
+                for (auto& unit : task.units) {
+                    finish_unit(worker_index, unit);
                 }
+
+                pipeline.complete(Stage::BACKEND, submit_local, unit_count);
             }
 
-            if (Stage::TOKENIZATION == task.step) {
+            scheduler.complete();
+
+            idle_begin = clk::now();
+            trace_recorder.record_task(worker_index, task_stage, task_path, unit_count, task_begin, idle_begin, queue_wait);
+
+            // Units of the finished task are released before waiting again
+            task = Task{};
+        }
+    }
+
+    #if HARC_CUDA
+    ///
+    /// Function which is run to assign work to CUDA streams
+    ///
+    void cuda_worker(std::size_t worker_index, int device_index, cudaStream_t stream) {
+        cudaSetDevice(device_index);
+
+        Task task{};
+        while (scheduler.pop(worker_index, task)) {
+            if (Stage::TOKENIZATION == task.stage) {
                 //TODO: Invoke Tokenization kernels
             }
+
+            scheduler.complete();
         }
     }
     #endif
@@ -229,21 +699,40 @@ namespace harc {
     // Helper functions
     //=====================================================
 
-    void create_cpu_worker_threads() {
-        auto thread_count = std::thread::hardware_concurrency();
+    ///
+    /// \param config Harc configuration
+    /// \return Number of CPU worker threads to launch
+    std::size_t cpu_worker_count(const Config& config) {
+        return std::max<std::size_t>(config.thread_count, 1);
+    }
+
+    void create_cpu_worker_threads(std::size_t thread_count) {
+        cpu_worker_threads.reserve(thread_count);
 
         for (std::size_t i = 0; i < thread_count; ++i) {
-            cpu_worker_threads.emplace_back(cpu_worker);
+            cpu_worker_threads.emplace_back(cpu_worker, i);
         }
     }
 
     #if HARC_CUDA
-    void create_cuda_worker_threads() {
+    // This is currently an arbitrary number in need of refinement
+    constexpr int streams_per_device = 8;
+
+    ///
+    /// \return Number of CUDA worker threads to launch
+    std::size_t cuda_worker_count() {
         int device_count;
         cudaGetDeviceCount(&device_count);
 
-        // This is currently an arbitrary number in need of refinement
-        constexpr int streams_per_device = 8;
+        return device_count * streams_per_device;
+    }
+
+    ///
+    /// \param first_worker_index Index of the scheduler queue owned by the
+    /// first CUDA worker. Subsequent workers use consecutive queues.
+    void create_cuda_worker_threads(std::size_t first_worker_index) {
+        int device_count;
+        cudaGetDeviceCount(&device_count);
 
         // Create CUDA streams
         std::vector<std::array<cudaStream_t, streams_per_device>> device_streams;
@@ -262,6 +751,7 @@ namespace harc {
             for (int j = 0; j < streams_per_device; ++j) {
                 cuda_worker_threads.emplace_back(
                     cuda_worker,
+                    first_worker_index + cuda_worker_threads.size(),
                     i,
                     device_streams[i][j]
                 );
@@ -270,69 +760,244 @@ namespace harc {
     }
     #endif
 
-    void create_compilation_tasks(std::span<const std::string_view> source_paths) {
+    ///
+    /// Sizes the scheduler so that every CPU and CUDA worker thread owns one
+    /// of its queues.
+    ///
+    /// \param config Harc configuration
+    void initialize_scheduler(const Config& config) {
+        std::size_t worker_count = cpu_worker_count(config);
+        #if HARC_CUDA
+        worker_count += cuda_worker_count();
+        #endif
+
+        scheduler.initialize(worker_count);
+
+        timing_collector.initialize(
+            worker_count,
+            config.stage_timing_data_report,
+            config.file_timing_data_report
+        );
+
+        trace_recorder.initialize(worker_count, !config.trace_path.empty());
+
+        lex_chunk_size = config.lex_chunk_size;
+        parse_chunk_size = config.parse_chunk_size;
+    }
+
+    void create_compilation_tasks(
+        std::span<const std::string_view> source_paths,
+        const Config& config
+    ) {
+        pipeline.initialize(source_paths.size());
+        pipeline.set_prerequisite(Stage::BACKEND, Stage::PARSING);
+
+        // A missing cache is expected on the first build
+        auto cache_error = build_cache.load(config.cache_directory, config.caching_policy);
+        if (cache_error == Error_code::INVALID_BUILD_CACHE) {
+            HARC_LOG_WARNING("Ignoring build cache: {}", to_string(cache_error));
+        }
+
+        // Units smaller than the byte budget are gathered into batches so
+        // that the per-task overhead is amortized across several of them
+        const std::uint64_t batch_byte_budget = config.task_batch_byte_budget;
+
+        Task batch{};
+        batch.stage = Stage::TOKENIZATION;
+        std::uint64_t batch_bytes = 0;
+
+        auto submit_batch = [&batch, &batch_bytes] () {
+            if (batch.units.empty()) {
+                return;
+            }
+
+            auto unit_count = static_cast<std::uint32_t>(batch.units.size());
+            pipeline.advance(std::move(batch), submit_external, unit_count);
+
+            batch = Task{};
+            batch.stage = Stage::TOKENIZATION;
+            batch_bytes = 0;
+        };
+
         for (auto& source_path : source_paths) {
-            work_queue.emplace_back();
-            auto& task = work_queue.back();
-            task.stage = Stage::TOKENIZATION;
-            task.unit.source_path = source_path;
+            Translation_unit unit{};
+            unit.source_path = source_path;
 
-            //TODO: Check if a cache entry exists for the specified translation
-            //unit and create tasks in response to that.
+            // Entries which pass the timestamp check are attached to the
+            // unit here. Hashes are checked once the prepass has run.
+            unit.source_timestamp = file_modification_time(source_path);
+            unit.cache_entry = build_cache.find(source_path, unit.source_timestamp);
 
             #if HARC_POSIX
-            Text_file_mapping mapping = map_text_file(source_path);
+            File_mapping_options mapping_options{};
+            mapping_options.populate = config.populate_source_mappings;
+
+            Text_file_mapping mapping = map_text_file(source_path, mapping_options);
             if (mapping.error_code != Error_code::NO_ERROR) {
                 //TODO: Log error
+                pipeline.retire(Stage::TOKENIZATION, submit_external);
                 continue;
             }
 
-            task.unit.source = mapping.text;
-            unmap_file(mapping);
+            // The unit keeps the file mapped until it is destroyed so that
+            // the source is never copied
+            unit.set_source(Mapped_text_file{mapping});
 
-            #elif
-            std::ifstream fin{source_path.data()};
-            t.seekg(0, std::ios::end);
-            std::size_t size = t.tellg();
+            #else
+            std::ifstream fin{source_path.data(), std::ios::binary};
+            fin.seekg(0, std::ios::end);
+            std::size_t size = fin.tellg();
 
             std::string buffer(size, ' ');
-            t.seekg(0);
-            t.read(&buffer[0], size);
+            fin.seekg(0);
+            fin.read(&buffer[0], size);
 
-            back.unit.source = std::move(buffer);
+            unit.set_source(std::move(buffer));
 
             #endif
+
+            std::uint64_t unit_bytes = unit.source.size();
+            if (unit_bytes >= batch_byte_budget) {
+                Task task{};
+                task.stage = Stage::TOKENIZATION;
+                task.units.push_back(std::move(unit));
+                pipeline.advance(std::move(task), submit_external);
+                continue;
+            }
+
+            if (batch_bytes + unit_bytes > batch_byte_budget) {
+                submit_batch();
+            }
+
+            batch.units.push_back(std::move(unit));
+            batch_bytes += unit_bytes;
         }
 
+        submit_batch();
+
         //if (!Message_buffer::is_empty()) {
         //    return Error_code::GENERAL_INTERNAL_ERRORR;
         //}
     }
 
-    //=====================================================
-    // Core Harc functions
-    //=====================================================
+    ///
+    /// Replaces the build cache with the results of the current build
+    ///
+    /// \param config Harc configuration
+    void write_build_cache(const Config& config) {
+        auto error_code = build_cache.store(config.cache_directory);
+        if (error_code != Error_code::NO_ERROR) {
+            HARC_LOG_WARNING("Failed to write build cache: {}", to_string(error_code));
+        }
+    }
 
-    void run_client(const Config& config) {
-        terminate_once_idle = false;
+    ///
+    /// Prints the timing reports requested by the configuration, if any
+    ///
+    /// \param config Harc configuration
+    void report_timing_data(const Config& config) {
+        if (!timing_collector.is_enabled()) {
+            return;
+        }
 
-        create_cpu_worker_threads();
-        #if HARC_CUDA
-        create_cuda_worker_threads();
-        #endif
+        config.print_info_callback("Timing", timing_collector.report());
+    }
 
-        // Wait for threads to complete their work
+    ///
+    /// Prints the messages reported for all units, ordered by location
+    ///
+    void report_messages() {
+        auto messages = message_collector.merge();
+        if (!messages.empty()) {
+            print(messages);
+        }
+    }
+
+    ///
+    /// Writes the trace of worker activity if one was requested
+    ///
+    /// \param config Harc configuration
+    void write_trace(const Config& config) {
+        if (!trace_recorder.is_enabled()) {
+            return;
+        }
+
+        auto error_code = trace_recorder.write(config.trace_path);
+        if (error_code != Error_code::NO_ERROR) {
+            HARC_LOG_WARNING("Failed to write trace: {}", to_string(error_code));
+        }
+    }
+
+    ///
+    /// Waits for all worker threads to exit so that the next build may
+    /// launch its own
+    ///
+    void join_worker_threads() {
         for (auto& th : cpu_worker_threads) {
             th.join();
         }
+        cpu_worker_threads.clear();
 
         #if HARC_CUDA
         for (auto& th : cuda_worker_threads) {
             th.join();
         }
+        cuda_worker_threads.clear();
         #endif
     }
 
+    ///
+    /// Compiles the specified sources on freshly launched workers and
+    /// reports the results once every worker has exited. May be called
+    /// repeatedly by the same process.
+    ///
+    /// \param source_paths Paths of source files to compile. Must not be
+    /// empty.
+    /// \param config Harc configuration
+    void run_build(
+        std::span<const std::string_view> source_paths,
+        const Config& config
+    ) {
+        // Messages of earlier builds run by the same process are not
+        // reported again
+        message_collector.clear();
+
+        initialize_scheduler(config);
+        scheduler.set_terminate_once_idle(true);
+        timing_collector.begin_build();
+
+        create_compilation_tasks(source_paths, config);
+        create_cpu_worker_threads(cpu_worker_count(config));
+
+        #if HARC_CUDA
+        create_cuda_worker_threads(cpu_worker_count(config));
+        #endif
+
+        join_worker_threads();
+        timing_collector.end_build();
+
+        report_messages();
+        write_build_cache(config);
+        report_timing_data(config);
+        write_trace(config);
+    }
+
+    //=====================================================
+    // Core Harc functions
+    //=====================================================
+
+    void run_client(const Config& config) {
+        initialize_scheduler(config);
+        scheduler.set_terminate_once_idle(false);
+
+        create_cpu_worker_threads(cpu_worker_count(config));
+        #if HARC_CUDA
+        create_cuda_worker_threads(cpu_worker_count(config));
+        #endif
+
+        join_worker_threads();
+    }
+
     void run_pure_server(
         std::span<const std::string_view> source_paths,
         const Config& config
@@ -342,9 +1007,10 @@ namespace harc {
             return;
         }
 
-        terminate_once_idle = true;
+        initialize_scheduler(config);
+        scheduler.set_terminate_once_idle(true);
 
-        create_compilation_tasks(source_paths);
+        create_compilation_tasks(source_paths, config);
     }
 
     void run_server(
@@ -356,25 +1022,7 @@ namespace harc {
             return;
         }
 
-        terminate_once_idle = true;
-
-        create_compilation_tasks(source_paths);
-
-        create_cpu_worker_threads();
-        #if HARC_CUDA
-        create_cuda_worker_threads();
-        #endif
-
-        // Wait for threads to complete their work
-        for (auto& th : cpu_worker_threads) {
-            th.join();
-        }
-
-        #if HARC_CUDA
-        for (auto& th : cuda_worker_threads) {
-            th.join();
-        }
-        #endif
+        run_build(source_paths, config);
     }
 
     void run_locally(
@@ -386,25 +1034,7 @@ namespace harc {
             return;
         }
 
-        terminate_once_idle = true;
-
-        create_compilation_tasks(source_paths);
-        create_cpu_worker_threads();
-
-        #if HARC_CUDA
-        create_cuda_worker_threads();
-        #endif
-
-        // Wait for threads to complete their work
-        for (auto& th : cpu_worker_threads) {
-            th.join();
-        }
-
-        #if HARC_CUDA
-        for (auto& th : cuda_worker_threads) {
-            th.join();
-        }
-        #endif
+        run_build(source_paths, config);
     }
 
 }
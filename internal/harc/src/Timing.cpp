@@ -0,0 +1,212 @@
+#include <harc/Timing.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace harc {
+
+    ///
+    /// Names of the stages which are reported, indexed by Stage
+    ///
+    constexpr std::array<std::string_view, stage_count> stage_names {
+        "",
+        "Tokenization",
+        "Parsing",
+        "Backend"
+    };
+
+    ///
+    /// \param bytes Number of bytes processed
+    /// \param nanoseconds Time taken to process bytes
+    /// \return Throughput in megabytes per second
+    double megabytes_per_second(std::uint64_t bytes, std::uint64_t nanoseconds) {
+        if (nanoseconds == 0) {
+            return 0.0;
+        }
+
+        return (double(bytes) / 1.0e6) / (double(nanoseconds) / 1.0e9);
+    }
+
+    ///
+    /// \param nanoseconds Arbitrary duration
+    /// \return Duration in milliseconds
+    double milliseconds(std::uint64_t nanoseconds) {
+        return double(nanoseconds) / 1.0e6;
+    }
+
+    //=====================================================
+    // Mutators
+    //=====================================================
+
+    void Timing_collector::initialize(std::size_t worker_count, Level stage_report_level, Level file_report_level) {
+        threads.clear();
+        threads.resize(worker_count);
+
+        stage_level = stage_report_level;
+        file_level = file_report_level;
+    }
+
+    void Timing_collector::begin_build() {
+        build_begin = clock::now();
+    }
+
+    void Timing_collector::end_build() {
+        build_end = clock::now();
+    }
+
+    void Timing_collector::record(
+        std::size_t worker_index,
+        Stage stage,
+        std::string_view path,
+        std::uint64_t bytes,
+        clock::duration duration
+    ) {
+        if (!is_enabled()) {
+            return;
+        }
+
+        auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        auto stage_index = static_cast<std::size_t>(stage);
+
+        auto& data = threads[worker_index];
+        data.stage_durations[stage_index] += nanoseconds;
+        data.stage_bytes[stage_index] += bytes;
+        data.stage_unit_counts[stage_index] += 1;
+
+        if (file_level != Level::NONE) {
+            data.file_timings.push_back(File_stage_timing{path, bytes, stage, std::uint64_t(nanoseconds)});
+        }
+    }
+
+    //=====================================================
+    // Accessors
+    //=====================================================
+
+    std::string Timing_collector::report() const {
+        std::string ret;
+
+        if (stage_level != Level::NONE) {
+            append_stage_report(ret);
+        }
+
+        if (file_level != Level::NONE) {
+            append_file_report(ret);
+        }
+
+        return ret;
+    }
+
+    //=====================================================
+    // Helper functions
+    //=====================================================
+
+    void Timing_collector::append_stage_report(std::string& out) const {
+        std::array<std::uint64_t, stage_count> durations{};
+        std::array<std::uint64_t, stage_count> bytes{};
+        std::array<std::uint64_t, stage_count> unit_counts{};
+
+        for (const auto& data : threads) {
+            for (std::size_t i = 0; i < stage_count; ++i) {
+                durations[i] += data.stage_durations[i];
+                bytes[i] += data.stage_bytes[i];
+                unit_counts[i] += data.stage_unit_counts[i];
+            }
+        }
+
+        auto build_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(build_end - build_begin).count();
+
+        // Every unit passes through tokenization exactly once
+        auto source_bytes = bytes[static_cast<std::size_t>(Stage::TOKENIZATION)];
+
+        out += fmt::format(
+            "Build time: {:.3f} ms ({} units, {:.2f} MB, {:.1f} MB/s)\n",
+            milliseconds(build_duration),
+            unit_counts[static_cast<std::size_t>(Stage::TOKENIZATION)],
+            double(source_bytes) / 1.0e6,
+            megabytes_per_second(source_bytes, build_duration)
+        );
+
+        if (stage_level == Level::LOW) {
+            return;
+        }
+
+        // Times are summed over all threads, so throughput is per thread
+        out += fmt::format("{:<14}{:>8}{:>14}{:>12}\n", "Stage", "Units", "Time (ms)", "MB/s");
+        for (std::size_t i = 1; i < stage_count; ++i) {
+            out += fmt::format(
+                "{:<14}{:>8}{:>14.3f}{:>12.1f}\n",
+                stage_names[i],
+                unit_counts[i],
+                milliseconds(durations[i]),
+                megabytes_per_second(bytes[i], durations[i])
+            );
+        }
+    }
+
+    void Timing_collector::append_file_report(std::string& out) const {
+        struct File_summary {
+            std::string_view path{};
+            std::uint64_t bytes = 0;
+            std::uint64_t total_duration = 0;
+            std::array<std::uint64_t, stage_count> stage_durations{};
+        };
+
+        // A unit's stages may run on different threads
+        std::unordered_map<std::string_view, File_summary> summaries;
+        for (const auto& data : threads) {
+            for (const auto& timing : data.file_timings) {
+                auto& summary = summaries[timing.path];
+                summary.path = timing.path;
+                summary.bytes = timing.bytes;
+                summary.total_duration += timing.duration;
+                summary.stage_durations[static_cast<std::size_t>(timing.stage)] += timing.duration;
+            }
+        }
+
+        std::vector<File_summary> files;
+        files.reserve(summaries.size());
+        for (const auto& entry : summaries) {
+            files.push_back(entry.second);
+        }
+
+        // Ties are broken by path so that reports are deterministic
+        std::size_t count = std::min(files.size(), slowest_file_count);
+        std::partial_sort(files.begin(), files.begin() + count, files.end(), [] (const File_summary& a, const File_summary& b) {
+            if (a.total_duration != b.total_duration) {
+                return a.total_duration > b.total_duration;
+            }
+            return a.path < b.path;
+        });
+
+        out += fmt::format("Slowest files ({} of {}):\n", count, files.size());
+
+        out += fmt::format("{:>14}{:>12}", "Time (ms)", "MB/s");
+        if (file_level != Level::LOW) {
+            for (std::size_t i = 1; i < stage_count; ++i) {
+                out += fmt::format("{:>14}", stage_names[i]);
+            }
+        }
+        out += "  Path\n";
+
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto& file = files[i];
+
+            out += fmt::format(
+                "{:>14.3f}{:>12.1f}",
+                milliseconds(file.total_duration),
+                megabytes_per_second(file.bytes, file.total_duration)
+            );
+
+            if (file_level != Level::LOW) {
+                for (std::size_t j = 1; j < stage_count; ++j) {
+                    out += fmt::format("{:>14.3f}", milliseconds(file.stage_durations[j]));
+                }
+            }
+
+            out += fmt::format("  {}\n", file.path);
+        }
+    }
+
+}
@@ -0,0 +1,142 @@
+#include <harc/Tracing.hpp>
+
+#include <fmt/format.h>
+
+#include <array>
+#include <fstream>
+
+namespace harc {
+
+    ///
+    /// Names under which the stages appear in traces, indexed by Stage
+    ///
+    constexpr std::array<std::string_view, stage_count> trace_stage_names {
+        "Unknown",
+        "Tokenization",
+        "Parsing",
+        "Backend"
+    };
+
+    ///
+    /// \param out String to append to
+    /// \param str String to append as the contents of a JSON string literal
+    void append_json_escaped(std::string& out, std::string_view str) {
+        for (char c : str) {
+            switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n";  break;
+                case '\r': out += "\\r";  break;
+                case '\t': out += "\\t";  break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out += fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+    }
+
+    //=====================================================
+    // Mutators
+    //=====================================================
+
+    void Trace_recorder::initialize(std::size_t worker_count, bool is_enabled) {
+        buffers.clear();
+        enabled = is_enabled;
+        origin = clock::now();
+
+        if (!enabled) {
+            return;
+        }
+
+        buffers.resize(worker_count);
+        for (auto& buffer : buffers) {
+            buffer.events.resize(trace_events_per_worker);
+        }
+    }
+
+    Error_code Trace_recorder::write(std::string_view path) const {
+        auto json = to_json();
+
+        std::ofstream fout{std::string{path}, std::ios::binary | std::ios::trunc};
+        fout.write(json.data(), json.size());
+        if (!fout) {
+            return Error_code::INACCESSIBLE_TRACE_FILE;
+        }
+
+        return Error_code::NO_ERROR;
+    }
+
+    //=====================================================
+    // Accessors
+    //=====================================================
+
+    std::string Trace_recorder::to_json() const {
+        using microseconds = std::chrono::duration<double, std::micro>;
+
+        std::string ret = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool is_first = true;
+
+        auto begin_event = [&ret, &is_first] () {
+            if (!is_first) {
+                ret += ",\n";
+            }
+            is_first = false;
+        };
+
+        for (std::size_t tid = 0; tid < buffers.size(); ++tid) {
+            const auto& buffer = buffers[tid];
+
+            // Name each worker's track so that traces are easy to navigate
+            begin_event();
+            ret += fmt::format(
+                R"({{"name":"thread_name","ph":"M","pid":1,"tid":{},"args":{{"name":"Worker {}","dropped_events":{}}}}})",
+                tid,
+                tid,
+                buffer.dropped_count()
+            );
+
+            // Oldest retained event first
+            std::uint64_t capacity = buffer.events.size();
+            std::uint64_t first = buffer.push_count - std::min(buffer.push_count, capacity);
+
+            for (std::uint64_t i = first; i < buffer.push_count; ++i) {
+                const auto& event = buffer.events[i % capacity];
+
+                double ts = microseconds(event.begin - origin).count();
+                double dur = microseconds(event.end - event.begin).count();
+
+                begin_event();
+                if (event.type == Trace_event_type::IDLE) {
+                    ret += fmt::format(
+                        R"({{"name":"Idle","cat":"idle","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f}}})",
+                        tid,
+                        ts,
+                        dur
+                    );
+                    continue;
+                }
+
+                ret += fmt::format(
+                    R"({{"name":"{}","cat":"task","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f},"args":{{"path":")",
+                    trace_stage_names[static_cast<std::size_t>(event.stage)],
+                    tid,
+                    ts,
+                    dur
+                );
+                append_json_escaped(ret, event.path);
+                ret += fmt::format(
+                    R"(","units":{},"queue_wait_us":{:.3f}}}}})",
+                    event.unit_count,
+                    microseconds(event.queue_wait).count()
+                );
+            }
+        }
+
+        ret += "\n]}\n";
+        return ret;
+    }
+
+}
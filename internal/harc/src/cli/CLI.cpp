@@ -159,7 +159,10 @@ namespace harc::cli {
             }
         }
 
+        // Source paths were collected before the options were parsed
+        auto source_paths = std::move(results.source_paths);
         results = config_string_map_to_config_struct(cli_config_map);
+        results.source_paths = std::move(source_paths);
         return results;
     }
 
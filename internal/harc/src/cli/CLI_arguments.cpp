@@ -5,6 +5,7 @@
 
 #include <harc/Harc.hpp>
 
+#include <filesystem>
 #include <string>
 #include <thread>
 
@@ -53,6 +54,15 @@ namespace harc::cli {
         static_assert(sizeof(unsigned long long) >= sizeof(std::uint16_t));
 
         unsigned long long v = 0;
+        if (value.empty()) {
+            Message_buffer::append(
+                Error_code::MISSING_VALUE,
+                key,
+                value
+            );
+            return;
+        }
+
         try {
             v = std::stoull(value.data());
         } catch (std::invalid_argument& e) {
@@ -88,6 +98,15 @@ namespace harc::cli {
         static_assert(sizeof(long long) >= sizeof(std::int16_t));
 
         long long v = 0;
+        if (value.empty()) {
+            Message_buffer::append(
+                Error_code::MISSING_VALUE,
+                key,
+                value
+            );
+            return;
+        }
+
         try {
             v = std::stoull(value.data());
         } catch (std::invalid_argument& e) {
@@ -123,6 +142,15 @@ namespace harc::cli {
         static_assert(sizeof(unsigned long long) >= sizeof(std::uint32_t));
 
         unsigned long long v = 0;
+        if (value.empty()) {
+            Message_buffer::append(
+                Error_code::MISSING_VALUE,
+                key,
+                value
+            );
+            return;
+        }
+
         try {
             v = std::stoull(value.data());
         } catch (std::invalid_argument& e) {
@@ -158,6 +186,15 @@ namespace harc::cli {
         static_assert(sizeof(long long) >= sizeof(std::int32_t));
 
         long long v = 0;
+        if (value.empty()) {
+            Message_buffer::append(
+                Error_code::MISSING_VALUE,
+                key,
+                value
+            );
+            return;
+        }
+
         try {
             v = std::stoull(value.data());
         } catch (std::invalid_argument& e) {
@@ -193,6 +230,15 @@ namespace harc::cli {
         static_assert(sizeof(unsigned long long) >= sizeof(std::uint64_t));
 
         unsigned long long v = 0;
+        if (value.empty()) {
+            Message_buffer::append(
+                Error_code::MISSING_VALUE,
+                key,
+                value
+            );
+            return;
+        }
+
         try {
             v = std::stoull(value.data());
         } catch (std::invalid_argument& e) {
@@ -228,6 +274,15 @@ namespace harc::cli {
         static_assert(sizeof(long long) >= sizeof(std::int64_t));
 
         long long v = 0;
+        if (value.empty()) {
+            Message_buffer::append(
+                Error_code::MISSING_VALUE,
+                key,
+                value
+            );
+            return;
+        }
+
         try {
             v = std::stoull(value.data());
         } catch (std::invalid_argument& e) {
@@ -258,6 +313,22 @@ namespace harc::cli {
         out = v;
     }
 
+    void parse_path(std::string_view key, std::string_view value, void* out_ptr) {
+        std::string_view& out = *reinterpret_cast<std::string_view*>(out_ptr);
+
+        if (value.empty()) {
+            Message_buffer::append(
+                Error_code::MISSING_VALUE,
+                key,
+                value
+            );
+            return;
+        }
+
+        // Views into argv remain valid for the lifetime of the program
+        out = value;
+    }
+
     //=====================================================
     // Validation functions
     //=====================================================
@@ -296,6 +367,89 @@ namespace harc::cli {
         */
     }
 
+    void validate_trace_path(std::string_view key, std::string_view value) {
+        namespace fs = std::filesystem;
+
+        if (value.empty()) {
+            return;
+        }
+
+        std::error_code ec;
+        fs::path path{value};
+
+        if (fs::is_directory(path, ec)) {
+            Message_buffer::append(
+                Error_code::DIRECTORY_AS_TRACE_PATH,
+                key,
+                value
+            );
+            return;
+        }
+
+        // The trace is only written once the build finishes, so a bad path
+        // is better caught before any work is done
+        if (path.has_parent_path() && !fs::is_directory(path.parent_path(), ec)) {
+            Message_buffer::append(
+                Error_code::INACCESSIBLE_TRACE_DIRECTORY,
+                key,
+                value
+            );
+        }
+    }
+
+    void validate_task_batch_byte_budget(std::string_view key, std::string_view value) {
+        // Sources are batched until a task holds this many bytes, so past a
+        // few megabytes a typical build lands in a handful of tasks
+        constexpr unsigned long long large_budget = 4 * 1024 * 1024;
+
+        unsigned long long v = 0;
+        try {
+            v = std::stoull(std::string{value});
+        } catch (std::exception& e) {
+            // Already reported by the parser
+            return;
+        }
+
+        if (large_budget < v && v <= UINT32_MAX) {
+            Message_buffer::append(
+                Warning_code::LARGE_TASK_BATCH_BYTE_BUDGET,
+                key,
+                value,
+                std::to_string(large_budget)
+            );
+        }
+    }
+
+    ///
+    /// Warns about chunk sizes which are non-zero but below min_size
+    ///
+    void validate_chunk_size(std::string_view key, std::string_view value, unsigned long long min_size) {
+        unsigned long long v = 0;
+        try {
+            v = std::stoull(std::string{value});
+        } catch (std::exception& e) {
+            // Already reported by the parser
+            return;
+        }
+
+        if (v != 0 && v < min_size) {
+            Message_buffer::append(
+                Warning_code::SMALL_CHUNK_SIZE,
+                key,
+                value,
+                std::to_string(min_size)
+            );
+        }
+    }
+
+    void validate_lex_chunk_size(std::string_view key, std::string_view value) {
+        validate_chunk_size(key, value, 4 * 1024);
+    }
+
+    void validate_parse_chunk_size(std::string_view key, std::string_view value) {
+        validate_chunk_size(key, value, 1024);
+    }
+
     //=====================================================
     // Response functions
     //=====================================================
@@ -399,7 +553,11 @@ namespace harc::cli {
         //{"server_address_ipv4",   {&args.server_address_ipv4,       parse_ipv4_address}},
         //{"network_port",          {offsetof(Config, network_port),  parse_u16, validate_port_number}},
         //{"assembler",             {&args.assembler_path,            parse_path}},
-        {"threads",                 {offsetof(Config, thread_count),  parse_u32, null_validator}}
+        {"threads",                 {offsetof(Config, thread_count),  parse_u16, null_validator}},
+        {"trace_path",              {offsetof(Config, trace_path),    parse_path, validate_trace_path}},
+        {"task_batch_byte_budget",  {offsetof(Config, task_batch_byte_budget), parse_u32, validate_task_batch_byte_budget}},
+        {"lex_chunk_size",          {offsetof(Config, lex_chunk_size), parse_u32, validate_lex_chunk_size}},
+        {"parse_chunk_size",        {offsetof(Config, parse_chunk_size), parse_u32, validate_parse_chunk_size}}
     };
 
 }
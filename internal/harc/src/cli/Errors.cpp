@@ -11,6 +11,8 @@ namespace harc::cli {
                 return "'{key}' is not a recognized command line argument.";
             case Error_code::UNRECOGNIZED_VALUE:
                 return "'{value}' is not a recognized value for '{key}'.";
+            case Error_code::MISSING_VALUE:
+                return "'{key}' requires a value.";
             case Error_code::IPV6_WRONG_NUMBER_OF_BIT_GROUPS:
                 return "{value} is not a valid IPv6 address. An IPv6 address should be of the form xxxx:xxxx:xxxx:xxxx.";
 
@@ -35,6 +37,11 @@ namespace harc::cli {
             case Error_code::ZERO_THREADS_REQUESTED:
                 return "Zero CPU worker threads requested.";
 
+            case Error_code::INACCESSIBLE_TRACE_DIRECTORY:
+                return "The directory containing the trace file {value} does not exist.";
+            case Error_code::DIRECTORY_AS_TRACE_PATH:
+                return "{value} is a directory and cannot be written as a trace file.";
+
             default: {
                 HARC_LOG_ERROR("Unhandled enum value.");
                 return "Missing error description";
@@ -48,6 +55,10 @@ namespace harc::cli {
                 return "{value} is a privileged port number.";
             case Warning_code::MORE_THREADS_REQUESTED_THAN_AVAILABLE:
                 return "{value} is more threads than are available on this system. {extra_info} thread are available.";
+            case Warning_code::LARGE_TASK_BATCH_BYTE_BUDGET:
+                return "A batch budget of {value} bytes may group most sources into a single task. Budgets above {extra_info} bytes leave little work for other threads.";
+            case Warning_code::SMALL_CHUNK_SIZE:
+                return "A '{key}' of {value} splits sources into chunks which cost more to stitch together than they save. Sizes below {extra_info} are not recommended.";
             default: {
                 HARC_LOG_ERROR("Unhandled enum value.");
                 return "Missing error description";
@@ -24,6 +24,13 @@ QUERIES:
 
 OPTIONS:
   --threads <val>       Set the amount of compilation threads
+  --trace_path <path>   Write a trace of worker activity to the given file
+  --task_batch_byte_budget <bytes>
+                        Group sources smaller than this into shared tasks
+  --lex_chunk_size <bytes>
+                        Lex sources larger than this in parallel chunks
+  --parse_chunk_size <tokens>
+                        Parse sources with more tokens than this in parallel chunks
 )";
 
     const std::string_view options_help_page =
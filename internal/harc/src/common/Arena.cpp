@@ -0,0 +1,52 @@
+#include <harc/common/Arena.hpp>
+
+#include <algorithm>
+
+namespace harc {
+
+    //=====================================================
+    // Mutators
+    //=====================================================
+
+    void Arena::release() {
+        for (auto* entry = destructors; entry; entry = entry->previous) {
+            entry->destroy(entry->object);
+        }
+        destructors = nullptr;
+
+        while (blocks) {
+            auto* previous = blocks->previous;
+            ::operator delete(static_cast<void*>(blocks));
+            blocks = previous;
+        }
+
+        cursor = nullptr;
+        limit = nullptr;
+        used = 0;
+        reserved = 0;
+    }
+
+    //=====================================================
+    // Helper functions
+    //=====================================================
+
+    void* Arena::allocate_from_new_block(std::size_t size, std::size_t alignment) {
+        constexpr std::size_t header_size = sizeof(Block_header);
+
+        // Oversized requests get a block of their own rather than forcing the
+        // geometric growth to skip ahead
+        std::size_t block_size = std::max(next_block_size, header_size + size + alignment);
+        next_block_size = std::min(next_block_size * 2, max_block_size);
+
+        auto* memory = static_cast<std::byte*>(::operator new(block_size));
+        auto* header = ::new (memory) Block_header{blocks, block_size};
+        blocks = header;
+        reserved += block_size;
+
+        cursor = memory + header_size;
+        limit = memory + block_size;
+
+        return allocate(size, alignment);
+    }
+
+}
@@ -0,0 +1,23 @@
+#include <harc/common/Identifier_table.hpp>
+
+namespace harc {
+
+    std::uint32_t Identifier_table::intern(std::string_view text) {
+        auto [it, is_new] = ids.try_emplace(text, static_cast<std::uint32_t>(names.size()));
+        if (is_new) {
+            names.push_back(text);
+        }
+
+        return it->second;
+    }
+
+    std::uint32_t Identifier_table::find(std::string_view text) const {
+        auto it = ids.find(text);
+        if (it == ids.end()) {
+            return null_id;
+        }
+
+        return it->second;
+    }
+
+}
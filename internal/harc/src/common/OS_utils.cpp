@@ -88,7 +88,7 @@ namespace harc {
         #endif
     }
 
-    Binary_file_mapping map_binary_file(std::string_view file_path) {
+    Binary_file_mapping map_binary_file(std::string_view file_path, File_mapping_options options) {
         Binary_file_mapping ret{};
 
         #if HARC_POSIX
@@ -104,18 +104,39 @@ namespace harc {
 
         // Query and validate source file length
         struct stat file_statistics{};
-        stat(file_path.data(), &file_statistics);
+        if (fstat(fd, &file_statistics) == -1) {
+            close(fd);
+
+            ret.error_code = Error_code::INACCESSIBLE_SOURCE_FILE_PATH;
+            return ret;
+        }
+
+        // Empty files cannot be mapped
+        if (file_statistics.st_size == 0) {
+            close(fd);
+            return ret;
+        }
+
+        int flags = MAP_PRIVATE;
+        #if defined(MAP_POPULATE)
+        if (options.populate) {
+            flags |= MAP_POPULATE;
+        }
+        #endif
 
         // Memory map file contents
         char* mapping_ptr = static_cast<char*>(mmap(
             nullptr,
             file_statistics.st_size,
             PROT_READ,
-            MAP_PRIVATE,
+            flags,
             fd,
             0 // Offset
         ));
 
+        // The mapping remains valid after the descriptor is closed
+        close(fd);
+
         if (mapping_ptr == MAP_FAILED) {
             //TODO: Log error
 
@@ -123,6 +144,10 @@ namespace harc {
             return ret;
         }
 
+        if (options.sequential) {
+            madvise(mapping_ptr, file_statistics.st_size, MADV_SEQUENTIAL);
+        }
+
         ret.bytes = aul::Span<const std::byte>{
             reinterpret_cast<std::byte*>(mapping_ptr),
             std::size_t(file_statistics.st_size)
@@ -155,8 +180,8 @@ namespace harc {
         unmap_file(mapping.bytes);
     }
 
-    Text_file_mapping map_text_file(std::string_view file_path) {
-        auto result = map_binary_file(file_path);
+    Text_file_mapping map_text_file(std::string_view file_path, File_mapping_options options) {
+        auto result = map_binary_file(file_path, options);
 
         Text_file_mapping ret;
         ret.error_code = result.error_code;
@@ -178,4 +203,21 @@ namespace harc {
         unmap_file(mapping.text);
     }
 
+    std::uint64_t file_modification_time(std::string_view path) {
+        #if HARC_POSIX
+        struct stat file_statistics{};
+        if (stat(path.data(), &file_statistics) == -1) {
+            return 0;
+        }
+
+        return
+            std::uint64_t(file_statistics.st_mtim.tv_sec) * 1'000'000'000 +
+            std::uint64_t(file_statistics.st_mtim.tv_nsec);
+
+        #else
+        static_assert(false, "This function is not implemented for the target OS");
+
+        #endif
+    }
+
 }
@@ -0,0 +1,195 @@
+#include <harc/common/String_pool.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+
+namespace harc {
+
+    ///
+    /// Number of low bits of an ID which identify its shard
+    ///
+    constexpr std::uint32_t shard_bits = std::countr_zero(String_pool::shard_count);
+
+    ///
+    /// Number of IDs which each shard may assign. The last ID of the last
+    /// shard would be null_id, so it is never assigned.
+    ///
+    constexpr std::uint32_t max_shard_size = (std::uint64_t{1} << (32 - shard_bits)) - 1;
+
+    ///
+    /// Capacity of the first table of each shard
+    ///
+    constexpr std::size_t initial_table_capacity = 64;
+
+    ///
+    /// \param text Arbitrary string
+    /// \return Hash of text whose high bits select a shard and whose low
+    /// bits select a slot within that shard's table
+    std::uint64_t hash_of(std::string_view text) {
+        return std::uint64_t{std::hash<std::string_view>{}(text)} * 0x9e3779b97f4a7c15;
+    }
+
+    //=====================================================
+    // -ctors
+    //=====================================================
+
+    String_pool::String_pool():
+        shards(std::make_unique<Shard[]>(shard_count)) {}
+
+    //=====================================================
+    // Mutators
+    //=====================================================
+
+    std::uint32_t String_pool::intern(std::string_view text) {
+        auto hash = hash_of(text);
+        auto shard_index = static_cast<std::uint32_t>(hash >> (64 - shard_bits));
+        auto& shard = shards[shard_index];
+
+        // Most strings are already present, in which case no lock is needed
+        const auto* table = shard.table.load(std::memory_order_acquire);
+        if (table) {
+            if (const auto* entry = probe(*table, hash, text)) {
+                return entry->id;
+            }
+        }
+
+        std::lock_guard lock{shard.mutex};
+
+        // Another thread may have inserted the string since the first probe
+        table = shard.table.load(std::memory_order_relaxed);
+        if (table) {
+            if (const auto* entry = probe(*table, hash, text)) {
+                return entry->id;
+            }
+        }
+
+        auto local_index = shard.entry_count.load(std::memory_order_relaxed);
+        if (local_index == max_shard_size) {
+            return null_id;
+        }
+
+        auto* characters = static_cast<char*>(shard.arena.allocate(text.size(), 1));
+        if (!text.empty()) {
+            std::memcpy(characters, text.data(), text.size());
+        }
+
+        auto [chunk_index, offset] = locate(local_index);
+        auto* chunk = const_cast<Entry*>(shard.chunks[chunk_index].load(std::memory_order_relaxed));
+        if (!chunk) {
+            std::size_t chunk_size = std::size_t{first_chunk_size} << chunk_index;
+            chunk = static_cast<Entry*>(shard.arena.allocate(chunk_size * sizeof(Entry), alignof(Entry)));
+            std::uninitialized_default_construct_n(chunk, chunk_size);
+            shard.chunks[chunk_index].store(chunk, std::memory_order_release);
+        }
+
+        auto& entry = chunk[offset];
+        entry.hash = hash;
+        entry.text = std::string_view{characters, text.size()};
+        entry.id = (local_index << shard_bits) | shard_index;
+
+        shard.entry_count.store(local_index + 1, std::memory_order_release);
+
+        // Tables are kept at most half full so that probe sequences stay
+        // short. A full replacement includes the new entry.
+        if (!table || 2 * (local_index + 1) > table->capacity) {
+            auto capacity = table ? 2 * table->capacity : initial_table_capacity;
+            shard.table.store(create_table(shard, capacity), std::memory_order_release);
+        } else {
+            insert(*table, &entry);
+        }
+
+        return entry.id;
+    }
+
+    //=====================================================
+    // Accessors
+    //=====================================================
+
+    std::uint32_t String_pool::find(std::string_view text) const {
+        auto hash = hash_of(text);
+        const auto& shard = shards[hash >> (64 - shard_bits)];
+
+        const auto* table = shard.table.load(std::memory_order_acquire);
+        if (!table) {
+            return null_id;
+        }
+
+        const auto* entry = probe(*table, hash, text);
+        return entry ? entry->id : null_id;
+    }
+
+    std::string_view String_pool::text(std::uint32_t id) const {
+        const auto& shard = shards[id & (shard_count - 1)];
+
+        auto [chunk_index, offset] = locate(id >> shard_bits);
+        const auto* chunk = shard.chunks[chunk_index].load(std::memory_order_acquire);
+        return chunk[offset].text;
+    }
+
+    std::size_t String_pool::size() const {
+        std::size_t ret = 0;
+        for (std::uint32_t i = 0; i < shard_count; ++i) {
+            ret += shards[i].entry_count.load(std::memory_order_relaxed);
+        }
+
+        return ret;
+    }
+
+    //=====================================================
+    // Helper functions
+    //=====================================================
+
+    std::array<std::uint32_t, 2> String_pool::locate(std::uint32_t local_index) {
+        std::uint32_t chunk_index = std::bit_width(local_index / first_chunk_size + 1) - 1;
+        std::uint32_t chunk_begin = first_chunk_size * ((std::uint32_t{1} << chunk_index) - 1);
+        return {chunk_index, local_index - chunk_begin};
+    }
+
+    const String_pool::Entry* String_pool::probe(const Slot_table& table, std::uint64_t hash, std::string_view text) {
+        auto mask = table.capacity - 1;
+        for (auto i = hash & mask;; i = (i + 1) & mask) {
+            const auto* entry = table.slots[i].load(std::memory_order_acquire);
+            if (!entry) {
+                return nullptr;
+            }
+
+            if (entry->hash == hash && entry->text == text) {
+                return entry;
+            }
+        }
+    }
+
+    void String_pool::insert(const Slot_table& table, const Entry* entry) {
+        auto mask = table.capacity - 1;
+        auto i = entry->hash & mask;
+        while (table.slots[i].load(std::memory_order_relaxed)) {
+            i = (i + 1) & mask;
+        }
+
+        table.slots[i].store(entry, std::memory_order_release);
+    }
+
+    const String_pool::Slot_table* String_pool::create_table(Shard& shard, std::size_t capacity) {
+        auto* slots = static_cast<std::atomic<const Entry*>*>(shard.arena.allocate(
+            capacity * sizeof(std::atomic<const Entry*>),
+            alignof(std::atomic<const Entry*>)
+        ));
+
+        for (std::size_t i = 0; i < capacity; ++i) {
+            ::new (slots + i) std::atomic<const Entry*>{nullptr};
+        }
+
+        auto* ret = shard.arena.create<Slot_table>(Slot_table{slots, capacity});
+
+        auto entry_count = shard.entry_count.load(std::memory_order_relaxed);
+        for (std::uint32_t i = 0; i < entry_count; ++i) {
+            auto [chunk_index, offset] = locate(i);
+            insert(*ret, shard.chunks[chunk_index].load(std::memory_order_relaxed) + offset);
+        }
+
+        return ret;
+    }
+
+}
@@ -0,0 +1,515 @@
+#include <harc/parser/Flat_parse_tree.hpp>
+#include <harc/parser/Parse_tree.hpp>
+
+#include <algorithm>
+
+namespace harc::parser {
+
+    ///
+    /// Visitor which appends a node to a Flat_parse_tree for every node in
+    /// a pointer-based parse tree. Linked lists are collapsed into the
+    /// children of a single node.
+    ///
+    class Flattener : public Visitor {
+    public:
+
+        //=================================================
+        // -ctors
+        //=================================================
+
+        explicit Flattener(Flat_parse_tree& tree):
+            tree(tree) {}
+
+        //=================================================
+        // Visit methods
+        //=================================================
+
+        void visit(std::uint32_t token_index) override {
+            if (token_index == UINT32_MAX || open_nodes.empty()) {
+                return;
+            }
+
+            auto node = open_nodes.back();
+            tree.first_tokens[node] = std::min(tree.first_tokens[node], token_index);
+            tree.end_tokens[node] = std::max(tree.end_tokens[node], token_index + 1);
+        }
+
+        void visit(Parse_tree_node* node) override {
+            open(Node_type::GENERIC_NODE);
+            close();
+        }
+
+        void visit(Text* node) override {
+            open(Node_type::TEXT);
+            visit(node->text_token);
+            close();
+        }
+
+        void visit(Text_sequence* node) override {
+            // Elements become children of the enclosing node
+            for (auto* n = node; n; n = n->tail) {
+                child(n->head);
+                visit(n->comma_token);
+            }
+        }
+
+        void visit(Resolved_identifier* node) override {
+            open(Node_type::RESOLVED_IDENTIFIER);
+            for (auto* n = node; n; n = n->tail) {
+                child(n->head);
+                visit(n->dot_token);
+            }
+            close();
+        }
+
+        void visit(Identifier* node) override {
+            open(Node_type::IDENTIFIER);
+            for (Resolved_identifier* n = node; n; n = n->tail) {
+                child(n->head);
+                visit(n->dot_token);
+            }
+            child(node->name);
+            close();
+        }
+
+        void visit(Expression* node) override {
+            open(Node_type::EXPRESSION);
+            close();
+        }
+
+        void visit(Identifier_expression* node) override {
+            open(Node_type::IDENTIFIER_EXPRESSION);
+            child(node->identifier);
+            close();
+        }
+
+        void visit(Expression_list* node) override {
+            open(Node_type::EXPRESSION_LIST);
+            for (auto* n = node; n; n = n->tail) {
+                child(n->head);
+                visit(n->semicolon_token);
+            }
+            close();
+        }
+
+        void visit(Expression_sequence* node) override {
+            open(Node_type::EXPRESSION_SEQUENCE);
+            for (auto* n = node; n; n = n->tail) {
+                child(n->head);
+                visit(n->comma_token);
+            }
+            close();
+        }
+
+        void visit(Resolved_template* node) override {
+            open(Node_type::RESOLVED_TEMPLATE);
+            child(node->template_expression);
+            visit(node->l_template_bracket);
+            child(node->parameters);
+            visit(node->r_template_bracket);
+            close();
+        }
+
+        void visit(Numeric_literal_expression* node) override {
+            open(Node_type::NUMERIC_LITERAL_EXPRESSION);
+            visit(node->numeric_literal_token);
+            visit(node->colon_token);
+            child(node->type_expression);
+            close();
+        }
+
+        void visit(String_literal_expression* node) override {
+            open(Node_type::STRING_LITERAL_EXPRESSION);
+            visit(node->string_literal_token);
+            visit(node->colon_token);
+            child(node->type_expression);
+            close();
+        }
+
+        void visit(Codepoint_literal_expression* node) override {
+            open(Node_type::CODEPOINT_LITERAL_EXPRESSION);
+            visit(node->codepoint_literal_token);
+            visit(node->colon_token);
+            child(node->type_expression);
+            close();
+        }
+
+        void visit(Tuple_literal* node) override {
+            open(Node_type::TUPLE_LITERAL);
+            visit(node->l_curly_bracket_token);
+            child(node->expression_sequence);
+            visit(node->r_curly_bracket_token);
+            visit(node->colon_token);
+            child(node->type_expression);
+            close();
+        }
+
+        void visit(Parenthesized_expression* node) override {
+            open(Node_type::PARENTHESIZED_EXPRESSION);
+            visit(node->l_paren_token);
+            child(node->expression);
+            visit(node->r_paren_token);
+            close();
+        }
+
+        void visit(Unary_operator_expression* node) override {
+            open(Node_type::UNARY_OPERATOR_EXPRESSION);
+            visit(node->operator_token);
+            child(node->expression);
+            close();
+        }
+
+        void visit(Binary_operator_expression* node) override {
+            open(Node_type::BINARY_OPERATOR_EXPRESSION);
+            child(node->l_expression);
+            visit(node->operator_token);
+            child(node->r_expression);
+            close();
+        }
+
+        void visit(Binary_text_operator_expression* node) override {
+            open(Node_type::BINARY_TEXT_OPERATOR_EXPRESSION);
+            child(node->l_expression);
+            child(node->operator_text);
+            child(node->r_expression);
+            close();
+        }
+
+        void visit(Function_call* node) override {
+            open(Node_type::FUNCTION_CALL);
+            child(node->name);
+            visit(node->l_paren_token);
+            child(node->parameters);
+            visit(node->r_paren_token);
+            close();
+        }
+
+        void visit(Subscript_call* node) override {
+            open(Node_type::SUBSCRIPT_CALL);
+            child(node->name);
+            visit(node->l_square_bracket_token);
+            child(node->parameters);
+            visit(node->r_square_bracket_token);
+            close();
+        }
+
+        void visit(Statement* node) override {
+            open(Node_type::STATEMENT);
+            close();
+        }
+
+        void visit(If_statement* node) override {
+            open(Node_type::IF_STATEMENT);
+            child(node->if_keyword);
+            child(node->condition);
+            child(node->true_branch);
+            for (std::size_t i = 0; i < node->else_if_branches.size(); ++i) {
+                child(node->else_keywords[i]);
+                child(node->else_if_keywords[i]);
+                child(node->else_if_conditions[i]);
+                child(node->else_if_branches[i]);
+            }
+            child(node->else_keyword);
+            child(node->else_branch);
+            close();
+        }
+
+        void visit(While_statement* node) override {
+            open(Node_type::WHILE_STATEMENT);
+            child(node->while_keyword);
+            child(node->condition);
+            child(node->loop_body);
+            close();
+        }
+
+        void visit(For_loop* node) override {
+            open(Node_type::FOR_LOOP);
+            child(node->for_keyword);
+            child(node->initializers);
+            child(node->condition);
+            visit(node->semicolon_token);
+            child(node->incrementer);
+            child(node->loop_body);
+            close();
+        }
+
+        void visit(Ranged_for_loop* node) override {
+            open(Node_type::RANGED_FOR_LOOP);
+            child(node->for_keyword);
+            child(node->loop_variables);
+            child(node->in_keyword);
+            child(node->ranges);
+            child(node->loop_body);
+            close();
+        }
+
+        void visit(Do_while_loop* node) override {
+            open(Node_type::DO_WHILE_LOOP);
+            child(node->do_keyword);
+            child(node->code_body);
+            child(node->while_keyword);
+            child(node->condition);
+            visit(node->semicolon_token);
+            close();
+        }
+
+        void visit(Expression_statement* node) override {
+            open(Node_type::EXPRESSION_STATEMENT);
+            child(node->expression);
+            visit(node->semicolon_token);
+            close();
+        }
+
+        void visit(Return_statement* node) override {
+            open(Node_type::RETURN_STATEMENT);
+            child(node->return_keyword);
+            child(node->expression);
+            visit(node->semicolon_token);
+            close();
+        }
+
+        void visit(Variable_declaration* node) override {
+            open(Node_type::VARIABLE_DECLARATION);
+            child(node->var_keyword);
+            child(node->name);
+            visit(node->colon_token);
+            child(node->type);
+            visit(node->equals_token);
+            child(node->initializer);
+            visit(node->semicolon_token);
+            close();
+        }
+
+        void visit(Constant_declaration* node) override {
+            open(Node_type::CONSTANT_DECLARATION);
+            child(node->let_keyword);
+            child(node->name);
+            visit(node->colon_token);
+            child(node->type);
+            visit(node->equals_token);
+            child(node->initializer);
+            visit(node->semicolon_token);
+            close();
+        }
+
+        void visit(Module_declaration* node) override {
+            open(Node_type::MODULE_DECLARATION);
+            child(node->module_keyword);
+            child(node->module_name);
+            visit(node->semicolon_token);
+            close();
+        }
+
+        void visit(Attribute* node) override {
+            open(Node_type::ATTRIBUTE);
+            child(node->name);
+            visit(node->l_paren_token);
+            child(node->value);
+            visit(node->r_paren_token);
+            close();
+        }
+
+        void visit(Attribute_list_body* node) override {
+            // Elements become children of the enclosing attribute list
+            for (auto* n = node; n; n = n->tail) {
+                child(n->head);
+                visit(n->comma_token);
+            }
+        }
+
+        void visit(Attribute_list* node) override {
+            open(Node_type::ATTRIBUTE_LIST);
+            visit(node->l_square_bracket_token);
+            child(node->body);
+            visit(node->r_square_bracket_token);
+            close();
+        }
+
+        void visit(Statement_sequence* node) override {
+            // Elements become children of the enclosing node
+            for (auto* n = node; n; n = n->tail) {
+                child(n->head);
+            }
+        }
+
+        void visit(Code_body* node) override {
+            open(Node_type::CODE_BODY);
+            visit(node->l_curly_bracket);
+            child(node->statement_sequence);
+            visit(node->r_curly_bracket);
+            close();
+        }
+
+        void visit(Parameter* node) override {
+            open(Node_type::PARAMETER);
+            child(node->input_qualifier);
+            child(node->name);
+            visit(node->colon_token);
+            child(node->type);
+            close();
+        }
+
+        void visit(Parameter_sequence* node) override {
+            // Elements become children of the enclosing parameter list
+            for (auto* n = node; n; n = n->tail) {
+                child(n->head);
+                visit(n->comma_token);
+            }
+        }
+
+        void visit(Parameter_list* node) override {
+            open(Node_type::PARAMETER_LIST);
+            visit(node->l_paren);
+            child(node->parameter_sequence);
+            visit(node->r_paren);
+            close();
+        }
+
+        void visit(Source_body* node) override {
+            open(Node_type::SOURCE_BODY);
+            close();
+        }
+
+        void visit(Function_definition* node) override {
+            open(Node_type::FUNCTION_DEFINITION);
+            child(node->func_keyword);
+            child(node->attributes);
+            child(node->name);
+            visit(node->l_paren_token);
+            child(node->parameter_list);
+            visit(node->r_paren_token);
+            visit(node->arrow_token);
+            child(node->return_type);
+            visit(node->l_curly_bracket);
+            child(node->body);
+            visit(node->r_curly_bracket);
+            close();
+        }
+
+        void visit(Lambda* node) override {
+            open(Node_type::LAMBDA);
+            child(node->lambda_keyword);
+            child(node->attribute_list);
+            child(node->name);
+            visit(node->l_paren_token);
+            child(node->parameter_list);
+            visit(node->r_paren_token);
+            visit(node->arrow_token);
+            child(node->return_type);
+            visit(node->l_curly_bracket);
+            child(node->body);
+            visit(node->r_curly_bracket);
+            close();
+        }
+
+        void visit(Struct_definition* node) override {
+            open(Node_type::STRUCT_DEFINITION);
+            child(node->struct_keyword);
+            child(node->attribute_list);
+            close();
+        }
+
+        void visit(Alias_definition* node) override {
+            open(Node_type::ALIAS_DEFINITION);
+            child(node->alias_keyword);
+            child(node->attribute_list);
+            child(node->name);
+            visit(node->equals_token);
+            child(node->type);
+            visit(node->semicolon_token);
+            close();
+        }
+
+        void visit(Source_body_list* node) override {
+            open(Node_type::SOURCE_BODY_LIST);
+            for (auto* n = node; n; n = n->tail) {
+                child(n->head);
+            }
+            close();
+        }
+
+        void visit(Source_file* node) override {
+            open(Node_type::SOURCE_FILE);
+            child(node->module_declaration);
+            child(node->body);
+            close();
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        Flat_parse_tree& tree;
+
+        ///
+        /// Nodes whose children are currently being appended
+        ///
+        std::vector<std::uint32_t> open_nodes;
+
+        ///
+        /// Most recently appended child of each node in open_nodes
+        ///
+        std::vector<std::uint32_t> last_children;
+
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        template<class T>
+        void child(T* node) {
+            if (node) {
+                node->accept(*this);
+            }
+        }
+
+        void open(Node_type type) {
+            auto node = tree.append(type);
+
+            if (!open_nodes.empty()) {
+                auto& last = last_children.back();
+                if (last == Flat_parse_tree::null_index) {
+                    tree.first_children[open_nodes.back()] = node;
+                } else {
+                    tree.next_siblings[last] = node;
+                }
+                last = node;
+            }
+
+            open_nodes.push_back(node);
+            last_children.push_back(Flat_parse_tree::null_index);
+        }
+
+        void close() {
+            auto node = open_nodes.back();
+            open_nodes.pop_back();
+            last_children.pop_back();
+
+            if (tree.first_tokens[node] == UINT32_MAX) {
+                tree.first_tokens[node] = 0;
+                tree.end_tokens[node] = 0;
+                return;
+            }
+
+            if (!open_nodes.empty()) {
+                auto parent = open_nodes.back();
+                tree.first_tokens[parent] = std::min(tree.first_tokens[parent], tree.first_tokens[node]);
+                tree.end_tokens[parent] = std::max(tree.end_tokens[parent], tree.end_tokens[node]);
+            }
+        }
+
+    };
+
+    Flat_parse_tree flatten(Parse_tree_node* root) {
+        Flat_parse_tree ret{};
+        if (!root) {
+            return ret;
+        }
+
+        Flattener flattener{ret};
+        root->accept(flattener);
+        return ret;
+    }
+
+}
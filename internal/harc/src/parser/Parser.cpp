@@ -3,11 +3,12 @@
 #include <harc/lexer/Tokens.hpp>
 #include <harc/Error_reporting.hpp>
 
+#include <algorithm>
+#include <string>
 #include <vector>
 
 namespace harc::parser {
 
-    /*
     class Parser {
     public:
 
@@ -15,27 +16,127 @@ namespace harc::parser {
         // -ctors
         //=================================================
 
-        explicit Parser(Translation_unit& unit):
-            unit(unit),
-            token_index(0),
-            end_index(unit.tokenization.types.size()) {}
+        explicit Parser(Translation_unit& unit, Body_parsing body_parsing = Body_parsing::EAGER):
+            Parser(unit, 0, unit.tokens.size()) {
+
+            if (body_parsing == Body_parsing::DEFERRED) {
+                deferred_bodies = &unit.parse_tree.deferred_bodies;
+            }
+        }
+
+        ///
+        /// \param unit Translation unit to parse
+        /// \param begin Index of first token to parse
+        /// \param end Index one past last token to parse
+        Parser(Translation_unit& unit, std::uint32_t begin, std::uint32_t end):
+            source_path(unit.source_path),
+            source(unit.source),
+            tokens(unit.tokens),
+            arena(unit.parse_tree.arena),
+            identifiers(unit.identifiers),
+            message_buffer(unit.parse_tree.message_buffer),
+            token_index(begin),
+            end_index(end) {}
+
+        ///
+        /// Creates a parser which only writes to chunk and refers to no
+        /// translation unit
+        ///
+        /// \param source_path Path of source which chunk belongs to
+        /// \param tokens Tokens of the source which chunk belongs to
+        /// \param chunk Object to hold the results of parsing a chunk
+        Parser(std::string_view source_path, const lex::Tokenization_view& tokens, Chunk_parse& chunk):
+            source_path(source_path),
+            source(tokens.source),
+            tokens(tokens),
+            arena(chunk.arena),
+            identifiers(chunk.identifiers),
+            message_buffer(chunk.message_buffer),
+            texts(&chunk.texts),
+            token_index(chunk.chunk.begin),
+            end_index(chunk.chunk.end) {}
 
         //=================================================
         // Mutators
         //=================================================
 
-        Error_code parse() {
-            unit.parse_tree.root = parse_source_file();
+        Source_file* parse() {
+            return parse_source_file();
+        }
+
+        Error_code error() const {
+            return error_code;
+        }
+
+        ///
+        /// Parses declarations which span the parser's tokens
+        ///
+        /// \param chunk Object to place results into
+        void parse_chunk(Chunk_parse& chunk) {
+            chunk.body = parse_source_body_list();
+
+            if (token_index != end_index && error_code == Error_code::NO_ERROR) {
+                report_parsing_error("Expected function or alias definition");
+            }
+
+            chunk.error_code = error_code;
+        }
+
+        ///
+        /// \param function Function whose body spans the parser's tokens
+        /// \return Error code
+        Error_code parse_body(Function_definition& function) {
+            function.body = parse_code_body(true);
             return error_code;
         }
 
+        Parse_tree_node* parse_standalone_expression() {
+            auto* ret = parse_expression(true);
+
+            if (token_index != end_index && error_code == Error_code::NO_ERROR) {
+                report_parsing_error("Expected end of expression");
+            }
+
+            return ret;
+        }
+
     private:
 
         //=================================================
         // Instance members
         //=================================================
 
-        Translation_unit& unit;
+        std::string_view source_path;
+
+        std::string_view source;
+
+        lex::Tokenization_view tokens;
+
+        ///
+        /// Storage for created nodes
+        ///
+        Arena& arena;
+
+        ///
+        /// Table in which the text of created Text nodes is interned
+        ///
+        Identifier_table& identifiers;
+
+        ///
+        /// Buffer to report errors to
+        ///
+        Message_buffer& message_buffer;
+
+        ///
+        /// If non-null, function bodies are skipped and their functions
+        /// are appended to this list instead
+        ///
+        std::vector<Function_definition*>* deferred_bodies = nullptr;
+
+        ///
+        /// If non-null, receives every created Text node
+        ///
+        std::vector<Text*>* texts = nullptr;
 
         std::uint32_t token_index = 0;
 
@@ -47,46 +148,23 @@ namespace harc::parser {
         // Parsing functions
         //=================================================
 
-        Text* parse_text(std::string_view expected, bool is_required) {
+        Text* parse_text(Keyword expected, bool is_required) {
             if (token_index == end_index) {
                 return nullptr;
             }
 
-            if (!expected.empty()) {
-                if (unit.tokenization.types[token_index] != Token_type::TEXT) {
+            if (current_keyword() != expected) {
+                if (is_required) {
                     std::string message = "Expected \"";
-                    message.append(expected);
+                    message.append(to_string(expected));
                     message.push_back('\"');
                     report_parsing_error(message);
-                    return nullptr;
                 }
 
-                std::string_view view{
-                    unit.source.data() + unit.tokenization.source_indices[token_index],
-                    unit.tokenization.lengths[token_index]
-                };
-
-                if (view != expected) {
-                    if (is_required) {
-                        std::string message = "Expected \"";
-                        message.append(expected);
-                        message.push_back('\"');
-                        report_parsing_error(message);
-                    }
-
-                    return nullptr;
-                }
+                return nullptr;
             }
 
-            auto ret = new Text();
-
-            ret->text_token = token_index;
-            ++token_index;
-            return ret;
-        }
-
-        Text* parse_text(const char* expected, bool is_required) {
-            return parse_text(std::string_view{expected}, is_required);
+            return create_text();
         }
 
         Text* parse_text(bool is_required) {
@@ -94,19 +172,15 @@ namespace harc::parser {
                 return nullptr;
             }
 
-            if (is_required) {
-                if (unit.tokenization.types[token_index] != Token_type::TEXT) {
-                    std::string message = "Expected textual token.";
-                    report_parsing_error(message);
-                    return nullptr;
+            if (current_token_type() != Token_type::TEXT) {
+                if (is_required) {
+                    report_parsing_error("Expected textual token.");
                 }
-            }
 
-            auto ret = new Text();
+                return nullptr;
+            }
 
-            ret->text_token = token_index;
-            ++token_index;
-            return ret;
+            return create_text();
         }
 
         Resolved_identifier* parse_resolved_identifier(bool is_required) {
@@ -114,17 +188,15 @@ namespace harc::parser {
                 return nullptr;
             }
 
-            auto* ret = new Resolved_identifier();
-            ret->head = parse_text(is_required);
-
-            if (!ret->head) {
-                report_parsing_error("Expected textual token.");
-
-                delete ret;
+            auto* head = parse_text(is_required);
+            if (!head) {
                 return nullptr;
             }
 
-            if (unit.tokenization.types[token_index] != Token_type::PERIO) {
+            auto* ret = create<Resolved_identifier>();
+            ret->head = head;
+
+            if (current_token_type() != Token_type::SPACED_PERIOD) {
                 return ret;
             }
             ret->dot_token = token_index;
@@ -133,61 +205,218 @@ namespace harc::parser {
             ret->tail = parse_resolved_identifier(true);
             if (!ret->tail) {
                 report_parsing_error("Expected rest of resolved identifier.");
-
-                delete ret;
                 return nullptr;
             }
 
             return ret;
         }
 
+        ///
+        /// Parses an expression by precedence climbing. Operators are
+        /// classified through the constexpr tables in Operators.hpp and
+        /// nodes come from the parse tree's arena, so nothing else is
+        /// allocated. Runs of operators which bind no more tightly than
+        /// their left operand are consumed in a loop, so recursion only
+        /// deepens for tighter operators and nested brackets.
+        ///
         Expression* parse_expression(bool is_required) {
+            return parse_expression(loosest_precedence, is_required);
+        }
+
+        ///
+        /// \param limit Precedence of the most loosely binding operator
+        /// which may be consumed
+        /// \param is_required True if an error should be reported when no
+        /// expression is present
+        /// \return Expression. Null on failure.
+        Expression* parse_expression(std::uint32_t limit, bool is_required) {
             if (token_index == end_index) {
+                if (is_required) {
+                    report_parsing_error("Expected expression");
+                }
+
                 return nullptr;
             }
 
-            auto* ret = new Expression();
-
-            std::vector<Expression*> operand_stack;
-            std::vector<Token_type> unary_operator_stack;
-            std::vector<Token_type> binary_operator_stack;
+            auto* ret = parse_unary_operator_expression(is_required);
+            if (!ret) {
+                return nullptr;
+            }
 
-            //Utilize variant of Shunting Yard algorithm
             while (true) {
-                auto curr = current_token_type();
+                if (current_token_type() == Token_type::TEXT) {
+                    auto binding = text_operator_binding(current_keyword());
+                    if (binding.precedence == 0 || binding.precedence > limit) {
+                        return ret;
+                    }
+
+                    ret = parse_binary_text_operator_expression(ret, binding);
+                } else {
+                    const auto& binding = infix_operator_table[static_cast<std::uint8_t>(current_token_type())];
+                    if (binding.precedence == 0 || binding.precedence > limit) {
+                        return ret;
+                    }
 
-                if (is_unary_operator(current_token_type())) {
-                    unary_operator_stack.push_back(current_token_type());
-                    continue;
+                    ret = parse_binary_operator_expression(ret, binding);
                 }
 
-                if (unit.tokenization.types[token_index] == Token_type::L_PAREN) {
+                if (!ret) {
+                    return nullptr;
+                }
+            }
+        }
 
-                    continue;
+        ///
+        /// \return An operand without any infix operators, e.g. a literal,
+        /// identifier, or parenthesized expression
+        Expression* parse_primary_expression(bool is_required) {
+            if (token_index == end_index) {
+                if (is_required) {
+                    report_parsing_error("Expected expression");
                 }
 
-                if (unit.tokenization.types[token_index] == Token_type::TEXT && unit.token_source(token_index) == "lambda") {
-                    operand_stack.push_back(parse_lambda(true));
-                    continue;
+                return nullptr;
+            }
+
+            switch (current_token_type()) {
+                case Token_type::NUMERIC_LITERAL:
+                    return parse_numeric_literal_expression(is_required);
+                case Token_type::STRING_LITERAL:
+                    return parse_string_literal_expression(is_required);
+                case Token_type::CODEPOINT_LITERAL:
+                    return parse_codepoint_literal_expression(is_required);
+                case Token_type::LEFT_PARENTHESIS:
+                    return parse_parenthesized_expression(is_required);
+                case Token_type::LEFT_CURLY_BRACKET:
+                    return parse_tuple_literal();
+                case Token_type::TEXT:
+                    if (current_keyword() == Keyword::LAMBDA) {
+                        return parse_lambda(is_required);
+                    }
+
+                    if (current_keyword() == Keyword::NONE) {
+                        return parse_identifier_expression(is_required);
+                    }
+                    break;
+                default:
+                    break;
+            }
+
+            if (is_required) {
+                report_parsing_error("Expected expression");
+            }
+
+            return nullptr;
+        }
+
+        Identifier_expression* parse_identifier_expression(bool is_required) {
+            auto* identifier = parse_resolved_identifier(is_required);
+            if (!identifier) {
+                return nullptr;
+            }
+
+            auto* ret = create<Identifier_expression>();
+            ret->identifier = identifier;
+
+            return ret;
+        }
+
+        ///
+        /// \return A primary expression followed by any number of postfix
+        /// operators, function calls, subscripts, template arguments, and
+        /// member accesses
+        Expression* parse_postfix_expression(bool is_required) {
+            auto* ret = parse_primary_expression(is_required);
+
+            while (ret) {
+                switch (current_token_type()) {
+                    case Token_type::LEFT_PARENTHESIS:
+                        ret = parse_function_call(ret);
+                        break;
+                    case Token_type::LEFT_SQUARE_BRACKET:
+                        ret = parse_subscript_call(ret);
+                        break;
+                    case Token_type::LEFT_TEMPLATE_BRACKET:
+                        ret = parse_resolved_template(ret);
+                        break;
+                    case Token_type::SPACED_PERIOD:
+                        ret = parse_member_access(ret);
+                        break;
+                    default: {
+                        const auto& binding = postfix_operator_table[static_cast<std::uint8_t>(current_token_type())];
+                        if (binding.precedence == 0) {
+                            return ret;
+                        }
+
+                        auto* unary = create<Unary_operator_expression>();
+                        unary->operator_token = token_index;
+                        unary->expression = ret;
+                        token_index += 1;
+
+                        ret = unary;
+                        break;
+                    }
                 }
+            }
+
+            return ret;
+        }
 
-                if (is_binary_operator(current_token_type())) {
+        Function_call* parse_function_call(Expression* name) {
+            auto* ret = create<Function_call>();
+            ret->name = name;
+            ret->l_paren_token = token_index;
+            token_index += 1;
 
+            if (current_token_type() != Token_type::RIGHT_PARENTHESIS) {
+                ret->parameters = parse_expression_sequence(true);
+                if (!ret->parameters) {
+                    return nullptr;
                 }
+            }
 
-                increment_token();
+            if (current_token_type() != Token_type::RIGHT_PARENTHESIS) {
+                report_parsing_error("Expected ) to close function call");
+                return nullptr;
+            }
+            ret->r_paren_token = token_index;
+            token_index += 1;
 
-                auto next = current_token_type();
+            return ret;
+        }
 
-                // Check for function call
-                if (curr == Token_type::TEXT && next == Token_type::L_PAREN) {
+        Subscript_call* parse_subscript_call(Expression* name) {
+            auto* ret = create<Subscript_call>();
+            ret->name = name;
+            ret->l_square_bracket_token = token_index;
+            token_index += 1;
 
-                }
+            ret->parameters = parse_expression_sequence(true);
+            if (!ret->parameters) {
+                return nullptr;
+            }
 
-                break;
+            if (current_token_type() != Token_type::RIGHT_SQUARE_BRACKET) {
+                report_parsing_error("Expected ] to close subscript");
+                return nullptr;
             }
+            ret->r_square_bracket_token = token_index;
+            token_index += 1;
+
+            return ret;
+        }
 
-            //TODO: Reconstruct parse tree
+        Binary_operator_expression* parse_member_access(Expression* object) {
+            auto* ret = create<Binary_operator_expression>();
+            ret->l_expression = object;
+            ret->operator_token = token_index;
+            token_index += 1;
+
+            ret->r_expression = parse_identifier_expression(true);
+            if (!ret->r_expression) {
+                report_parsing_error("Expected member name");
+                return nullptr;
+            }
 
             return ret;
         }
@@ -197,18 +426,15 @@ namespace harc::parser {
                 return nullptr;
             }
 
-            auto* ret = new Expression_list();
-            ret->head = parse_expression(is_required);
-            if (!ret->head) {
-                if (is_required) {
-                    report_parsing_error("Expected expression");
-                }
-
-                delete ret;
+            auto* head = parse_expression(is_required);
+            if (!head) {
                 return nullptr;
             }
 
-            if (unit.tokenization.types[token_index] != Token_type::SEMICOLON) {
+            auto* ret = create<Expression_list>();
+            ret->head = head;
+
+            if (current_token_type() != Token_type::SEMICOLON) {
                 return ret;
             }
             ret->semicolon_token = token_index;
@@ -219,64 +445,120 @@ namespace harc::parser {
             return ret;
         }
 
+        ///
+        /// Parses comma-separated expressions. The list is built in a loop
+        /// rather than by recursion so that long argument lists cannot
+        /// deepen the call stack.
+        ///
         Expression_sequence* parse_expression_sequence(bool is_required) {
             if (token_index == end_index) {
                 return nullptr;
             }
 
+            auto* head = parse_expression(is_required);
+            if (!head) {
+                return nullptr;
+            }
 
-            //TODO: Implement
-            return nullptr;
-        }
+            auto* ret = create<Expression_sequence>();
+            ret->head = head;
 
-        Type_expression* parse_type_expression(bool is_required) {
-            if (token_index == end_index) {
-                return nullptr;
+            auto* last = ret;
+            while (current_token_type() == Token_type::COMMA) {
+                last->comma_token = token_index;
+                token_index += 1;
+
+                auto* next = create<Expression_sequence>();
+                next->head = parse_expression(true);
+                if (!next->head) {
+                    return nullptr;
+                }
+
+                last->tail = next;
+                last = next;
             }
 
-            //TODO: Implement
-            return nullptr;
+            return ret;
         }
 
-        Resolved_template* parse_resolved_template(bool is_required) {
+        ///
+        /// Types are parsed as postfix expressions, e.g. core.Array<i32>,
+        /// and are only told apart from values by later passes. An empty
+        /// pair of parentheses denotes the unit type.
+        ///
+        Expression* parse_type_expression(bool is_required) {
             if (token_index == end_index) {
+                if (is_required) {
+                    report_parsing_error("Expected type");
+                }
+
                 return nullptr;
             }
 
-            //TODO: Implement
-            return nullptr;
+            if (
+                current_token_type() == Token_type::LEFT_PARENTHESIS &&
+                next_token_type() == Token_type::RIGHT_PARENTHESIS
+            ) {
+                auto* ret = create<Parenthesized_expression>();
+                ret->l_paren_token = token_index;
+                ret->r_paren_token = token_index + 1;
+                token_index += 2;
+
+                return ret;
+            }
+
+            return parse_postfix_expression(is_required);
         }
 
+        Resolved_template* parse_resolved_template(Expression* template_expression) {
+            auto* ret = create<Resolved_template>();
+            ret->template_expression = template_expression;
+            ret->l_template_bracket = token_index;
+            token_index += 1;
+
+            if (current_token_type() != Token_type::RIGHT_TEMPLATE_BRACKET) {
+                ret->parameters = parse_expression_sequence(true);
+                if (!ret->parameters) {
+                    return nullptr;
+                }
+            }
+
+            if (current_token_type() != Token_type::RIGHT_TEMPLATE_BRACKET) {
+                report_parsing_error("Expected > to close template arguments");
+                return nullptr;
+            }
+            ret->r_template_bracket = token_index;
+            token_index += 1;
 
+            return ret;
+        }
 
         Numeric_literal_expression* parse_numeric_literal_expression(bool is_required) {
             if (token_index == end_index) {
                 return nullptr;
             }
 
-            auto* ret = new Numeric_literal_expression();
-
-            if (unit.tokenization.types[token_index] != Token_type::NUMERIC_LITERAL) {
+            if (current_token_type() != Token_type::NUMERIC_LITERAL) {
                 if (is_required) {
                     report_parsing_error("Expected numeric literal.");
                 }
 
-                delete ret;
                 return nullptr;
             }
+
+            auto* ret = create<Numeric_literal_expression>();
             ret->numeric_literal_token = token_index;
             token_index += 1;
 
-            if (unit.tokenization.types[token_index] != Token_type::COLON) {
+            if (current_token_type() != Token_type::COLON) {
                 return ret;
             }
             ret->colon_token = token_index;
             token_index += 1;
 
-            ret->type_expression = parse_expression(true);
+            ret->type_expression = parse_postfix_expression(true);
             if (!ret->type_expression) {
                 report_parsing_error("Expected type suffix after numeric literal.");
-                delete ret;
                 return nullptr;
             }
 
@@ -288,29 +570,27 @@ namespace harc::parser {
                 return nullptr;
             }
 
-            auto* ret = new String_literal_expression();
-
-            if (unit.tokenization.types[token_index] != Token_type::STRING_LITERAL) {
+            if (current_token_type() != Token_type::STRING_LITERAL) {
                 if (is_required) {
                     report_parsing_error("Expected string literal");
                 }
 
-                delete ret;
                 return nullptr;
             }
+
+            auto* ret = create<String_literal_expression>();
             ret->string_literal_token = token_index;
             token_index += 1;
 
-            if (unit.tokenization.types[token_index] != Token_type::COLON) {
+            if (current_token_type() != Token_type::COLON) {
                 return ret;
             }
             ret->colon_token = token_index;
             token_index += 1;
 
-            ret->type_expression = parse_expression(true);
+            ret->type_expression = parse_postfix_expression(true);
             if (!ret->type_expression) {
                 report_parsing_error("Expected type suffix after string literal.");
-                delete ret;
                 return nullptr;
             }
 
@@ -322,43 +602,72 @@ namespace harc::parser {
                 return nullptr;
             }
 
-            auto* ret = new Codepoint_literal_expression();
-
-            if (unit.tokenization.types[token_index] != Token_type::CHAR_LITERAL) {
+            if (current_token_type() != Token_type::CODEPOINT_LITERAL) {
                 if (is_required) {
                     report_parsing_error("Expected codepoint literal");
                 }
 
-                delete ret;
                 return nullptr;
             }
+
+            auto* ret = create<Codepoint_literal_expression>();
             ret->codepoint_literal_token = token_index;
             token_index += 1;
 
-            if (unit.tokenization.types[token_index] != Token_type::COLON) {
+            if (current_token_type() != Token_type::COLON) {
                 return ret;
             }
             ret->colon_token = token_index;
             token_index += 1;
 
-            ret->type_expression = parse_expression(true);
+            ret->type_expression = parse_postfix_expression(true);
             if (!ret->type_expression) {
                 report_parsing_error("Expected type suffix after codepoint literal.");
-                delete ret;
                 return nullptr;
             }
 
-            ret->type_expression = parse_expression(true);
-
             return ret;
         }
 
-        Tuple_literal* parse_tuple_literal(bool is_required) {
-            if (token_index == end_index) {
+        ///
+        /// Parses a brace-enclosed, possibly empty, sequence of expressions
+        /// with an optional type suffix, e.g. {a, b}:Pair. Only reached in
+        /// expression position since a statement beginning with { is a
+        /// code body.
+        ///
+        /// \return Tuple literal. Null on failure.
+        Tuple_literal* parse_tuple_literal() {
+            auto* ret = create<Tuple_literal>();
+            ret->l_curly_bracket_token = token_index;
+            token_index += 1;
+
+            if (current_token_type() != Token_type::RIGHT_CURLY_BRACKET) {
+                ret->expression_sequence = parse_expression_sequence(true);
+                if (!ret->expression_sequence) {
+                    return nullptr;
+                }
+            }
+
+            if (current_token_type() != Token_type::RIGHT_CURLY_BRACKET) {
+                report_parsing_error("Expected } to close tuple literal");
                 return nullptr;
             }
+            ret->r_curly_bracket_token = token_index;
+            token_index += 1;
 
-            return nullptr;
+            if (current_token_type() != Token_type::COLON) {
+                return ret;
+            }
+            ret->colon_token = token_index;
+            token_index += 1;
+
+            ret->type_expression = parse_postfix_expression(true);
+            if (!ret->type_expression) {
+                report_parsing_error("Expected type suffix after tuple literal.");
+                return nullptr;
+            }
+
+            return ret;
         }
 
         Parenthesized_expression* parse_parenthesized_expression(bool is_required) {
@@ -366,31 +675,107 @@ namespace harc::parser {
                 return nullptr;
             }
 
-            return nullptr;
+            if (current_token_type() != Token_type::LEFT_PARENTHESIS) {
+                if (is_required) {
+                    report_parsing_error("Expected (");
+                }
+
+                return nullptr;
+            }
+
+            auto* ret = create<Parenthesized_expression>();
+            ret->l_paren_token = token_index;
+            token_index += 1;
+
+            ret->expression = parse_expression(true);
+            if (!ret->expression) {
+                return nullptr;
+            }
+
+            if (current_token_type() != Token_type::RIGHT_PARENTHESIS) {
+                report_parsing_error("Expected ) to close parenthesized expression");
+                return nullptr;
+            }
+            ret->r_paren_token = token_index;
+            token_index += 1;
+
+            return ret;
         }
 
-        Unary_operator_expression* parse_unary_operator_expression(bool is_required) {
-            if (token_index == end_index) {
+        ///
+        /// \return A postfix expression preceded by any number of prefix
+        /// operators. Prefix operators bind less tightly than postfix ones,
+        /// so -a++ is -(a++).
+        Expression* parse_unary_operator_expression(bool is_required) {
+            const auto& binding = prefix_operator_table[static_cast<std::uint8_t>(current_token_type())];
+            if (binding.precedence == 0) {
+                return parse_postfix_expression(is_required);
+            }
+
+            auto* ret = create<Unary_operator_expression>();
+            ret->operator_token = token_index;
+            token_index += 1;
+
+            ret->expression = parse_unary_operator_expression(true);
+            if (!ret->expression) {
                 return nullptr;
             }
 
-            return nullptr;
+            return ret;
         }
 
-        Binary_operator_expression* parse_binary_operator_expression(bool is_required) {
-            if (token_index == end_index) {
+        ///
+        /// \param l_expression Left operand, already parsed
+        /// \param binding Binding of the current token as an infix operator
+        /// \return Binary expression. Null on failure.
+        Binary_operator_expression* parse_binary_operator_expression(
+            Expression* l_expression,
+            const Operator_binding& binding
+        ) {
+            auto* ret = create<Binary_operator_expression>();
+            ret->l_expression = l_expression;
+            ret->operator_token = token_index;
+            token_index += 1;
+
+            // A left-associative operator's right operand may only contain
+            // operators which bind more tightly than it does
+            auto limit = binding.precedence;
+            if (binding.associativity == Associativity::LEFT) {
+                limit -= 1;
+            }
+
+            ret->r_expression = parse_expression(limit, true);
+            if (!ret->r_expression) {
                 return nullptr;
             }
 
-            return nullptr;
+            return ret;
         }
 
-        Binary_text_operator_expression* parse_binary_text_operator(bool is_required) {
-            if (token_index == end_index) {
+        ///
+        /// \param l_expression Left operand, already parsed
+        /// \param binding Binding of the current token's text as an infix
+        /// operator, e.g. as, is, or in
+        /// \return Binary expression. Null on failure.
+        Binary_text_operator_expression* parse_binary_text_operator_expression(
+            Expression* l_expression,
+            const Operator_binding& binding
+        ) {
+            auto* ret = create<Binary_text_operator_expression>();
+            ret->l_expression = l_expression;
+            ret->operator_text = create_text();
+
+            auto limit = binding.precedence;
+            if (binding.associativity == Associativity::LEFT) {
+                limit -= 1;
+            }
+
+            ret->r_expression = parse_expression(limit, true);
+            if (!ret->r_expression) {
                 return nullptr;
             }
 
-            return nullptr;
+            return ret;
         }
 
         Attribute* parse_attribute(bool is_required) {
@@ -398,35 +783,33 @@ namespace harc::parser {
                 return nullptr;
             }
 
-            auto* ret = new Attribute();
-            ret->name = parse_text(is_required);
-            if (!ret->name) {
-                if (is_required) {
-                    report_parsing_error("Expected attribute name");
-                }
-
-                delete ret;
+            auto* name = parse_text(is_required);
+            if (!name) {
                 return nullptr;
             }
 
-            if (unit.tokenization.types[token_index] != Token_type::L_PAREN) {
+            auto* ret = create<Attribute>();
+            ret->name = name;
+
+            if (current_token_type() != Token_type::LEFT_PARENTHESIS) {
                 return ret;
             }
             ret->l_paren_token = token_index;
             token_index += 1;
 
             ret->value = parse_expression(true);
+            if (!ret->value) {
+                return nullptr;
+            }
 
-            if (unit.tokenization.types[token_index] != Token_type::R_PAREN) {
+            if (current_token_type() != Token_type::RIGHT_PARENTHESIS) {
                 report_parsing_error("Expected ) to close attribute specification");
-
-                delete ret;
                 return nullptr;
             }
             ret->r_paren_token = token_index;
             token_index += 1;
 
-            return nullptr;
+            return ret;
         }
 
         Attribute_list_body* parse_attribute_list_body(bool is_required) {
@@ -434,18 +817,19 @@ namespace harc::parser {
                 return nullptr;
             }
 
-            auto* ret = new Attribute_list_body();
-            ret->head = parse_attribute(false);
-            if (!ret->head) {
+            auto* head = parse_attribute(false);
+            if (!head) {
                 if (is_required) {
                     report_parsing_error("Expected attribute");
                 }
 
-                delete ret;
                 return nullptr;
             }
 
-            if (unit.tokenization.types[token_index] != Token_type::COMMA) {
+            auto* ret = create<Attribute_list_body>();
+            ret->head = head;
+
+            if (current_token_type() != Token_type::COMMA) {
                 return ret;
             }
             ret->comma_token = token_index;
@@ -461,214 +845,824 @@ namespace harc::parser {
                 return nullptr;
             }
 
-            auto* ret = new Attribute_list();
-
-            if (unit.tokenization.types[token_index] != Token_type::L_SQUARE_BRACKET) {
+            if (current_token_type() != Token_type::LEFT_SQUARE_BRACKET) {
                 if (is_required) {
                     report_parsing_error("Expected [ as opening for attribute list");
                 }
 
-                delete ret;
                 return nullptr;
             }
+
+            auto* ret = create<Attribute_list>();
+            ret->l_square_bracket_token = token_index;
             token_index += 1;
 
             ret->body = parse_attribute_list_body(false);
 
-            if (unit.tokenization.types[token_index] != Token_type::L_SQUARE_BRACKET) {
-                if (is_required) {
-                    report_parsing_error("Expected ] as closing for attribute list");
-                }
-
-                delete ret;
+            if (current_token_type() != Token_type::RIGHT_SQUARE_BRACKET) {
+                report_parsing_error("Expected ] as closing for attribute list");
                 return nullptr;
             }
+            ret->r_square_bracket_token = token_index;
             token_index += 1;
 
             return ret;
         }
 
-        Parameter_list* parse_parameter_list(bool is_required) {
-            //TODO: Implement
-            return nullptr;
-        }
-
-        Function_definition* parse_function_definition(bool is_required) {
+        Parameter* parse_parameter(bool is_required) {
             if (token_index == end_index) {
                 return nullptr;
             }
 
-            auto* ret = new Function_definition();
-            if (unit.tokenization.types[token_index] != Token_type::TEXT) {
-                if (is_required) {
-                    report_parsing_error("Expected func keyword");
-                }
-
-                delete ret;
+            auto* name = parse_text(is_required);
+            if (!name) {
                 return nullptr;
             }
-            token_index += 1;
-
-            ret->attributes = parse_attribute_list(false);
 
-            ret->name = parse_text(true);
-            if (!ret->name) {
-                report_parsing_error("Expected function name");
+            auto* ret = create<Parameter>();
+            ret->name = name;
 
-                delete ret;
+            if (current_token_type() != Token_type::COLON) {
+                report_parsing_error("Expected : after parameter name");
                 return nullptr;
             }
+            ret->colon_token = token_index;
+            token_index += 1;
 
-            if (unit.tokenization.types[token_index] != Token_type::L_PAREN) {
-                report_parsing_error("Expected opening ( for function parameter list");
+            ret->type = parse_type_expression(true);
+            if (!ret->type) {
+                return nullptr;
+            }
+
+            return ret;
+        }
 
-                delete ret;
+        Parameter_sequence* parse_parameter_sequence(bool is_required) {
+            if (token_index == end_index) {
                 return nullptr;
             }
-            token_index += 1;
 
-            ret->parameter_list = parse_parameter_list(false);
+            auto* head = parse_parameter(is_required);
+            if (!head) {
+                return nullptr;
+            }
+
+            auto* ret = create<Parameter_sequence>();
+            ret->head = head;
+
+            auto* last = ret;
+            while (current_token_type() == Token_type::COMMA) {
+                last->comma_token = token_index;
+                token_index += 1;
+
+                auto* next = create<Parameter_sequence>();
+                next->head = parse_parameter(true);
+                if (!next->head) {
+                    return nullptr;
+                }
+
+                last->tail = next;
+                last = next;
+            }
 
-            if (unit.tokenization.types[token_index] != Token_type::R_PAREN) {
-                report_parsing_error("Expected closing ) for function parameter list");
+            return ret;
+        }
 
-                delete ret;
+        Parameter_list* parse_parameter_list(bool is_required) {
+            if (token_index == end_index) {
                 return nullptr;
             }
+
+            if (current_token_type() != Token_type::LEFT_PARENTHESIS) {
+                if (is_required) {
+                    report_parsing_error("Expected opening ( for parameter list");
+                }
+
+                return nullptr;
+            }
+
+            auto* ret = create<Parameter_list>();
+            ret->l_paren = token_index;
             token_index += 1;
 
-            ret->return_type = parse_type_expression(true);
-            if (!ret->return_type) {
-                report_parsing_error("Expected function return type");
+            if (current_token_type() != Token_type::RIGHT_PARENTHESIS) {
+                ret->parameter_sequence = parse_parameter_sequence(true);
+                if (!ret->parameter_sequence) {
+                    return nullptr;
+                }
+            }
 
-                delete ret;
+            if (current_token_type() != Token_type::RIGHT_PARENTHESIS) {
+                report_parsing_error("Expected closing ) for parameter list");
                 return nullptr;
             }
+            ret->r_paren = token_index;
+            token_index += 1;
 
+            return ret;
+        }
 
+        //=================================================
+        // Statement parsing functions
+        //=================================================
 
+        ///
+        /// Parses statements up to, but not including, the closing curly
+        /// bracket of the enclosing code body. The sequence is built in a
+        /// loop so that long bodies cannot deepen the call stack.
+        ///
+        /// \return Statements in source order. Null if there are none, or
+        /// on failure, in which case error_code is set.
+        Statement_sequence* parse_statement_sequence() {
+            Statement_sequence* ret = nullptr;
+            Statement_sequence* last = nullptr;
+
+            while (true) {
+                skip_documentation();
+
+                if (token_index == end_index || current_token_type() == Token_type::RIGHT_CURLY_BRACKET) {
+                    return ret;
+                }
+
+                auto* statement = parse_statement(true);
+                if (!statement) {
+                    return nullptr;
+                }
 
-            //TODO: Complete implementation
+                auto* next = create<Statement_sequence>();
+                next->head = statement;
+
+                if (last) {
+                    last->tail = next;
+                } else {
+                    ret = next;
+                }
+                last = next;
+            }
+        }
+
+        Code_body* parse_code_body(bool is_required) {
+            if (current_token_type() != Token_type::LEFT_CURLY_BRACKET) {
+                if (is_required) {
+                    report_parsing_error("Expected {");
+                }
+
+                return nullptr;
+            }
+
+            auto* ret = create<Code_body>();
+            ret->l_curly_bracket = token_index;
+            token_index += 1;
+
+            ret->statement_sequence = parse_statement_sequence();
+            if (error_code != Error_code::NO_ERROR) {
+                return nullptr;
+            }
+
+            if (current_token_type() != Token_type::RIGHT_CURLY_BRACKET) {
+                report_parsing_error("Expected } to close code body");
+                return nullptr;
+            }
+            ret->r_curly_bracket = token_index;
+            token_index += 1;
 
             return ret;
         }
 
-        Lambda* parse_lambda(bool is_required) {
+        Statement* parse_statement(bool is_required) {
             if (token_index == end_index) {
+                if (is_required) {
+                    report_parsing_error("Expected statement");
+                }
+
                 return nullptr;
             }
 
-            auto* ret = new Lambda();
-            ret->lambda_keyword = parse_text("lambda", is_required);
+            switch (current_keyword()) {
+                case Keyword::LET:
+                    return parse_declaration(Keyword::LET, &Constant_declaration::let_keyword, true);
+                case Keyword::VAR:
+                    return parse_declaration(Keyword::VAR, &Variable_declaration::var_keyword, true);
+                case Keyword::RETURN:
+                    return parse_return_statement(true);
+                case Keyword::IF:
+                    return parse_if_statement(true);
+                case Keyword::WHILE:
+                    return parse_while_statement(true);
+                case Keyword::DO:
+                    return parse_do_while_loop(true);
+                case Keyword::FOR:
+                    if (is_ranged_for_loop()) {
+                        return parse_ranged_for_loop(true);
+                    }
+
+                    return parse_for_loop(true);
+                case Keyword::ALIAS:
+                    return parse_alias_definition(true);
+                default:
+                    break;
+            }
 
+            if (current_token_type() == Token_type::LEFT_CURLY_BRACKET) {
+                return parse_code_body(true);
+            }
+
+            return parse_expression_statement(is_required);
+        }
+
+        Expression_statement* parse_expression_statement(bool is_required) {
+            auto* expression = parse_expression(is_required);
+            if (!expression) {
+                return nullptr;
+            }
+
+            auto* ret = create<Expression_statement>();
+            ret->expression = expression;
+
+            if (current_token_type() != Token_type::SEMICOLON) {
+                report_parsing_error("Expected ; after expression");
+                return nullptr;
+            }
+            ret->semicolon_token = token_index;
+            token_index += 1;
 
             return ret;
         }
 
-        Struct_definition* parse_struct_definition(bool is_required) {
-            if (token_index == end_index) {
+        ///
+        /// Parses a constant or variable declaration, which share the form
+        /// `let name: type = initializer;`. The type and initializer are
+        /// each optional.
+        ///
+        /// \tparam T Constant_declaration or Variable_declaration
+        /// \param keyword Keyword which introduces declaration
+        /// \param keyword_member Member of T which holds keyword
+        /// \return Declaration. Null on failure.
+        template<class T>
+        T* parse_declaration(Keyword keyword, Text* T::* keyword_member, bool is_required) {
+            auto* keyword_text = parse_text(keyword, is_required);
+            if (!keyword_text) {
                 return nullptr;
             }
 
-            return nullptr;
+            auto* ret = create<T>();
+            ret->*keyword_member = keyword_text;
+
+            ret->name = parse_text(false);
+            if (!ret->name) {
+                report_parsing_error("Expected name of declared variable");
+                return nullptr;
+            }
+
+            if (current_token_type() == Token_type::COLON) {
+                ret->colon_token = token_index;
+                token_index += 1;
+
+                ret->type = parse_type_expression(true);
+                if (!ret->type) {
+                    return nullptr;
+                }
+            }
+
+            if (current_token_type() == Token_type::SPACED_EQUALS) {
+                ret->equals_token = token_index;
+                token_index += 1;
+
+                ret->initializer = parse_expression(true);
+                if (!ret->initializer) {
+                    return nullptr;
+                }
+            }
+
+            if (current_token_type() != Token_type::SEMICOLON) {
+                report_parsing_error("Expected ; after declaration");
+                return nullptr;
+            }
+            ret->semicolon_token = token_index;
+            token_index += 1;
+
+            return ret;
         }
 
-        Module_declaration* parse_module_declaration(bool is_required) {
-            if (token_index == end_index) {
+        Return_statement* parse_return_statement(bool is_required) {
+            auto* return_keyword = parse_text(Keyword::RETURN, is_required);
+            if (!return_keyword) {
+                return nullptr;
+            }
+
+            auto* ret = create<Return_statement>();
+            ret->return_keyword = return_keyword;
+
+            if (current_token_type() != Token_type::SEMICOLON) {
+                ret->expression = parse_expression(true);
+                if (!ret->expression) {
+                    return nullptr;
+                }
+            }
+
+            if (current_token_type() != Token_type::SEMICOLON) {
+                report_parsing_error("Expected ; after return statement");
+                return nullptr;
+            }
+            ret->semicolon_token = token_index;
+            token_index += 1;
+
+            return ret;
+        }
+
+        If_statement* parse_if_statement(bool is_required) {
+            auto* if_keyword = parse_text(Keyword::IF, is_required);
+            if (!if_keyword) {
+                return nullptr;
+            }
+
+            auto* ret = create<If_statement>();
+            ret->if_keyword = if_keyword;
+
+            ret->condition = parse_expression(true);
+            if (!ret->condition) {
+                return nullptr;
+            }
+
+            ret->true_branch = parse_code_body(true);
+            if (!ret->true_branch) {
                 return nullptr;
             }
 
-            auto* ret = new Module_declaration();
-            ret->module_keyword = parse_text("module");
-            if (!ret->module_keyword) {
-                delete ret;
+            while (current_keyword() == Keyword::ELSE) {
+                auto* else_keyword = create_text();
 
-                if (!is_required) {
+                if (current_keyword() != Keyword::IF) {
+                    ret->else_keyword = else_keyword;
+                    ret->else_branch = parse_code_body(true);
+                    if (!ret->else_branch) {
+                        return nullptr;
+                    }
+
+                    break;
+                }
+
+                ret->else_keywords.push_back(else_keyword);
+                ret->else_if_keywords.push_back(create_text());
+
+                auto* condition = parse_expression(true);
+                if (!condition) {
                     return nullptr;
                 }
+                ret->else_if_conditions.push_back(condition);
 
-                report_parsing_error("Expected module keyword");
+                auto* branch = parse_code_body(true);
+                if (!branch) {
+                    return nullptr;
+                }
+                ret->else_if_branches.push_back(branch);
+            }
 
+            return ret;
+        }
+
+        While_statement* parse_while_statement(bool is_required) {
+            auto* while_keyword = parse_text(Keyword::WHILE, is_required);
+            if (!while_keyword) {
                 return nullptr;
             }
 
-            ret->module_name = parse_resolved_identifier(true);
-            if (!ret->module_name) {
-                report_parsing_error("Expected module name");
+            auto* ret = create<While_statement>();
+            ret->while_keyword = while_keyword;
 
-                delete ret;
+            ret->condition = parse_expression(true);
+            if (!ret->condition) {
                 return nullptr;
             }
 
-            if (unit.tokenization.types[token_index] != Token_type::SEMICOLON) {
-                report_parsing_error("Expected semicolon.");
+            ret->loop_body = parse_code_body(true);
+            if (!ret->loop_body) {
+                return nullptr;
+            }
+
+            return ret;
+        }
+
+        Do_while_loop* parse_do_while_loop(bool is_required) {
+            auto* do_keyword = parse_text(Keyword::DO, is_required);
+            if (!do_keyword) {
+                return nullptr;
+            }
+
+            auto* ret = create<Do_while_loop>();
+            ret->do_keyword = do_keyword;
+
+            ret->code_body = parse_code_body(true);
+            if (!ret->code_body) {
+                return nullptr;
+            }
+
+            ret->while_keyword = parse_text(Keyword::WHILE, true);
+            if (!ret->while_keyword) {
+                return nullptr;
+            }
 
-                delete ret;
+            ret->condition = parse_expression(true);
+            if (!ret->condition) {
+                return nullptr;
+            }
+
+            if (current_token_type() != Token_type::SEMICOLON) {
+                report_parsing_error("Expected ; after do-while loop");
                 return nullptr;
             }
             ret->semicolon_token = token_index;
-            ++token_index;
+            token_index += 1;
 
             return ret;
         }
 
-        Source_body* parse_source_body() {
+        ///
+        /// Parses a loop of the form `for initializer; condition; incrementer {}`
+        /// where the initializer is a statement which consumes its own
+        /// semicolon
+        ///
+        For_loop* parse_for_loop(bool is_required) {
+            auto* for_keyword = parse_text(Keyword::FOR, is_required);
+            if (!for_keyword) {
+                return nullptr;
+            }
+
+            auto* ret = create<For_loop>();
+            ret->for_keyword = for_keyword;
+
+            ret->initializers = create<Statement_sequence>();
+            ret->initializers->head = parse_statement(true);
+            if (!ret->initializers->head) {
+                return nullptr;
+            }
+
+            ret->condition = parse_expression(true);
+            if (!ret->condition) {
+                return nullptr;
+            }
+
+            if (current_token_type() != Token_type::SEMICOLON) {
+                report_parsing_error("Expected ; after for loop condition");
+                return nullptr;
+            }
+            ret->semicolon_token = token_index;
+            token_index += 1;
+
+            if (current_token_type() != Token_type::LEFT_CURLY_BRACKET) {
+                ret->incrementer = create<Statement_sequence>();
+                ret->incrementer->head = parse_expression(true);
+                if (!ret->incrementer->head) {
+                    return nullptr;
+                }
+            }
+
+            ret->loop_body = parse_code_body(true);
+            if (!ret->loop_body) {
+                return nullptr;
+            }
+
+            return ret;
+        }
+
+        Ranged_for_loop* parse_ranged_for_loop(bool is_required) {
+            auto* for_keyword = parse_text(Keyword::FOR, is_required);
+            if (!for_keyword) {
+                return nullptr;
+            }
+
+            auto* ret = create<Ranged_for_loop>();
+            ret->for_keyword = for_keyword;
+
+            ret->loop_variables = parse_text_sequence(true);
+            if (!ret->loop_variables) {
+                return nullptr;
+            }
+
+            ret->in_keyword = parse_text(Keyword::IN, true);
+            if (!ret->in_keyword) {
+                return nullptr;
+            }
+
+            ret->ranges = parse_expression_sequence(true);
+            if (!ret->ranges) {
+                return nullptr;
+            }
+
+            ret->loop_body = parse_code_body(true);
+            if (!ret->loop_body) {
+                return nullptr;
+            }
+
+            return ret;
+        }
+
+        Text_sequence* parse_text_sequence(bool is_required) {
+            auto* head = parse_text(is_required);
+            if (!head) {
+                return nullptr;
+            }
+
+            auto* ret = create<Text_sequence>();
+            ret->head = head;
+
+            auto* last = ret;
+            while (current_token_type() == Token_type::COMMA) {
+                last->comma_token = token_index;
+                token_index += 1;
+
+                auto* next = create<Text_sequence>();
+                next->head = parse_text(true);
+                if (!next->head) {
+                    return nullptr;
+                }
+
+                last->tail = next;
+                last = next;
+            }
+
+            return ret;
+        }
+
+        //=================================================
+        // Declaration parsing functions
+        //=================================================
+
+        Function_definition* parse_function_definition(bool is_required) {
             if (token_index == end_index) {
                 return nullptr;
             }
 
-            if (unit.tokenization.types[token_index] != Token_type::TEXT) {
+            auto* func_keyword = parse_text(Keyword::FUNC, is_required);
+            if (!func_keyword) {
                 return nullptr;
             }
 
-            std::string_view view{
-                unit.source.data() + unit.tokenization.source_indices[token_index],
-                unit.tokenization.lengths[token_index]
-            };
+            auto* ret = create<Function_definition>();
+            ret->func_keyword = func_keyword;
 
-            if (view == "func") {
-                return parse_function_definition(true);
-            } else {
+            ret->attributes = parse_attribute_list(false);
+
+            ret->name = parse_text(true);
+            if (!ret->name) {
+                report_parsing_error("Expected function name");
+                return nullptr;
+            }
+
+            ret->parameter_list = parse_parameter_list(true);
+            if (!ret->parameter_list) {
+                return nullptr;
+            }
+            ret->l_paren_token = ret->parameter_list->l_paren;
+            ret->r_paren_token = ret->parameter_list->r_paren;
+
+            if (current_token_type() != Token_type::JOINED_SINGLE_ARROW) {
+                report_parsing_error("Expected -> before function return type");
+                return nullptr;
+            }
+            ret->arrow_token = token_index;
+            token_index += 1;
+
+            ret->return_type = parse_type_expression(true);
+            if (!ret->return_type) {
+                report_parsing_error("Expected function return type");
+                return nullptr;
+            }
+
+            if (current_token_type() != Token_type::LEFT_CURLY_BRACKET) {
+                report_parsing_error("Expected { to open function body");
+                return nullptr;
+            }
+
+            ret->l_curly_bracket = token_index;
+            ret->r_curly_bracket = tokens.pair_indices[token_index];
+            if (ret->r_curly_bracket == ret->l_curly_bracket || ret->r_curly_bracket >= end_index) {
+                report_parsing_error("Expected } to close function body");
                 return nullptr;
             }
+
+            if (deferred_bodies) {
+                token_index = ret->r_curly_bracket + 1;
+                deferred_bodies->push_back(ret);
+                return ret;
+            }
+
+            ret->body = parse_code_body(true);
+            if (!ret->body) {
+                return nullptr;
+            }
+
+            return ret;
         }
 
-        Source_body_list* parse_source_body_list() {
+        Lambda* parse_lambda(bool is_required) {
             if (token_index == end_index) {
                 return nullptr;
             }
 
-            auto* ret = new Source_body_list();
-            ret->head = parse_source_body();
-            if (!ret->head) {
-                delete ret;
+            auto* lambda_keyword = parse_text(Keyword::LAMBDA, is_required);
+            if (!lambda_keyword) {
                 return nullptr;
             }
 
-            ret->tail = parse_source_body_list();
+            auto* ret = create<Lambda>();
+            ret->lambda_keyword = lambda_keyword;
+
+            ret->attribute_list = parse_attribute_list(false);
+
+            if (current_keyword() == Keyword::NONE) {
+                ret->name = parse_text(false);
+            }
+
+            ret->parameter_list = parse_parameter_list(true);
+            if (!ret->parameter_list) {
+                return nullptr;
+            }
+            ret->l_paren_token = ret->parameter_list->l_paren;
+            ret->r_paren_token = ret->parameter_list->r_paren;
+
+            // Return type may be omitted
+            if (current_token_type() == Token_type::JOINED_SINGLE_ARROW) {
+                ret->arrow_token = token_index;
+                token_index += 1;
+
+                ret->return_type = parse_type_expression(true);
+                if (!ret->return_type) {
+                    return nullptr;
+                }
+            }
+
+            ret->body = parse_code_body(true);
+            if (!ret->body) {
+                return nullptr;
+            }
+            ret->l_curly_bracket = ret->body->l_curly_bracket;
+            ret->r_curly_bracket = ret->body->r_curly_bracket;
 
             return ret;
         }
 
-        Parse_tree_node* parse_source_file() {
+        Alias_definition* parse_alias_definition(bool is_required) {
             if (token_index == end_index) {
                 return nullptr;
             }
 
-            auto* ret = new Source_file();
+            auto* alias_keyword = parse_text(Keyword::ALIAS, is_required);
+            if (!alias_keyword) {
+                return nullptr;
+            }
 
-            // Module declaration is required
-            ret->module_declaration = parse_module_declaration(true);
-            if (!ret->module_declaration) {
-                delete ret;
+            auto* ret = create<Alias_definition>();
+            ret->alias_keyword = alias_keyword;
+
+            ret->attribute_list = parse_attribute_list(false);
+
+            ret->name = parse_text(false);
+            if (!ret->name) {
+                report_parsing_error("Expected alias name");
+                return nullptr;
+            }
+
+            if (current_token_type() != Token_type::SPACED_EQUALS) {
+                report_parsing_error("Expected = after alias name");
+                return nullptr;
+            }
+            ret->equals_token = token_index;
+            token_index += 1;
+
+            ret->type = parse_type_expression(true);
+            if (!ret->type) {
+                return nullptr;
+            }
 
-                report_parsing_error("Expected module declaration");
+            if (current_token_type() != Token_type::SEMICOLON) {
+                report_parsing_error("Expected ; after alias definition");
                 return nullptr;
             }
+            ret->semicolon_token = token_index;
+            token_index += 1;
+
+            return ret;
+        }
+
+        ///
+        /// The members of a struct have no representation in the parse tree
+        /// yet, so a struct definition is reported as an error rather than
+        /// being skipped
+        ///
+        Struct_definition* parse_struct_definition(bool is_required) {
+            if (token_index == end_index) {
+                return nullptr;
+            }
+
+            if (current_keyword() != Keyword::STRUCT) {
+                if (is_required) {
+                    report_parsing_error("Expected \"struct\"");
+                }
+
+                return nullptr;
+            }
+
+            report_parsing_error("Struct definitions are not yet supported");
+            return nullptr;
+        }
+
+        Module_declaration* parse_module_declaration(bool is_required) {
+            if (token_index == end_index) {
+                return nullptr;
+            }
+
+            auto* module_keyword = parse_text(Keyword::MODULE, is_required);
+            if (!module_keyword) {
+                return nullptr;
+            }
+
+            auto* ret = create<Module_declaration>();
+            ret->module_keyword = module_keyword;
+
+            ret->module_name = parse_resolved_identifier(true);
+            if (!ret->module_name) {
+                report_parsing_error("Expected module name");
+                return nullptr;
+            }
+
+            if (current_token_type() != Token_type::SEMICOLON) {
+                report_parsing_error("Expected semicolon.");
+                return nullptr;
+            }
+            ret->semicolon_token = token_index;
+            ++token_index;
+
+            return ret;
+        }
+
+        Source_body* parse_source_body() {
+            if (token_index == end_index) {
+                return nullptr;
+            }
+
+            switch (current_keyword()) {
+                case Keyword::FUNC:
+                    return parse_function_definition(true);
+                case Keyword::ALIAS:
+                    return parse_alias_definition(true);
+                case Keyword::STRUCT:
+                    return parse_struct_definition(true);
+                default:
+                    return nullptr;
+            }
+        }
+
+        ///
+        /// Parses declarations until one fails to parse. The list is built
+        /// in a loop so that files with many declarations cannot deepen
+        /// the call stack.
+        ///
+        Source_body_list* parse_source_body_list() {
+            Source_body_list* ret = nullptr;
+            Source_body_list* last = nullptr;
+
+            while (true) {
+                skip_documentation();
+
+                auto* head = parse_source_body();
+                if (!head) {
+                    return ret;
+                }
+
+                auto* next = create<Source_body_list>();
+                next->head = head;
+
+                if (last) {
+                    last->tail = next;
+                } else {
+                    ret = next;
+                }
+                last = next;
+            }
+        }
+
+        Source_file* parse_source_file() {
+            if (token_index == end_index) {
+                return nullptr;
+            }
+
+            // Module declaration is required
+            auto* module_declaration = parse_module_declaration(true);
+            if (!module_declaration) {
+                return nullptr;
+            }
+
+            auto* ret = create<Source_file>();
+            ret->module_declaration = module_declaration;
 
             // Body can be empty
             ret->body = parse_source_body_list();
 
+            if (token_index != end_index && error_code == Error_code::NO_ERROR) {
+                report_parsing_error("Expected function or alias definition");
+            }
+
             return ret;
         }
 
@@ -676,21 +1670,302 @@ namespace harc::parser {
         // Helper functions
         //=================================================
 
-        Token_type current_token_type() {
-            return unit.tokenization.types[token_index];
+        ///
+        /// Allocates a node from the unit's parse tree arena. Nodes which
+        /// end up unused because of a parsing error are not reclaimed until
+        /// the tree itself is destroyed.
+        ///
+        /// \tparam T Node type
+        /// \return Pointer to default-constructed node
+        template<class T>
+        T* create() {
+            return arena.create<T>();
+        }
+
+        ///
+        /// \return Type of the current token or NULL_TOKEN if all tokens
+        /// have been consumed
+        Token_type current_token_type() const {
+            if (token_index >= end_index) {
+                return Token_type::NULL_TOKEN;
+            }
+
+            return tokens.types[token_index];
+        }
+
+        ///
+        /// \return Type of the token after the current one or NULL_TOKEN if
+        /// there is no such token
+        Token_type next_token_type() const {
+            if (token_index + 1 >= end_index) {
+                return Token_type::NULL_TOKEN;
+            }
+
+            return tokens.types[token_index + 1];
+        }
+
+        ///
+        /// \return Keyword spelled by the current token or NONE if it is not
+        /// a keyword or all tokens have been consumed
+        Keyword current_keyword() const {
+            if (token_index >= end_index) {
+                return Keyword::NONE;
+            }
+
+            return tokens.keywords[token_index];
+        }
+
+        ///
+        /// \param i Index of token
+        /// \return Text of token
+        std::string_view token_source(std::uint32_t i) const {
+            return std::string_view{source.data() + tokens.source_indices[i], tokens.lengths[i]};
+        }
+
+        ///
+        /// Creates a Text node for the current token and advances past it
+        ///
+        /// \return Newly created node
+        Text* create_text() {
+            auto* ret = create<Text>();
+
+            ret->text_token = token_index;
+            ret->identifier = identifiers.intern(token_source(token_index));
+            ++token_index;
+
+            if (texts) {
+                texts->push_back(ret);
+            }
+
+            return ret;
+        }
+
+        ///
+        /// Advances past documentation comments. These are not yet attached
+        /// to the declarations which they precede.
+        ///
+        void skip_documentation() {
+            while (current_token_type() == Token_type::DOC_TEXT) {
+                ++token_index;
+            }
+        }
+
+        ///
+        /// Distinguishes `for a, b in xs, ys {}` from a counted for loop by
+        /// looking ahead for the in keyword after a list of names
+        ///
+        /// \return True if the current for keyword begins a ranged for loop
+        bool is_ranged_for_loop() const {
+            auto i = token_index + 1;
+            while (i < end_index && tokens.types[i] == Token_type::TEXT) {
+                if (tokens.keywords[i] != Keyword::NONE) {
+                    return false;
+                }
+
+                i += 1;
+                if (i < end_index && tokens.keywords[i] == Keyword::IN) {
+                    return true;
+                }
+
+                if (i >= end_index || tokens.types[i] != Token_type::COMMA) {
+                    return false;
+                }
+
+                i += 1;
+            }
+
+            return false;
         }
 
         void increment_token() {
             ++token_index;
         }
 
+        ///
+        /// Records an error located at the current token, or at the end of
+        /// the source if all tokens have been consumed
+        ///
+        /// \param message Error message
+        void report_parsing_error(std::string_view message) {
+            error_code = Error_code::PARSING_ERROR;
+
+            const auto& line_indices = tokens.line_indices;
+
+            // Parsers which cover only part of a unit may run out of tokens
+            // before the end of the source
+            std::uint32_t index = static_cast<std::uint32_t>(source.size());
+            if (token_index < tokens.size()) {
+                index = tokens.source_indices[token_index];
+            }
+
+            if (line_indices.empty()) {
+                message_buffer.error(message, source_path);
+                return;
+            }
+
+            auto it = std::upper_bound(line_indices.begin(), line_indices.end(), index);
+            std::uint32_t line = it - line_indices.begin();
+            std::uint32_t column = index - *(it - 1) + 1;
+
+            message_buffer.error(message, source_path, line, column);
+        }
+
     };
-    */
 
-    Error_code parse(Translation_unit& unit) {
-        //Parser parser{unit};
-        //auto error_code = parser.parse();
-        return {};
+    ///
+    /// Releases every node of a parse tree
+    ///
+    /// \param tree Parse tree to clear
+    static void clear_nodes(Parse_tree& tree) {
+        tree.arena.release();
+        tree.chunk_arenas.clear();
+        tree.root = nullptr;
+        tree.deferred_bodies.clear();
+    }
+
+    Error_code parse(Translation_unit& unit, Body_parsing body_parsing) {
+        clear_nodes(unit.parse_tree);
+
+        Parser parser{unit, body_parsing};
+        unit.parse_tree.root = parser.parse();
+
+        unit.parse_tree.flat = flatten(unit.parse_tree.root);
+        return parser.error();
+    }
+
+    Error_code parse_body(Translation_unit& unit, Function_definition& function) {
+        if (function.body) {
+            return Error_code::NO_ERROR;
+        }
+
+        Parser parser{unit, function.l_curly_bracket, function.r_curly_bracket + 1};
+        return parser.parse_body(function);
+    }
+
+    Error_code parse_deferred_bodies(Translation_unit& unit) {
+        auto ret = Error_code::NO_ERROR;
+
+        for (auto* function : unit.parse_tree.deferred_bodies) {
+            auto error_code = parse_body(unit, *function);
+            if (error_code != Error_code::NO_ERROR) {
+                ret = error_code;
+            }
+        }
+
+        unit.parse_tree.deferred_bodies.clear();
+        unit.parse_tree.flat = flatten(unit.parse_tree.root);
+        return ret;
+    }
+
+    std::vector<Source_body_chunk> split_source_bodies(const lex::Tokenization_view& tokens, std::uint32_t chunk_size) {
+        std::vector<Source_body_chunk> ret;
+
+        constexpr std::uint32_t no_chunk = UINT32_MAX;
+        std::uint32_t begin = no_chunk;
+
+        for (std::uint32_t i = 0; i < tokens.size();) {
+            auto keyword = tokens.keywords[i];
+            if (keyword == Keyword::FUNC || keyword == Keyword::ALIAS) {
+                if (begin == no_chunk) {
+                    begin = i;
+                } else if (i - begin >= chunk_size) {
+                    ret.push_back({begin, i});
+                    begin = i;
+                }
+            }
+
+            // No declaration begins within brackets, so their contents are
+            // skipped. Unpaired tokens refer to themselves.
+            auto pair_index = tokens.pair_indices[i];
+            i = (pair_index > i) ? pair_index + 1 : i + 1;
+        }
+
+        if (begin != no_chunk) {
+            ret.push_back({begin, tokens.size()});
+        }
+
+        return ret;
+    }
+
+    Chunk_parse parse_chunk(std::string_view source_path, const lex::Tokenization_view& tokens, Source_body_chunk chunk) {
+        Chunk_parse ret{};
+        ret.chunk = chunk;
+
+        Parser parser{source_path, tokens, ret};
+        parser.parse_chunk(ret);
+
+        return ret;
+    }
+
+    Error_code stitch_chunk_parses(Translation_unit& unit, std::vector<Chunk_parse> chunks) {
+        clear_nodes(unit.parse_tree);
+
+        // Only the module declaration and any documentation precede the
+        // first chunk
+        auto prologue_end = chunks.empty() ? unit.tokens.size() : chunks.front().chunk.begin;
+
+        // Without a module declaration the source is rejected before any
+        // declarations are reached
+        if (prologue_end == 0 && unit.tokens.size() != 0) {
+            return parse(unit);
+        }
+
+        Parser parser{unit, 0, prologue_end};
+        auto* source_file = parser.parse();
+        auto error_code = parser.error();
+
+        unit.parse_tree.root = source_file;
+        if (!source_file || error_code != Error_code::NO_ERROR) {
+            unit.parse_tree.flat = flatten(unit.parse_tree.root);
+            return error_code;
+        }
+
+        std::vector<std::uint32_t> ids;
+        Source_body_list* last = nullptr;
+        for (auto& chunk : chunks) {
+            // Interning each chunk's identifiers in turn assigns IDs in
+            // order of first appearance, just as a single parser would
+            ids.resize(chunk.identifiers.size());
+            for (std::uint32_t i = 0; i < ids.size(); ++i) {
+                ids[i] = unit.identifiers.intern(chunk.identifiers.text(i));
+            }
+
+            for (auto* text : chunk.texts) {
+                text->identifier = ids[text->identifier];
+            }
+
+            if (last) {
+                last->tail = chunk.body;
+            } else {
+                source_file->body = chunk.body;
+            }
+
+            for (auto* n = chunk.body; n; n = n->tail) {
+                last = n;
+            }
+
+            unit.parse_tree.chunk_arenas.push_back(std::move(chunk.arena));
+            unit.parse_tree.message_buffer.append(std::move(chunk.message_buffer));
+
+            // A single parser would have stopped at the failed declaration
+            if (chunk.error_code != Error_code::NO_ERROR) {
+                error_code = chunk.error_code;
+                break;
+            }
+        }
+
+        unit.parse_tree.flat = flatten(unit.parse_tree.root);
+        return error_code;
+    }
+
+    Error_code parse_expression(Translation_unit& unit) {
+        clear_nodes(unit.parse_tree);
+
+        Parser parser{unit};
+        unit.parse_tree.root = parser.parse_standalone_expression();
+
+        unit.parse_tree.flat = flatten(unit.parse_tree.root);
+        return parser.error();
     }
 
 }
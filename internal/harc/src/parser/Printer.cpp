@@ -36,7 +36,7 @@ namespace harc::parser {
                 return;
             }
 
-            auto token_type = unit.tokenization.types[token_index];
+            auto token_type = unit.tokens.types[token_index];
 
             indent();
             output += to_string(token_type);
@@ -61,6 +61,23 @@ namespace harc::parser {
             output += '\n';
         }
 
+        void visit(Text_sequence* node) override {
+            indent();
+            output += "TEXT_SEQUENCE:\n";
+            depth += 1;
+
+            for (auto* n = node; n; n = n->tail) {
+                if (n->head) {
+                    n->head->accept(*this);
+                }
+
+                visit(n->comma_token);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
         void visit(Resolved_identifier* node) override {
             indent();
             output += "RESOLVED_IDENTIFIER:\n";
@@ -99,6 +116,19 @@ namespace harc::parser {
             // Nothing to do
         }
 
+        void visit(Identifier_expression* node) override {
+            indent();
+            output += "IDENTIFIER_EXPRESSION:\n";
+            depth += 1;
+
+            if (node->identifier) {
+                node->identifier->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
         void visit(Expression_list* node) override {
             indent();
             output += "EXPRESSION_LIST:\n";
@@ -118,6 +148,188 @@ namespace harc::parser {
             output += '\n';
         }
 
+        void visit(Expression_sequence* node) override {
+            indent();
+            output += "EXPRESSION_SEQUENCE:\n";
+            depth += 1;
+
+            if (node->head) {
+                node->head->accept(*this);
+            }
+
+            visit(node->comma_token);
+
+            if (node->tail) {
+                visit(node->tail);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(Resolved_template* node) override {
+            indent();
+            output += "RESOLVED_TEMPLATE:\n";
+            depth += 1;
+
+            if (node->template_expression) {
+                node->template_expression->accept(*this);
+            }
+
+            visit(node->l_template_bracket);
+
+            if (node->parameters) {
+                node->parameters->accept(*this);
+            }
+
+            visit(node->r_template_bracket);
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(Numeric_literal_expression* node) override {
+            indent();
+            output += "NUMERIC_LITERAL_EXPRESSION:\n";
+            depth += 1;
+
+            visit(node->numeric_literal_token);
+            visit(node->colon_token);
+
+            if (node->type_expression) {
+                node->type_expression->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(String_literal_expression* node) override {
+            indent();
+            output += "STRING_LITERAL_EXPRESSION:\n";
+            depth += 1;
+
+            visit(node->string_literal_token);
+            visit(node->colon_token);
+
+            if (node->type_expression) {
+                node->type_expression->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(Codepoint_literal_expression* node) override {
+            indent();
+            output += "CODEPOINT_LITERAL_EXPRESSION:\n";
+            depth += 1;
+
+            visit(node->codepoint_literal_token);
+            visit(node->colon_token);
+
+            if (node->type_expression) {
+                node->type_expression->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(Tuple_literal* node) override {
+            indent();
+            output += "TUPLE_LITERAL:\n";
+            depth += 1;
+
+            visit(node->l_curly_bracket_token);
+
+            if (node->expression_sequence) {
+                node->expression_sequence->accept(*this);
+            }
+
+            visit(node->r_curly_bracket_token);
+            visit(node->colon_token);
+
+            if (node->type_expression) {
+                node->type_expression->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(Parenthesized_expression* node) override {
+            indent();
+            output += "PARENTHESIZED_EXPRESSION:\n";
+            depth += 1;
+
+            visit(node->l_paren_token);
+
+            if (node->expression) {
+                node->expression->accept(*this);
+            }
+
+            visit(node->r_paren_token);
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(Unary_operator_expression* node) override {
+            indent();
+            output += "UNARY_OPERATOR_EXPRESSION:\n";
+            depth += 1;
+
+            visit(node->operator_token);
+
+            if (node->expression) {
+                node->expression->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(Binary_operator_expression* node) override {
+            indent();
+            output += "BINARY_OPERATOR_EXPRESSION:\n";
+            depth += 1;
+
+            if (node->l_expression) {
+                node->l_expression->accept(*this);
+            }
+
+            visit(node->operator_token);
+
+            if (node->r_expression) {
+                node->r_expression->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(Binary_text_operator_expression* node) override {
+            indent();
+            output += "BINARY_TEXT_OPERATOR_EXPRESSION:\n";
+            depth += 1;
+
+            if (node->l_expression) {
+                node->l_expression->accept(*this);
+            }
+
+            if (node->operator_text) {
+                node->operator_text->accept(*this);
+            }
+
+            if (node->r_expression) {
+                node->r_expression->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
         void visit(Function_call* node) override {
             indent();
             output += "FUNCTION_CALL:\n";
@@ -139,10 +351,190 @@ namespace harc::parser {
             output += '\n';
         }
 
+        void visit(Subscript_call* node) override {
+            indent();
+            output += "SUBSCRIPT_CALL:\n";
+            depth += 1;
+
+            if (node->name) {
+                node->name->accept(*this);
+            }
+
+            visit(node->l_square_bracket_token);
+
+            if (node->parameters) {
+                node->parameters->accept(*this);
+            }
+
+            visit(node->r_square_bracket_token);
+
+            depth -= 1;
+            output += '\n';
+        }
+
         void visit(Statement* node) override {
             // Nothing to do
         }
 
+        void visit(If_statement* node) override {
+            indent();
+            output += "IF_STATEMENT:\n";
+            depth += 1;
+
+            if (node->if_keyword) {
+                node->if_keyword->accept(*this);
+            }
+
+            if (node->condition) {
+                node->condition->accept(*this);
+            }
+
+            if (node->true_branch) {
+                node->true_branch->accept(*this);
+            }
+
+            for (std::size_t i = 0; i < node->else_if_branches.size(); ++i) {
+                node->else_keywords[i]->accept(*this);
+                node->else_if_keywords[i]->accept(*this);
+                node->else_if_conditions[i]->accept(*this);
+                node->else_if_branches[i]->accept(*this);
+            }
+
+            if (node->else_keyword) {
+                node->else_keyword->accept(*this);
+            }
+
+            if (node->else_branch) {
+                node->else_branch->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(While_statement* node) override {
+            indent();
+            output += "WHILE_STATEMENT:\n";
+            depth += 1;
+
+            if (node->while_keyword) {
+                node->while_keyword->accept(*this);
+            }
+
+            if (node->condition) {
+                node->condition->accept(*this);
+            }
+
+            if (node->loop_body) {
+                node->loop_body->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(For_loop* node) override {
+            indent();
+            output += "FOR_LOOP:\n";
+            depth += 1;
+
+            if (node->for_keyword) {
+                node->for_keyword->accept(*this);
+            }
+
+            if (node->initializers) {
+                node->initializers->accept(*this);
+            }
+
+            if (node->condition) {
+                node->condition->accept(*this);
+            }
+
+            visit(node->semicolon_token);
+
+            if (node->incrementer) {
+                node->incrementer->accept(*this);
+            }
+
+            if (node->loop_body) {
+                node->loop_body->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(Ranged_for_loop* node) override {
+            indent();
+            output += "RANGED_FOR_LOOP:\n";
+            depth += 1;
+
+            if (node->for_keyword) {
+                node->for_keyword->accept(*this);
+            }
+
+            if (node->loop_variables) {
+                node->loop_variables->accept(*this);
+            }
+
+            if (node->in_keyword) {
+                node->in_keyword->accept(*this);
+            }
+
+            if (node->ranges) {
+                node->ranges->accept(*this);
+            }
+
+            if (node->loop_body) {
+                node->loop_body->accept(*this);
+            }
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(Do_while_loop* node) override {
+            indent();
+            output += "DO_WHILE_LOOP:\n";
+            depth += 1;
+
+            if (node->do_keyword) {
+                node->do_keyword->accept(*this);
+            }
+
+            if (node->code_body) {
+                node->code_body->accept(*this);
+            }
+
+            if (node->while_keyword) {
+                node->while_keyword->accept(*this);
+            }
+
+            if (node->condition) {
+                node->condition->accept(*this);
+            }
+
+            visit(node->semicolon_token);
+
+            depth -= 1;
+            output += '\n';
+        }
+
+        void visit(Expression_statement* node) override {
+            indent();
+            output += "EXPRESSION_STATEMENT:\n";
+            depth += 1;
+
+            if (node->expression) {
+                node->expression->accept(*this);
+            }
+
+            visit(node->semicolon_token);
+
+            depth -= 1;
+            output += '\n';
+        }
+
         void visit(Return_statement* node) override {
             indent();
             output += "RETURN_STATEMENT:\n";
@@ -171,6 +563,12 @@ namespace harc::parser {
                 node->var_keyword->accept(*this);
             }
 
+            if (node->name) {
+                node->name->accept(*this);
+            }
+
+            visit(node->colon_token);
+
             if (node->type) {
                 node->type->accept(*this);
             }
@@ -196,6 +594,12 @@ namespace harc::parser {
                 node->let_keyword->accept(*this);
             }
 
+            if (node->name) {
+                node->name->accept(*this);
+            }
+
+            visit(node->colon_token);
+
             if (node->type) {
                 node->type->accept(*this);
             }
@@ -332,14 +736,16 @@ namespace harc::parser {
                 node->input_qualifier->accept(*this);
             }
 
-            if (node->type) {
-                node->type->accept(*this);
-            }
-
             if (node->name) {
                 node->name->accept(*this);
             }
 
+            visit(node->colon_token);
+
+            if (node->type) {
+                node->type->accept(*this);
+            }
+
             depth -= 1;
             output += '\n';
         }
@@ -407,12 +813,17 @@ namespace harc::parser {
                 node->parameter_list->accept(*this);
             }
 
+            visit(node->arrow_token);
+
             if (node->return_type) {
                 node->return_type->accept(*this);
             }
 
             if (node->body) {
                 node->body->accept(*this);
+            } else {
+                visit(node->l_curly_bracket);
+                visit(node->r_curly_bracket);
             }
 
             depth -= 1;
@@ -444,6 +855,7 @@ namespace harc::parser {
 
             visit(node->r_paren_token);
 
+            visit(node->arrow_token);
 
             if (node->return_type) {
                 node->return_type->accept(*this);
@@ -491,12 +903,18 @@ namespace harc::parser {
                 node->attribute_list->accept(*this);
             }
 
+            if (node->name) {
+                node->name->accept(*this);
+            }
+
             visit(node->equals_token);
 
             if (node->type) {
                 node->type->accept(*this);
             }
 
+            visit(node->semicolon_token);
+
             depth -= 1;
             output += '\n';
         }
@@ -1,9 +1,33 @@
 #include <harc/prepass/Prepass.hpp>
 
+#include <algorithm>
+#include <bit>
 #include <cstring>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define HARC_PREPASS_X86_KERNELS 1
+    #include <immintrin.h>
+#else
+    #define HARC_PREPASS_X86_KERNELS 0
+#endif
+
 namespace harc::prepass {
 
+    ///
+    /// Number of bytes processed per iteration of each kernel's main loop
+    ///
+    constexpr std::size_t block_width = 64;
+
+    ///
+    /// Maximum number of UTF-8 errors that will be recorded for a single
+    /// source. Mirrors the default of lex::Config::max_errors.
+    ///
+    constexpr std::size_t max_reported_errors = 100;
+
+    //=====================================================
+    // MurmurHash3_x86_128
+    //=====================================================
+
     std::uint64_t fmix64(std::uint64_t k) {
         // Helper function used in computation of MurmurHash3_x86_128
         k ^= k >> 33;
@@ -15,36 +39,33 @@ namespace harc::prepass {
         return k;
     }
 
-    Prepass_results prepass(const Translation_unit& unit) {
-        std::uint32_t codepoint_count = unit.source.size();
+    ///
+    /// Running state of the MurmurHash3_x86_128 computation.
+    ///
+    /// Each 16-byte block depends on the state left behind by the previous
+    /// one, so there is no parallelism across blocks for SIMD to exploit.
+    /// Every kernel therefore drives this same scalar code, which also
+    /// guarantees that all kernels produce identical hashes.
+    ///
+    struct Murmur_state {
+        static constexpr std::uint32_t block_size = 16;
+
+        static constexpr std::uint64_t c1 = 0x87c37b91114253d5ull;
+        static constexpr std::uint64_t c2 = 0x4cf5ad432745937full;
 
-        // MurmurHash3_x86_128 state
         std::uint64_t h1 = 0x0123456789abcdef;
         std::uint64_t h2 = 0xfdecba9876543210;
 
-        constexpr std::uint32_t block_size = 16;
-
-        constexpr std::uint64_t c1 = 0x87c37b91114253d5ull;
-        constexpr std::uint64_t c2 = 0x4cf5ad432745937full;
-
-        std::uint64_t whole_blocks = unit.source.size() / block_size;
-        std::uint64_t block_remainders = unit.source.size() % block_size;
-
-        // Process whole blocks
-        std::uint64_t i = 0;
-        for (; i < whole_blocks * block_size; i += block_size) {
+        ///
+        /// \param ptr Pointer to block_size bytes
+        void consume_block(const char* ptr) {
             // Load 128-bit block
             std::uint64_t block0;
-            std::memcpy(&block0, unit.source.data() + i, sizeof(std::uint64_t));
+            std::memcpy(&block0, ptr, sizeof(std::uint64_t));
 
             std::uint64_t block1;
-            std::memcpy(&block1, unit.source.data() + i + sizeof(std::uint64_t), sizeof(std::uint64_t));
+            std::memcpy(&block1, ptr + sizeof(std::uint64_t), sizeof(std::uint64_t));
 
-            // Codepoint counting logic
-            codepoint_count -= std::popcount(((~block0 << 1) & block0) & 0x8080808080808080ull);
-            codepoint_count -= std::popcount(((~block1 << 1) & block1) & 0x8080808080808080ull);
-
-            // MurmurHash3_x86_128 logic
             block0 *= c1;
             block0 = std::rotl(block0, 31);
             block0 *= c2;
@@ -64,28 +85,25 @@ namespace harc::prepass {
             h2 = h2 * 5 + 0x38495ab5;
         }
 
-        // Process final partial block
-        if (block_remainders != 0) {
+        ///
+        /// \param ptr Pointer to final partial block
+        /// \param n Number of bytes in partial block. Less than block_size.
+        void consume_tail(const char* ptr, std::uint64_t n) {
+            if (n == 0) {
+                return;
+            }
+
             // Load 128-bit block
             std::uint64_t block0 = 0;
-            std::memcpy(
-                &block0,
-                unit.source.data() + i,
-                std::min(block_remainders, sizeof(std::uint64_t))
-            );
+            std::memcpy(&block0, ptr, std::min(n, sizeof(std::uint64_t)));
 
             std::uint64_t block1 = 0;
             std::memcpy(
                 &block1,
-                unit.source.data() + i + block_size /  2,
-                block_remainders - std::min(block_remainders, sizeof(std::uint64_t))
+                ptr + block_size / 2,
+                n - std::min(n, sizeof(std::uint64_t))
             );
 
-            // Codepoint counting logic
-            codepoint_count -= std::popcount(((~block0 << 1) & block0) & 0x8080808080808080ull);
-            codepoint_count -= std::popcount(((~block1 << 1) & block1) & 0x8080808080808080ull);
-
-            // MurmurHash3_x86_128 logic
             block0 *= c1;
             block0  = std::rotl(block0, 31);
             block0 *= c2;
@@ -93,31 +111,720 @@ namespace harc::prepass {
 
             block1 *= c2;
             block1  = std::rotl(block1, 33);
-            block1 = c1;
+            block1 *= c1;
             h2 ^= block1;
         }
 
-        // MurmurHash3_x86_128 finalization logic
-        h1 ^= unit.source.size();
-        h2 ^= unit.source.size();
+        ///
+        /// \param length Total number of bytes hashed
+        /// \return Final hash value
+        std::array<std::uint64_t, 2> finalize(std::uint64_t length) {
+            h1 ^= length;
+            h2 ^= length;
+
+            h1 += h2;
+            h2 += h1;
+
+            h1 = fmix64(h1);
+            h2 = fmix64(h2);
+
+            h1 += h2;
+            h2 += h1;
+
+            return {h1, h2};
+        }
+    };
+
+    //=====================================================
+    // Helper functions
+    //=====================================================
+
+    ///
+    /// Appends the start of each line which begins after a line feed in the
+    /// current block
+    ///
+    /// \param line_indices Vector to append line starts to
+    /// \param newlines Mask of line feed bytes in block
+    /// \param block_index Index of first byte of block
+    inline void record_line_starts(
+        std::vector<std::uint32_t>& line_indices,
+        std::uint64_t newlines,
+        std::size_t block_index
+    ) {
+        while (newlines != 0) {
+            auto bit = std::countr_zero(newlines);
+            line_indices.push_back(block_index + bit + 1);
+            newlines &= newlines - 1;
+        }
+    }
+
+    ///
+    /// \param c Arbitrary byte
+    /// \return True if c is a UTF-8 continuation byte
+    constexpr bool is_continuation_byte(std::uint8_t c) {
+        return (c & 0xC0) == 0x80;
+    }
+
+    ///
+    /// Decodes the source one codepoint at a time to locate every UTF-8
+    /// error precisely. Only invoked once a kernel has determined that the
+    /// source contains an error, or that it contains non-ASCII bytes in the
+    /// case of the scalar kernel.
+    ///
+    /// \param source Source to validate
+    /// \return List of errors in order of occurrence
+    std::vector<Error> find_utf8_errors(std::string_view source) {
+        std::vector<Error> ret;
+
+        auto report = [&ret] (Error_code code, std::size_t begin, std::size_t end) {
+            if (ret.size() < max_reported_errors) {
+                ret.push_back(Error{code, std::uint32_t(begin), std::uint32_t(end)});
+            }
+        };
+
+        std::size_t i = 0;
+        while (i < source.size() && ret.size() < max_reported_errors) {
+            std::uint8_t lead = source[i];
+
+            if (lead < 0x80) {
+                i += 1;
+                continue;
+            }
+
+            // Runs of stray continuation bytes are reported as a single error
+            if (is_continuation_byte(lead)) {
+                std::size_t end = i + 1;
+                while (end < source.size() && is_continuation_byte(source[end])) {
+                    ++end;
+                }
+
+                report(Error_code::INVALID_UTF8_EXCESSIVE_CONTINUATION_BYTES, i, end);
+                i = end;
+                continue;
+            }
+
+            // Lead bytes of five and six byte sequences could only encode
+            // codepoints beyond U+10FFFF
+            if (lead >= 0xF8) {
+                report(Error_code::INVALID_UTF8_CODEPOINT_GREATER_THAN_U10FFFF, i, i + 1);
+                i += 1;
+                continue;
+            }
+
+            std::size_t length = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : 2;
+
+            std::size_t end = i + 1;
+            while (end < i + length && end < source.size() && is_continuation_byte(source[end])) {
+                ++end;
+            }
+
+            if (end != i + length) {
+                report(Error_code::INVALID_UTF8_INSUFFICIENT_CONTINUATION_BYTES, i, end);
+                i = end;
+                continue;
+            }
+
+            constexpr std::array<std::uint8_t, 5> lead_masks{0x00, 0x00, 0x1F, 0x0F, 0x07};
+            constexpr std::array<std::uint32_t, 5> minimum_codepoints{0x00, 0x00, 0x80, 0x800, 0x10000};
+
+            std::uint32_t codepoint = lead & lead_masks[length];
+            for (std::size_t j = i + 1; j < end; ++j) {
+                codepoint = (codepoint << 6) | (std::uint8_t(source[j]) & 0x3F);
+            }
+
+            if (codepoint < minimum_codepoints[length]) {
+                report(Error_code::INVALID_UTF8_NON_SHORTEST_FORM, i, end);
+            } else if (0xD800 <= codepoint && codepoint <= 0xDFFF) {
+                report(Error_code::INVALID_UTF8_CODEPOINT_IS_SURROGATE_VALUE, i, end);
+            } else if (codepoint > 0x10FFFF) {
+                report(Error_code::INVALID_UTF8_CODEPOINT_GREATER_THAN_U10FFFF, i, end);
+            }
+
+            i = end;
+        }
+
+        return ret;
+    }
 
-        h1 += h2;
-        h2 += h1;
+    ///
+    /// Populates the fields of the results which are derived from the
+    /// values accumulated by a kernel
+    ///
+    /// \param results Results to complete
+    /// \param source Source on which the prepass was performed
+    /// \param continuation_count Number of UTF-8 continuation bytes
+    /// \param is_ascii True if no byte has its MSB set
+    /// \param has_utf8_errors True if the source may not be valid UTF-8
+    /// \param hash State of the hash after consuming all bytes
+    void finish_results(
+        Prepass_results& results,
+        std::string_view source,
+        std::uint64_t continuation_count,
+        bool is_ascii,
+        bool has_utf8_errors,
+        Murmur_state& hash
+    ) {
+        results.is_ascii = is_ascii;
+        results.codepoint_count = source.size() - continuation_count;
+        results.hash = hash.finalize(source.size());
 
-        h1 = fmix64(h1);
-        h2 = fmix64(h2);
+        if (has_utf8_errors) {
+            results.errors = find_utf8_errors(source);
+        }
+    }
 
-        h1 += h2;
-        h2 += h1;
+    ///
+    /// \param source Source to perform prepass on
+    /// \return Results with line_indices prepared for appending
+    Prepass_results initial_results(std::string_view source) {
+        // Guess number of lines and reserve enough space
+        constexpr std::size_t bytes_per_line_estimate = 32;
 
-        //Populate output variable
         Prepass_results results;
-        results.is_ascii = codepoint_count == unit.source.size();
-        results.codepoint_count = codepoint_count;
-        results.hash[0] = h1;
-        results.hash[1] = h2;
+        results.line_indices.reserve(source.size() / bytes_per_line_estimate + 1);
+        results.line_indices.push_back(0);
+        return results;
+    }
+
+    //=====================================================
+    // Scalar kernel
+    //=====================================================
+
+    Prepass_results prepass_scalar(std::string_view source) {
+        auto results = initial_results(source);
+        Murmur_state hash{};
+
+        constexpr std::uint64_t high_bits = 0x8080808080808080ull;
+        constexpr std::uint64_t low_bits = 0x7F7F7F7F7F7F7F7Full;
+        constexpr std::uint64_t line_feeds = 0x0A0A0A0A0A0A0A0Aull;
+
+        std::uint64_t continuation_count = 0;
+        std::uint64_t msb_bits = 0;
+
+        auto consume_word = [&] (const char* ptr, std::size_t index) {
+            std::uint64_t word;
+            std::memcpy(&word, ptr, sizeof(std::uint64_t));
+
+            msb_bits |= word & high_bits;
+
+            // Continuation bytes have their MSB set and the next bit cleared
+            continuation_count += std::popcount(((~word << 1) & word) & high_bits);
+
+            // Exact per-byte equality with line feed
+            std::uint64_t t = word ^ line_feeds;
+            std::uint64_t newlines = ~(((t & low_bits) + low_bits) | t) & high_bits;
+            while (newlines != 0) {
+                auto bit = std::countr_zero(newlines);
+                results.line_indices.push_back(index + bit / 8 + 1);
+                newlines &= newlines - 1;
+            }
+        };
+
+        std::size_t i = 0;
+        for (; i + block_width <= source.size(); i += block_width) {
+            const char* ptr = source.data() + i;
+            for (std::size_t j = 0; j < block_width; j += sizeof(std::uint64_t)) {
+                consume_word(ptr + j, i + j);
+            }
+
+            for (std::size_t j = 0; j < block_width; j += Murmur_state::block_size) {
+                hash.consume_block(ptr + j);
+            }
+        }
+
+        // Process final partial block, padded with null bytes
+        if (i < source.size()) {
+            alignas(block_width) char buffer[block_width]{};
+            std::memcpy(buffer, source.data() + i, source.size() - i);
+
+            for (std::size_t j = 0; j < block_width; j += sizeof(std::uint64_t)) {
+                consume_word(buffer + j, i + j);
+            }
+
+            std::size_t j = 0;
+            for (; i + j + Murmur_state::block_size <= source.size(); j += Murmur_state::block_size) {
+                hash.consume_block(buffer + j);
+            }
+            hash.consume_tail(buffer + j, source.size() - i - j);
+        }
+
+        // Non-ASCII sources are fully decoded since there is no cheap way to
+        // validate them one word at a time
+        bool is_ascii = (msb_bits == 0);
+        finish_results(results, source, continuation_count, is_ascii, !is_ascii, hash);
+
+        return results;
+    }
+
+    //=====================================================
+    // SIMD kernels
+    //=====================================================
+
+    #if HARC_PREPASS_X86_KERNELS
+
+    // UTF-8 validation follows the lookup algorithm of Keiser and Lemire,
+    // "Validating UTF-8 In Less Than One Instruction Per Byte". Each byte is
+    // checked against the byte before it using three 16-entry tables indexed
+    // by nibbles. Errors which span more than two bytes are caught by
+    // checking that the third and fourth bytes of multi-byte sequences are
+    // continuation bytes. Tables are repeated for each 128-bit lane.
+
+    constexpr std::uint8_t too_short   = 1 << 0; // 11______ 0_______, 11______ 11______
+    constexpr std::uint8_t too_long    = 1 << 1; // 0_______ 10______
+    constexpr std::uint8_t overlong_3  = 1 << 2; // 11100000 100_____
+    constexpr std::uint8_t too_large   = 1 << 3; // 11110100 1001____ and above
+    constexpr std::uint8_t surrogate   = 1 << 4; // 11101101 101_____
+    constexpr std::uint8_t overlong_2  = 1 << 5; // 1100000_ 10______
+    constexpr std::uint8_t too_large_1000 = 1 << 6; // 11110101 1000____ and above
+    constexpr std::uint8_t overlong_4  = 1 << 6; // 11110000 1000____
+    constexpr std::uint8_t two_conts   = 1 << 7; // 10______ 10______
+    constexpr std::uint8_t carry = too_short | too_long | two_conts;
+
+    ///
+    /// \param table 16 table entries
+    /// \return Table repeated for each 128-bit lane of a 512-bit vector
+    constexpr std::array<std::uint8_t, 64> replicate_lanes(const std::array<std::uint8_t, 16>& table) {
+        std::array<std::uint8_t, 64> ret{};
+        for (std::size_t i = 0; i < ret.size(); ++i) {
+            ret[i] = table[i % table.size()];
+        }
+        return ret;
+    }
+
+    ///
+    /// Indexed by high nibble of previous byte
+    ///
+    alignas(64) constexpr std::array<std::uint8_t, 64> byte_1_high_table = replicate_lanes({
+        too_long, too_long, too_long, too_long,
+        too_long, too_long, too_long, too_long,
+        two_conts, two_conts, two_conts, two_conts,
+        too_short | overlong_2,
+        too_short,
+        too_short | overlong_3 | surrogate,
+        too_short | too_large | too_large_1000 | overlong_4
+    });
+
+    ///
+    /// Indexed by low nibble of previous byte
+    ///
+    alignas(64) constexpr std::array<std::uint8_t, 64> byte_1_low_table = replicate_lanes({
+        carry | overlong_3 | overlong_2 | overlong_4,
+        carry | overlong_2,
+        carry,
+        carry,
+        carry | too_large,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000 | surrogate,
+        carry | too_large | too_large_1000,
+        carry | too_large | too_large_1000
+    });
+
+    ///
+    /// Indexed by high nibble of current byte
+    ///
+    alignas(64) constexpr std::array<std::uint8_t, 64> byte_2_high_table = replicate_lanes({
+        too_short, too_short, too_short, too_short,
+        too_short, too_short, too_short, too_short,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+        too_long | overlong_2 | two_conts | overlong_3 | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_long | overlong_2 | two_conts | surrogate | too_large,
+        too_short, too_short, too_short, too_short
+    });
+
+    ///
+    /// Largest values which the final three bytes of a vector may take
+    /// without beginning a sequence which continues past the vector
+    ///
+    alignas(64) constexpr std::array<std::uint8_t, 64> incomplete_thresholds = [] () {
+        std::array<std::uint8_t, 64> ret{};
+        std::fill(ret.begin(), ret.end(), 0xFF);
+        ret[61] = 0xF0 - 1;
+        ret[62] = 0xE0 - 1;
+        ret[63] = 0xC0 - 1;
+        return ret;
+    }();
+
+    //=================================================
+    // AVX2 kernel
+    //=================================================
+
+    ///
+    /// UTF-8 validation state carried between vectors
+    ///
+    struct Avx2_utf8_state {
+        __m256i error;
+        __m256i prev_input;
+        __m256i prev_incomplete;
+    };
+
+    ///
+    /// \tparam N Number of bytes to shift in from prev_input
+    /// \return The bytes of input shifted up by N bytes, with the last N
+    /// bytes of prev_input shifted in
+    template<int N>
+    [[gnu::target("avx2")]]
+    inline __m256i prev_bytes_avx2(__m256i input, __m256i prev_input) {
+        return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - N);
+    }
+
+    [[gnu::target("avx2")]]
+    inline __m256i lookup_avx2(const std::array<std::uint8_t, 64>& table, __m256i indices) {
+        auto t = _mm256_load_si256(reinterpret_cast<const __m256i*>(table.data()));
+        return _mm256_shuffle_epi8(t, indices);
+    }
+
+    [[gnu::target("avx2")]]
+    inline void check_utf8_avx2(Avx2_utf8_state& state, __m256i input) {
+        if (_mm256_movemask_epi8(input) == 0) {
+            state.error = _mm256_or_si256(state.error, state.prev_incomplete);
+            state.prev_incomplete = _mm256_setzero_si256();
+            state.prev_input = input;
+            return;
+        }
+
+        const __m256i low_nibble_mask = _mm256_set1_epi8(0x0F);
+
+        __m256i prev1 = prev_bytes_avx2<1>(input, state.prev_input);
+        __m256i prev1_high = _mm256_and_si256(_mm256_srli_epi16(prev1, 4), low_nibble_mask);
+        __m256i prev1_low = _mm256_and_si256(prev1, low_nibble_mask);
+        __m256i input_high = _mm256_and_si256(_mm256_srli_epi16(input, 4), low_nibble_mask);
+
+        __m256i special_cases = _mm256_and_si256(
+            _mm256_and_si256(lookup_avx2(byte_1_high_table, prev1_high), lookup_avx2(byte_1_low_table, prev1_low)),
+            lookup_avx2(byte_2_high_table, input_high)
+        );
+
+        // Third and fourth bytes of sequences must be continuation bytes
+        __m256i prev2 = prev_bytes_avx2<2>(input, state.prev_input);
+        __m256i prev3 = prev_bytes_avx2<3>(input, state.prev_input);
+        __m256i is_third_byte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xE0 - 0x80)));
+        __m256i is_fourth_byte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xF0 - 0x80)));
+        __m256i must_be_continuation = _mm256_and_si256(
+            _mm256_or_si256(is_third_byte, is_fourth_byte),
+            _mm256_set1_epi8(char(0x80))
+        );
+
+        state.error = _mm256_or_si256(state.error, _mm256_xor_si256(must_be_continuation, special_cases));
+
+        auto thresholds = _mm256_load_si256(reinterpret_cast<const __m256i*>(incomplete_thresholds.data() + 32));
+        state.prev_incomplete = _mm256_subs_epu8(input, thresholds);
+        state.prev_input = input;
+    }
+
+    ///
+    /// \param state Validation state to update
+    /// \param line_indices Vector to append line starts to
+    /// \param msb_bits Accumulated bitwise OR of all bytes
+    /// \param continuation_count Running count of continuation bytes
+    /// \param ptr Pointer to block_width bytes
+    /// \param index Index of first byte of block within source
+    [[gnu::target("avx2,popcnt")]]
+    inline void consume_block_avx2(
+        Avx2_utf8_state& state,
+        std::vector<std::uint32_t>& line_indices,
+        __m256i& msb_bits,
+        std::uint64_t& continuation_count,
+        const char* ptr,
+        std::size_t index
+    ) {
+        const __m256i line_feeds = _mm256_set1_epi8('\n');
+        const __m256i continuation_limit = _mm256_set1_epi8(-64);
+
+        __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + 32));
+
+        msb_bits = _mm256_or_si256(msb_bits, _mm256_or_si256(v0, v1));
+
+        // Continuation bytes are those less than 0xC0 when interpreted as
+        // signed values
+        std::uint64_t continuations =
+            std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpgt_epi8(continuation_limit, v0)))) |
+            std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpgt_epi8(continuation_limit, v1)))) << 32;
+        continuation_count += std::popcount(continuations);
+
+        std::uint64_t newlines =
+            std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v0, line_feeds)))) |
+            std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v1, line_feeds)))) << 32;
+        record_line_starts(line_indices, newlines, index);
+
+        check_utf8_avx2(state, v0);
+        check_utf8_avx2(state, v1);
+    }
+
+    [[gnu::target("avx2,popcnt")]]
+    Prepass_results prepass_avx2(std::string_view source) {
+        auto results = initial_results(source);
+        Murmur_state hash{};
+
+        Avx2_utf8_state utf8_state{
+            _mm256_setzero_si256(),
+            _mm256_setzero_si256(),
+            _mm256_setzero_si256()
+        };
+
+        std::uint64_t continuation_count = 0;
+        __m256i msb_bits = _mm256_setzero_si256();
+
+        std::size_t i = 0;
+        for (; i + block_width <= source.size(); i += block_width) {
+            const char* ptr = source.data() + i;
+            consume_block_avx2(utf8_state, results.line_indices, msb_bits, continuation_count, ptr, i);
+
+            for (std::size_t j = 0; j < block_width; j += Murmur_state::block_size) {
+                hash.consume_block(ptr + j);
+            }
+        }
+
+        // Process final partial block, padded with null bytes
+        if (i < source.size()) {
+            alignas(block_width) char buffer[block_width]{};
+            std::memcpy(buffer, source.data() + i, source.size() - i);
+            consume_block_avx2(utf8_state, results.line_indices, msb_bits, continuation_count, buffer, i);
+
+            std::size_t j = 0;
+            for (; i + j + Murmur_state::block_size <= source.size(); j += Murmur_state::block_size) {
+                hash.consume_block(buffer + j);
+            }
+            hash.consume_tail(buffer + j, source.size() - i - j);
+        }
+
+        __m256i error = _mm256_or_si256(utf8_state.error, utf8_state.prev_incomplete);
+
+        bool is_ascii = _mm256_movemask_epi8(msb_bits) == 0;
+        bool has_utf8_errors = !_mm256_testz_si256(error, error);
+        finish_results(results, source, continuation_count, is_ascii, has_utf8_errors, hash);
+
+        return results;
+    }
+
+    //=================================================
+    // AVX-512 kernel
+    //=================================================
+
+    ///
+    /// UTF-8 validation state carried between vectors
+    ///
+    struct Avx512_utf8_state {
+        __m512i error;
+        __m512i prev_input;
+        __m512i prev_incomplete;
+    };
+
+    ///
+    /// \tparam N Number of bytes to shift in from prev_input
+    /// \return The bytes of input shifted up by N bytes, with the last N
+    /// bytes of prev_input shifted in
+    template<int N>
+    [[gnu::target("avx512f,avx512bw")]]
+    inline __m512i prev_bytes_avx512(__m512i input, __m512i prev_input) {
+        // Lanes of the previous 128 bytes which precede each lane of input.
+        // The unmasked intrinsic passes an undefined vector through, which
+        // GCC warns may be uninitialized.
+        __m512i preceding_lanes = _mm512_mask_alignr_epi32(_mm512_setzero_si512(), 0xFFFF, input, prev_input, 12);
+        return _mm512_alignr_epi8(input, preceding_lanes, 16 - N);
+    }
+
+    [[gnu::target("avx512f,avx512bw")]]
+    inline __m512i lookup_avx512(const std::array<std::uint8_t, 64>& table, __m512i indices) {
+        auto t = _mm512_load_si512(table.data());
+        return _mm512_shuffle_epi8(t, indices);
+    }
+
+    [[gnu::target("avx512f,avx512bw")]]
+    inline void check_utf8_avx512(Avx512_utf8_state& state, __m512i input) {
+        if (_mm512_movepi8_mask(input) == 0) {
+            state.error = _mm512_or_si512(state.error, state.prev_incomplete);
+            state.prev_incomplete = _mm512_setzero_si512();
+            state.prev_input = input;
+            return;
+        }
+
+        const __m512i low_nibble_mask = _mm512_set1_epi8(0x0F);
+
+        __m512i prev1 = prev_bytes_avx512<1>(input, state.prev_input);
+        __m512i prev1_high = _mm512_and_si512(_mm512_srli_epi16(prev1, 4), low_nibble_mask);
+        __m512i prev1_low = _mm512_and_si512(prev1, low_nibble_mask);
+        __m512i input_high = _mm512_and_si512(_mm512_srli_epi16(input, 4), low_nibble_mask);
+
+        __m512i special_cases = _mm512_and_si512(
+            _mm512_and_si512(lookup_avx512(byte_1_high_table, prev1_high), lookup_avx512(byte_1_low_table, prev1_low)),
+            lookup_avx512(byte_2_high_table, input_high)
+        );
+
+        // Third and fourth bytes of sequences must be continuation bytes
+        __m512i prev2 = prev_bytes_avx512<2>(input, state.prev_input);
+        __m512i prev3 = prev_bytes_avx512<3>(input, state.prev_input);
+        __m512i is_third_byte = _mm512_subs_epu8(prev2, _mm512_set1_epi8(char(0xE0 - 0x80)));
+        __m512i is_fourth_byte = _mm512_subs_epu8(prev3, _mm512_set1_epi8(char(0xF0 - 0x80)));
+        __m512i must_be_continuation = _mm512_and_si512(
+            _mm512_or_si512(is_third_byte, is_fourth_byte),
+            _mm512_set1_epi8(char(0x80))
+        );
+
+        state.error = _mm512_or_si512(state.error, _mm512_xor_si512(must_be_continuation, special_cases));
+
+        auto thresholds = _mm512_load_si512(incomplete_thresholds.data());
+        state.prev_incomplete = _mm512_subs_epu8(input, thresholds);
+        state.prev_input = input;
+    }
+
+    ///
+    /// \param state Validation state to update
+    /// \param line_indices Vector to append line starts to
+    /// \param msb_bits Accumulated mask of bytes with their MSB set
+    /// \param continuation_count Running count of continuation bytes
+    /// \param v Block of block_width bytes
+    /// \param index Index of first byte of block within source
+    [[gnu::target("avx512f,avx512bw,popcnt")]]
+    inline void consume_block_avx512(
+        Avx512_utf8_state& state,
+        std::vector<std::uint32_t>& line_indices,
+        __mmask64& msb_bits,
+        std::uint64_t& continuation_count,
+        __m512i v,
+        std::size_t index
+    ) {
+        const __m512i line_feeds = _mm512_set1_epi8('\n');
+        const __m512i continuation_limit = _mm512_set1_epi8(-64);
+
+        msb_bits |= _mm512_movepi8_mask(v);
+
+        // Continuation bytes are those less than 0xC0 when interpreted as
+        // signed values
+        continuation_count += std::popcount(std::uint64_t(_mm512_cmplt_epi8_mask(v, continuation_limit)));
+
+        record_line_starts(line_indices, _mm512_cmpeq_epi8_mask(v, line_feeds), index);
+
+        check_utf8_avx512(state, v);
+    }
+
+    [[gnu::target("avx512f,avx512bw,popcnt")]]
+    Prepass_results prepass_avx512(std::string_view source) {
+        auto results = initial_results(source);
+        Murmur_state hash{};
+
+        Avx512_utf8_state utf8_state{
+            _mm512_setzero_si512(),
+            _mm512_setzero_si512(),
+            _mm512_setzero_si512()
+        };
+
+        std::uint64_t continuation_count = 0;
+        __mmask64 msb_bits = 0;
+
+        std::size_t i = 0;
+        for (; i + block_width <= source.size(); i += block_width) {
+            const char* ptr = source.data() + i;
+            consume_block_avx512(utf8_state, results.line_indices, msb_bits, continuation_count, _mm512_loadu_si512(ptr), i);
+
+            for (std::size_t j = 0; j < block_width; j += Murmur_state::block_size) {
+                hash.consume_block(ptr + j);
+            }
+        }
+
+        // Process final partial block. Masked load fills the remainder with
+        // null bytes without reading past the end of the source.
+        if (i < source.size()) {
+            std::size_t remainder = source.size() - i;
+            __mmask64 load_mask = (std::uint64_t{1} << remainder) - 1;
+            __m512i v = _mm512_maskz_loadu_epi8(load_mask, source.data() + i);
+            consume_block_avx512(utf8_state, results.line_indices, msb_bits, continuation_count, v, i);
+
+            std::size_t j = 0;
+            for (; j + Murmur_state::block_size <= remainder; j += Murmur_state::block_size) {
+                hash.consume_block(source.data() + i + j);
+            }
+            hash.consume_tail(source.data() + i + j, remainder - j);
+        }
+
+        __m512i error = _mm512_or_si512(utf8_state.error, utf8_state.prev_incomplete);
+
+        bool is_ascii = (msb_bits == 0);
+        bool has_utf8_errors = _mm512_test_epi8_mask(error, error) != 0;
+        finish_results(results, source, continuation_count, is_ascii, has_utf8_errors, hash);
 
         return results;
     }
 
+    #endif
+
+    //=====================================================
+    // Errors
+    //=====================================================
+
+    std::string_view to_string(Error_code error) {
+        switch (error) {
+            case Error_code::NO_ERROR:
+                return "No error";
+            case Error_code::INVALID_UTF8_NON_SHORTEST_FORM:
+                return "Overlong UTF-8 sequence";
+            case Error_code::INVALID_UTF8_INSUFFICIENT_CONTINUATION_BYTES:
+                return "UTF-8 sequence is missing continuation bytes";
+            case Error_code::INVALID_UTF8_EXCESSIVE_CONTINUATION_BYTES:
+                return "Unexpected UTF-8 continuation byte";
+            case Error_code::INVALID_UTF8_CODEPOINT_IS_SURROGATE_VALUE:
+                return "UTF-8 sequence encodes a surrogate codepoint";
+            case Error_code::INVALID_UTF8_CODEPOINT_GREATER_THAN_U10FFFF:
+                return "UTF-8 sequence encodes a codepoint greater than U+10FFFF";
+        }
+
+        return "Unknown error";
+    }
+
+    //=====================================================
+    // Kernel selection
+    //=====================================================
+
+    ///
+    /// \return Widest kernel supported by host CPU
+    Prepass_kernel detect_kernel() {
+        #if HARC_PREPASS_X86_KERNELS
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            return Prepass_kernel::AVX512;
+        }
+
+        if (__builtin_cpu_supports("avx2")) {
+            return Prepass_kernel::AVX2;
+        }
+        #endif
+
+        return Prepass_kernel::SCALAR;
+    }
+
+    Prepass_kernel selected_kernel() {
+        static const Prepass_kernel kernel = detect_kernel();
+        return kernel;
+    }
+
+    //=====================================================
+    // Prepass
+    //=====================================================
+
+    Prepass_results prepass(std::string_view source, Prepass_kernel kernel) {
+        switch (kernel) {
+            #if HARC_PREPASS_X86_KERNELS
+            case Prepass_kernel::AVX512:
+                return prepass_avx512(source);
+            case Prepass_kernel::AVX2:
+                return prepass_avx2(source);
+            #endif
+            default:
+                return prepass_scalar(source);
+        }
+    }
+
+    Prepass_results prepass(const Translation_unit& unit) {
+        return prepass(unit.source, selected_kernel());
+    }
+
 }
@@ -0,0 +1,365 @@
+#!/usr/bin/env python3
+
+# Generates synthetic Harmonia sources for benchmarking and scaling
+# experiments, e.g. measuring how a local build scales with file count and
+# file size. Output is deterministic for a given set of arguments.
+#
+# Example:
+#     Generate_corpus.py out/ --files 1000 --file-size 64K
+#     Harc $(cat out/sources.txt)
+#
+# Sources are spread across subdirectories of at most 1000 files each, and
+# the path of every generated file is listed in sources.txt.
+
+import argparse
+import os
+import random
+import sys
+
+keywords = {
+    'alias', 'do', 'else', 'for', 'func', 'if', 'in', 'lambda', 'let',
+    'module', 'return', 'struct', 'var', 'while'
+}
+
+ascii_stems = [
+    'index', 'count', 'value', 'result', 'buffer', 'offset', 'length', 'node',
+    'token', 'source', 'width', 'height', 'scale', 'vector', 'matrix',
+    'element', 'total', 'limit', 'entry', 'state', 'delta', 'sample', 'phase',
+    'weight', 'cursor', 'range', 'key', 'item', 'span', 'depth'
+]
+
+# Identifier codepoints beyond ASCII, drawn from several scripts and from
+# both two and three byte UTF-8 sequences
+non_ascii_start_stems = [
+    'é', 'ñ', 'ø', 'ß', 'ש', 'ع', '数', '値', '長', '幅', '点', '가', '값'
+]
+
+# Codepoints which Harc's Unicode tables only permit after the first
+# codepoint of an identifier
+non_ascii_continue_stems = ['λ', 'π', 'σ', 'ω', 'ж', 'д', 'щ']
+
+non_ascii_text = [
+    'café', 'naïve', 'Ελληνικά', 'кириллица', 'עברית', 'العربية', '日本語',
+    '中文', '한국어', '→', '∑', '≤', '…', '😀'
+]
+
+scalar_types = ['i8', 'i16', 'i32', 'i64', 'u8', 'u16', 'u32', 'u64', 'f32', 'f64', 'bool']
+
+template_types = ['Array', 'Vector', 'Span', 'Optional']
+
+binary_operators = [
+    '+', '-', '*', '/', '%', '&', '|', '^', '<<', '>>', '&&', '||', '^^',
+    '==', '!=', '<', '>', '<=', '>='
+]
+
+assignment_operators = ['=', '+=', '-=', '*=', '/=', '%=', '&=', '|=', '^=', '<<=', '>>=']
+
+prefix_operators = ['-', '+', '!', '~', '++', '--']
+
+escapes = ['\\n', '\\t', '\\\\', '\\"', '\\\'', '\\0']
+
+
+def parse_size(text):
+    multipliers = {'K': 1 << 10, 'M': 1 << 20, 'G': 1 << 30}
+
+    suffix = text[-1:].upper()
+    if suffix in multipliers:
+        return int(text[:-1]) * multipliers[suffix]
+
+    return int(text)
+
+
+class Generator:
+
+    def __init__(self, args, seed, file):
+        self.rng = random.Random(seed)
+        self.max_depth = args.depth
+        self.identifier_length = args.identifier_length
+        self.non_ascii_ratio = args.non_ascii_ratio
+
+        self.depth = 0
+        self.file = file
+        self.size = 0
+
+    #==========================================================================
+    # Output
+    #==========================================================================
+
+    def emit(self, text):
+        self.file.write(text)
+        self.size += len(text.encode('utf-8'))
+
+    def line(self, text):
+        self.emit('    ' * self.depth + text + '\n')
+
+    #==========================================================================
+    # Leaves
+    #==========================================================================
+
+    def is_non_ascii(self):
+        return self.rng.random() < self.non_ascii_ratio
+
+    def identifier(self):
+        rng = self.rng
+
+        parts = []
+        length = 0
+        target = max(1, int(rng.gauss(self.identifier_length, self.identifier_length / 4)))
+        while length < target:
+            if self.is_non_ascii():
+                if parts:
+                    part = rng.choice(non_ascii_start_stems + non_ascii_continue_stems)
+                else:
+                    part = rng.choice(non_ascii_start_stems)
+            else:
+                part = rng.choice(ascii_stems)
+
+            parts.append(part)
+            length += len(part) + 1
+
+        ret = '_'.join(parts)[:max(target, 1)].rstrip('_')
+        if ret in keywords or ret[0].isdigit():
+            ret = '_' + ret
+
+        return ret
+
+    def type_expression(self, depth=0):
+        rng = self.rng
+
+        if depth < 2 and rng.random() < 0.3:
+            return rng.choice(template_types) + '<' + self.type_expression(depth + 1) + '>'
+
+        if rng.random() < 0.15:
+            return 'core.' + rng.choice(scalar_types)
+
+        return rng.choice(scalar_types)
+
+    def numeric_literal(self):
+        rng = self.rng
+
+        kind = rng.randrange(5)
+        if kind == 0:
+            ret = hex(rng.randrange(1 << 32))
+        elif kind == 1:
+            ret = bin(rng.randrange(256))
+        elif kind == 2:
+            ret = '{:.3f}'.format(rng.random() * 1000)
+        else:
+            ret = str(rng.randrange(10000))
+
+        if rng.random() < 0.1:
+            ret += ':' + rng.choice(scalar_types)
+
+        return ret
+
+    def string_literal(self):
+        rng = self.rng
+
+        words = []
+        for _ in range(rng.randrange(1, 6)):
+            if self.is_non_ascii():
+                words.append(rng.choice(non_ascii_text))
+            elif rng.random() < 0.2:
+                words.append(rng.choice(escapes))
+            else:
+                words.append(rng.choice(ascii_stems))
+
+        return '"' + ' '.join(words) + '"'
+
+    def codepoint_literal(self):
+        rng = self.rng
+
+        if self.is_non_ascii():
+            return "'" + rng.choice(non_ascii_text)[0] + "'"
+
+        if rng.random() < 0.2:
+            return "'" + rng.choice(escapes) + "'"
+
+        return "'" + rng.choice('abcdefghijklmnopqrstuvwxyz0123456789') + "'"
+
+    #==========================================================================
+    # Expressions
+    #==========================================================================
+
+    def primary_expression(self, depth):
+        rng = self.rng
+
+        kind = rng.randrange(10)
+        if kind < 4:
+            return self.identifier()
+        if kind == 4:
+            return self.string_literal()
+        if kind == 5:
+            return self.codepoint_literal()
+        if kind == 6 and depth < 3:
+            arguments = ', '.join(self.expression(depth + 1) for _ in range(rng.randrange(4)))
+            return self.identifier() + '(' + arguments + ')'
+        if kind == 7 and depth < 3:
+            return self.identifier() + '[' + self.expression(depth + 1) + ']'
+        if kind == 8 and depth < 3:
+            return self.identifier() + '<' + self.type_expression() + '>(' + self.expression(depth + 1) + ')'
+
+        return self.numeric_literal()
+
+    def expression(self, depth=0):
+        rng = self.rng
+
+        if depth >= self.max_depth + 2:
+            return self.primary_expression(depth)
+
+        kind = rng.randrange(10)
+        if kind < 4:
+            return self.primary_expression(depth)
+        if kind < 8:
+            operator = rng.choice(binary_operators)
+            return self.expression(depth + 1) + ' ' + operator + ' ' + self.expression(depth + 1)
+        if kind == 8:
+            return rng.choice(prefix_operators) + self.primary_expression(depth + 1)
+
+        return '(' + self.expression(depth + 1) + ')'
+
+    def lambda_expression(self):
+        rng = self.rng
+
+        parameter = self.identifier()
+        body = self.expression(self.max_depth)
+        return (
+            'lambda (' + parameter + ': ' + self.type_expression() + ') -> ' + self.type_expression() +
+            ' { return ' + body + '; }'
+        )
+
+    #==========================================================================
+    # Statements
+    #==========================================================================
+
+    def comment(self):
+        rng = self.rng
+
+        kind = rng.randrange(3)
+        if kind == 0:
+            self.line('// ' + self.string_literal()[1:-1])
+        elif kind == 1:
+            self.line('/* ' + self.identifier() + ' /* ' + self.identifier() + ' */ */')
+        else:
+            self.line('/*')
+            self.line(' * ' + self.string_literal()[1:-1])
+            self.line(' */')
+
+    def code_body(self, header):
+        self.line((header + ' {').lstrip())
+        self.depth += 1
+
+        for _ in range(self.rng.randrange(1, 5)):
+            self.statement()
+
+        self.depth -= 1
+
+    def statement(self):
+        rng = self.rng
+
+        is_nestable = self.depth < self.max_depth
+        kind = rng.randrange(12 if is_nestable else 5)
+
+        if kind == 0:
+            self.line('let ' + self.identifier() + ': ' + self.type_expression() + ' = ' + self.expression() + ';')
+        elif kind == 1:
+            self.line('var ' + self.identifier() + ': ' + self.type_expression() + ' = ' + self.expression() + ';')
+        elif kind == 2:
+            self.line(self.identifier() + ' ' + rng.choice(assignment_operators) + ' ' + self.expression() + ';')
+        elif kind == 3:
+            self.line('let ' + self.identifier() + ' = ' + self.lambda_expression() + ';')
+        elif kind == 4:
+            self.comment()
+        elif kind == 5 or kind == 6:
+            self.code_body('if ' + self.expression())
+            for _ in range(rng.randrange(3)):
+                self.code_body('} else if ' + self.expression())
+            if rng.random() < 0.5:
+                self.code_body('} else')
+            self.line('}')
+        elif kind == 7:
+            self.code_body('while ' + self.expression())
+            self.line('}')
+        elif kind == 8:
+            self.code_body('do')
+            self.line('} while ' + self.expression() + ';')
+        elif kind == 9:
+            i = self.identifier()
+            self.code_body('for let ' + i + ' = 0; ' + i + ' < ' + self.expression() + '; ++' + i)
+            self.line('}')
+        elif kind == 10:
+            variables = [self.identifier() for _ in range(rng.randrange(1, 3))]
+            ranges = [self.identifier() for _ in variables]
+            self.code_body('for ' + ', '.join(variables) + ' in ' + ', '.join(ranges))
+            self.line('}')
+        else:
+            self.code_body('')
+            self.line('}')
+
+    #==========================================================================
+    # Top-level constructs
+    #==========================================================================
+
+    def function_definition(self):
+        rng = self.rng
+
+        if rng.random() < 0.5:
+            self.line('/// ' + self.string_literal()[1:-1])
+
+        attributes = ''
+        if rng.random() < 0.2:
+            attributes = rng.choice(['inline', 'pure', 'cold'])
+
+        parameters = ', '.join(
+            self.identifier() + ': ' + self.type_expression() for _ in range(rng.randrange(4))
+        )
+
+        header = 'func[' + attributes + '] ' + self.identifier() + '(' + parameters + ') -> ' + self.type_expression()
+        self.code_body(header)
+        self.depth += 1
+        self.line('return ' + self.expression() + ';')
+        self.depth -= 1
+        self.line('}')
+        self.emit('\n')
+
+    def source_file(self, module_name, target_size):
+        self.emit('module ' + module_name + ';\n\n')
+
+        while self.size < target_size:
+            self.function_definition()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate synthetic Harmonia sources.')
+    parser.add_argument('output_dir', help='Directory to write sources to')
+    parser.add_argument('--files', type=int, default=1, help='Number of source files')
+    parser.add_argument('--file-size', type=parse_size, default=64 * 1024, help='Approximate size of each file, e.g. 1K, 64M, 1G')
+    parser.add_argument('--depth', type=int, default=4, help='Maximum nesting depth of statements')
+    parser.add_argument('--identifier-length', type=int, default=10, help='Mean identifier length in codepoints')
+    parser.add_argument('--non-ascii-ratio', type=float, default=0.0, help='Fraction of identifiers and literal words which are non-ASCII')
+    parser.add_argument('--seed', type=int, default=0, help='Seed for random generation')
+    args = parser.parse_args()
+
+    if not 0.0 <= args.non_ascii_ratio <= 1.0:
+        sys.exit('--non-ascii-ratio must be within [0, 1]')
+
+    paths = []
+    for i in range(args.files):
+        directory = os.path.join(args.output_dir, 'd{:03}'.format(i // 1000))
+        os.makedirs(directory, exist_ok=True)
+
+        module_name = 'corpus.d{:03}.m{:03}'.format(i // 1000, i % 1000)
+
+        path = os.path.join(directory, 'm{:03}.hmn'.format(i % 1000))
+        with open(path, 'w', encoding='utf-8') as f:
+            generator = Generator(args, (args.seed << 32) + i, f)
+            generator.source_file(module_name, args.file_size)
+
+        paths.append(path)
+
+    with open(os.path.join(args.output_dir, 'sources.txt'), 'w') as f:
+        f.write('\n'.join(paths) + '\n')
+
+
+if __name__=="__main__":
+    main()
@@ -0,0 +1,51 @@
+#ifndef HARC_BUILD_CACHE_TESTS_HPP
+#define HARC_BUILD_CACHE_TESTS_HPP
+
+#include <harc/Build_cache.hpp>
+#include <harc/lexer/Lexer.hpp>
+
+#include <filesystem>
+#include <string>
+
+namespace harc::tests {
+
+    TEST(Build_cache, reloading_discards_earlier_state) {
+        auto directory = std::filesystem::temp_directory_path() / "harc_tests_build_cache";
+        std::filesystem::remove_all(directory);
+        auto cache_path = (directory / build_cache_file_name).string();
+
+        Translation_unit unit;
+        unit.source_path = "a.hmn";
+        unit.source_timestamp = 1;
+        unit.set_source(std::string{"module a;\nlet x = (1 + 2);\n"});
+        unit.tokenization = lex::lex(unit.source_path, unit.source);
+        unit.tokens = lex::Tokenization_view{unit.tokenization};
+
+        Build_cache cache;
+        EXPECT_EQ(cache.load(directory.string(), Caching_policy::TIMESTAMP), Error_code::INACCESSIBLE_BUILD_CACHE);
+        cache.record(unit);
+        ASSERT_EQ(cache.store(directory.string()), Error_code::NO_ERROR);
+        auto cache_size = std::filesystem::file_size(cache_path);
+
+        // Records from the previous build are not stored a second time
+        for (int i = 0; i < 2; ++i) {
+            ASSERT_EQ(cache.load(directory.string(), Caching_policy::TIMESTAMP), Error_code::NO_ERROR);
+            ASSERT_NE(cache.find("a.hmn", 1), nullptr);
+            EXPECT_EQ(cache.find("a.hmn", 2), nullptr);
+
+            cache.record(unit);
+            ASSERT_EQ(cache.store(directory.string()), Error_code::NO_ERROR);
+            EXPECT_EQ(std::filesystem::file_size(cache_path), cache_size);
+        }
+
+        // Entries of an earlier load do not survive a load which fails
+        std::filesystem::remove_all(directory);
+        EXPECT_NE(cache.load(directory.string(), Caching_policy::TIMESTAMP), Error_code::NO_ERROR);
+        EXPECT_EQ(cache.find("a.hmn", 1), nullptr);
+
+        std::filesystem::remove_all(directory);
+    }
+
+}
+
+#endif //HARC_BUILD_CACHE_TESTS_HPP
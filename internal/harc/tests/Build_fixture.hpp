@@ -0,0 +1,94 @@
+#ifndef HARC_BUILD_FIXTURE_HPP
+#define HARC_BUILD_FIXTURE_HPP
+
+#include <harc/Harc.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace harc::tests {
+
+    ///
+    /// Source files written to a temporary directory for the duration of a
+    /// test, which are built through run_locally
+    ///
+    struct Build_fixture {
+
+        std::filesystem::path directory{};
+
+        std::vector<std::string> paths{};
+
+        explicit Build_fixture(std::string_view name):
+            directory(std::filesystem::temp_directory_path() / ("harc_tests_" + std::string{name})) {
+            std::filesystem::remove_all(directory);
+            std::filesystem::create_directories(directory);
+        }
+
+        ~Build_fixture() {
+            std::error_code ec;
+            std::filesystem::remove_all(directory, ec);
+        }
+
+        void add_source(std::string_view file_name, std::string_view source) {
+            auto path = directory / file_name;
+            std::ofstream{path, std::ios::binary} << source;
+            paths.push_back(path.string());
+        }
+
+        ///
+        /// \return Configuration of an unbatched, unchunked build which does
+        /// not touch the build cache
+        Config config() const {
+            Config ret{};
+            ret.caching_policy = Caching_policy::DISABLED;
+            ret.thread_count = 4;
+            return ret;
+        }
+
+        ///
+        /// \param config Configuration of build
+        /// \return Messages printed by the build
+        std::string build(const Config& config) {
+            std::vector<std::string_view> source_paths{paths.begin(), paths.end()};
+
+            testing::internal::CaptureStdout();
+            run_locally(source_paths, config);
+            return testing::internal::GetCapturedStdout();
+        }
+
+    };
+
+    ///
+    /// Adds a handful of small sources to fixture, some of which fail to lex
+    /// or parse, so that builds print messages which can be compared
+    ///
+    inline void add_mixed_sources(Build_fixture& fixture) {
+        fixture.add_source("a.hmn", "module a;\nfunc f(x: i32) -> i32 {\n    return x * 2;\n}\n");
+        fixture.add_source("b.hmn", "module b;\nfunc g() -> () { a b; }\n");
+        fixture.add_source("c.hmn", "module c;\nlet s = \"abc;\n");
+        fixture.add_source("d.hmn", "module d;\nfunc h() -> () {\n    return;\n}\n");
+        fixture.add_source("e.hmn", "module e;\nfunc k() -> () { let x = (1; }\n");
+    }
+
+    ///
+    /// \param function_count Number of functions in source
+    /// \param broken_function Malformed function placed near the middle
+    /// \return Source of several kilobytes with an error near its middle
+    inline std::string large_source(std::uint32_t function_count, std::string_view broken_function) {
+        std::string ret = "module large;\n";
+        for (std::uint32_t i = 0; i < function_count; ++i) {
+            ret += "func f" + std::to_string(i) + "(x: i32) -> i32 {\n    let y = (x + 1) * 2;\n    return y;\n}\n";
+            if (i == function_count / 2) {
+                ret += broken_function;
+            }
+        }
+        return ret;
+    }
+
+}
+
+#endif //HARC_BUILD_FIXTURE_HPP
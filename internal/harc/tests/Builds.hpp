@@ -0,0 +1,39 @@
+#ifndef HARC_BUILDS_TESTS_HPP
+#define HARC_BUILDS_TESTS_HPP
+
+#include "Build_fixture.hpp"
+
+#include <harc/Harc.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace harc::tests {
+
+    TEST(Builds, repeated_builds_report_once) {
+        Build_fixture fixture{"repeated"};
+        add_mixed_sources(fixture);
+
+        auto expected = fixture.build(fixture.config());
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(fixture.build(fixture.config()), expected);
+    }
+
+    TEST(Builds, repeated_server_builds_report_once) {
+        Build_fixture fixture{"repeated_server"};
+        add_mixed_sources(fixture);
+
+        auto expected = fixture.build(fixture.config());
+        std::vector<std::string_view> source_paths{fixture.paths.begin(), fixture.paths.end()};
+
+        for (int i = 0; i < 2; ++i) {
+            testing::internal::CaptureStdout();
+            run_server(source_paths, fixture.config());
+            EXPECT_EQ(testing::internal::GetCapturedStdout(), expected);
+        }
+    }
+
+}
+
+#endif //HARC_BUILDS_TESTS_HPP
@@ -1,6 +1,28 @@
 #include <gtest/gtest.h>
 
+#include "Build_cache.hpp"
+#include "Builds.hpp"
+#include "cli/CLI.hpp"
 #include "common/Algorithms.hpp"
+#include "common/Arena.hpp"
+#include "common/Identifier_table.hpp"
+#include "common/OS_utils.hpp"
+#include "common/String_pool.hpp"
+#include "lexer/Cache.hpp"
+#include "lexer/Chunked_lexing.hpp"
+#include "lexer/Keywords.hpp"
+#include "lexer/Lexer.hpp"
+#include "lexer/Pairing.hpp"
+#include "parser/Body_parsing.hpp"
+#include "parser/Chunked_parsing.hpp"
+#include "parser/Expressions.hpp"
+#include "parser/Flat_parse_tree.hpp"
+#include "Pipeline.hpp"
+#include "prepass/Prepass.hpp"
+#include "Scheduler.hpp"
+#include "Symbols.hpp"
+#include "Timing.hpp"
+#include "Tracing.hpp"
 
 int main(int argc, char* argv[]) {
     ::testing::InitGoogleTest(&argc, argv);
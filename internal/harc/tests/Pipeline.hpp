@@ -0,0 +1,108 @@
+#ifndef HARC_PIPELINE_TESTS_HPP
+#define HARC_PIPELINE_TESTS_HPP
+
+#include "Build_fixture.hpp"
+
+#include <harc/Pipeline.hpp>
+
+#include <vector>
+
+namespace harc::tests {
+
+    struct Pipeline_test_task {
+        Stage stage = Stage::NULL_STEP;
+        int id = 0;
+    };
+
+    ///
+    /// Pipeline whose BACKEND stage waits on every unit passing PARSING, as
+    /// during a build, along with the tasks it has released
+    ///
+    struct Pipeline_fixture {
+
+        Pipeline<Pipeline_test_task> pipeline{};
+
+        std::vector<int> submitted{};
+
+        explicit Pipeline_fixture(std::uint32_t unit_count) {
+            pipeline.initialize(unit_count);
+            pipeline.set_prerequisite(Stage::BACKEND, Stage::PARSING);
+        }
+
+        auto submit() {
+            return [this] (Pipeline_test_task&& task) {
+                submitted.push_back(task.id);
+            };
+        }
+
+        void advance(Stage stage, int id, std::uint32_t unit_count = 1) {
+            pipeline.advance(Pipeline_test_task{stage, id}, submit(), unit_count);
+        }
+
+    };
+
+    TEST(Pipeline, stages_without_prerequisite_released_immediately) {
+        Pipeline_fixture f{2};
+
+        f.advance(Stage::TOKENIZATION, 1);
+        f.advance(Stage::PARSING, 2);
+        EXPECT_EQ(f.submitted, (std::vector<int>{1, 2}));
+
+        EXPECT_EQ(f.pipeline.entered_count(Stage::PARSING), 1);
+        EXPECT_EQ(f.pipeline.in_flight_count(Stage::PARSING), 1);
+    }
+
+    TEST(Pipeline, barrier_parks_until_prerequisite_finished) {
+        Pipeline_fixture f{3};
+
+        f.advance(Stage::BACKEND, 1);
+        f.pipeline.complete(Stage::PARSING, f.submit());
+        f.advance(Stage::BACKEND, 2, 2);
+        EXPECT_TRUE(f.submitted.empty());
+        EXPECT_EQ(f.pipeline.in_flight_count(Stage::BACKEND), 3);
+
+        // A batch of two units completes last and releases every parked task
+        // through the completing worker's submit
+        f.pipeline.complete(Stage::PARSING, f.submit(), 2);
+        EXPECT_EQ(f.submitted, (std::vector<int>{1, 2}));
+        EXPECT_TRUE(f.pipeline.is_stage_finished(Stage::PARSING));
+
+        // Once open, the barrier stays open
+        f.advance(Stage::BACKEND, 3);
+        EXPECT_EQ(f.submitted, (std::vector<int>{1, 2, 3}));
+    }
+
+    TEST(Pipeline, retired_units_pass_later_stages) {
+        Pipeline_fixture f{2};
+
+        f.advance(Stage::BACKEND, 1);
+        f.pipeline.complete(Stage::PARSING, f.submit());
+        EXPECT_TRUE(f.submitted.empty());
+
+        // The other unit failed to tokenize, so never reaches parsing
+        f.pipeline.retire(Stage::TOKENIZATION, f.submit());
+        EXPECT_EQ(f.submitted, (std::vector<int>{1}));
+        EXPECT_EQ(f.pipeline.completed_count(Stage::PARSING), 1);
+        EXPECT_FALSE(f.pipeline.is_stage_finished(Stage::BACKEND));
+    }
+
+    TEST(Pipeline, build_batching_matches_unbatched) {
+        Build_fixture fixture{"batching"};
+        add_mixed_sources(fixture);
+
+        auto expected = fixture.build(fixture.config());
+
+        // From one unit per task up to every unit in a single task
+        for (std::uint32_t budget : {1u, 64u, 128u, 1u << 20}) {
+            auto config = fixture.config();
+            config.task_batch_byte_budget = budget;
+            EXPECT_EQ(fixture.build(config), expected) << budget;
+
+            config.thread_count = 1;
+            EXPECT_EQ(fixture.build(config), expected) << budget;
+        }
+    }
+
+}
+
+#endif //HARC_PIPELINE_TESTS_HPP
@@ -0,0 +1,146 @@
+#ifndef HARC_SCHEDULER_TESTS_HPP
+#define HARC_SCHEDULER_TESTS_HPP
+
+#include <harc/Scheduler.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace harc::tests {
+
+    TEST(Work_stealing_scheduler, owner_pops_newest_first) {
+        Work_stealing_scheduler<int> scheduler{};
+        scheduler.initialize(2);
+
+        scheduler.push(0, 1);
+        scheduler.push(0, 2);
+        scheduler.push(0, 3);
+        EXPECT_EQ(scheduler.outstanding(), 3);
+
+        int task = 0;
+        for (int expected : {3, 2, 1}) {
+            ASSERT_TRUE(scheduler.pop(0, task));
+            EXPECT_EQ(task, expected);
+            scheduler.complete();
+        }
+
+        EXPECT_EQ(scheduler.outstanding(), 0);
+    }
+
+    TEST(Work_stealing_scheduler, thieves_steal_oldest_first) {
+        Work_stealing_scheduler<int> scheduler{};
+        scheduler.initialize(3);
+
+        scheduler.push(0, 1);
+        scheduler.push(0, 2);
+        scheduler.push(0, 3);
+
+        int task = 0;
+        ASSERT_TRUE(scheduler.pop(1, task));
+        EXPECT_EQ(task, 1);
+        ASSERT_TRUE(scheduler.pop(2, task));
+        EXPECT_EQ(task, 2);
+
+        // Own queue is still consumed from the back
+        ASSERT_TRUE(scheduler.pop(0, task));
+        EXPECT_EQ(task, 3);
+    }
+
+    TEST(Work_stealing_scheduler, external_pushes_round_robin) {
+        Work_stealing_scheduler<int> scheduler{};
+        scheduler.initialize(2);
+
+        scheduler.push(1);
+        scheduler.push(2);
+        scheduler.push(3);
+
+        // Queue 0 holds 1 and 3, queue 1 holds 2
+        int task = 0;
+        ASSERT_TRUE(scheduler.pop(1, task));
+        EXPECT_EQ(task, 2);
+        ASSERT_TRUE(scheduler.pop(1, task));
+        EXPECT_EQ(task, 1);
+        ASSERT_TRUE(scheduler.pop(0, task));
+        EXPECT_EQ(task, 3);
+    }
+
+    TEST(Work_stealing_scheduler, terminates_once_idle) {
+        Work_stealing_scheduler<int> scheduler{};
+        scheduler.initialize(1);
+        scheduler.set_terminate_once_idle(true);
+
+        int task = 0;
+        EXPECT_FALSE(scheduler.pop(0, task));
+
+        // A task in flight keeps the scheduler from being idle even though
+        // no task is queued
+        scheduler.push(0, 1);
+        ASSERT_TRUE(scheduler.pop(0, task));
+        scheduler.push(0, 2);
+        scheduler.complete();
+
+        ASSERT_TRUE(scheduler.pop(0, task));
+        EXPECT_EQ(task, 2);
+        scheduler.complete();
+
+        EXPECT_FALSE(scheduler.pop(0, task));
+    }
+
+    TEST(Work_stealing_scheduler, workers_drain_spawned_tasks) {
+        constexpr std::size_t worker_count = 4;
+
+        Work_stealing_scheduler<int> scheduler{};
+        scheduler.initialize(worker_count);
+
+        // Each task of depth n spawns two tasks of depth n - 1
+        scheduler.push(0, 10);
+
+        std::atomic<std::uint32_t> task_count = 0;
+        {
+            std::vector<std::jthread> workers;
+            for (std::size_t i = 0; i < worker_count; ++i) {
+                workers.emplace_back([&, i] {
+                    int depth = 0;
+                    while (scheduler.pop(i, depth)) {
+                        if (depth != 0) {
+                            scheduler.push(i, depth - 1);
+                            scheduler.push(i, depth - 1);
+                        }
+
+                        task_count.fetch_add(1);
+                        scheduler.complete();
+                    }
+                });
+            }
+
+            // Workers sleep rather than exit while this is false, so every
+            // worker is released at once
+            scheduler.set_terminate_once_idle(true);
+        }
+
+        EXPECT_EQ(task_count.load(), (1u << 11) - 1);
+        EXPECT_EQ(scheduler.outstanding(), 0);
+    }
+
+    TEST(Work_stealing_scheduler, sleeping_worker_woken_by_push) {
+        Work_stealing_scheduler<int> scheduler{};
+        scheduler.initialize(2);
+
+        int task = 0;
+        bool popped = false;
+        {
+            std::jthread worker{[&] {
+                popped = scheduler.pop(1, task);
+            }};
+
+            scheduler.push(0, 7);
+        }
+
+        EXPECT_TRUE(popped);
+        EXPECT_EQ(task, 7);
+    }
+
+}
+
+#endif //HARC_SCHEDULER_TESTS_HPP
@@ -0,0 +1,79 @@
+#ifndef HARC_SYMBOLS_TESTS_HPP
+#define HARC_SYMBOLS_TESTS_HPP
+
+#include <harc/Symbols.hpp>
+
+#include <vector>
+
+namespace harc::tests {
+
+    TEST(Symbols, symbol_map) {
+        symbols::Symbol_map<int> map{};
+        EXPECT_EQ(map.find(0), nullptr);
+
+        for (int i = 0; i < 1000; ++i) {
+            auto [value, is_inserted] = map.insert(i * 3, i);
+            EXPECT_TRUE(is_inserted);
+            EXPECT_EQ(*value, i);
+        }
+
+        auto [value, is_inserted] = map.insert(30, -1);
+        EXPECT_FALSE(is_inserted);
+        EXPECT_EQ(*value, 10);
+
+        EXPECT_EQ(map.size(), 1000);
+        for (int i = 0; i < 1000; ++i) {
+            ASSERT_NE(map.find(i * 3), nullptr);
+            EXPECT_EQ(*map.find(i * 3), i);
+            EXPECT_EQ(map.find(i * 3 + 1), nullptr);
+        }
+    }
+
+    TEST(Symbols, reinsertion_does_not_grow) {
+        symbols::Symbol_map<int> map{};
+
+        // The first table holds 8 slots, so a fifth key would grow it
+        std::vector<const int*> values;
+        for (int i = 1; i <= 4; ++i) {
+            values.push_back(map.insert(i, i).first);
+        }
+
+        for (int i = 1; i <= 4; ++i) {
+            auto [value, is_inserted] = map.insert(i, -i);
+            EXPECT_FALSE(is_inserted);
+            EXPECT_EQ(value, values[i - 1]);
+            EXPECT_EQ(*value, i);
+        }
+
+        EXPECT_EQ(map.size(), 4);
+    }
+
+    TEST(Symbols, parent_chain_lookup) {
+        String_pool pool{};
+        auto x = pool.intern("x");
+        auto y = pool.intern("y");
+        auto z = pool.intern("z");
+
+        symbols::Symbol_table outer{};
+        symbols::Symbol_table inner{};
+        inner.parent = &outer;
+
+        outer.private_variables.insert(x, symbols::Variable{nullptr, 1});
+        outer.private_variables.insert(y, symbols::Variable{nullptr, 2});
+        inner.private_variables.insert(y, symbols::Variable{nullptr, 3});
+
+        auto* found_x = inner.find(&symbols::Symbol_table::private_variables, x);
+        auto* found_y = inner.find(&symbols::Symbol_table::private_variables, y);
+
+        ASSERT_NE(found_x, nullptr);
+        ASSERT_NE(found_y, nullptr);
+        EXPECT_EQ(found_x->implementation_hash, 1);
+        EXPECT_EQ(found_y->implementation_hash, 3);
+
+        EXPECT_EQ(inner.find(&symbols::Symbol_table::private_variables, z), nullptr);
+        EXPECT_EQ(inner.find(&symbols::Symbol_table::public_variables, x), nullptr);
+    }
+
+}
+
+#endif //HARC_SYMBOLS_TESTS_HPP
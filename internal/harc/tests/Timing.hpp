@@ -0,0 +1,51 @@
+#ifndef HARC_TIMING_TESTS_HPP
+#define HARC_TIMING_TESTS_HPP
+
+#include <harc/Timing.hpp>
+
+#include <chrono>
+#include <string>
+
+namespace harc::tests {
+
+    TEST(Timing_collector, disabled_by_default) {
+        Timing_collector collector{};
+        collector.initialize(2, Level::NONE, Level::NONE);
+        collector.record(0, Stage::TOKENIZATION, "a.hmn", 100, std::chrono::milliseconds{1});
+
+        EXPECT_FALSE(collector.is_enabled());
+        EXPECT_TRUE(collector.report().empty());
+    }
+
+    TEST(Timing_collector, slowest_files_first) {
+        using namespace std::chrono_literals;
+
+        Timing_collector collector{};
+        collector.initialize(2, Level::MEDIUM, Level::MEDIUM);
+        collector.begin_build();
+
+        // Stages of a single unit may be recorded by different workers
+        collector.record(0, Stage::TOKENIZATION, "fast.hmn", 1000, 1ms);
+        collector.record(1, Stage::TOKENIZATION, "slow.hmn", 2000000, 2ms);
+        collector.record(0, Stage::PARSING, "slow.hmn", 2000000, 3ms);
+        collector.record(1, Stage::PARSING, "fast.hmn", 1000, 1ms);
+
+        collector.end_build();
+
+        auto report = collector.report();
+        EXPECT_NE(report.find("Tokenization"), std::string::npos);
+        EXPECT_NE(report.find("Slowest files (2 of 2)"), std::string::npos);
+
+        auto slow_position = report.find("slow.hmn");
+        auto fast_position = report.find("fast.hmn");
+        ASSERT_NE(slow_position, std::string::npos);
+        ASSERT_NE(fast_position, std::string::npos);
+        EXPECT_LT(slow_position, fast_position);
+
+        // 2 MB over 5 ms
+        EXPECT_NE(report.find("400.0"), std::string::npos);
+    }
+
+}
+
+#endif //HARC_TIMING_TESTS_HPP
@@ -0,0 +1,270 @@
+#ifndef HARC_TRACING_TESTS_HPP
+#define HARC_TRACING_TESTS_HPP
+
+#include "Build_fixture.hpp"
+
+#include <harc/Tracing.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace harc::tests {
+
+    ///
+    /// Value read from a JSON document. Only what is needed to inspect
+    /// traces is supported: strings without unicode escapes, and numbers.
+    ///
+    struct Json_value {
+        enum class Kind {
+            NONE,
+            NUMBER,
+            STRING,
+            ARRAY,
+            OBJECT
+        };
+
+        Kind kind = Kind::NONE;
+        double number = 0.0;
+        std::string string{};
+        std::vector<Json_value> array{};
+        std::map<std::string, Json_value, std::less<>> object{};
+
+        ///
+        /// \param key Key of member
+        /// \return Member with key. Null if this is not an object or it has
+        /// no such member.
+        const Json_value* find(std::string_view key) const {
+            auto it = object.find(key);
+            return (it == object.end()) ? nullptr : &it->second;
+        }
+    };
+
+    ///
+    /// Reader for the subset of JSON produced by Trace_recorder
+    ///
+    class Json_reader {
+    public:
+
+        explicit Json_reader(std::string_view text):
+            text(text) {}
+
+        ///
+        /// \param out Value to read document into
+        /// \return True if text held exactly one well-formed value
+        bool read(Json_value& out) {
+            if (!read_value(out)) {
+                return false;
+            }
+
+            skip_whitespace();
+            return i == text.size();
+        }
+
+    private:
+
+        std::string_view text;
+
+        std::size_t i = 0;
+
+        void skip_whitespace() {
+            while (i < text.size() && (text[i] == ' ' || text[i] == '\n' || text[i] == '\t' || text[i] == '\r')) {
+                ++i;
+            }
+        }
+
+        bool consume(char c) {
+            skip_whitespace();
+            if (i < text.size() && text[i] == c) {
+                ++i;
+                return true;
+            }
+            return false;
+        }
+
+        bool read_string(std::string& out) {
+            if (!consume('"')) {
+                return false;
+            }
+
+            while (i < text.size() && text[i] != '"') {
+                if (text[i] == '\\') {
+                    if (++i == text.size()) {
+                        return false;
+                    }
+                }
+                out += text[i++];
+            }
+
+            return consume('"');
+        }
+
+        bool read_value(Json_value& out) {
+            skip_whitespace();
+            if (i == text.size()) {
+                return false;
+            }
+
+            if (text[i] == '"') {
+                out.kind = Json_value::Kind::STRING;
+                return read_string(out.string);
+            }
+
+            if (consume('[')) {
+                out.kind = Json_value::Kind::ARRAY;
+                if (consume(']')) {
+                    return true;
+                }
+
+                do {
+                    if (!read_value(out.array.emplace_back())) {
+                        return false;
+                    }
+                } while (consume(','));
+
+                return consume(']');
+            }
+
+            if (consume('{')) {
+                out.kind = Json_value::Kind::OBJECT;
+                if (consume('}')) {
+                    return true;
+                }
+
+                do {
+                    std::string key;
+                    if (!read_string(key) || !consume(':') || !read_value(out.object[key])) {
+                        return false;
+                    }
+                } while (consume(','));
+
+                return consume('}');
+            }
+
+            std::string number{text.substr(i, text.find_first_of(",]}", i) - i)};
+            char* end = nullptr;
+            out.kind = Json_value::Kind::NUMBER;
+            out.number = std::strtod(number.c_str(), &end);
+            if (end == number.c_str()) {
+                return false;
+            }
+
+            i += end - number.c_str();
+            return true;
+        }
+
+    };
+
+    TEST(Trace_recorder, disabled) {
+        Trace_recorder recorder{};
+        recorder.initialize(2, false);
+        recorder.record_idle(0, {}, {});
+
+        EXPECT_FALSE(recorder.is_enabled());
+        EXPECT_EQ(recorder.to_json().find("\"ph\":\"X\""), std::string::npos);
+    }
+
+    TEST(Trace_recorder, task_events) {
+        using namespace std::chrono_literals;
+
+        Trace_recorder recorder{};
+        recorder.initialize(2, true);
+
+        auto t = Trace_recorder::clock::now();
+        recorder.record_idle(1, t, t + 5us);
+        recorder.record_task(1, Stage::PARSING, "dir/\"quoted\".hmn", 1, t + 5us, t + 25us, 3us);
+
+        auto json = recorder.to_json();
+        EXPECT_NE(json.find(R"("name":"Worker 1")"), std::string::npos);
+        EXPECT_NE(json.find(R"("name":"Idle")"), std::string::npos);
+        EXPECT_NE(json.find(R"("name":"Parsing")"), std::string::npos);
+        EXPECT_NE(json.find(R"("dur":20.000)"), std::string::npos);
+        EXPECT_NE(json.find(R"("path":"dir/\"quoted\".hmn")"), std::string::npos);
+        EXPECT_NE(json.find(R"("queue_wait_us":3.000)"), std::string::npos);
+    }
+
+    TEST(Trace_recorder, oldest_events_overwritten) {
+        Trace_recorder recorder{};
+        recorder.initialize(1, true);
+
+        auto t = Trace_recorder::clock::now();
+        for (std::size_t i = 0; i < trace_events_per_worker + 3; ++i) {
+            recorder.record_idle(0, t, t);
+        }
+
+        EXPECT_NE(recorder.to_json().find(R"("dropped_events":3)"), std::string::npos);
+    }
+
+    TEST(Trace_recorder, build_trace) {
+        Build_fixture fixture{"tracing"};
+        add_mixed_sources(fixture);
+
+        auto expected = fixture.build(fixture.config());
+
+        auto trace_path = (fixture.directory / "trace.json").string();
+        auto config = fixture.config();
+        config.trace_path = trace_path;
+        EXPECT_EQ(fixture.build(config), expected);
+
+        std::ifstream trace{trace_path};
+        ASSERT_TRUE(trace.is_open());
+        std::string json{std::istreambuf_iterator<char>{trace}, std::istreambuf_iterator<char>{}};
+
+        Json_value root;
+        ASSERT_TRUE(Json_reader{json}.read(root)) << json;
+
+        const auto* events = root.find("traceEvents");
+        ASSERT_NE(events, nullptr);
+        ASSERT_EQ(events->kind, Json_value::Kind::ARRAY);
+
+        // Every unit passes through each stage exactly once
+        std::map<std::string, double, std::less<>> units_per_stage;
+        std::size_t worker_count = 0;
+        for (const auto& event : events->array) {
+            const auto* name = event.find("name");
+            const auto* phase = event.find("ph");
+            ASSERT_NE(name, nullptr);
+            ASSERT_NE(phase, nullptr);
+
+            if (phase->string == "M") {
+                ++worker_count;
+                continue;
+            }
+
+            ASSERT_EQ(phase->string, "X");
+            ASSERT_NE(event.find("ts"), nullptr);
+            ASSERT_NE(event.find("dur"), nullptr);
+            EXPECT_GE(event.find("dur")->number, 0.0);
+
+            if (name->string == "Idle") {
+                continue;
+            }
+
+            const auto* args = event.find("args");
+            ASSERT_NE(args, nullptr);
+            ASSERT_NE(args->find("path"), nullptr);
+            ASSERT_NE(args->find("units"), nullptr);
+            EXPECT_NE(args->find("path")->string.find(".hmn"), std::string::npos);
+            EXPECT_GE(args->find("queue_wait_us")->number, 0.0);
+
+            units_per_stage[name->string] += args->find("units")->number;
+        }
+
+        EXPECT_EQ(worker_count, config.thread_count);
+
+        auto source_count = static_cast<double>(fixture.paths.size());
+        EXPECT_EQ(units_per_stage.size(), 3);
+        EXPECT_EQ(units_per_stage["Tokenization"], source_count);
+        EXPECT_EQ(units_per_stage["Parsing"], source_count);
+        EXPECT_EQ(units_per_stage["Backend"], source_count);
+    }
+
+}
+
+#endif //HARC_TRACING_TESTS_HPP
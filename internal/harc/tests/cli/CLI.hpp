@@ -0,0 +1,54 @@
+#ifndef HARC_CLI_TESTS_HPP
+#define HARC_CLI_TESTS_HPP
+
+#include <harc/cli/CLI.hpp>
+
+#include <string_view>
+#include <vector>
+
+namespace harc::tests {
+
+    ///
+    /// \param args Command line arguments, excluding the executable name
+    /// \return Results of parsing args as a command line
+    inline cli::Config_results parse_command_line(std::vector<const char*> args) {
+        args.insert(args.begin(), "harc");
+        return cli::parse_configuration(static_cast<int>(args.size()), const_cast<char* const*>(args.data()));
+    }
+
+    TEST(CLI, trace_path) {
+        auto results = parse_command_line({"--trace_path", "trace.json", "a.hmn", "b.hmn"});
+        ASSERT_TRUE(results.successful);
+        EXPECT_EQ(results.config.trace_path, "trace.json");
+        EXPECT_EQ(results.source_paths, (std::vector<std::string_view>{"a.hmn", "b.hmn"}));
+
+        // Tracing stays disabled when the path is missing
+        results = parse_command_line({"a.hmn", "--trace_path"});
+        EXPECT_TRUE(results.config.trace_path.empty());
+        EXPECT_EQ(results.source_paths, (std::vector<std::string_view>{"a.hmn"}));
+    }
+
+    TEST(CLI, integer_options) {
+        auto results = parse_command_line({
+            "--threads", "3",
+            "--task_batch_byte_budget", "65536",
+            "--lex_chunk_size", "16384",
+            "--parse_chunk_size", "2048",
+            "a.hmn"
+        });
+        EXPECT_EQ(results.config.thread_count, 3);
+        EXPECT_EQ(results.config.task_batch_byte_budget, 65536);
+        EXPECT_EQ(results.config.lex_chunk_size, 16384);
+        EXPECT_EQ(results.config.parse_chunk_size, 2048);
+
+        // Malformed and missing values leave the defaults in place
+        results = parse_command_line({"--task_batch_byte_budget", "lots", "a.hmn"});
+        EXPECT_EQ(results.config.task_batch_byte_budget, Config{}.task_batch_byte_budget);
+
+        results = parse_command_line({"a.hmn", "--task_batch_byte_budget"});
+        EXPECT_EQ(results.config.task_batch_byte_budget, Config{}.task_batch_byte_budget);
+    }
+
+}
+
+#endif //HARC_CLI_TESTS_HPP
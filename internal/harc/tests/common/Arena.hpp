@@ -0,0 +1,74 @@
+#ifndef HARC_ARENA_TESTS_HPP
+#define HARC_ARENA_TESTS_HPP
+
+#include <harc/common/Arena.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace harc::tests {
+
+    TEST(Arena, empty_arena) {
+        Arena arena{};
+        EXPECT_EQ(0, arena.bytes_used());
+        EXPECT_EQ(0, arena.bytes_reserved());
+    }
+
+    TEST(Arena, allocations_are_aligned) {
+        Arena arena{};
+
+        for (std::size_t alignment = 1; alignment <= 256; alignment *= 2) {
+            auto* p = arena.allocate(1, alignment);
+            EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(p) % alignment);
+        }
+    }
+
+    TEST(Arena, oversized_allocation) {
+        Arena arena{64};
+
+        auto* p = static_cast<char*>(arena.allocate(4096, 8));
+        p[0] = 'a';
+        p[4095] = 'b';
+
+        EXPECT_GE(arena.bytes_used(), 4096);
+        EXPECT_GE(arena.bytes_reserved(), arena.bytes_used());
+    }
+
+    TEST(Arena, destructors_run_on_release) {
+        int destroyed = 0;
+
+        struct Counter {
+            int* count;
+
+            ~Counter() {
+                *count += 1;
+            }
+        };
+
+        Arena arena{};
+        for (int i = 0; i < 1000; ++i) {
+            (void) arena.create<Counter>(&destroyed);
+        }
+
+        auto* str = arena.create<std::string>(100, 'x');
+        EXPECT_EQ(100, str->size());
+
+        arena.release();
+        EXPECT_EQ(1000, destroyed);
+        EXPECT_EQ(0, arena.bytes_used());
+        EXPECT_EQ(0, arena.bytes_reserved());
+    }
+
+    TEST(Arena, move_preserves_objects) {
+        Arena arena0{};
+        auto* x = arena0.create<std::uint64_t>(std::uint64_t{42});
+
+        Arena arena1{std::move(arena0)};
+        EXPECT_EQ(0, arena0.bytes_used());
+        EXPECT_EQ(42, *x);
+        EXPECT_EQ(sizeof(std::uint64_t), arena1.bytes_used());
+    }
+
+}
+
+#endif //HARC_ARENA_TESTS_HPP
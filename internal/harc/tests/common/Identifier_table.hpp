@@ -0,0 +1,34 @@
+#ifndef HARC_IDENTIFIER_TABLE_TESTS_HPP
+#define HARC_IDENTIFIER_TABLE_TESTS_HPP
+
+#include <harc/common/Identifier_table.hpp>
+
+#include <string>
+
+namespace harc::tests {
+
+    TEST(Identifier_table, ids_are_dense_and_stable) {
+        Identifier_table table{};
+
+        std::string source = "alpha beta alpha gamma beta";
+        std::string_view view = source;
+
+        auto alpha = table.intern(view.substr(0, 5));
+        auto beta = table.intern(view.substr(6, 4));
+        auto alpha_again = table.intern(view.substr(11, 5));
+        auto gamma = table.intern(view.substr(17, 5));
+
+        EXPECT_EQ(alpha, 0);
+        EXPECT_EQ(beta, 1);
+        EXPECT_EQ(alpha_again, alpha);
+        EXPECT_EQ(gamma, 2);
+        EXPECT_EQ(table.size(), 3);
+
+        EXPECT_EQ(table.text(beta), "beta");
+        EXPECT_EQ(table.find("gamma"), gamma);
+        EXPECT_EQ(table.find("delta"), Identifier_table::null_id);
+    }
+
+}
+
+#endif //HARC_IDENTIFIER_TABLE_TESTS_HPP
@@ -0,0 +1,57 @@
+#ifndef HARC_OS_UTILS_TESTS_HPP
+#define HARC_OS_UTILS_TESTS_HPP
+
+#include <harc/common/OS_utils.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace harc::tests {
+
+    TEST(OS_utils, mapping_options_preserve_contents) {
+        auto directory = std::filesystem::temp_directory_path() / "harc_tests_os_utils";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        std::string contents;
+        for (int i = 0; i < 10000; ++i) {
+            contents += "let x" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+        }
+
+        auto path = (directory / "a.hmn").string();
+        auto empty_path = (directory / "empty.hmn").string();
+        auto missing_path = (directory / "missing.hmn").string();
+        std::ofstream{path, std::ios::binary} << contents;
+        std::ofstream{empty_path, std::ios::binary};
+
+        for (bool sequential : {false, true}) {
+            for (bool populate : {false, true}) {
+                File_mapping_options options{sequential, populate};
+
+                auto text = map_text_file(path, options);
+                ASSERT_EQ(text.error_code, Error_code::NO_ERROR);
+                EXPECT_EQ(text.text, contents);
+                unmap_file(text);
+
+                auto bytes = map_binary_file(path, options);
+                ASSERT_EQ(bytes.error_code, Error_code::NO_ERROR);
+                EXPECT_EQ(bytes.bytes.size(), contents.size());
+                unmap_file(bytes);
+
+                auto empty = map_text_file(empty_path, options);
+                EXPECT_EQ(empty.error_code, Error_code::NO_ERROR);
+                EXPECT_TRUE(empty.text.empty());
+
+                auto missing = map_text_file(missing_path, options);
+                EXPECT_EQ(missing.error_code, Error_code::INACCESSIBLE_SOURCE_FILE_PATH);
+                EXPECT_TRUE(missing.text.empty());
+            }
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+
+}
+
+#endif //HARC_OS_UTILS_TESTS_HPP
@@ -0,0 +1,73 @@
+#ifndef HARC_STRING_POOL_TESTS_HPP
+#define HARC_STRING_POOL_TESTS_HPP
+
+#include <harc/common/String_pool.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace harc::tests {
+
+    TEST(String_pool, ids_are_stable) {
+        String_pool pool{};
+
+        auto foo = pool.intern("foo");
+        auto bar = pool.intern("bar");
+
+        EXPECT_NE(foo, bar);
+        EXPECT_EQ(pool.intern(std::string{"foo"}), foo);
+        EXPECT_EQ(pool.find("bar"), bar);
+        EXPECT_EQ(pool.find("baz"), String_pool::null_id);
+        EXPECT_EQ(pool.text(foo), "foo");
+        EXPECT_EQ(pool.size(), 2);
+
+        EXPECT_EQ(pool.text(pool.intern("")), "");
+    }
+
+    TEST(String_pool, survives_growth) {
+        String_pool pool{};
+
+        std::vector<std::uint32_t> ids;
+        for (int i = 0; i < 100000; ++i) {
+            ids.push_back(pool.intern("name" + std::to_string(i)));
+        }
+
+        for (int i = 0; i < 100000; ++i) {
+            auto name = "name" + std::to_string(i);
+            ASSERT_EQ(pool.find(name), ids[i]);
+            ASSERT_EQ(pool.text(ids[i]), name);
+        }
+
+        EXPECT_EQ(pool.size(), 100000);
+    }
+
+    TEST(String_pool, concurrent_interning) {
+        String_pool pool{};
+
+        constexpr int thread_count = 8;
+        constexpr int name_count = 20000;
+
+        // Every thread interns the same names in a different order
+        std::vector<std::vector<std::uint32_t>> ids(thread_count, std::vector<std::uint32_t>(name_count));
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < thread_count; ++t) {
+            threads.emplace_back([&pool, &ids, t] () {
+                for (int i = 0; i < name_count; ++i) {
+                    int n = (i * 7919 + t * 104729) % name_count;
+                    ids[t][n] = pool.intern("symbol_" + std::to_string(n));
+                }
+            });
+        }
+        threads.clear();
+
+        for (int t = 1; t < thread_count; ++t) {
+            EXPECT_EQ(ids[t], ids[0]);
+        }
+
+        EXPECT_EQ(pool.size(), name_count);
+    }
+
+}
+
+#endif //HARC_STRING_POOL_TESTS_HPP
@@ -0,0 +1,100 @@
+#ifndef HARC_LEX_CACHE_TESTS_HPP
+#define HARC_LEX_CACHE_TESTS_HPP
+
+#include <harc/lexer/Cache.hpp>
+
+#include <algorithm>
+#include <string_view>
+
+namespace harc::tests {
+
+    TEST(Lexer_cache, tokenization_round_trip) {
+        std::string_view source = "func[] foo() -> () {\n    let x = (a + b);\n}\n";
+
+        auto tokenization = lex::lex("test.hmn", source);
+        ASSERT_TRUE(tokenization.success);
+
+        lex::Tokenization_view original{tokenization};
+        auto bytes = lex::serialize_tokenization(original);
+        auto view = lex::parse_binary_tokenization(bytes, source);
+        ASSERT_TRUE(view.has_value());
+
+        EXPECT_EQ(view->size(), original.size());
+        EXPECT_TRUE(std::ranges::equal(view->types, original.types));
+        EXPECT_TRUE(std::ranges::equal(view->source_indices, original.source_indices));
+        EXPECT_TRUE(std::ranges::equal(view->lengths, original.lengths));
+        EXPECT_TRUE(std::ranges::equal(view->line_indices, original.line_indices));
+        EXPECT_TRUE(std::ranges::equal(view->pair_indices, original.pair_indices));
+        EXPECT_TRUE(std::ranges::equal(view->keywords, original.keywords));
+
+        // Arrays are used in place rather than copied
+        EXPECT_GE(reinterpret_cast<const std::byte*>(view->types.data()), bytes.data());
+        EXPECT_LT(reinterpret_cast<const std::byte*>(view->types.data()), bytes.data() + bytes.size());
+    }
+
+    TEST(Lexer_cache, rejects_mismatched_source) {
+        std::string_view source = "let x = 1;\n";
+        auto tokenization = lex::lex("test.hmn", source);
+        auto bytes = lex::serialize_tokenization(lex::Tokenization_view{tokenization});
+
+        EXPECT_FALSE(lex::parse_binary_tokenization(bytes, "let x = 12;\n").has_value());
+    }
+
+    TEST(Lexer_cache, rejects_corrupt_indices) {
+        std::string_view source = "let x = 1;\n";
+        auto tokenization = lex::lex("test.hmn", source);
+        auto bytes = lex::serialize_tokenization(lex::Tokenization_view{tokenization});
+
+        // First source index lies immediately after the 32-byte header
+        bytes[32 + 3] = std::byte{0x7F};
+        EXPECT_FALSE(lex::parse_binary_tokenization(bytes, source).has_value());
+
+        EXPECT_FALSE(lex::parse_binary_tokenization({bytes.data(), 16}, source).has_value());
+    }
+
+    TEST(Lexer_cache, rejects_corrupt_types) {
+        std::string_view source = "let x = 1;\n";
+        auto tokenization = lex::lex("test.hmn", source);
+        auto bytes = lex::serialize_tokenization(lex::Tokenization_view{tokenization});
+
+        // Token types are followed only by keywords, both padded to 8 bytes
+        std::size_t padded_count = (tokenization.types.size() + 7) / 8 * 8;
+        std::size_t types_offset = bytes.size() - 2 * padded_count;
+        ASSERT_EQ(bytes[types_offset], static_cast<std::byte>(tokenization.types[0]));
+
+        for (std::uint8_t type : {0x00, 0x45, 0x80, 0xF9}) {
+            auto corrupt_bytes = bytes;
+            corrupt_bytes[types_offset] = std::byte{type};
+            EXPECT_FALSE(lex::parse_binary_tokenization(corrupt_bytes, source).has_value()) << int(type);
+        }
+
+        bytes[types_offset] = static_cast<std::byte>(Token_type::DOC_TEXT);
+        EXPECT_TRUE(lex::parse_binary_tokenization(bytes, source).has_value());
+    }
+
+    TEST(Lexer_cache, cache_round_trip) {
+        std::string_view source = "let x = 1;\n";
+        auto tokenization = lex::lex("test.hmn", source);
+        auto tokenization_bytes = lex::serialize_tokenization(lex::Tokenization_view{tokenization});
+
+        lex::Cache cache{};
+        cache.entries.push_back(lex::Cache_entry{"a.hmn", 17, tokenization_bytes});
+        cache.entries.push_back(lex::Cache_entry{"bc.hmn", 42, {}});
+
+        auto bytes = lex::serialize_cache(cache);
+        auto parsed = lex::parse_binary_cache(bytes);
+        ASSERT_EQ(parsed.entries.size(), 2);
+
+        EXPECT_EQ(parsed.entries[0].path, "a.hmn");
+        EXPECT_EQ(parsed.entries[0].time_stamp, 17);
+        EXPECT_TRUE(std::ranges::equal(parsed.entries[0].tokenization, tokenization_bytes));
+        EXPECT_TRUE(lex::parse_binary_tokenization(parsed.entries[0].tokenization, source).has_value());
+
+        EXPECT_EQ(parsed.entries[1].path, "bc.hmn");
+        EXPECT_EQ(parsed.entries[1].time_stamp, 42);
+        EXPECT_TRUE(parsed.entries[1].tokenization.empty());
+    }
+
+}
+
+#endif //HARC_LEX_CACHE_TESTS_HPP
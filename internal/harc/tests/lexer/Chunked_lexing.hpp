@@ -0,0 +1,153 @@
+#ifndef HARC_LEX_CHUNKED_LEXING_TESTS_HPP
+#define HARC_LEX_CHUNKED_LEXING_TESTS_HPP
+
+#include "../Build_fixture.hpp"
+
+#include <harc/lexer/Lexer.hpp>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+namespace harc::tests {
+
+    ///
+    /// \param source Source to lex
+    /// \param chunk_size Target size of chunks
+    /// \return Tokenization of source produced by lexing it in chunks
+    inline lex::Tokenization lex_in_chunks(std::string_view source, std::uint32_t chunk_size) {
+        auto line_indices = lex::lex("test.hmn", source).line_indices;
+        auto chunks = lex::split_into_chunks(source, line_indices, chunk_size);
+
+        std::vector<lex::Chunk_tokenization> results;
+        for (auto chunk : chunks) {
+            results.push_back(lex::lex_chunk("test.hmn", source, chunk, line_indices, false));
+        }
+
+        return lex::stitch_chunks("test.hmn", source, std::move(results), std::move(line_indices), false);
+    }
+
+    ///
+    /// Checks that lexing in chunks of every size produces the same tokens
+    /// as lexing the whole source at once
+    ///
+    inline void expect_chunked_lexing_matches(std::string_view source) {
+        auto expected = lex::lex("test.hmn", source);
+
+        for (std::uint32_t chunk_size = 1; chunk_size <= source.size(); ++chunk_size) {
+            auto tokenization = lex_in_chunks(source, chunk_size);
+
+            EXPECT_EQ(tokenization.success, expected.success) << chunk_size;
+            EXPECT_EQ(tokenization.types, expected.types) << chunk_size;
+            EXPECT_EQ(tokenization.source_indices, expected.source_indices) << chunk_size;
+            EXPECT_EQ(tokenization.lengths, expected.lengths) << chunk_size;
+            EXPECT_EQ(tokenization.line_indices, expected.line_indices) << chunk_size;
+            EXPECT_EQ(tokenization.pair_indices, expected.pair_indices) << chunk_size;
+        }
+    }
+
+    TEST(Chunked_lexing, chunks_begin_at_line_starts) {
+        std::string_view source = "let a = 1;\nlet b = \"x\\\ny\";\nlet c = 3;\n";
+        auto line_indices = lex::lex("test.hmn", source).line_indices;
+
+        auto chunks = lex::split_into_chunks(source, line_indices, 1);
+        ASSERT_EQ(chunks.size(), 3);
+        EXPECT_EQ(chunks.front().begin, 0);
+        EXPECT_EQ(chunks.back().end, source.size());
+
+        for (std::size_t i = 1; i < chunks.size(); ++i) {
+            EXPECT_EQ(chunks[i].begin, chunks[i - 1].end);
+            EXPECT_EQ(source[chunks[i].begin - 1], '\n');
+        }
+
+        // The line continued by a backslash is not split from its successor
+        EXPECT_EQ(source.substr(chunks[1].begin, 8), "let b = ");
+        EXPECT_EQ(source.substr(chunks[2].begin), "let c = 3;\n");
+    }
+
+    TEST(Chunked_lexing, brackets_paired_across_chunks) {
+        expect_chunked_lexing_matches(
+            "func[] foo() -> () {\n"
+            "    let x = (a +\n"
+            "        b);\n"
+            "    let y: Array<Array<int>> = [\n"
+            "        1, 2\n"
+            "    ];\n"
+            "    let z: Array<Array<\n"
+            "        int>> = [];\n"
+            "}\n"
+        );
+    }
+
+    TEST(Chunked_lexing, shifts_closing_earlier_templates) {
+        expect_chunked_lexing_matches(
+            "let a: A<B<\n"
+            "    C>> = x >> 1;\n"
+            "let b = y >> 2;\n"
+            "let c: D<E<\n"
+            "    F>> = G<H<\n"
+            "    I>>;\n"
+            "let d = (z >> 3);\n"
+        );
+    }
+
+    TEST(Chunked_lexing, many_shifts) {
+        std::string source = "let a: A<B<\n";
+        for (int i = 0; i < 2000; ++i) {
+            source += "    x = x >> 1;\n";
+        }
+        source += "    C>> = 0;\n";
+
+        auto expected = lex::lex("test.hmn", source);
+        for (std::uint32_t chunk_size : {16u, 64u, 1024u}) {
+            auto tokenization = lex_in_chunks(source, chunk_size);
+
+            EXPECT_EQ(tokenization.types, expected.types) << chunk_size;
+            EXPECT_EQ(tokenization.source_indices, expected.source_indices) << chunk_size;
+            EXPECT_EQ(tokenization.pair_indices, expected.pair_indices) << chunk_size;
+        }
+    }
+
+    TEST(Chunked_lexing, comments_spanning_chunks) {
+        expect_chunked_lexing_matches(
+            "let a = 1;\n"
+            "/* outer\n"
+            "   /* nested ( \" '\n"
+            "   */ still { inside\n"
+            "*/\n"
+            "let b = (a);\n"
+            "/// doc text\n"
+            "let c = 'x';\n"
+        );
+    }
+
+    TEST(Chunked_lexing, errors_match_serial_lexing) {
+        expect_chunked_lexing_matches(
+            "let a = (1;\n"
+            "let b = 2);\n"
+            "func f() {\n"
+            "    let c = \"unterminated\n"
+            "}\n"
+            "/* unterminated\n"
+            "comment\n"
+        );
+    }
+
+    TEST(Chunked_lexing, build_matches_unchunked) {
+        Build_fixture fixture{"chunked_lexing"};
+        add_mixed_sources(fixture);
+        fixture.add_source("large.hmn", large_source(200, "func broken() -> () { a b; let s = 'c; }\n"));
+
+        auto expected = fixture.build(fixture.config());
+        EXPECT_NE(expected.find("large.hmn"), std::string::npos);
+
+        for (std::uint32_t chunk_size : {64u, 1000u, 4096u}) {
+            auto config = fixture.config();
+            config.lex_chunk_size = chunk_size;
+            EXPECT_EQ(fixture.build(config), expected) << chunk_size;
+        }
+    }
+
+}
+
+#endif //HARC_LEX_CHUNKED_LEXING_TESTS_HPP
@@ -0,0 +1,58 @@
+#ifndef HARC_LEX_KEYWORDS_TESTS_HPP
+#define HARC_LEX_KEYWORDS_TESTS_HPP
+
+#include <harc/lexer/Lexer.hpp>
+#include <harc/lexer/Tokens.hpp>
+
+#include <string>
+#include <vector>
+
+namespace harc::tests {
+
+    TEST(Keywords, identify_keyword) {
+        for (std::uint8_t i = 1; i <= static_cast<std::uint8_t>(Keyword::WHILE); ++i) {
+            auto keyword = static_cast<Keyword>(i);
+            EXPECT_EQ(identify_keyword(to_string(keyword)), keyword);
+
+            // Near misses share a hash with keywords but must not match
+            auto spelling = std::string{to_string(keyword)};
+            EXPECT_EQ(identify_keyword(spelling + "s"), Keyword::NONE);
+            EXPECT_EQ(identify_keyword(spelling.substr(1)), Keyword::NONE);
+        }
+
+        EXPECT_EQ(identify_keyword(""), Keyword::NONE);
+        EXPECT_EQ(identify_keyword("x"), Keyword::NONE);
+        EXPECT_EQ(identify_keyword("Func"), Keyword::NONE);
+        EXPECT_EQ(identify_keyword("functions"), Keyword::NONE);
+    }
+
+    TEST(Keywords, recorded_by_lexer) {
+        auto tokenization = lex::lex("test.hmn", "func[] f() -> () { let x = lambda; }\n");
+        ASSERT_TRUE(tokenization.success);
+        ASSERT_EQ(tokenization.keywords.size(), tokenization.types.size());
+
+        std::vector<Keyword> keywords;
+        for (auto keyword : tokenization.keywords) {
+            if (keyword != Keyword::NONE) {
+                keywords.push_back(keyword);
+            }
+        }
+
+        std::vector<Keyword> expected{Keyword::FUNC, Keyword::LET, Keyword::LAMBDA};
+        EXPECT_EQ(keywords, expected);
+    }
+
+    TEST(Keywords, text_operators) {
+        auto tokenization = lex::lex("test.hmn", "a as b is c in d asis\n");
+        ASSERT_TRUE(tokenization.success);
+
+        std::vector<Keyword> expected{
+            Keyword::NONE, Keyword::AS, Keyword::NONE, Keyword::IS,
+            Keyword::NONE, Keyword::IN, Keyword::NONE, Keyword::NONE
+        };
+        EXPECT_EQ(std::vector<Keyword>(tokenization.keywords.begin(), tokenization.keywords.end()), expected);
+    }
+
+}
+
+#endif //HARC_LEX_KEYWORDS_TESTS_HPP
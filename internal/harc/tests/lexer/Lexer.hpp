@@ -0,0 +1,336 @@
+#ifndef HARC_LEX_LEXER_TESTS_HPP
+#define HARC_LEX_LEXER_TESTS_HPP
+
+#include <harc/lexer/Lexer.hpp>
+#include <harc/lexer/Tokens.hpp>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace harc::tests {
+
+    ///
+    /// \param tokenization Tokenization of source
+    /// \param source Source which was lexed
+    /// \return Text of each token
+    inline std::vector<std::string_view> token_texts(const lex::Tokenization& tokenization, std::string_view source) {
+        std::vector<std::string_view> ret;
+        for (std::size_t i = 0; i < tokenization.types.size(); ++i) {
+            ret.push_back(source.substr(tokenization.source_indices[i], tokenization.lengths[i]));
+        }
+        return ret;
+    }
+
+    ///
+    /// \param tokenization Arbitrary tokenization
+    /// \return Type of each token
+    inline std::vector<Token_type> token_types(const lex::Tokenization& tokenization) {
+        return {tokenization.types.begin(), tokenization.types.end()};
+    }
+
+    TEST(Lexer, whitespace_sensitive_operators) {
+        using enum Token_type;
+
+        std::string_view source = "a + b -a a++ ++b a - -b a.b x... a::b a -> b a => b";
+        auto tokenization = lex::lex("test.hmn", source);
+        ASSERT_TRUE(tokenization.success);
+
+        std::vector<Token_type> expected{
+            TEXT, SPACED_PLUS, TEXT,
+            PREFIX_MINUS, TEXT,
+            TEXT, SUFFIX_INCREMENT,
+            PREFIX_INCREMENT, TEXT,
+            TEXT, SPACED_MINUS, PREFIX_MINUS, TEXT,
+            TEXT, SPACED_PERIOD, TEXT,
+            TEXT, SUFFIX_TRIPLE_PERIOD,
+            TEXT, JOINED_DOUBLE_COLON, TEXT,
+            TEXT, JOINED_SINGLE_ARROW, TEXT,
+            TEXT, SPACED_DOUBLE_ARROW, TEXT
+        };
+        EXPECT_EQ(token_types(tokenization), expected);
+
+        // A left angle bracket is only a comparison when spaced
+        tokenization = lex::lex("test.hmn", "a < b;\nc<d> e <<= f;\n");
+        ASSERT_TRUE(tokenization.success);
+
+        expected = {
+            TEXT, SPACED_COMPARE_LT, TEXT, SEMICOLON,
+            TEXT, LEFT_TEMPLATE_BRACKET, TEXT, RIGHT_TEMPLATE_BRACKET,
+            TEXT, SPACED_MODULAR_LEFT_SHIFT_EQUALS, TEXT, SEMICOLON
+        };
+        EXPECT_EQ(token_types(tokenization), expected);
+        EXPECT_EQ(tokenization.pair_indices[5], 7);
+    }
+
+    TEST(Lexer, numeric_literals) {
+        std::string_view source = "0x1F 12.5e3 0b101 1_000 1:u8";
+        auto tokenization = lex::lex("test.hmn", source);
+        ASSERT_TRUE(tokenization.success);
+
+        std::vector<std::string_view> texts{"0x1F", "12.5e3", "0b101", "1_000", "1", ":", "u8"};
+        EXPECT_EQ(token_texts(tokenization, source), texts);
+
+        for (std::size_t i = 0; i < 5; ++i) {
+            EXPECT_EQ(tokenization.types[i], Token_type::NUMERIC_LITERAL) << i;
+        }
+        EXPECT_EQ(tokenization.types[5], Token_type::COLON);
+        EXPECT_EQ(tokenization.types[6], Token_type::TEXT);
+    }
+
+    TEST(Lexer, string_and_codepoint_literals) {
+        std::string_view source = R"(let s = "a\"b" + 'c' + '\t';)";
+        auto tokenization = lex::lex("test.hmn", source);
+        ASSERT_TRUE(tokenization.success);
+
+        auto texts = token_texts(tokenization, source);
+        ASSERT_EQ(texts.size(), 9);
+        EXPECT_EQ(texts[3], R"("a\"b")");
+        EXPECT_EQ(tokenization.types[3], Token_type::STRING_LITERAL);
+        EXPECT_EQ(texts[5], "'c'");
+        EXPECT_EQ(tokenization.types[5], Token_type::CODEPOINT_LITERAL);
+        EXPECT_EQ(texts[7], R"('\t')");
+        EXPECT_EQ(tokenization.types[7], Token_type::CODEPOINT_LITERAL);
+
+        tokenization = lex::lex("test.hmn", "let s =\n  \"abc;\n");
+        EXPECT_FALSE(tokenization.success);
+        EXPECT_NE(to_string(tokenization.message_buffer).find("test.hmn:2:3"), std::string::npos);
+
+        tokenization = lex::lex("test.hmn", "let c = 'c;");
+        EXPECT_FALSE(tokenization.success);
+        EXPECT_NE(to_string(tokenization.message_buffer).find("Unmatched single quote"), std::string::npos);
+    }
+
+    TEST(Lexer, comments) {
+        std::string_view source =
+            "a // line comment\n"
+            "b /* block\n"
+            "comment */ c\n"
+            "/// Documentation\n"
+            "d /* nested /* block */ comment */ e\n";
+
+        auto tokenization = lex::lex("test.hmn", source);
+        ASSERT_TRUE(tokenization.success);
+
+        std::vector<std::string_view> texts{"a", "b", "c", "/// Documentation", "d", "e"};
+        EXPECT_EQ(token_texts(tokenization, source), texts);
+        EXPECT_EQ(tokenization.types[3], Token_type::DOC_TEXT);
+        EXPECT_EQ(tokenization.line_indices.size(), 6);
+    }
+
+    TEST(Lexer, non_ascii_identifiers) {
+        std::string_view source = "let \xC3\xA9 = \xC3\xBCnic\xC3\xB6" "de + \xE5\x8F\x98\xE9\x87\x8F;";
+        auto tokenization = lex::lex("test.hmn", source);
+        ASSERT_TRUE(tokenization.success);
+
+        std::vector<std::string_view> texts{"let", "\xC3\xA9", "=", "\xC3\xBCnic\xC3\xB6" "de", "+", "\xE5\x8F\x98\xE9\x87\x8F", ";"};
+        EXPECT_EQ(token_texts(tokenization, source), texts);
+        EXPECT_EQ(tokenization.types[3], Token_type::TEXT);
+        EXPECT_EQ(tokenization.types[5], Token_type::TEXT);
+
+        // Not accepted by the ASCII-only tokenizer
+        EXPECT_FALSE(lex::lex_ascii("test.hmn", source).success);
+    }
+
+    TEST(Lexer, invalid_utf8) {
+        // Stray continuation byte, then a truncated two-byte sequence
+        for (std::string_view source : {"let a = b\xBF;", "let a = b\xC3;"}) {
+            auto tokenization = lex::lex("test.hmn", source);
+            EXPECT_FALSE(tokenization.success);
+
+            auto messages = to_string(tokenization.message_buffer);
+            EXPECT_NE(messages.find("Invalid UTF-8 sequence"), std::string::npos);
+            EXPECT_NE(messages.find("test.hmn:1:10"), std::string::npos);
+        }
+    }
+
+    TEST(Lexer, template_closer_split) {
+        using enum Token_type;
+
+        std::string_view source = "let a: Array<Array<i32>> = b >> 2;";
+        auto tokenization = lex::lex("test.hmn", source);
+        ASSERT_TRUE(tokenization.success);
+
+        std::vector<Token_type> expected{
+            TEXT, TEXT, COLON,
+            TEXT, LEFT_TEMPLATE_BRACKET, TEXT, LEFT_TEMPLATE_BRACKET, TEXT, RIGHT_TEMPLATE_BRACKET, RIGHT_TEMPLATE_BRACKET,
+            SPACED_EQUALS, TEXT, SPACED_MODULAR_RIGHT_SHIFT, NUMERIC_LITERAL, SEMICOLON
+        };
+        EXPECT_EQ(token_types(tokenization), expected);
+
+        // Each half of the split token is one byte long
+        auto texts = token_texts(tokenization, source);
+        EXPECT_EQ(texts[8], ">");
+        EXPECT_EQ(texts[9], ">");
+        EXPECT_EQ(tokenization.pair_indices[4], 9);
+        EXPECT_EQ(tokenization.pair_indices[6], 8);
+
+        // Without open template brackets, >> stays a shift
+        EXPECT_EQ(texts[12], ">>");
+    }
+
+    ///
+    /// Expected type of a fixed-length token for each combination of
+    /// surrounding whitespace
+    ///
+    struct Fixed_length_token_case {
+        std::string_view spelling;
+
+        ///
+        /// Indexed by (whitespace before << 1) | whitespace after
+        ///
+        std::array<Token_type, 4> types;
+    };
+
+    ///
+    /// \param type Type of a token which ignores surrounding whitespace
+    /// \return type for every combination of surrounding whitespace
+    constexpr std::array<Token_type, 4> insensitive(Token_type type) {
+        return {type, type, type, type};
+    }
+
+    TEST(Lexer, fixed_length_token_dispatch) {
+        using enum Token_type;
+
+        // One entry per spelling in the lexer's token table
+        const std::vector<Fixed_length_token_case> cases{
+            {"!=",  insensitive(SPACED_COMPARE_NE)},
+            {"!",   insensitive(PREFIX_EXCLAMATION)},
+            {"#",   insensitive(HASH)},
+            {"%=",  insensitive(SPACED_REM_EQUALS)},
+            {"%",   insensitive(SPACED_PERCENT)},
+            {"&&=", insensitive(SPACED_LOGICAL_AND_EQUALS)},
+            {"&&",  insensitive(SPACED_LOGICAL_AND)},
+            {"&=",  insensitive(SPACED_BITWISE_AND_EQUALS)},
+            {"&",   {SUFFIX_AMPERSAND, SUFFIX_AMPERSAND, SPACED_AMPERSAND, SPACED_AMPERSAND}},
+            {"(",   insensitive(LEFT_PARENTHESIS)},
+            {")",   insensitive(RIGHT_PARENTHESIS)},
+            {"*/",  insensitive(RIGHT_COMMENT_BRACKET)},
+            {"*=",  insensitive(SPACED_TIMES_EQUALS)},
+            {"*",   insensitive(SPACED_ASTERISK)},
+            {"++",  {PREFIX_INCREMENT, SUFFIX_INCREMENT, PREFIX_INCREMENT, PREFIX_INCREMENT}},
+            {"+=",  insensitive(SPACED_PLUS_EQUALS)},
+            {"+",   {PREFIX_PLUS, SPACED_PLUS, PREFIX_PLUS, SPACED_PLUS}},
+            {",",   insensitive(COMMA)},
+            {"--",  {PREFIX_DECREMENT, SUFFIX_DECREMENT, PREFIX_DECREMENT, PREFIX_DECREMENT}},
+            {"-=",  insensitive(SPACED_MINUS_EQUALS)},
+            {"->",  insensitive(JOINED_SINGLE_ARROW)},
+            {"-",   {PREFIX_MINUS, SPACED_MINUS, PREFIX_MINUS, SPACED_MINUS}},
+            {"...", insensitive(SUFFIX_TRIPLE_PERIOD)},
+            {"..",  insensitive(JOINED_DOUBLE_PERIOD)},
+            {".",   insensitive(SPACED_PERIOD)},
+            {"/*",  insensitive(LEFT_COMMENT_BRACKET)},
+            {"/=",  insensitive(SPACED_DIV_EQUALS)},
+            {"/",   insensitive(SPACED_SLASH)},
+            {"::",  insensitive(JOINED_DOUBLE_COLON)},
+            {":",   insensitive(COLON)},
+            {";",   insensitive(SEMICOLON)},
+            {"<|=", insensitive(SPACED_SATURATING_LEFT_SHIFT_EQUALS)},
+            {"<<=", insensitive(SPACED_MODULAR_LEFT_SHIFT_EQUALS)},
+            {"<<",  insensitive(SPACED_MODULAR_LEFT_SHIFT)},
+            {"<=",  insensitive(SPACED_COMPARE_LE)},
+            {"<|",  insensitive(SPACED_SATURATING_LEFT_SHIFT)},
+            {"<",   {LEFT_TEMPLATE_BRACKET, LEFT_TEMPLATE_BRACKET, LEFT_TEMPLATE_BRACKET, SPACED_COMPARE_LT}},
+            {"==",  insensitive(SPACED_COMPARE_EQ)},
+            {"=>",  insensitive(SPACED_DOUBLE_ARROW)},
+            {"=",   insensitive(SPACED_EQUALS)},
+            {">>=", insensitive(SPACED_MODULAR_RIGHT_SHIFT_EQUALS)},
+            {">=",  insensitive(SPACED_COMPARE_GE)},
+            {">>",  insensitive(SPACED_MODULAR_RIGHT_SHIFT)},
+            {">",   {RIGHT_TEMPLATE_BRACKET, RIGHT_TEMPLATE_BRACKET, RIGHT_TEMPLATE_BRACKET, SPACED_COMPARE_GT}},
+            {"@",   insensitive(AT_SIGN)},
+            {"[",   insensitive(LEFT_SQUARE_BRACKET)},
+            {"]",   insensitive(RIGHT_SQUARE_BRACKET)},
+            {"^^=", insensitive(SPACED_LOGICAL_XOR_EQUALS)},
+            {"^=",  insensitive(SPACED_BITWISE_XOR_EQUALS)},
+            {"^^",  insensitive(SPACED_LOGICAL_XOR)},
+            {"^",   {SUFFIX_CARET, SUFFIX_CARET, SPACED_CARET, SPACED_CARET}},
+            {"{",   insensitive(LEFT_CURLY_BRACKET)},
+            {"|>=", insensitive(SPACED_SATURATING_RIGHT_SHIFT_EQuALS)},
+            {"||=", insensitive(SPACED_LOGICAL_OR_EQUALS)},
+            {"|=",  insensitive(SPACED_BITWISE_OR_EQUALS)},
+            {"||",  insensitive(SPACED_LOGICAL_OR)},
+            {"|>",  insensitive(SPACED_SATURATING_RIGHT_SHIFT)},
+            {"|",   insensitive(SPACED_PIPE)},
+            {"}",   insensitive(RIGHT_CURLY_BRACKET)},
+            {"~",   insensitive(PREFIX_TILDE)},
+        };
+
+        std::array<bool, std::size_t(PREFIX_TILDE) + 1> is_covered{};
+        for (const auto& c : cases) {
+            for (auto type : c.types) {
+                is_covered[std::size_t(type)] = true;
+            }
+
+            // Opens a comment before the dispatch table is reached
+            if (c.spelling == "/*") {
+                continue;
+            }
+
+            for (std::size_t ws = 0; ws < 4; ++ws) {
+                std::string source = "a";
+                source += (ws & 0x2) ? " " : "";
+                source += c.spelling;
+                source += (ws & 0x1) ? " " : "";
+                source += "b";
+
+                auto tokenization = lex::lex("test.hmn", source);
+                ASSERT_EQ(tokenization.types.size(), 3) << source;
+                EXPECT_EQ(tokenization.types[1], c.types[ws]) << source;
+                EXPECT_EQ(token_texts(tokenization, source)[1], c.spelling) << source;
+            }
+        }
+
+        // Every fixed-length token is produced by some spelling
+        for (std::size_t i = 1; i < is_covered.size(); ++i) {
+            EXPECT_TRUE(is_covered[i]) << i;
+        }
+    }
+
+    ///
+    /// Lexes source, checking that the token count stays within the room
+    /// reserved for it up front
+    ///
+    /// \param source Source to lex
+    /// \return Tokenization of source
+    inline lex::Tokenization lex_within_bound(std::string_view source) {
+        auto tokenization = lex::lex("test.hmn", source);
+        EXPECT_LE(tokenization.types.size(), tokenization.capacity()) << source;
+        return tokenization;
+    }
+
+    TEST(Lexer, token_count_bound) {
+        // Every byte begins a token, so the bound is exact
+        for (std::string_view source : {"a+b", "(){}[];,", "a.b.c", "x=-y", "f(g(h))"}) {
+            auto tokenization = lex_within_bound(source);
+            EXPECT_TRUE(tokenization.success) << source;
+            EXPECT_EQ(tokenization.types.size(), tokenization.capacity()) << source;
+        }
+
+        // Numeric literals absorb the letters and digits which follow them
+        auto tokenization = lex_within_bound("1u8 0x1Fa 2e10 0b1z 3_u;");
+        std::vector<Token_type> expected(5, Token_type::NUMERIC_LITERAL);
+        expected.push_back(Token_type::SEMICOLON);
+        EXPECT_EQ(token_types(tokenization), expected);
+        EXPECT_EQ(tokenization.types.size(), tokenization.capacity());
+
+        // Non-ASCII identifiers, including ones directly against punctuation,
+        // and non-ASCII whitespace between tokens
+        lex_within_bound("\xC3\xA9+\xC3\xBC(\xE5\x8F\x98)\xC3\xB6");
+        lex_within_bound("a\xC2\xA0" "b\xE2\x80\x83" "c\xE3\x80\x80" "d");
+        lex_within_bound("\xC3\xA9\xE2\x80\x83\xC3\xBC");
+
+        // Each half of a split shift is a token of its own
+        tokenization = lex_within_bound("A<B<C>>");
+        EXPECT_EQ(tokenization.types.size(), 7);
+        EXPECT_EQ(tokenization.types.size(), tokenization.capacity());
+
+        tokenization = lex_within_bound("A<B<C<D<E>>>>");
+        EXPECT_EQ(tokenization.types.size(), 13);
+        EXPECT_EQ(tokenization.types.size(), tokenization.capacity());
+    }
+
+}
+
+#endif //HARC_LEX_LEXER_TESTS_HPP
@@ -0,0 +1,114 @@
+#ifndef HARC_LEX_PAIRING_TESTS_HPP
+#define HARC_LEX_PAIRING_TESTS_HPP
+
+#include <harc/lexer/Pairing.hpp>
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace harc::tests {
+
+    ///
+    /// Runs every iteration on the calling thread
+    ///
+    inline void serial_for(std::size_t count, const std::function<void(std::size_t)>& f) {
+        for (std::size_t i = 0; i < count; ++i) {
+            f(i);
+        }
+    }
+
+    ///
+    /// Spreads iterations across four threads, including the calling thread
+    ///
+    inline void threaded_for(std::size_t count, const std::function<void(std::size_t)>& f) {
+        std::atomic<std::size_t> next = 0;
+        auto work = [&] {
+            for (auto i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                f(i);
+            }
+        };
+
+        std::vector<std::jthread> threads;
+        for (int i = 0; i < 3; ++i) {
+            threads.emplace_back(work);
+        }
+
+        work();
+    }
+
+    ///
+    /// Checks that pairing a source's tokens again, block-wise through
+    /// parallel_for, produces the pairs and messages of the serial pass and
+    /// the pairs found while lexing
+    ///
+    inline void expect_pairing_matches_serial(std::string_view source, const lex::Parallel_for& parallel_for) {
+        auto lexed = lex::lex("test.hmn", source);
+
+        auto serial = lex::lex("test.hmn", source);
+        serial.message_buffer = {};
+        std::ranges::fill(serial.pair_indices, 0);
+        auto serial_error_count = lex::pair_brackets(serial, "test.hmn");
+
+        auto tokenization = lex::lex("test.hmn", source);
+        tokenization.message_buffer = {};
+        std::ranges::fill(tokenization.pair_indices, 0);
+        auto error_count = lex::pair_brackets(tokenization, "test.hmn", {}, parallel_for);
+
+        EXPECT_EQ(error_count, serial_error_count);
+        EXPECT_EQ(error_count == 0, lexed.success);
+        EXPECT_EQ(tokenization.pair_indices, serial.pair_indices);
+        EXPECT_EQ(tokenization.pair_indices, lexed.pair_indices);
+
+        // Unpaired tokens are reported at the same line and column
+        EXPECT_EQ(to_string(tokenization.message_buffer), to_string(serial.message_buffer));
+    }
+
+    TEST(Pairing, balanced_brackets) {
+        expect_pairing_matches_serial(
+            "func[] foo() -> () {\n"
+            "    let x: Array<Array<int>> = [(a + b), {c}];\n"
+            "}\n",
+            serial_for
+        );
+    }
+
+    TEST(Pairing, unbalanced_brackets) {
+        for (auto* parallel_for : {serial_for, threaded_for}) {
+            expect_pairing_matches_serial("let a = (1;\nlet b = [2);\nfunc f() {\n", parallel_for);
+            expect_pairing_matches_serial("let a = 1);\n{ (] }\nstruct S {}\n", parallel_for);
+        }
+
+        auto tokenization = lex::lex("test.hmn", "let a = (1;\n  let b = 2);\n]\n");
+        tokenization.message_buffer = {};
+        EXPECT_EQ(lex::pair_brackets(tokenization, "test.hmn", {}, serial_for), 1);
+        EXPECT_NE(to_string(tokenization.message_buffer).find("test.hmn:3:1"), std::string::npos);
+    }
+
+    TEST(Pairing, stack_reset_by_declarations) {
+        // Brackets balance by depth, but func and struct keywords may not be
+        // enclosed, so the lexer reports both brackets as unpaired
+        for (auto* parallel_for : {serial_for, threaded_for}) {
+            expect_pairing_matches_serial("let a = (1;\nfunc f() -> () { }\nlet b = 2);\n", parallel_for);
+            expect_pairing_matches_serial("let a = [{\nstruct S { }\n}];\n", parallel_for);
+        }
+    }
+
+    TEST(Pairing, multiple_blocks) {
+        // Enough tokens that the source spans many blocks
+        std::string source;
+        for (int i = 0; i < 40000; ++i) {
+            source += "let x = ((a) + [b, {c}]);\n";
+        }
+
+        expect_pairing_matches_serial(source, threaded_for);
+
+        source.insert(source.size() / 2, "(");
+        expect_pairing_matches_serial(source, threaded_for);
+    }
+
+}
+
+#endif //HARC_LEX_PAIRING_TESTS_HPP
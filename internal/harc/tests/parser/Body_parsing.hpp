@@ -0,0 +1,169 @@
+#ifndef HARC_PARSER_BODY_PARSING_TESTS_HPP
+#define HARC_PARSER_BODY_PARSING_TESTS_HPP
+
+#include <harc/parser/Parser.hpp>
+#include <harc/parser/Parse_tree.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace harc::tests {
+
+    inline const char* body_parsing_source =
+        "module a.b;\n"
+        "\n"
+        "alias Index = core.u32;\n"
+        "\n"
+        "/// Documentation\n"
+        "func[inline] f(x: i32, y: Array<Optional<f32>>) -> i32 {\n"
+        "    let a: i32 = x * 2;\n"
+        "    var b = lambda (z: i32) -> i32 { return z; };\n"
+        "    if a < x {\n"
+        "        b = a;\n"
+        "    } else if a > x {\n"
+        "        while a != 0 { a -= 1; }\n"
+        "    } else {\n"
+        "        do { ++a; } while a < 10;\n"
+        "    }\n"
+        "    for let i = 0; i < x; ++i { { g(i); } }\n"
+        "    for p, q in y, y { return p; }\n"
+        "    return a + b(x);\n"
+        "}\n"
+        "\n"
+        "func g() -> () {\n"
+        "    return;\n"
+        "}\n";
+
+    inline std::unique_ptr<Translation_unit> lex_unit(std::string_view source) {
+        auto unit = std::make_unique<Translation_unit>();
+        unit->source_path = "test.hmn";
+        unit->set_source(std::string{source});
+        unit->tokenization = lex::lex(unit->source_path, unit->source);
+        unit->tokens = lex::Tokenization_view{unit->tokenization};
+        return unit;
+    }
+
+    inline std::uint32_t count_nodes(const parser::Flat_parse_tree& tree, parser::Node_type type) {
+        return static_cast<std::uint32_t>(std::count(tree.types.begin(), tree.types.end(), type));
+    }
+
+    TEST(Body_parsing, eager) {
+        using namespace parser;
+
+        auto unit = lex_unit(body_parsing_source);
+        ASSERT_TRUE(unit->tokenization.success);
+        ASSERT_EQ(parse(*unit), Error_code::NO_ERROR);
+        EXPECT_TRUE(unit->parse_tree.deferred_bodies.empty());
+
+        const auto& flat = unit->parse_tree.flat;
+        EXPECT_EQ(count_nodes(flat, Node_type::ALIAS_DEFINITION), 1);
+        EXPECT_EQ(count_nodes(flat, Node_type::FUNCTION_DEFINITION), 2);
+        EXPECT_EQ(count_nodes(flat, Node_type::LAMBDA), 1);
+        EXPECT_EQ(count_nodes(flat, Node_type::IF_STATEMENT), 1);
+        EXPECT_EQ(count_nodes(flat, Node_type::WHILE_STATEMENT), 1);
+        EXPECT_EQ(count_nodes(flat, Node_type::DO_WHILE_LOOP), 1);
+        EXPECT_EQ(count_nodes(flat, Node_type::FOR_LOOP), 1);
+        EXPECT_EQ(count_nodes(flat, Node_type::RANGED_FOR_LOOP), 1);
+        EXPECT_EQ(count_nodes(flat, Node_type::RETURN_STATEMENT), 4);
+        EXPECT_EQ(count_nodes(flat, Node_type::CONSTANT_DECLARATION), 2);
+        EXPECT_EQ(count_nodes(flat, Node_type::VARIABLE_DECLARATION), 1);
+
+        // The root spans every token
+        EXPECT_EQ(flat.first_tokens[0], 0);
+        EXPECT_EQ(flat.end_tokens[0], unit->tokens.size());
+    }
+
+    TEST(Body_parsing, deferred_matches_eager) {
+        using namespace parser;
+
+        auto eager = lex_unit(body_parsing_source);
+        ASSERT_EQ(parse(*eager), Error_code::NO_ERROR);
+
+        auto deferred = lex_unit(body_parsing_source);
+        ASSERT_EQ(parse(*deferred, Body_parsing::DEFERRED), Error_code::NO_ERROR);
+
+        const auto& bodies = deferred->parse_tree.deferred_bodies;
+        ASSERT_EQ(bodies.size(), 2);
+        for (auto* function : bodies) {
+            EXPECT_EQ(function->body, nullptr);
+            EXPECT_EQ(deferred->tokens.types[function->l_curly_bracket], Token_type::LEFT_CURLY_BRACKET);
+            EXPECT_EQ(deferred->tokens.types[function->r_curly_bracket], Token_type::RIGHT_CURLY_BRACKET);
+        }
+
+        // Only declarations are present, yet they span the same tokens
+        const auto& declarations = deferred->parse_tree.flat;
+        EXPECT_EQ(count_nodes(declarations, Node_type::CODE_BODY), 0);
+        EXPECT_EQ(count_nodes(declarations, Node_type::FUNCTION_DEFINITION), 2);
+        EXPECT_EQ(declarations.end_tokens[0], eager->parse_tree.flat.end_tokens[0]);
+
+        ASSERT_EQ(parse_deferred_bodies(*deferred), Error_code::NO_ERROR);
+        EXPECT_TRUE(bodies.empty());
+
+        const auto& a = eager->parse_tree.flat;
+        const auto& b = deferred->parse_tree.flat;
+        EXPECT_EQ(a.types, b.types);
+        EXPECT_EQ(a.first_children, b.first_children);
+        EXPECT_EQ(a.next_siblings, b.next_siblings);
+        EXPECT_EQ(a.first_tokens, b.first_tokens);
+        EXPECT_EQ(a.end_tokens, b.end_tokens);
+    }
+
+    TEST(Body_parsing, errors_within_deferred_bodies) {
+        using namespace parser;
+
+        auto unit = lex_unit(
+            "module m;\n"
+            "func f() -> () { a b; }\n"
+            "func g() -> () { return 1; }\n"
+        );
+        ASSERT_TRUE(unit->tokenization.success);
+
+        // Malformed bodies go unnoticed until they are parsed
+        ASSERT_EQ(parse(*unit, Body_parsing::DEFERRED), Error_code::NO_ERROR);
+        ASSERT_EQ(unit->parse_tree.deferred_bodies.size(), 2);
+
+        auto* f = unit->parse_tree.deferred_bodies[0];
+        auto* g = unit->parse_tree.deferred_bodies[1];
+
+        EXPECT_EQ(parse_body(*unit, *g), Error_code::NO_ERROR);
+        ASSERT_NE(g->body, nullptr);
+        EXPECT_NE(g->body->statement_sequence, nullptr);
+
+        EXPECT_EQ(parse_body(*unit, *f), Error_code::PARSING_ERROR);
+        EXPECT_EQ(f->body, nullptr);
+
+        // Bodies which were parsed on demand are not parsed again
+        EXPECT_EQ(parse_deferred_bodies(*unit), Error_code::PARSING_ERROR);
+        EXPECT_EQ(count_nodes(unit->parse_tree.flat, Node_type::CODE_BODY), 1);
+
+        unit = lex_unit("module m;\nfunc f() -> () { a b; }\n");
+        EXPECT_EQ(parse(*unit), Error_code::PARSING_ERROR);
+    }
+
+    TEST(Body_parsing, declaration_errors) {
+        using namespace parser;
+
+        // Malformed attribute value
+        auto unit = lex_unit("module m;\nfunc[align(+)] f() -> () { }\n");
+        ASSERT_TRUE(unit->tokenization.success);
+        EXPECT_EQ(parse(*unit), Error_code::PARSING_ERROR);
+
+        unit = lex_unit("module m;\nfunc[align(16)] f() -> () { }\n");
+        EXPECT_EQ(parse(*unit), Error_code::NO_ERROR);
+
+        // Struct definitions are reported rather than ending the list of
+        // declarations silently
+        unit = lex_unit("module m;\nstruct S { }\nfunc f() -> () { }\n");
+        ASSERT_TRUE(unit->tokenization.success);
+        EXPECT_EQ(parse(*unit), Error_code::PARSING_ERROR);
+
+        auto messages = to_string(unit->parse_tree.message_buffer);
+        EXPECT_NE(messages.find("Struct definitions are not yet supported"), std::string::npos);
+        EXPECT_NE(messages.find("test.hmn:2:1"), std::string::npos);
+    }
+
+}
+
+#endif //HARC_PARSER_BODY_PARSING_TESTS_HPP
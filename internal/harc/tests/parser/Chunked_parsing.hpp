@@ -0,0 +1,151 @@
+#ifndef HARC_PARSER_CHUNKED_PARSING_TESTS_HPP
+#define HARC_PARSER_CHUNKED_PARSING_TESTS_HPP
+
+#include "../Build_fixture.hpp"
+
+#include "Body_parsing.hpp"
+
+#include <harc/parser/Parser.hpp>
+
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace harc::tests {
+
+    ///
+    /// \param unit Lexed translation unit
+    /// \param chunk_size Target number of tokens per chunk
+    /// \return Error code of parsing unit in chunks, each on its own thread
+    inline Error_code parse_in_chunks(Translation_unit& unit, std::uint32_t chunk_size) {
+        auto chunks = parser::split_source_bodies(unit.tokens, chunk_size);
+
+        std::vector<parser::Chunk_parse> results(chunks.size());
+        {
+            std::vector<std::jthread> threads;
+            for (std::size_t i = 0; i < chunks.size(); ++i) {
+                threads.emplace_back([&, i] {
+                    results[i] = parser::parse_chunk(unit.source_path, unit.tokens, chunks[i]);
+                });
+            }
+        }
+
+        return parser::stitch_chunk_parses(unit, std::move(results));
+    }
+
+    ///
+    /// Checks that parsing in chunks of every size produces the same tree,
+    /// identifier IDs, and messages as parsing the whole source at once
+    ///
+    inline void expect_chunked_parsing_matches(std::string_view source) {
+        auto expected = lex_unit(source);
+        auto expected_error = parser::parse(*expected);
+
+        const auto& a = expected->parse_tree.flat;
+        for (std::uint32_t chunk_size = 1; chunk_size <= expected->tokens.size(); chunk_size *= 2) {
+            auto unit = lex_unit(source);
+            EXPECT_EQ(parse_in_chunks(*unit, chunk_size), expected_error) << chunk_size;
+
+            const auto& b = unit->parse_tree.flat;
+            EXPECT_EQ(a.types, b.types) << chunk_size;
+            EXPECT_EQ(a.first_children, b.first_children) << chunk_size;
+            EXPECT_EQ(a.next_siblings, b.next_siblings) << chunk_size;
+            EXPECT_EQ(a.first_tokens, b.first_tokens) << chunk_size;
+            EXPECT_EQ(a.end_tokens, b.end_tokens) << chunk_size;
+
+            ASSERT_EQ(unit->identifiers.size(), expected->identifiers.size()) << chunk_size;
+            for (std::uint32_t i = 0; i < unit->identifiers.size(); ++i) {
+                EXPECT_EQ(unit->identifiers.text(i), expected->identifiers.text(i)) << chunk_size;
+            }
+
+            EXPECT_EQ(
+                to_string(unit->parse_tree.message_buffer),
+                to_string(expected->parse_tree.message_buffer)
+            ) << chunk_size;
+        }
+    }
+
+    TEST(Chunked_parsing, chunks_begin_at_top_level_declarations) {
+        auto unit = lex_unit(
+            "module m;\n"
+            "func f() -> () { alias A = B; let g = lambda () { }; }\n"
+            "/// Documentation\n"
+            "alias C = D;\n"
+            "func[inline] g(x: T) -> () { }\n"
+        );
+
+        auto chunks = parser::split_source_bodies(unit->tokens, 1);
+        ASSERT_EQ(chunks.size(), 3);
+        EXPECT_EQ(unit->token_source(chunks[0].begin), "func");
+        EXPECT_EQ(unit->token_source(chunks[1].begin), "alias");
+        EXPECT_EQ(unit->token_source(chunks[2].begin), "func");
+        EXPECT_EQ(chunks.back().end, unit->tokens.size());
+
+        for (std::size_t i = 1; i < chunks.size(); ++i) {
+            EXPECT_EQ(chunks[i].begin, chunks[i - 1].end);
+        }
+
+        // Small declarations are grouped together
+        chunks = parser::split_source_bodies(unit->tokens, 1000);
+        ASSERT_EQ(chunks.size(), 1);
+
+        unit = lex_unit("module m;\n");
+        EXPECT_TRUE(parser::split_source_bodies(unit->tokens, 1).empty());
+    }
+
+    TEST(Chunked_parsing, matches_single_parser) {
+        std::string source = body_parsing_source;
+        for (int i = 0; i < 8; ++i) {
+            source += "func h" + std::to_string(i) + "(a: i32) -> i32 { return a * " + std::to_string(i) + "; }\n";
+            source += "alias A" + std::to_string(i) + " = Array<h" + std::to_string(i) + ">;\n";
+        }
+
+        expect_chunked_parsing_matches(source);
+        expect_chunked_parsing_matches("module m;\n");
+    }
+
+    TEST(Chunked_parsing, errors) {
+        // Within a declaration
+        expect_chunked_parsing_matches(
+            "module m;\n"
+            "func f() -> () { return 1; }\n"
+            "func g() -> () { a b; }\n"
+            "func h() -> () { c d; }\n"
+        );
+
+        // Between declarations
+        expect_chunked_parsing_matches(
+            "module m;\n"
+            "func f() -> () { }\n"
+            "let x = 1;\n"
+            "func g() -> () { }\n"
+        );
+
+        // Before the first declaration
+        expect_chunked_parsing_matches("module m;\nlet x = 1;\nfunc f() -> () { }\n");
+        expect_chunked_parsing_matches("func f() -> () { }\n");
+    }
+
+    TEST(Chunked_parsing, build_matches_unchunked) {
+        Build_fixture fixture{"chunked_parsing"};
+        add_mixed_sources(fixture);
+        fixture.add_source("large.hmn", large_source(200, "func broken() -> () { a b; }\nfunc[align(+)] g() -> () { }\n"));
+
+        auto expected = fixture.build(fixture.config());
+        EXPECT_NE(expected.find("large.hmn"), std::string::npos);
+
+        for (std::uint32_t chunk_size : {16u, 300u, 1024u}) {
+            auto config = fixture.config();
+            config.parse_chunk_size = chunk_size;
+            EXPECT_EQ(fixture.build(config), expected) << chunk_size;
+
+            // Chunked parsing of chunked lexing results
+            config.lex_chunk_size = 1024;
+            EXPECT_EQ(fixture.build(config), expected) << chunk_size;
+        }
+    }
+
+}
+
+#endif //HARC_PARSER_CHUNKED_PARSING_TESTS_HPP
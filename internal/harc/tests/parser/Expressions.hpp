@@ -0,0 +1,246 @@
+#ifndef HARC_PARSER_EXPRESSIONS_TESTS_HPP
+#define HARC_PARSER_EXPRESSIONS_TESTS_HPP
+
+#include <harc/parser/Parser.hpp>
+#include <harc/parser/Parse_tree.hpp>
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+namespace harc::tests {
+
+    ///
+    /// \return Index of the first token spanned by an expression
+    inline std::uint32_t first_token(parser::Parse_tree_node* node) {
+        using namespace parser;
+
+        if (auto* n = dynamic_cast<Identifier_expression*>(node)) {
+            return n->identifier->head->text_token;
+        }
+        if (auto* n = dynamic_cast<Numeric_literal_expression*>(node)) {
+            return n->numeric_literal_token;
+        }
+        if (auto* n = dynamic_cast<String_literal_expression*>(node)) {
+            return n->string_literal_token;
+        }
+        if (auto* n = dynamic_cast<Parenthesized_expression*>(node)) {
+            return n->l_paren_token;
+        }
+        if (auto* n = dynamic_cast<Tuple_literal*>(node)) {
+            return n->l_curly_bracket_token;
+        }
+        if (auto* n = dynamic_cast<Binary_operator_expression*>(node)) {
+            return first_token(n->l_expression);
+        }
+        if (auto* n = dynamic_cast<Binary_text_operator_expression*>(node)) {
+            return first_token(n->l_expression);
+        }
+        if (auto* n = dynamic_cast<Unary_operator_expression*>(node)) {
+            return std::min(n->operator_token, first_token(n->expression));
+        }
+        if (auto* n = dynamic_cast<Function_call*>(node)) {
+            return first_token(n->name);
+        }
+        if (auto* n = dynamic_cast<Subscript_call*>(node)) {
+            return first_token(n->name);
+        }
+        if (auto* n = dynamic_cast<Resolved_template*>(node)) {
+            return first_token(n->template_expression);
+        }
+
+        return UINT32_MAX;
+    }
+
+    ///
+    /// Renders an expression tree with every operation parenthesized so
+    /// that its grouping can be compared against a string
+    ///
+    inline std::string to_grouping(const Translation_unit& unit, parser::Parse_tree_node* node) {
+        using namespace parser;
+
+        if (!node) {
+            return "<null>";
+        }
+
+        auto token = [&](std::uint32_t i) { return std::string{unit.token_source(i)}; };
+
+        auto sequence = [&](Expression_sequence* s) {
+            std::string ret;
+            for (; s; s = s->tail) {
+                ret += to_grouping(unit, s->head);
+                ret += s->tail ? ", " : "";
+            }
+            return ret;
+        };
+
+        if (auto* n = dynamic_cast<Identifier_expression*>(node)) {
+            std::string ret;
+            for (auto* i = n->identifier; i; i = i->tail) {
+                ret += token(i->head->text_token);
+                ret += i->tail ? "." : "";
+            }
+            return ret;
+        }
+
+        if (auto* n = dynamic_cast<Numeric_literal_expression*>(node)) {
+            return token(n->numeric_literal_token);
+        }
+
+        if (auto* n = dynamic_cast<String_literal_expression*>(node)) {
+            return token(n->string_literal_token);
+        }
+
+        if (auto* n = dynamic_cast<Parenthesized_expression*>(node)) {
+            return to_grouping(unit, n->expression);
+        }
+
+        if (auto* n = dynamic_cast<Tuple_literal*>(node)) {
+            return "{" + sequence(n->expression_sequence) + "}";
+        }
+
+        if (auto* n = dynamic_cast<Binary_operator_expression*>(node)) {
+            return "(" + to_grouping(unit, n->l_expression) + " " + token(n->operator_token) + " " + to_grouping(unit, n->r_expression) + ")";
+        }
+
+        if (auto* n = dynamic_cast<Binary_text_operator_expression*>(node)) {
+            return "(" + to_grouping(unit, n->l_expression) + " " + token(n->operator_text->text_token) + " " + to_grouping(unit, n->r_expression) + ")";
+        }
+
+        if (auto* n = dynamic_cast<Unary_operator_expression*>(node)) {
+            auto op = token(n->operator_token);
+            auto operand = to_grouping(unit, n->expression);
+
+            if (n->operator_token < first_token(n->expression)) {
+                return "(" + op + " " + operand + ")";
+            } else {
+                return "(" + operand + " " + op + ")";
+            }
+        }
+
+        if (auto* n = dynamic_cast<Function_call*>(node)) {
+            return to_grouping(unit, n->name) + "(" + sequence(n->parameters) + ")";
+        }
+
+        if (auto* n = dynamic_cast<Subscript_call*>(node)) {
+            return to_grouping(unit, n->name) + "[" + sequence(n->parameters) + "]";
+        }
+
+        if (auto* n = dynamic_cast<Resolved_template*>(node)) {
+            return to_grouping(unit, n->template_expression) + "<" + sequence(n->parameters) + ">";
+        }
+
+        return "<unknown>";
+    }
+
+    ///
+    /// \param source Source consisting of a single expression
+    /// \return Fully parenthesized rendering of source's expression. Empty
+    /// if source could not be parsed.
+    inline std::string parse_grouping(std::string_view source) {
+        Translation_unit unit;
+        unit.source_path = "test.hmn";
+        unit.set_source(std::string{source});
+        unit.tokenization = lex::lex(unit.source_path, unit.source);
+        unit.tokens = lex::Tokenization_view{unit.tokenization};
+
+        if (parser::parse_expression(unit) != Error_code::NO_ERROR) {
+            return {};
+        }
+
+        return to_grouping(unit, unit.parse_tree.root);
+    }
+
+    TEST(Expressions, precedence) {
+        EXPECT_EQ(parse_grouping("a + b * c"), "(a + (b * c))");
+        EXPECT_EQ(parse_grouping("a * b + c"), "((a * b) + c)");
+        EXPECT_EQ(parse_grouping("a << 1 + b"), "(a << (1 + b))");
+        EXPECT_EQ(parse_grouping("a && b || c && d"), "((a && b) || (c && d))");
+        EXPECT_EQ(parse_grouping("a & b == c"), "(a & (b == c))");
+        EXPECT_EQ(parse_grouping("(a + b) * c"), "((a + b) * c)");
+    }
+
+    TEST(Expressions, associativity) {
+        EXPECT_EQ(parse_grouping("a - b - c - d"), "(((a - b) - c) - d)");
+        EXPECT_EQ(parse_grouping("a = b = c"), "(a = (b = c))");
+        EXPECT_EQ(parse_grouping("a += b * c"), "(a += (b * c))");
+    }
+
+    TEST(Expressions, unary_and_postfix) {
+        EXPECT_EQ(parse_grouping("-a * b"), "((- a) * b)");
+        EXPECT_EQ(parse_grouping("!~a"), "(! (~ a))");
+        EXPECT_EQ(parse_grouping("-f(x)[1]"), "(- f(x)[1])");
+        EXPECT_EQ(parse_grouping("-a++ * b"), "((- (a ++)) * b)");
+        EXPECT_EQ(parse_grouping("f(a++)"), "f((a ++))");
+        EXPECT_EQ(parse_grouping("f(a, b + c)(d)"), "f(a, (b + c))(d)");
+        EXPECT_EQ(parse_grouping("f()"), "f()");
+        EXPECT_EQ(parse_grouping("m.n.g<Array<i32>>(x).y"), "(m.n.g<Array<i32>>(x) . y)");
+    }
+
+    TEST(Expressions, literals) {
+        EXPECT_EQ(parse_grouping("1 + 0x10 * \"s\""), "(1 + (0x10 * \"s\"))");
+
+        // A type suffix binds only to its literal
+        EXPECT_EQ(parse_grouping("1:u32 + 2"), "(1 + 2)");
+    }
+
+    TEST(Expressions, text_operators) {
+        EXPECT_EQ(parse_grouping("a as T"), "(a as T)");
+        EXPECT_EQ(parse_grouping("a + b as T"), "(a + (b as T))");
+        EXPECT_EQ(parse_grouping("x is T && y in z"), "((x is T) && (y in z))");
+        EXPECT_EQ(parse_grouping("a as T as U"), "((a as T) as U)");
+        EXPECT_EQ(parse_grouping("f(x) as Array<i32>"), "(f(x) as Array<i32>)");
+
+        EXPECT_EQ(parse_grouping("a as"), "");
+        EXPECT_EQ(parse_grouping("a as + b"), "");
+    }
+
+    TEST(Expressions, tuple_literals) {
+        EXPECT_EQ(parse_grouping("{a, b + c}"), "{a, (b + c)}");
+        EXPECT_EQ(parse_grouping("{}"), "{}");
+        EXPECT_EQ(parse_grouping("{{a}, b}"), "{{a}, b}");
+        EXPECT_EQ(parse_grouping("f({a, b})"), "f({a, b})");
+
+        // A type suffix binds only to its literal
+        EXPECT_EQ(parse_grouping("{a}:Pair<i32> + b"), "({a} + b)");
+
+        EXPECT_EQ(parse_grouping("{a"), "");
+        EXPECT_EQ(parse_grouping("{a b}"), "");
+        EXPECT_EQ(parse_grouping("{a}:"), "");
+    }
+
+    TEST(Expressions, errors) {
+        EXPECT_EQ(parse_grouping("a +"), "");
+        EXPECT_EQ(parse_grouping("f(a,"), "");
+        EXPECT_EQ(parse_grouping("a b"), "");
+        EXPECT_EQ(parse_grouping("(a"), "");
+    }
+
+    TEST(Expressions, deep_nesting) {
+        std::string source;
+        for (int i = 0; i < 1000; ++i) {
+            source += "(";
+        }
+        source += "a";
+        for (int i = 0; i < 1000; ++i) {
+            source += " + b)";
+        }
+
+        EXPECT_FALSE(parse_grouping(source).empty());
+
+        // Long chains are parsed without recursing once per operator
+        std::string chain = "a";
+        for (int i = 0; i < 10000; ++i) {
+            chain += " + a";
+        }
+
+        Translation_unit unit;
+        unit.set_source(std::move(chain));
+        unit.tokenization = lex::lex("test.hmn", unit.source);
+        unit.tokens = lex::Tokenization_view{unit.tokenization};
+        EXPECT_EQ(parser::parse_expression(unit), Error_code::NO_ERROR);
+    }
+
+}
+
+#endif //HARC_PARSER_EXPRESSIONS_TESTS_HPP
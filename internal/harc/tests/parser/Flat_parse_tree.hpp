@@ -0,0 +1,117 @@
+#ifndef HARC_FLAT_PARSE_TREE_TESTS_HPP
+#define HARC_FLAT_PARSE_TREE_TESTS_HPP
+
+#include <harc/parser/Parse_tree.hpp>
+#include <harc/parser/Flat_parse_tree.hpp>
+
+#include <vector>
+
+namespace harc::tests {
+
+    struct Flat_order_recorder : parser::Flat_visitor<Flat_order_recorder> {
+        std::vector<parser::Node_type> entered;
+        std::vector<parser::Node_type> left;
+
+        bool enter(const parser::Flat_parse_tree& tree, std::uint32_t node) {
+            entered.push_back(tree.types[node]);
+            return true;
+        }
+
+        void leave(const parser::Flat_parse_tree& tree, std::uint32_t node) {
+            left.push_back(tree.types[node]);
+        }
+    };
+
+    TEST(Flat_parse_tree, null_root) {
+        auto tree = parser::flatten(nullptr);
+        EXPECT_TRUE(tree.empty());
+
+        Flat_order_recorder recorder{};
+        recorder.traverse(tree);
+        EXPECT_TRUE(recorder.entered.empty());
+    }
+
+    TEST(Flat_parse_tree, lists_become_siblings) {
+        using namespace parser;
+
+        // Corresponds to the tokens: module a.b; func f ( ) func g ( )
+        Arena arena{};
+
+        auto* a = arena.create<Text>();
+        a->text_token = 1;
+        auto* b = arena.create<Text>();
+        b->text_token = 3;
+
+        auto* name_tail = arena.create<Resolved_identifier>();
+        name_tail->head = b;
+        auto* name = arena.create<Resolved_identifier>();
+        name->head = a;
+        name->dot_token = 2;
+        name->tail = name_tail;
+
+        auto* module_keyword = arena.create<Text>();
+        module_keyword->text_token = 0;
+
+        auto* module = arena.create<Module_declaration>();
+        module->module_keyword = module_keyword;
+        module->module_name = name;
+        module->semicolon_token = 4;
+
+        auto* f = arena.create<Function_definition>();
+        f->l_paren_token = 7;
+        f->r_paren_token = 8;
+        auto* g = arena.create<Function_definition>();
+        g->l_paren_token = 11;
+        g->r_paren_token = 12;
+
+        auto* list_tail = arena.create<Source_body_list>();
+        list_tail->head = g;
+        auto* list = arena.create<Source_body_list>();
+        list->head = f;
+        list->tail = list_tail;
+
+        auto* file = arena.create<Source_file>();
+        file->module_declaration = module;
+        file->body = list;
+
+        auto tree = flatten(file);
+        ASSERT_EQ(9, tree.size());
+
+        // Pre-order layout
+        EXPECT_EQ(Node_type::SOURCE_FILE, tree.types[0]);
+        EXPECT_EQ(Node_type::MODULE_DECLARATION, tree.types[1]);
+        EXPECT_EQ(Node_type::TEXT, tree.types[2]);
+        EXPECT_EQ(Node_type::RESOLVED_IDENTIFIER, tree.types[3]);
+        EXPECT_EQ(Node_type::TEXT, tree.types[4]);
+        EXPECT_EQ(Node_type::TEXT, tree.types[5]);
+        EXPECT_EQ(Node_type::SOURCE_BODY_LIST, tree.types[6]);
+        EXPECT_EQ(Node_type::FUNCTION_DEFINITION, tree.types[7]);
+        EXPECT_EQ(Node_type::FUNCTION_DEFINITION, tree.types[8]);
+
+        // Linked lists are collapsed into siblings
+        EXPECT_EQ(4, tree.first_children[3]);
+        EXPECT_EQ(5, tree.next_siblings[4]);
+        EXPECT_EQ(Flat_parse_tree::null_index, tree.next_siblings[5]);
+
+        EXPECT_EQ(7, tree.first_children[6]);
+        EXPECT_EQ(8, tree.next_siblings[7]);
+
+        // Token ranges
+        EXPECT_EQ(0, tree.first_tokens[0]);
+        EXPECT_EQ(13, tree.end_tokens[0]);
+        EXPECT_EQ(1, tree.first_tokens[3]);
+        EXPECT_EQ(4, tree.end_tokens[3]);
+        EXPECT_EQ(7, tree.first_tokens[6]);
+        EXPECT_EQ(13, tree.end_tokens[6]);
+
+        Flat_order_recorder recorder{};
+        recorder.traverse(tree);
+        EXPECT_EQ(tree.types, recorder.entered);
+        ASSERT_EQ(9, recorder.left.size());
+        EXPECT_EQ(Node_type::TEXT, recorder.left[0]);
+        EXPECT_EQ(Node_type::SOURCE_FILE, recorder.left.back());
+    }
+
+}
+
+#endif //HARC_FLAT_PARSE_TREE_TESTS_HPP
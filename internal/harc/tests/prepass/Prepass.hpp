@@ -0,0 +1,117 @@
+#ifndef HARC_PREPASS_TESTS_HPP
+#define HARC_PREPASS_TESTS_HPP
+
+#include "../Build_fixture.hpp"
+
+#include <harc/prepass/Prepass.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace harc::tests {
+
+    ///
+    /// \return Kernels which may be run on the host CPU
+    inline std::vector<prepass::Prepass_kernel> supported_prepass_kernels() {
+        std::vector<prepass::Prepass_kernel> ret{prepass::Prepass_kernel::SCALAR};
+
+        auto widest = prepass::selected_kernel();
+        if (widest == prepass::Prepass_kernel::AVX2 || widest == prepass::Prepass_kernel::AVX512) {
+            ret.push_back(prepass::Prepass_kernel::AVX2);
+        }
+
+        if (widest == prepass::Prepass_kernel::AVX512) {
+            ret.push_back(prepass::Prepass_kernel::AVX512);
+        }
+
+        return ret;
+    }
+
+    TEST(Prepass, line_indices) {
+        std::string source = "a\nbc\n\n";
+        source += std::string(100, 'x');
+        source += "\nd";
+
+        for (auto kernel : supported_prepass_kernels()) {
+            auto results = prepass::prepass(source, kernel);
+
+            std::vector<std::uint32_t> expected{0, 2, 5, 6, 107};
+            EXPECT_EQ(results.line_indices, expected);
+            EXPECT_TRUE(results.is_ascii);
+            EXPECT_TRUE(results.errors.empty());
+            EXPECT_EQ(results.codepoint_count, source.size());
+        }
+    }
+
+    TEST(Prepass, kernels_agree) {
+        std::string source;
+        for (int i = 0; i < 40; ++i) {
+            source += "let xé = \"€\U0001F600\";\n";
+            source += std::string(i, ' ');
+        }
+
+        auto expected = prepass::prepass(source, prepass::Prepass_kernel::SCALAR);
+        EXPECT_FALSE(expected.is_ascii);
+        EXPECT_TRUE(expected.errors.empty());
+        EXPECT_EQ(expected.codepoint_count, source.size() - 40 * (1 + 2 + 3));
+
+        // Every length of source exercises a different partial final block
+        for (std::size_t length = 0; length <= 200; ++length) {
+            std::string_view prefix{source.data(), length};
+            auto scalar_results = prepass::prepass(prefix, prepass::Prepass_kernel::SCALAR);
+
+            for (auto kernel : supported_prepass_kernels()) {
+                auto results = prepass::prepass(prefix, kernel);
+                EXPECT_EQ(results.hash, scalar_results.hash);
+                EXPECT_EQ(results.line_indices, scalar_results.line_indices);
+                EXPECT_EQ(results.codepoint_count, scalar_results.codepoint_count);
+                EXPECT_EQ(results.is_ascii, scalar_results.is_ascii);
+                EXPECT_EQ(results.errors.empty(), scalar_results.errors.empty());
+            }
+        }
+    }
+
+    TEST(Prepass, invalid_utf8) {
+        struct Case {
+            std::string_view source;
+            prepass::Error_code error_code;
+            std::uint32_t start_location;
+        };
+
+        std::vector<Case> cases{
+            {"abc\x80", prepass::Error_code::INVALID_UTF8_EXCESSIVE_CONTINUATION_BYTES, 3},
+            {"ab\xC3", prepass::Error_code::INVALID_UTF8_INSUFFICIENT_CONTINUATION_BYTES, 2},
+            {"\xE2\x82 x", prepass::Error_code::INVALID_UTF8_INSUFFICIENT_CONTINUATION_BYTES, 0},
+            {"x\xC0\xAF", prepass::Error_code::INVALID_UTF8_NON_SHORTEST_FORM, 1},
+            {"x\xED\xA0\x80", prepass::Error_code::INVALID_UTF8_CODEPOINT_IS_SURROGATE_VALUE, 1},
+            {"\xF4\x90\x80\x80", prepass::Error_code::INVALID_UTF8_CODEPOINT_GREATER_THAN_U10FFFF, 0}
+        };
+
+        for (const auto& c : cases) {
+            // Errors are placed at every offset relative to the vector width
+            for (std::size_t padding = 0; padding < 70; ++padding) {
+                std::string source(padding, ' ');
+                source += c.source;
+
+                for (auto kernel : supported_prepass_kernels()) {
+                    auto results = prepass::prepass(source, kernel);
+                    ASSERT_EQ(results.errors.size(), 1);
+                    EXPECT_EQ(results.errors[0].error_code, c.error_code);
+                    EXPECT_EQ(results.errors[0].start_location, padding + c.start_location);
+                }
+            }
+        }
+    }
+
+    TEST(Prepass, build_reports_encoding_errors) {
+        Build_fixture fixture{"encoding"};
+        fixture.add_source("a.hmn", "module a;\n// \xC0\xAF\nlet x = 1;\n");
+
+        auto messages = fixture.build(fixture.config());
+        EXPECT_NE(messages.find("Overlong UTF-8 sequence"), std::string::npos) << messages;
+    }
+
+}
+
+#endif //HARC_PREPASS_TESTS_HPP
@@ -3,14 +3,32 @@
 
 #include <vector>
 #include <span>
+#include <array>
 #include <cstdint>
 #include <string_view>
 
 namespace harc {
 
+    ///
+    /// Information stored within the build cache for a single source file.
+    ///
+    /// When produced by parse_serialization(), all views point directly into
+    /// the serialization which was parsed and every non-empty serialization
+    /// begins at an 8-byte aligned offset from the start of it.
+    ///
     struct Cache_entry_info {
         std::string_view path;
+
+        ///
+        /// Modification time of source file, in nanoseconds since the epoch
+        ///
         std::uint64_t timestamp = 0;
+
+        ///
+        /// 128-bit MurmurHash3 of source file contents
+        ///
+        std::array<std::uint64_t, 2> hash{};
+
         std::span<const std::byte> tokenization_serialization;
         std::span<const std::byte> parsing_serialization;
         std::span<const std::byte> ir_serialization;
@@ -28,7 +46,17 @@ namespace harc {
         std::span<const Cache_entry_info> infos
     );
 
-    std::vector<Cache_entry_info> parse_serialization();
+    ///
+    /// Reads the index of a serialization produced by
+    /// assemble_serialization(). No data is copied out of the serialization.
+    ///
+    /// \param bytes Serialization bytes. Must remain valid for as long as the
+    /// returned infos are used. Should be 8-byte aligned, such as when the
+    /// bytes come from a memory-mapped file.
+    /// \return Infos for each entry in the serialization. Empty if the bytes
+    /// are not a well-formed serialization of the current version.
+    [[nodiscard]]
+    std::vector<Cache_entry_info> parse_serialization(std::span<const std::byte> bytes);
 
 }
 
@@ -204,6 +204,26 @@ namespace harc {
 
     };
 
+    ///
+    /// Location which a message within a Message_buffer refers to. Messages
+    /// which are not about a particular file have an empty path, and those
+    /// which are not about a particular position have a line and column of 0.
+    ///
+    struct Message_location {
+
+        ///
+        /// Index of the message's first byte within the buffer
+        ///
+        std::size_t offset = 0;
+
+        std::uint32_t line = 0;
+
+        std::uint32_t column = 0;
+
+        std::string path;
+
+    };
+
     ///
     /// This class represents a buffer that is used to store message that are
     /// produced by the compilation process before being presented to the user.
@@ -348,6 +368,13 @@ namespace harc {
         /// \param buffer
         void append(Message_buffer&& buffer);
 
+        ///
+        /// Appends a single message from another buffer
+        ///
+        /// \param buffer Buffer holding message
+        /// \param i Index of message within buffer
+        void append_message(const Message_buffer& buffer, std::size_t i);
+
         //=================================================
         // Accessors
         //=================================================
@@ -363,6 +390,7 @@ namespace harc {
 
         void clear() {
             buffer = {};
+            message_locations = {};
         }
 
         [[nodiscard]]
@@ -375,6 +403,20 @@ namespace harc {
             return filter;
         }
 
+        ///
+        /// \return Locations of the buffer's messages, in the order in which
+        /// the messages were added
+        [[nodiscard]]
+        std::span<const Message_location> locations() const {
+            return message_locations;
+        }
+
+        ///
+        /// \param i Index of message
+        /// \return Markup of message
+        [[nodiscard]]
+        std::string_view message_markup(std::size_t i) const;
+
     private:
 
         //=================================================
@@ -383,8 +425,21 @@ namespace harc {
 
         std::vector<char> buffer;
 
+        std::vector<Message_location> message_locations;
+
         message_filter_func filter = message_filter_medium;
 
+        //=================================================
+        // Helper functions
+        //=================================================
+
+        void push_message(
+            std::string_view markup,
+            std::string_view path,
+            std::uint32_t line,
+            std::uint32_t column
+        );
+
     };
 
     //=====================================================
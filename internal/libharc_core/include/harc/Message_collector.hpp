@@ -0,0 +1,80 @@
+#ifndef HARC_MESSAGE_COLLECTOR_HPP
+#define HARC_MESSAGE_COLLECTOR_HPP
+
+#include <harc/Message_buffer.hpp>
+
+#include <deque>
+#include <mutex>
+
+namespace harc {
+
+    ///
+    /// Gathers the messages produced by several threads without having them
+    /// share a buffer.
+    ///
+    /// Each thread registers a Message_buffer of its own once, after which it
+    /// reports messages into that buffer without taking any locks. When the
+    /// messages are to be reported, merge() combines the buffers in an order
+    /// which does not depend on which thread produced which message, so that
+    /// output is reproducible from run to run.
+    ///
+    class Message_collector {
+    public:
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// Thread-safe
+        ///
+        /// \return Buffer for the exclusive use of the calling thread. Remains
+        /// valid until clear() is called.
+        [[nodiscard]]
+        Message_buffer& register_buffer();
+
+        ///
+        /// Discards all registered buffers along with their messages, so
+        /// that threads of the next build register buffers of their own.
+        /// Must not be called while any thread still holds its buffer.
+        ///
+        void clear();
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// Combines the messages of all registered buffers, ordered by path,
+        /// then line, then column. Messages with the same location are
+        /// ordered by their contents. Must not be called while any thread is
+        /// writing to its buffer.
+        ///
+        /// \return Buffer containing all messages
+        [[nodiscard]]
+        Message_buffer merge() const;
+
+        ///
+        /// \return Number of buffers registered since the last call to
+        /// clear()
+        [[nodiscard]]
+        std::size_t buffer_count() const;
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        mutable std::mutex mutex;
+
+        ///
+        /// Deque so that references to buffers survive further registrations
+        ///
+        std::deque<Message_buffer> buffers;
+
+    };
+
+}
+
+#endif //HARC_MESSAGE_COLLECTOR_HPP
@@ -8,7 +8,7 @@
 
 namespace harc {
 
-    Codepoint_category categorized_codepoint(std::uint32_t x) {
+    inline Codepoint_category categorized_codepoint(std::uint32_t x) {
         // Use lookup table for ASCII codepoints
         if (x < 128) {
             return codepoint_categories7[x];
@@ -25,10 +25,14 @@ namespace harc {
         if (x <= UINT16_MAX) {
             auto a = std::begin(identifier_codepoint_range_firsts_16);
             auto b = std::end(identifier_codepoint_range_firsts_16);
-            auto it = std::lower_bound(a, b, std::uint16_t(x));
+            auto it = std::upper_bound(a, b, std::uint16_t(x));
+            if (it == a) {
+                return Codepoint_category::UNRECOGNIZED;
+            }
+            --it;
 
-            auto range_begin = *it;
-            auto range_end = identifier_codepoint_range_sizes_16[it - a];
+            std::uint32_t range_begin = *it;
+            std::uint32_t range_end = range_begin + identifier_codepoint_range_sizes_16[it - a];
 
             if (range_begin <= x && x < range_end) {
                 std::uint32_t index = (it - a);
@@ -45,10 +49,14 @@ namespace harc {
         {
             auto a = std::begin(identifier_codepoint_range_firsts_21);
             auto b = std::end(identifier_codepoint_range_firsts_21);
-            auto it = std::lower_bound(a, b, x);
+            auto it = std::upper_bound(a, b, x);
+            if (it == a) {
+                return Codepoint_category::UNRECOGNIZED;
+            }
+            --it;
 
-            auto range_begin = *it;
-            auto range_end = identifier_codepoint_range_sizes_21[it - a];
+            std::uint32_t range_begin = *it;
+            std::uint32_t range_end = range_begin + identifier_codepoint_range_sizes_21[it - a];
 
             if (range_begin <= x && x < range_end) {
                 std::uint32_t index = (it - a);
@@ -3,42 +3,73 @@
 
 #include <aul/Math.hpp>
 
+#include <algorithm>
 #include <cstring>
 
 namespace harc {
 
-    const Version serialization_version{0, 0, 0, Release_type::ALPHA};
+    const Version serialization_version{0, 0, 1, Release_type::ALPHA};
+
+    // Region 0: Magic bytes, version, padding, and index entry count
+    constexpr std::size_t format_header_size = 24;
+
+    // Region 1: Entry offset, timestamp, and hash, followed by the path
+    // length and path bytes
+    constexpr std::size_t index_entry_overhead = 32;
+
+    // Region 2: Offset and size of each of the four sub-entries
+    constexpr std::size_t entry_header_size = 64;
+
+    constexpr std::size_t sub_entry_count = 4;
+
+    ///
+    /// \param n Arbitrary byte count
+    /// \return n rounded up to a multiple of 8
+    constexpr std::uint64_t pad8(std::uint64_t n) {
+        return (n + 7) & ~std::uint64_t{7};
+    }
+
+    ///
+    /// \param info Arbitrary cache entry info
+    /// \return Serialization spans of info in the order they are written
+    std::array<std::span<const std::byte>, sub_entry_count> sub_entries(const Cache_entry_info& info) {
+        return {
+            info.tokenization_serialization,
+            info.parsing_serialization,
+            info.ir_serialization,
+            info.machine_code_serialization
+        };
+    }
 
     std::vector<std::byte> assemble_serialization(
         std::span<const Cache_entry_info> infos
     ) {
-        constexpr std::size_t format_header_size = 16;
-        constexpr std::size_t index_entry_overhead = 24;
-        constexpr std::size_t entry_header_size = 32;
-
         // Compute size of serialized data
         std::size_t serialization_size = 0;
         serialization_size += format_header_size;
 
         for (const auto& info : infos) {
             serialization_size += index_entry_overhead;
-
-            serialization_size += sizeof(std::uint32_t);
-            serialization_size += 4 * aul::divide_ceil(info.path.size(), std::size_t(4));
+            serialization_size += pad8(sizeof(std::uint32_t) + info.path.size());
 
             serialization_size += entry_header_size;
-            serialization_size += info.tokenization_serialization.size();
-            serialization_size += info.parsing_serialization.size();
-            serialization_size += info.ir_serialization.size();
-            serialization_size += info.machine_code_serialization.size();
+            for (auto sub_entry : sub_entries(info)) {
+                serialization_size += pad8(sub_entry.size());
+            }
         }
 
+        // Zero-initialized so that padding bytes need not be written
         std::vector<std::byte> ret;
         ret.resize(serialization_size);
 
         // Write data to buffer:
         std::byte* output_ptr = ret.data();
 
+        auto write_u64 = [&output_ptr] (std::uint64_t x) {
+            std::memcpy(output_ptr, &x, sizeof(std::uint64_t));
+            output_ptr += sizeof(std::uint64_t);
+        };
+
         // Write region 0
         // Write serialization header
         const char* magic_bytes = "HarCache";
@@ -49,89 +80,60 @@ namespace harc {
         std::memcpy(output_ptr, &version_bytes, sizeof(std::uint32_t));
         output_ptr += sizeof(std::uint32_t);
 
-        std::memset(output_ptr, 0x00, 4);
         output_ptr += 4;
 
         // Assemble serialization index header
-        std::uint64_t entry_count = infos.size();
-        std::memcpy(&output_ptr, &entry_count, sizeof(std::uint64_t));
-        output_ptr += sizeof(std::uint64_t);
+        write_u64(infos.size());
 
         // Write region 1
         // Assemble entries
         std::uint64_t region2_offset = 0;
-        for (auto& info : infos) {
-            // Write offset
-            std::memcpy(output_ptr, &region2_offset, sizeof(std::uint64_t));
-            output_ptr += sizeof(std::uint64_t);
-
-            // Write  timestamp;
-            std::memcpy(output_ptr, &info.timestamp, sizeof(std::uint64_t));
-            output_ptr += sizeof(std::uint64_t);
+        for (const auto& info : infos) {
+            write_u64(region2_offset);
+            write_u64(info.timestamp);
+            write_u64(info.hash[0]);
+            write_u64(info.hash[1]);
 
             // Write file path
             std::uint32_t path_length = info.path.size();
-            std::memcpy(&output_ptr, &path_length, sizeof(std::uint32_t));
-            output_ptr += sizeof(std::uint32_t);
-
-            std::memcpy(output_ptr, info.path.data(), info.path.size());
-            output_ptr += info.path.size();
-
-            std::uint32_t padding_byte_count = (8 - (sizeof(std::uint32_t) + info.path.size()) % 8 ) % 8;
-            std::memset(output_ptr, 0x00, padding_byte_count);
-            output_ptr += padding_byte_count;
+            std::memcpy(output_ptr, &path_length, sizeof(std::uint32_t));
+            std::memcpy(output_ptr + sizeof(std::uint32_t), info.path.data(), info.path.size());
+            output_ptr += pad8(sizeof(std::uint32_t) + info.path.size());
 
             // Adjust region offset
-            std::uint64_t entry_size = 0;
-            entry_size += entry_header_size;
-            entry_size += info.tokenization_serialization.size();
-            entry_size += info.parsing_serialization.size();
-            entry_size += info.ir_serialization.size();
-            entry_size += info.machine_code_serialization.size();
+            std::uint64_t entry_size = entry_header_size;
+            for (auto sub_entry : sub_entries(info)) {
+                entry_size += pad8(sub_entry.size());
+            }
             region2_offset += entry_size;
         }
 
         // Region 2
         // Write cache entries
-        for (auto info : infos) {
-            // Write entry header
-            std::uint64_t lexer_offset = 0;
-            std::memcpy(output_ptr, &lexer_offset, sizeof(std::uint64_t));
-            output_ptr += sizeof(std::uint64_t);
-
-            std::uint64_t parse_offset = info.tokenization_serialization.size();
-            std::memcpy(output_ptr, &parse_offset, sizeof(std::uint64_t));
-            output_ptr += sizeof(std::uint64_t);
-
-            std::uint64_t ir_offset = parse_offset += info.parsing_serialization.size();
-            std::memcpy(output_ptr, &ir_offset, sizeof(std::uint64_t));
-            output_ptr += sizeof(std::uint64_t);
-
-            std::uint64_t machine_code_offset = ir_offset + info.ir_serialization.size();
-            std::memcpy(output_ptr, &machine_code_offset, sizeof(std::uint64_t));
-            output_ptr += sizeof(std::uint64_t);
+        for (const auto& info : infos) {
+            // Write entry header. Offsets are relative to the end of the
+            // header
+            std::uint64_t sub_entry_offset = 0;
+            for (auto sub_entry : sub_entries(info)) {
+                write_u64(sub_entry_offset);
+                write_u64(sub_entry.size());
+                sub_entry_offset += pad8(sub_entry.size());
+            }
 
             // Write sub-entries
-            std::memcpy(output_ptr, info.tokenization_serialization.data(), info.tokenization_serialization.size());
-            output_ptr += info.tokenization_serialization.size();
-
-            std::memcpy(output_ptr, info.parsing_serialization.data(), info.parsing_serialization.size());
-            output_ptr += info.parsing_serialization.size();
-
-            std::memcpy(output_ptr, info.ir_serialization.data(), info.ir_serialization.size());
-            output_ptr += info.ir_serialization.size();
-
-            std::memcpy(output_ptr, info.machine_code_serialization.data(), info.machine_code_serialization.size());
-            output_ptr += info.machine_code_serialization.size();
+            for (auto sub_entry : sub_entries(info)) {
+                if (!sub_entry.empty()) {
+                    std::memcpy(output_ptr, sub_entry.data(), sub_entry.size());
+                }
+                output_ptr += pad8(sub_entry.size());
+            }
         }
 
         return ret;
     }
 
     std::vector<Cache_entry_info> parse_serialization(std::span<const std::byte> bytes) {
-        //TODO: Perform proper error handling
-
-        if (bytes.size() < 24) {
+        if (bytes.size() < format_header_size) {
             return {};
             // Input is too small to be a valid serialization
             // 16 bytes for serialization header and 8 bytes for index table
@@ -155,6 +157,13 @@ namespace harc {
 
         std::uint64_t offset = sizeof(magic_bytes);
 
+        auto read_u64 = [&bytes, &offset] () {
+            std::uint64_t x = 0;
+            std::memcpy(&x, bytes.data() + offset, sizeof(std::uint64_t));
+            offset += sizeof(std::uint64_t);
+            return x;
+        };
+
         // Read version
         std::uint32_t version;
         std::memcpy(&version, bytes.data() + offset, sizeof(std::uint32_t));
@@ -169,15 +178,19 @@ namespace harc {
         offset += sizeof(std::uint32_t);
 
         // Read index entry count
-        std::uint64_t index_entry_count = 0;
-        std::memcpy(&index_entry_count, bytes.data() + offset, sizeof(std::uint64_t));
-        offset += sizeof(std::uint64_t);
+        std::uint64_t index_entry_count = read_u64();
 
         // Return early if serialization does not contain any entries
         if (index_entry_count == 0) {
             return {};
         }
 
+        // Each index entry occupies at least index_entry_overhead + 8 bytes,
+        // which bounds the count before anything is allocated
+        if (index_entry_count > (bytes.size() - offset) / (index_entry_overhead + 8)) {
+            return {};
+        }
+
         // Read index entries
         std::vector<Cache_entry_info> infos;
         infos.resize(index_entry_count);
@@ -187,62 +200,68 @@ namespace harc {
 
         for (std::uint64_t i = 0; i < index_entry_count; ++i) {
             //Ensure that serialization contains enough data
-            if (offset + 2 * sizeof(std::uint64_t) + sizeof(std::uint32_t)) {
+            if (bytes.size() - offset < index_entry_overhead + sizeof(std::uint32_t)) {
                 return {};
                 // Not enough bytes in the serialization to read index entry
             }
 
-            // Read cache entry offset
-            std::uint64_t cache_entry_offset = 0;
-            std::memcpy(&cache_entry_offset, bytes.data() + offset, sizeof(std::uint64_t));
-            offset += 64;
-            cache_entry_offsets[i] = cache_entry_offset;
-
-            // Read timestamp
-            std::uint64_t timestamp = 0;
-            std::memcpy(&timestamp, bytes.data() + offset, sizeof(std::uint64_t));
-            offset += 64;
-
-            infos[i].timestamp = timestamp;
+            cache_entry_offsets[i] = read_u64();
+            infos[i].timestamp = read_u64();
+            infos[i].hash[0] = read_u64();
+            infos[i].hash[1] = read_u64();
 
             // Read path size
             std::uint32_t path_size = 0;
+            std::memcpy(&path_size, bytes.data() + offset, sizeof(std::uint32_t));
 
             // Ensure that enough bytes exist to be read from
-            if (bytes.size() <= offset + path_size ) {
+            std::uint64_t padded_size = pad8(sizeof(std::uint32_t) + std::uint64_t{path_size});
+            if (bytes.size() - offset < padded_size) {
                 return {};
                 // Path was longer than amount of remaining bytes
             }
 
             // Read path
-            std::string_view path{
-                reinterpret_cast<const char*>(bytes.data() + offset),
+            infos[i].path = std::string_view{
+                reinterpret_cast<const char*>(bytes.data() + offset + sizeof(std::uint32_t)),
                 path_size
             };
 
-            infos[i].path = path;
+            offset += padded_size;
         }
 
-        std::uint64_t region2_offset = offset;
+        const std::uint64_t region2_offset = offset;
+        const std::uint64_t region2_size = bytes.size() - region2_offset;
 
         // Read entries
         for (std::uint64_t i = 0; i < index_entry_count; ++i) {
-            //TODO: Complete implementation
-            infos[i].tokenization_serialization = std::span<const std::byte>{
-
-            };
-
-            infos[i].parsing_serialization = std::span<const std::byte>{
+            std::uint64_t entry_offset = cache_entry_offsets[i];
+            if (entry_offset % 8 != 0 || entry_offset > region2_size || region2_size - entry_offset < entry_header_size) {
+                return {};
+                // Entry header lies outside of serialization
+            }
 
-            };
+            offset = region2_offset + entry_offset;
+            const std::uint64_t data_offset = offset + entry_header_size;
+            const std::uint64_t data_size = bytes.size() - data_offset;
 
-            infos[i].ir_serialization = std::span<const std::byte>{
+            std::array<std::span<const std::byte>, sub_entry_count> spans{};
+            for (auto& span : spans) {
+                std::uint64_t sub_entry_offset = read_u64();
+                std::uint64_t sub_entry_size = read_u64();
 
-            };
+                if (sub_entry_offset > data_size || data_size - sub_entry_offset < sub_entry_size) {
+                    return {};
+                    // Sub-entry lies outside of serialization
+                }
 
-            infos[i].machine_code_serialization = std::span<const std::byte>{
+                span = bytes.subspan(data_offset + sub_entry_offset, sub_entry_size);
+            }
 
-            };
+            infos[i].tokenization_serialization = spans[0];
+            infos[i].parsing_serialization = spans[1];
+            infos[i].ir_serialization = spans[2];
+            infos[i].machine_code_serialization = spans[3];
         }
 
         return infos;
@@ -188,8 +188,8 @@ namespace harc {
 
         Message_markup_builder builder;
         builder.append(mspan);
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+
+        push_message(builder.contents(), {}, 0, 0);
     }
 
     void Message_buffer::info(
@@ -220,8 +220,8 @@ namespace harc {
 
         Message_markup_builder builder;
         builder.append(mspan);
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+
+        push_message(builder.contents(), path, 0, 0);
     }
 
     void Message_buffer::info(
@@ -268,8 +268,7 @@ namespace harc {
         Message_markup_builder builder;
         builder.append(mspan);
 
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+        push_message(builder.contents(), path, line, column);
     }
 
     //=====================================================
@@ -302,8 +301,7 @@ namespace harc {
         Message_markup_builder builder;
         builder.append(mspan);
 
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+        push_message(builder.contents(), {}, 0, 0);
     }
 
     void Message_buffer::advice(
@@ -335,8 +333,7 @@ namespace harc {
         Message_markup_builder builder;
         builder.append(mspan);
 
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+        push_message(builder.contents(), path, 0, 0);
     }
 
     void Message_buffer::advice(
@@ -383,8 +380,7 @@ namespace harc {
         Message_markup_builder builder;
         builder.append(mspan);
 
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+        push_message(builder.contents(), path, line, column);
     }
 
     //=====================================================
@@ -417,8 +413,7 @@ namespace harc {
         Message_markup_builder builder;
         builder.append(mspan);
 
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+        push_message(builder.contents(), {}, 0, 0);
     }
 
     void Message_buffer::warning(
@@ -450,8 +445,7 @@ namespace harc {
         Message_markup_builder builder;
         builder.append(mspan);
 
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+        push_message(builder.contents(), path, 0, 0);
     }
 
     void Message_buffer::warning(
@@ -498,8 +492,7 @@ namespace harc {
         Message_markup_builder builder;
         builder.append(mspan);
 
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+        push_message(builder.contents(), path, line, column);
     }
 
     //=====================================================
@@ -532,13 +525,12 @@ namespace harc {
         Message_markup_builder builder;
         builder.append(mspan);
 
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+        push_message(builder.contents(), {}, 0, 0);
     }
 
     void Message_buffer::error(
-        std::string_view path,
-        std::string_view message
+        std::string_view message,
+        std::string_view path
     ) {
         const std::array<std::string_view, 5> strings{
             error_header_text,
@@ -565,8 +557,7 @@ namespace harc {
         Message_markup_builder builder;
         builder.append(mspan);
 
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+        push_message(builder.contents(), path, 0, 0);
     }
 
     void Message_buffer::error(
@@ -613,8 +604,7 @@ namespace harc {
         Message_markup_builder builder;
         builder.append(mspan);
 
-        auto t = builder.contents();
-        buffer.insert(buffer.end(), t.begin(), t.end());
+        push_message(builder.contents(), path, line, column);
     }
 
     //=========================================================================
@@ -622,11 +612,44 @@ namespace harc {
     //=========================================================================
 
     void Message_buffer::append(const Message_buffer& other) {
+        auto offset = buffer.size();
+        for (auto location : other.message_locations) {
+            location.offset += offset;
+            message_locations.push_back(std::move(location));
+        }
+
         buffer.insert(buffer.end(), other.contents().begin(), other.contents().end());
     }
 
     void Message_buffer::append(Message_buffer&& other) {
-        buffer.insert(buffer.end(), other.contents().begin(), other.contents().end());
+        if (buffer.empty()) {
+            buffer = std::move(other.buffer);
+            message_locations = std::move(other.message_locations);
+            return;
+        }
+
+        append(other);
+    }
+
+    void Message_buffer::append_message(const Message_buffer& other, std::size_t i) {
+        const auto& location = other.message_locations[i];
+        push_message(other.message_markup(i), location.path, location.line, location.column);
+    }
+
+    std::string_view Message_buffer::message_markup(std::size_t i) const {
+        auto begin = message_locations[i].offset;
+        auto end = (i + 1 < message_locations.size()) ? message_locations[i + 1].offset : buffer.size();
+        return std::string_view{buffer.data() + begin, end - begin};
+    }
+
+    void Message_buffer::push_message(
+        std::string_view markup,
+        std::string_view path,
+        std::uint32_t line,
+        std::uint32_t column
+    ) {
+        message_locations.push_back(Message_location{buffer.size(), line, column, std::string{path}});
+        buffer.insert(buffer.end(), markup.begin(), markup.end());
     }
 
     //=========================================================================
@@ -0,0 +1,69 @@
+#include <harc/Message_collector.hpp>
+
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+namespace harc {
+
+    //=====================================================
+    // Mutators
+    //=====================================================
+
+    Message_buffer& Message_collector::register_buffer() {
+        std::lock_guard lock{mutex};
+        return buffers.emplace_back();
+    }
+
+    void Message_collector::clear() {
+        std::lock_guard lock{mutex};
+        buffers.clear();
+    }
+
+    //=====================================================
+    // Accessors
+    //=====================================================
+
+    Message_buffer Message_collector::merge() const {
+        std::lock_guard lock{mutex};
+
+        struct Message_reference {
+            const Message_buffer* buffer = nullptr;
+            std::size_t index = 0;
+        };
+
+        std::vector<Message_reference> messages;
+        for (const auto& buffer : buffers) {
+            for (std::size_t i = 0; i < buffer.locations().size(); ++i) {
+                messages.push_back(Message_reference{&buffer, i});
+            }
+        }
+
+        auto key = [] (const Message_reference& m) {
+            const auto& location = m.buffer->locations()[m.index];
+            return std::make_tuple(
+                std::string_view{location.path},
+                location.line,
+                location.column,
+                m.buffer->message_markup(m.index)
+            );
+        };
+
+        std::sort(messages.begin(), messages.end(), [&key] (const auto& a, const auto& b) {
+            return key(a) < key(b);
+        });
+
+        Message_buffer ret;
+        for (const auto& m : messages) {
+            ret.append_message(*m.buffer, m.index);
+        }
+
+        return ret;
+    }
+
+    std::size_t Message_collector::buffer_count() const {
+        std::lock_guard lock{mutex};
+        return buffers.size();
+    }
+
+}
@@ -0,0 +1,89 @@
+#ifndef HARC_TESTS_CACHING_HPP
+#define HARC_TESTS_CACHING_HPP
+
+#include <harc/Caching.hpp>
+
+#include <cstring>
+#include <string>
+
+namespace harc::tests {
+
+    std::span<const std::byte> as_bytes(std::string_view str) {
+        return std::as_bytes(std::span<const char>{str.data(), str.size()});
+    }
+
+    std::string_view as_string(std::span<const std::byte> bytes) {
+        return std::string_view{reinterpret_cast<const char*>(bytes.data()), bytes.size()};
+    }
+
+    TEST(Caching_tests, Empty_serialization) {
+        auto bytes = assemble_serialization({});
+        auto infos = parse_serialization(bytes);
+        EXPECT_TRUE(infos.empty());
+    }
+
+    TEST(Caching_tests, Round_trip) {
+        std::array<Cache_entry_info, 2> entries{};
+
+        entries[0].path = "src/a.hm";
+        entries[0].timestamp = 1234;
+        entries[0].hash = {5, 6};
+        entries[0].tokenization_serialization = as_bytes("tokens");
+        entries[0].parsing_serialization = as_bytes("parse tree");
+
+        entries[1].path = "src/directory/b.hm";
+        entries[1].timestamp = 5678;
+        entries[1].hash = {7, 8};
+        entries[1].machine_code_serialization = as_bytes("\x90\x90\xc3");
+
+        auto bytes = assemble_serialization(entries);
+        auto infos = parse_serialization(bytes);
+        ASSERT_EQ(2, infos.size());
+
+        for (std::size_t i = 0; i < infos.size(); ++i) {
+            EXPECT_EQ(entries[i].path, infos[i].path);
+            EXPECT_EQ(entries[i].timestamp, infos[i].timestamp);
+            EXPECT_EQ(entries[i].hash, infos[i].hash);
+
+            EXPECT_EQ(as_string(entries[i].tokenization_serialization), as_string(infos[i].tokenization_serialization));
+            EXPECT_EQ(as_string(entries[i].parsing_serialization), as_string(infos[i].parsing_serialization));
+            EXPECT_EQ(as_string(entries[i].ir_serialization), as_string(infos[i].ir_serialization));
+            EXPECT_EQ(as_string(entries[i].machine_code_serialization), as_string(infos[i].machine_code_serialization));
+
+            // Views point into the serialization itself
+            if (!infos[i].path.empty()) {
+                EXPECT_GE(reinterpret_cast<const std::byte*>(infos[i].path.data()), bytes.data());
+                EXPECT_LT(reinterpret_cast<const std::byte*>(infos[i].path.data()), bytes.data() + bytes.size());
+            }
+
+            if (!infos[i].tokenization_serialization.empty()) {
+                auto offset = infos[i].tokenization_serialization.data() - bytes.data();
+                EXPECT_EQ(0, offset % 8);
+            }
+        }
+    }
+
+    TEST(Caching_tests, Truncated_serialization) {
+        std::array<Cache_entry_info, 1> entries{};
+        entries[0].path = "a.hm";
+        entries[0].tokenization_serialization = as_bytes("0123456789");
+
+        auto bytes = assemble_serialization(entries);
+        for (std::size_t n = 0; n < bytes.size(); ++n) {
+            std::span<const std::byte> truncated{bytes.data(), n};
+            EXPECT_TRUE(parse_serialization(truncated).empty());
+        }
+    }
+
+    TEST(Caching_tests, Bad_magic_bytes) {
+        std::array<Cache_entry_info, 1> entries{};
+        entries[0].path = "a.hm";
+
+        auto bytes = assemble_serialization(entries);
+        bytes[0] = std::byte('h');
+        EXPECT_TRUE(parse_serialization(bytes).empty());
+    }
+
+}
+
+#endif //HARC_TESTS_CACHING_HPP
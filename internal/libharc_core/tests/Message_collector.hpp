@@ -0,0 +1,89 @@
+#ifndef HARC_TESTS_MESSAGE_COLLECTOR_HPP
+#define HARC_TESTS_MESSAGE_COLLECTOR_HPP
+
+#include <harc/Message_collector.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace harc::tests {
+
+    TEST(Message_collector_tests, Merge_orders_by_location) {
+        harc::Message_collector collector;
+
+        auto& a = collector.register_buffer();
+        auto& b = collector.register_buffer();
+
+        a.error("Third", "b.hmn", 1, 1);
+        a.error("Second", "a.hmn", 2, 7);
+        b.error("First", "a.hmn", 2, 3);
+        b.warning("Fourth", "b.hmn", 10, 1);
+
+        auto merged = collector.merge();
+        auto locations = merged.locations();
+        ASSERT_EQ(locations.size(), 4);
+
+        EXPECT_EQ(locations[0].path, "a.hmn");
+        EXPECT_EQ(locations[0].column, 3);
+        EXPECT_EQ(locations[1].column, 7);
+        EXPECT_EQ(locations[2].path, "b.hmn");
+        EXPECT_EQ(locations[3].line, 10);
+
+        auto text = harc::to_string(merged);
+        auto first = text.find("First");
+        auto second = text.find("Second");
+        auto third = text.find("Third");
+        auto fourth = text.find("Fourth");
+
+        EXPECT_LT(first, second);
+        EXPECT_LT(second, third);
+        EXPECT_LT(third, fourth);
+        EXPECT_NE(fourth, std::string::npos);
+    }
+
+    TEST(Message_collector_tests, Clear_drops_registrations) {
+        harc::Message_collector collector;
+
+        for (int build = 0; build < 3; ++build) {
+            collector.clear();
+            for (int t = 0; t < 4; ++t) {
+                collector.register_buffer().error("Message", "a.hmn", 1, 1);
+            }
+
+            EXPECT_EQ(collector.buffer_count(), 4);
+            EXPECT_EQ(collector.merge().locations().size(), 4);
+        }
+
+        collector.clear();
+        EXPECT_EQ(collector.buffer_count(), 0);
+        EXPECT_TRUE(collector.merge().locations().empty());
+    }
+
+    TEST(Message_collector_tests, Merge_is_independent_of_threads) {
+        auto report = [] (std::size_t thread_count) {
+            harc::Message_collector collector;
+
+            std::vector<std::jthread> threads;
+            for (std::size_t t = 0; t < thread_count; ++t) {
+                threads.emplace_back([&collector, t, thread_count] () {
+                    auto& buffer = collector.register_buffer();
+                    for (std::uint32_t i = t; i < 100; i += thread_count) {
+                        auto path = "unit" + std::to_string(i % 7) + ".hmn";
+                        buffer.error("Message " + std::to_string(i), path, i % 5, i % 3);
+                    }
+                });
+            }
+            threads.clear();
+
+            return harc::to_string(collector.merge());
+        };
+
+        auto expected = report(1);
+        EXPECT_EQ(report(2), expected);
+        EXPECT_EQ(report(8), expected);
+    }
+
+}
+
+#endif //HARC_TESTS_MESSAGE_COLLECTOR_HPP
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include "Message_buffer.hpp"
+#include "Message_collector.hpp"
+#include "Caching.hpp"
 
 //=========================================================
 // GTest configurable printer
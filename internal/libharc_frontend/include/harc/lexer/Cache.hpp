@@ -5,6 +5,7 @@
 #include <vector>
 #include <array>
 #include <cstdint>
+#include <optional>
 #include <span>
 #include <string>
 
@@ -12,11 +13,19 @@
 
 namespace harc::lex {
 
+    ///
+    /// Tokenization of a single file stored within a lexer cache.
+    ///
     struct Cache_entry {
-        std::string path;
-        std::uint64_t time_stamp;
+        std::string_view path;
+        std::uint64_t time_stamp = 0;
 
-        Tokenization tokenization;
+        ///
+        /// Tokenization serialized by serialize_tokenization(). Use
+        /// parse_binary_tokenization() together with the file's source to
+        /// obtain a view over it.
+        ///
+        std::span<const std::byte> tokenization;
     };
 
     struct Cache {
@@ -25,12 +34,59 @@ namespace harc::lex {
 
     };
 
+    //=====================================================
+    // Tokenization serialization
+    //=====================================================
+
     ///
-    /// \param bytes
-    /// \return
+    /// Serializes the arrays of a tokenization into a layout which
+    /// parse_binary_tokenization() can use in place.
+    ///
+    /// The layout is a 32-byte header followed by the source_indices,
+    /// lengths, pair_indices, line_indices, types, and keywords arrays, in
+    /// that order and each padded to a multiple of 8 bytes. Integers are
+    /// stored in the byte order of the host.
+    ///
+    /// \param tokenization Tokenization to serialize
+    /// \return Serialized bytes
+    [[nodiscard]]
+    std::vector<std::byte> serialize_tokenization(const Tokenization_view& tokenization);
+
+    ///
+    /// Creates a view over a serialized tokenization without copying or
+    /// converting any of its arrays. All indices are validated against the
+    /// source so that a stale or corrupt serialization cannot lead to
+    /// out-of-bounds accesses.
+    ///
+    /// \param bytes Bytes produced by serialize_tokenization(). Must be
+    /// 4-byte aligned and remain valid while the view is used.
+    /// \param source Source from which the tokenization was produced
+    /// \return View over the tokenization. Empty if the bytes are not a
+    /// valid serialization of the current version for the source.
+    [[nodiscard]]
+    std::optional<Tokenization_view> parse_binary_tokenization(
+        std::span<const std::byte> bytes,
+        std::string_view source
+    );
+
+    //=====================================================
+    // Cache serialization
+    //=====================================================
+
+    ///
+    /// \param bytes Bytes produced by serialize_cache(). Must be 8-byte
+    /// aligned and remain valid while the cache is used.
+    /// \return Cache whose entries point into bytes. Empty if the bytes are
+    /// not a valid serialization.
     [[nodiscard]]
     Cache parse_binary_cache(std::span<const std::byte> bytes);
 
+    ///
+    /// \param cache Cache to serialize
+    /// \return Serialized bytes
+    [[nodiscard]]
+    std::vector<std::byte> serialize_cache(const Cache& cache);
+
     ///
     /// \param cache
     /// \return
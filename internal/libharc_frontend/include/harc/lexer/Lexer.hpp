@@ -12,7 +12,11 @@
 #include <string_view>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 #include <span>
+#include <memory>
+#include <algorithm>
+#include <functional>
 
 #include <aul/Math.hpp>
 
@@ -35,13 +39,140 @@ namespace harc::lex {
         std::uint32_t column = 0;
     };
 
+    ///
+    /// Array of per-token data which lives within a block of memory owned by
+    /// a Tokenization. The owning tokenization is responsible for ensuring
+    /// that there is capacity for any elements which are added.
+    ///
+    template<class T>
+    class Token_column {
+    public:
+
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        //=================================================
+        // Element access
+        //=================================================
+
+        T& operator[](std::size_t i) {
+            return ptr[i];
+        }
+
+        const T& operator[](std::size_t i) const {
+            return ptr[i];
+        }
+
+        [[nodiscard]]
+        T* data() {
+            return ptr;
+        }
+
+        [[nodiscard]]
+        const T* data() const {
+            return ptr;
+        }
+
+        //=================================================
+        // Iterators
+        //=================================================
+
+        T* begin() {
+            return ptr;
+        }
+
+        const T* begin() const {
+            return ptr;
+        }
+
+        T* end() {
+            return ptr + count;
+        }
+
+        const T* end() const {
+            return ptr + count;
+        }
+
+        //=================================================
+        // Mutators
+        //=================================================
+
+        void push_back(T value) {
+            ptr[count++] = value;
+        }
+
+        void append(std::span<const T> values) {
+            std::copy(values.begin(), values.end(), ptr + count);
+            count += values.size();
+        }
+
+        ///
+        /// \param n New size. Added elements are value-initialized.
+        void resize(std::size_t n) {
+            if (n > count) {
+                std::fill(ptr + count, ptr + n, T{});
+            }
+            count = n;
+        }
+
+        void clear() {
+            count = 0;
+        }
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        [[nodiscard]]
+        std::size_t size() const {
+            return count;
+        }
+
+        [[nodiscard]]
+        bool empty() const {
+            return count == 0;
+        }
+
+        //=================================================
+        // Comparison operators
+        //=================================================
+
+        friend bool operator==(const Token_column& lhs, const Token_column& rhs) {
+            return std::ranges::equal(lhs, rhs);
+        }
+
+    private:
+
+        friend struct Tokenization;
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        T* ptr = nullptr;
+
+        std::size_t count = 0;
+
+    };
+
     ///
     /// Struct representing the tokenize of a Harmonia source file.
     ///
-    /// TODO: Utilize a different data structure
+    /// The per-token arrays are laid out one after another within a single
+    /// allocation, which the lexer sizes up front using an upper bound on the
+    /// number of tokens.
     ///
     struct Tokenization {
 
+        Tokenization() = default;
+        Tokenization(const Tokenization&) = delete;
+        Tokenization(Tokenization&&) noexcept;
+        ~Tokenization() = default;
+
+        Tokenization& operator=(const Tokenization&) = delete;
+        Tokenization& operator=(Tokenization&&) noexcept;
+
         ///
         /// View over UTF-8 encoded Harmonia source code.
         ///
@@ -52,20 +183,21 @@ namespace harc::lex {
         ///
         /// List of token types encountered during lexing
         ///
-        std::vector<Token_type> types{};
+        Token_column<Token_type> types{};
 
         ///
         /// Byte indices of each token
         ///
-        std::vector<std::uint32_t> source_indices{};
+        Token_column<std::uint32_t> source_indices{};
 
         ///
         /// Length, in bytes, of each token
         ///
-        std::vector<std::uint32_t> lengths{};
+        Token_column<std::uint32_t> lengths{};
 
         ///
-        /// Byte index at which each line begins
+        /// Byte index at which each line begins. Typically produced by the
+        /// prepass, so held separately from the per-token arrays.
         ///
         std::vector<std::uint32_t> line_indices;
 
@@ -73,7 +205,12 @@ namespace harc::lex {
         /// Index of token which pairs up with the current token. For tokens
         /// which are not paired, this will be the token's own index.
         ///
-        std::vector<std::uint32_t> pair_indices;
+        Token_column<std::uint32_t> pair_indices{};
+
+        ///
+        /// Keyword spelled by each TEXT token. NONE for all other tokens.
+        ///
+        Token_column<Keyword> keywords{};
 
         ///
         /// Contains messages produced by tokenization process.
@@ -87,6 +224,85 @@ namespace harc::lex {
         ///
         bool success = false;
 
+        //=================================================
+        // Mutators
+        //=================================================
+
+        ///
+        /// Ensures that the per-token arrays have room for the specified
+        /// number of tokens. Since the arrays share one allocation, growing
+        /// relocates all of them.
+        ///
+        /// \param token_count Number of tokens to make room for
+        void reserve(std::size_t token_count);
+
+        //=================================================
+        // Accessors
+        //=================================================
+
+        ///
+        /// \return Number of tokens which fit without reallocating
+        [[nodiscard]]
+        std::size_t capacity() const {
+            return token_capacity;
+        }
+
+    private:
+
+        //=================================================
+        // Instance members
+        //=================================================
+
+        ///
+        /// Block holding the source_indices, lengths, pair_indices, types,
+        /// and keywords arrays, in that order
+        ///
+        std::unique_ptr<std::byte[]> storage;
+
+        std::size_t token_capacity = 0;
+
+    };
+
+    ///
+    /// Non-owning view over the arrays of a tokenization. The arrays may
+    /// belong to a Tokenization object or may point directly into a
+    /// serialized tokenization, such as one within a memory-mapped build
+    /// cache.
+    ///
+    struct Tokenization_view {
+
+        Tokenization_view() = default;
+
+        explicit Tokenization_view(const Tokenization& tokenization):
+            source(tokenization.source),
+            types(tokenization.types),
+            source_indices(tokenization.source_indices),
+            lengths(tokenization.lengths),
+            line_indices(tokenization.line_indices),
+            pair_indices(tokenization.pair_indices),
+            keywords(tokenization.keywords) {}
+
+        std::string_view source{};
+
+        std::span<const Token_type> types{};
+
+        std::span<const std::uint32_t> source_indices{};
+
+        std::span<const std::uint32_t> lengths{};
+
+        std::span<const std::uint32_t> line_indices{};
+
+        std::span<const std::uint32_t> pair_indices{};
+
+        std::span<const Keyword> keywords{};
+
+        ///
+        /// \return Number of tokens
+        [[nodiscard]]
+        std::uint32_t size() const {
+            return static_cast<std::uint32_t>(types.size());
+        }
+
     };
 
     ///
@@ -103,6 +319,191 @@ namespace harc::lex {
         const Config& config = {}
     );
 
+    ///
+    /// Equivalent to lex() but specialized for sources which consist solely
+    /// of ASCII characters, e.g. as determined by the prepass. No multi-byte
+    /// decoding is performed, and any byte with its MSB set is reported as
+    /// an error.
+    ///
+    /// \param source_id A string that identifies the source file
+    /// \param source View over ASCII encoded Harmonia source code
+    /// \param config Reference to Lexer configuration
+    /// \return Tokenization object containing tokenization results
+    [[nodiscard]]
+    Tokenization lex_ascii(
+        std::string_view source_id,
+        std::string_view source,
+        const Config& config = {}
+    );
+
+    ///
+    /// Equivalent to lex() but uses line starts which were computed ahead of
+    /// time, e.g. by the prepass, rather than recording them while lexing.
+    ///
+    /// \param source_id A string that identifies the source file
+    /// \param source View over UTF-8 encoded Harmonia source code
+    /// \param line_indices Byte index at which each line of source begins.
+    /// Must begin with 0. Moved into the returned tokenization. If empty, line
+    /// starts are recorded while lexing.
+    /// \param config Reference to Lexer configuration
+    /// \return Tokenization object containing tokenization results
+    [[nodiscard]]
+    Tokenization lex(
+        std::string_view source_id,
+        std::string_view source,
+        std::vector<std::uint32_t> line_indices,
+        const Config& config = {}
+    );
+
+    ///
+    /// Equivalent to lex_ascii() but uses line starts which were computed
+    /// ahead of time, e.g. by the prepass, rather than recording them while
+    /// lexing.
+    ///
+    /// \param source_id A string that identifies the source file
+    /// \param source View over ASCII encoded Harmonia source code
+    /// \param line_indices Byte index at which each line of source begins.
+    /// Must begin with 0. Moved into the returned tokenization. If empty, line
+    /// starts are recorded while lexing.
+    /// \param config Reference to Lexer configuration
+    /// \return Tokenization object containing tokenization results
+    [[nodiscard]]
+    Tokenization lex_ascii(
+        std::string_view source_id,
+        std::string_view source,
+        std::vector<std::uint32_t> line_indices,
+        const Config& config = {}
+    );
+
+    //=====================================================
+    // Chunked lexing
+    //=====================================================
+
+    ///
+    /// Range of bytes within a source which is lexed independently of the
+    /// rest of the source
+    ///
+    struct Source_chunk {
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+    };
+
+    ///
+    /// Invokes a function once for each index in [0, count), possibly
+    /// concurrently, and returns once every invocation has finished. Lets
+    /// the caller decide which threads take part, e.g. idle scheduler
+    /// workers.
+    ///
+    using Parallel_for = std::function<void(std::size_t count, const std::function<void(std::size_t)>& f)>;
+
+    ///
+    /// Tokens produced by lexing a single chunk of a source. Bracket pairing
+    /// is deferred until the chunks are stitched together, so every token's
+    /// pair index refers to itself.
+    ///
+    struct Chunk_tokenization {
+
+        Source_chunk chunk{};
+
+        ///
+        /// Tokens within the chunk. Source indices are relative to the start
+        /// of the whole source, not the chunk. Line indices are left empty.
+        ///
+        Tokenization tokenization{};
+
+        std::uint32_t error_count = 0;
+
+        ///
+        /// Indicates that the chunk ended inside a comment, in which case the
+        /// next chunk was lexed under the wrong assumption and must be lexed
+        /// again together with this one
+        ///
+        bool ends_in_comment = false;
+
+        ///
+        /// Indices of the chunk's >> tokens, in order, whose lexing depends
+        /// on brackets opened before the chunk. Each is left as a shift token
+        /// until stitch_chunks() decides whether it closes two template
+        /// brackets.
+        ///
+        std::vector<std::uint32_t> deferred_shifts{};
+
+    };
+
+    ///
+    /// Splits a source into chunks of roughly the specified size which may
+    /// be lexed concurrently.
+    ///
+    /// Chunks only begin at the start of a line and never after a line which
+    /// ends in a backslash, so no chunk begins within a string or codepoint
+    /// literal. Chunks may begin within a block comment, which is detected
+    /// and corrected by stitch_chunks().
+    ///
+    /// \param source View over UTF-8 encoded Harmonia source code
+    /// \param line_indices Byte index at which each line of source begins
+    /// \param chunk_size Target number of bytes per chunk
+    /// \return Contiguous chunks covering the whole source
+    [[nodiscard]]
+    std::vector<Source_chunk> split_into_chunks(
+        std::string_view source,
+        std::span<const std::uint32_t> line_indices,
+        std::uint32_t chunk_size
+    );
+
+    ///
+    /// Lexes a single chunk of a source, as produced by split_into_chunks().
+    /// Safe to call concurrently for different chunks of the same source.
+    ///
+    /// \param source_id A string that identifies the source file
+    /// \param source View over the whole of the UTF-8 encoded source
+    /// \param chunk Chunk of source to lex
+    /// \param line_indices Byte index at which each line of the whole source
+    /// begins. Used to locate errors.
+    /// \param is_ascii True if the source consists solely of ASCII characters
+    /// \param config Reference to Lexer configuration
+    /// \return Tokens within chunk
+    [[nodiscard]]
+    Chunk_tokenization lex_chunk(
+        std::string_view source_id,
+        std::string_view source,
+        Source_chunk chunk,
+        std::span<const std::uint32_t> line_indices,
+        bool is_ascii,
+        const Config& config = {}
+    );
+
+    ///
+    /// Combines the tokens of a source's chunks into a single tokenization
+    /// which is identical to the one lex() would produce for the whole
+    /// source, except that messages may be reported in a different order.
+    ///
+    /// Chunks which ended inside a comment are lexed again together with the
+    /// chunk that follows. Deferred shift tokens are split into template
+    /// brackets where necessary in a single pass over the chunks' tokens,
+    /// after which brackets are paired across the whole source by
+    /// pair_brackets().
+    ///
+    /// \param source_id A string that identifies the source file
+    /// \param source View over the whole of the UTF-8 encoded source
+    /// \param chunks Results of lex_chunk() for every chunk, in order
+    /// \param line_indices Byte index at which each line of source begins.
+    /// Moved into the returned tokenization.
+    /// \param is_ascii True if the source consists solely of ASCII characters
+    /// \param config Reference to Lexer configuration
+    /// \param parallel_for Function to pair brackets with, as accepted by
+    /// pair_brackets()
+    /// \return Tokenization object containing tokenization results
+    [[nodiscard]]
+    Tokenization stitch_chunks(
+        std::string_view source_id,
+        std::string_view source,
+        std::vector<Chunk_tokenization> chunks,
+        std::vector<std::uint32_t> line_indices,
+        bool is_ascii,
+        const Config& config = {},
+        const Parallel_for& parallel_for = {}
+    );
+
     ///
     ///
     ///
@@ -0,0 +1,49 @@
+#ifndef HARC_LEXER_PAIRING_HPP
+#define HARC_LEXER_PAIRING_HPP
+
+#include <harc/lexer/Lexer.hpp>
+#include <harc/lexer/Tokens.hpp>
+
+#include <cstdint>
+#include <string_view>
+
+namespace harc::lex {
+
+    ///
+    /// \param type Left or right token type
+    /// \return Message with which an unpaired token of the specified type is
+    /// reported
+    [[nodiscard]]
+    std::string_view unpaired_token_message(Token_type type);
+
+    ///
+    /// Pairs up the left and right tokens of a tokenization, overwriting its
+    /// pair_indices. Tokens which are not paired refer to themselves.
+    ///
+    /// The nesting depth before each token is computed as a prefix sum over
+    /// the token types, after which each left token is paired with the next
+    /// right token at the same depth. Work is split across blocks of tokens
+    /// which are handed to parallel_for.
+    ///
+    /// Without parallel_for, or if the tokens are not balanced, tokens are
+    /// paired using a stack on the calling thread. Unpaired tokens are then
+    /// reported exactly as lexing would have reported them, including the
+    /// resetting of the stack by func and struct keywords.
+    ///
+    /// \param tokenization Tokenization whose token types are final. Errors
+    /// are appended to its message buffer.
+    /// \param source_id A string that identifies the source file
+    /// \param config Reference to Lexer configuration
+    /// \param parallel_for Function which runs the work of each block. Only
+    /// worthwhile if several threads take part.
+    /// \return Number of unpaired tokens
+    std::uint32_t pair_brackets(
+        Tokenization& tokenization,
+        std::string_view source_id,
+        const Config& config = {},
+        const Parallel_for& parallel_for = {}
+    );
+
+}
+
+#endif //HARC_LEXER_PAIRING_HPP
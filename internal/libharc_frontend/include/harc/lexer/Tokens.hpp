@@ -110,6 +110,30 @@ namespace harc {
         DOC_TEXT             = 255
     };
 
+    ///
+    /// Keywords which TEXT tokens may spell. Recorded for each token by the
+    /// lexer so that later stages need not compare token text.
+    ///
+    enum class Keyword : std::uint8_t {
+        NONE = 0,
+        ALIAS,
+        AS,
+        DO,
+        ELSE,
+        FOR,
+        FUNC,
+        IF,
+        IN,
+        IS,
+        LAMBDA,
+        LET,
+        MODULE,
+        RETURN,
+        STRUCT,
+        VAR,
+        WHILE
+    };
+
     ///
     /// \param type Arbitrary Token_type object
     /// \return True if the token type is one of NUMERIC_LITERAL,
@@ -145,6 +169,13 @@ namespace harc {
     [[nodiscard]]
     bool is_right_token(Token_type type);
 
+    ///
+    /// \param type Arbitrary Token_type object
+    /// \return The token type which pairs up with the specified type.
+    /// NULL_TOKEN if the type is not a left or right token.
+    [[nodiscard]]
+    Token_type matching_token_type(Token_type type);
+
     ///
     /// The number of unique code points which constitute a codepoint, not
     /// including whitespace.
@@ -162,6 +193,19 @@ namespace harc {
     [[nodiscard]]
     std::string_view to_string(Token_type token_type);
 
+    ///
+    /// \param text Text of a TEXT token
+    /// \return Keyword which text spells. NONE if text is not a keyword.
+    [[nodiscard]]
+    Keyword identify_keyword(std::string_view text);
+
+    ///
+    /// \param keyword Keyword enum value
+    /// \return View over spelling of keyword. Empty for NONE. View remains
+    /// valid throughout life of program.
+    [[nodiscard]]
+    std::string_view to_string(Keyword keyword);
+
 }
 
 #endif //HARC_TOKENS_HPP
@@ -0,0 +1,93 @@
+#ifndef HARC_LEXER_UTILS_HPP
+#define HARC_LEXER_UTILS_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace harc::lex {
+
+    ///
+    /// Number of bytes classified at once by classify_block
+    ///
+    constexpr std::size_t block_width = 64;
+
+    ///
+    /// Set of bitmasks describing the bytes within a block of UTF-8 encoded
+    /// source code. Bit i of each mask corresponds to the i'th byte of the
+    /// block.
+    ///
+    struct Block_classification {
+
+        ///
+        /// ASCII whitespace, i.e. space, horizontal tab, line feed, vertical
+        /// tab, form feed, and carriage return
+        ///
+        std::uint64_t whitespace = 0;
+
+        ///
+        /// Line feed bytes
+        ///
+        std::uint64_t newlines = 0;
+
+        ///
+        /// ASCII letters, digits, and underscores
+        ///
+        std::uint64_t identifier = 0;
+
+        ///
+        /// Printable ASCII bytes which are not identifier bytes, i.e. the
+        /// bytes which may begin an operator, bracket, or literal
+        ///
+        std::uint64_t punctuation = 0;
+
+        ///
+        /// Bytes which end or escape a run of string or codepoint literal
+        /// contents, i.e. double quotes, single quotes, backslashes, and
+        /// line feeds
+        ///
+        std::uint64_t literal_delimiters = 0;
+
+        ///
+        /// Bytes which are part of a multi-byte UTF-8 sequence
+        ///
+        std::uint64_t non_ascii = 0;
+
+    };
+
+    ///
+    /// Classifies block_width bytes starting at the specified address.
+    ///
+    /// Uses AVX2 or SSE4.2 when the library is compiled with support for
+    /// those instruction sets and a scalar lookup table otherwise.
+    ///
+    /// \param ptr Pointer to at least block_width readable bytes
+    /// \return Classification of bytes
+    [[nodiscard]]
+    Block_classification classify_block(const char* ptr);
+
+    ///
+    /// Classifies up to block_width bytes starting at the specified address.
+    /// Bits corresponding to bytes past the end of the range are cleared in
+    /// all masks.
+    ///
+    /// \param ptr Pointer to bytes to classify
+    /// \param n Number of readable bytes. Values greater than block_width
+    /// are treated as block_width.
+    /// \return Classification of bytes
+    [[nodiscard]]
+    Block_classification classify_partial_block(const char* ptr, std::size_t n);
+
+    ///
+    /// Decodes a single UTF-8 encoded codepoint.
+    ///
+    /// \param ptr Pointer to first byte of codepoint
+    /// \param n Number of readable bytes
+    /// \param codepoint Object to write decoded codepoint to
+    /// \return Length of encoded codepoint in bytes. Returns 0 if the bytes
+    /// do not form a valid, shortest-form UTF-8 sequence.
+    [[nodiscard]]
+    std::uint32_t decode_utf8(const char* ptr, std::size_t n, std::uint32_t& codepoint);
+
+}
+
+#endif //HARC_LEXER_UTILS_HPP
@@ -1,28 +1,327 @@
 #include <harc/lexer/Cache.hpp>
 
+#include <harc/Version.hpp>
+
+#include <algorithm>
+#include <cstring>
+
 namespace harc::lex {
 
+    const Version tokenization_serialization_version{0, 0, 3, Release_type::ALPHA};
+
+    const Version cache_serialization_version{0, 0, 1, Release_type::ALPHA};
+
+    constexpr std::size_t tokenization_header_size = 32;
+
+    constexpr std::size_t cache_header_size = 24;
+
+    constexpr std::size_t cache_entry_overhead = 20;
+
+    constexpr std::array<std::byte, 8> tokenization_magic_bytes {
+        std::byte('H'), std::byte('a'), std::byte('r'), std::byte('T'),
+        std::byte('o'), std::byte('k'), std::byte('e'), std::byte('n')
+    };
+
+    constexpr std::array<std::byte, 8> cache_magic_bytes {
+        std::byte('H'), std::byte('a'), std::byte('r'), std::byte('L'),
+        std::byte('e'), std::byte('x'), std::byte('e'), std::byte('r')
+    };
+
+    ///
+    /// \param n Arbitrary byte count
+    /// \return n rounded up to a multiple of 8
+    constexpr std::uint64_t pad8(std::uint64_t n) {
+        return (n + 7) & ~std::uint64_t{7};
+    }
+
+    ///
+    /// \param token_count Number of tokens
+    /// \param line_count Number of lines
+    /// \return Number of bytes in serialization of a tokenization with the
+    /// specified number of tokens and lines
+    constexpr std::uint64_t tokenization_serialization_size(std::uint64_t token_count, std::uint64_t line_count) {
+        return
+            tokenization_header_size +
+            3 * pad8(token_count * sizeof(std::uint32_t)) +
+            pad8(line_count * sizeof(std::uint32_t)) +
+            pad8(token_count * sizeof(Token_type)) +
+            pad8(token_count * sizeof(Keyword));
+    }
+
+    //=====================================================
+    // Tokenization serialization
+    //=====================================================
+
+    std::vector<std::byte> serialize_tokenization(const Tokenization_view& tokenization) {
+        const std::uint32_t token_count = tokenization.size();
+        const std::uint32_t line_count = tokenization.line_indices.size();
+        const std::uint32_t source_length = tokenization.source.size();
+
+        // Zero-initialized so that padding bytes need not be written
+        std::vector<std::byte> ret;
+        ret.resize(tokenization_serialization_size(token_count, line_count));
+
+        std::byte* output_ptr = ret.data();
+
+        auto write_u32 = [&output_ptr] (std::uint32_t x) {
+            std::memcpy(output_ptr, &x, sizeof(std::uint32_t));
+            output_ptr += sizeof(std::uint32_t);
+        };
+
+        auto write_array = [&output_ptr] (auto span) {
+            if (!span.empty()) {
+                std::memcpy(output_ptr, span.data(), span.size_bytes());
+            }
+            output_ptr += pad8(span.size_bytes());
+        };
+
+        // Write header
+        std::memcpy(output_ptr, tokenization_magic_bytes.data(), tokenization_magic_bytes.size());
+        output_ptr += tokenization_magic_bytes.size();
+
+        write_u32(to_int(tokenization_serialization_version));
+        write_u32(token_count);
+        write_u32(line_count);
+        write_u32(source_length);
+
+        // Reserved
+        output_ptr += 8;
+
+        // Write arrays, widest elements first so that each begins aligned
+        write_array(tokenization.source_indices);
+        write_array(tokenization.lengths);
+        write_array(tokenization.pair_indices);
+        write_array(tokenization.line_indices);
+        write_array(tokenization.types);
+        write_array(tokenization.keywords);
+
+        return ret;
+    }
+
+    std::optional<Tokenization_view> parse_binary_tokenization(
+        std::span<const std::byte> bytes,
+        std::string_view source
+    ) {
+        if (bytes.size() < tokenization_header_size) {
+            return {};
+        }
+
+        // Arrays are used in place so they must be suitably aligned
+        if (reinterpret_cast<std::uintptr_t>(bytes.data()) % alignof(std::uint32_t) != 0) {
+            return {};
+        }
+
+        bool contains_magic_bytes = std::equal(
+            tokenization_magic_bytes.begin(),
+            tokenization_magic_bytes.end(),
+            bytes.begin()
+        );
+
+        if (!contains_magic_bytes) {
+            return {};
+        }
+
+        std::uint64_t offset = tokenization_magic_bytes.size();
+
+        auto read_u32 = [&bytes, &offset] () {
+            std::uint32_t x = 0;
+            std::memcpy(&x, bytes.data() + offset, sizeof(std::uint32_t));
+            offset += sizeof(std::uint32_t);
+            return x;
+        };
+
+        const std::uint32_t version = read_u32();
+        const std::uint32_t token_count = read_u32();
+        const std::uint32_t line_count = read_u32();
+        const std::uint32_t source_length = read_u32();
+
+        if (version != to_int(tokenization_serialization_version)) {
+            return {};
+        }
+
+        if (source_length != source.size()) {
+            return {};
+        }
+
+        if (bytes.size() < tokenization_serialization_size(token_count, line_count)) {
+            return {};
+        }
+
+        offset = tokenization_header_size;
+
+        auto u32_array = [&bytes, &offset] (std::uint32_t count) {
+            std::span<const std::uint32_t> ret{
+                reinterpret_cast<const std::uint32_t*>(bytes.data() + offset),
+                count
+            };
+            offset += pad8(count * sizeof(std::uint32_t));
+            return ret;
+        };
 
+        Tokenization_view ret{};
+        ret.source = source;
+        ret.source_indices = u32_array(token_count);
+        ret.lengths = u32_array(token_count);
+        ret.pair_indices = u32_array(token_count);
+        ret.line_indices = u32_array(line_count);
+        ret.types = std::span<const Token_type>{
+            reinterpret_cast<const Token_type*>(bytes.data() + offset),
+            token_count
+        };
+        offset += pad8(token_count * sizeof(Token_type));
+
+        ret.keywords = std::span<const Keyword>{
+            reinterpret_cast<const Keyword*>(bytes.data() + offset),
+            token_count
+        };
+
+        // Validate indices so that consumers need not trust the cache.
+        // Non-textual token types occupy every value up to PREFIX_TILDE.
+        for (std::uint32_t i = 0; i < token_count; ++i) {
+            bool is_valid_type =
+                (ret.types[i] != Token_type::NULL_TOKEN) &&
+                (ret.types[i] <= Token_type::PREFIX_TILDE || is_textual(ret.types[i]));
+
+            bool is_valid =
+                is_valid_type &&
+                ret.source_indices[i] <= source_length &&
+                ret.lengths[i] <= source_length - ret.source_indices[i] &&
+                ret.pair_indices[i] < token_count &&
+                ret.keywords[i] <= Keyword::WHILE;
+
+            if (!is_valid) {
+                return {};
+            }
+        }
+
+        for (auto line_index : ret.line_indices) {
+            if (line_index > source_length) {
+                return {};
+            }
+        }
+
+        return ret;
+    }
+
+    //=====================================================
+    // Cache serialization
+    //=====================================================
 
     Cache parse_binary_cache(std::span<const std::byte> bytes) {
-        //TODO: implement
-        return Cache{};
+        if (bytes.size() < cache_header_size) {
+            return Cache{};
+        }
+
+        bool contains_magic_bytes = std::equal(
+            cache_magic_bytes.begin(),
+            cache_magic_bytes.end(),
+            bytes.begin()
+        );
+
+        if (!contains_magic_bytes) {
+            return Cache{};
+        }
+
+        std::uint64_t offset = cache_magic_bytes.size();
+
+        std::uint32_t version = 0;
+        std::memcpy(&version, bytes.data() + offset, sizeof(std::uint32_t));
+        offset += 2 * sizeof(std::uint32_t);
+
+        if (version != to_int(cache_serialization_version)) {
+            return Cache{};
+        }
+
+        std::uint64_t entry_count = 0;
+        std::memcpy(&entry_count, bytes.data() + offset, sizeof(std::uint64_t));
+        offset += sizeof(std::uint64_t);
+
+        if (entry_count > (bytes.size() - offset) / pad8(cache_entry_overhead)) {
+            return Cache{};
+        }
+
+        Cache ret{};
+        ret.entries.resize(entry_count);
+
+        for (auto& entry : ret.entries) {
+            if (bytes.size() - offset < cache_entry_overhead) {
+                return Cache{};
+            }
+
+            std::uint64_t tokenization_size = 0;
+            std::uint32_t path_length = 0;
+
+            std::memcpy(&entry.time_stamp, bytes.data() + offset, sizeof(std::uint64_t));
+            std::memcpy(&tokenization_size, bytes.data() + offset + 8, sizeof(std::uint64_t));
+            std::memcpy(&path_length, bytes.data() + offset + 16, sizeof(std::uint32_t));
+
+            std::uint64_t path_offset = offset + cache_entry_overhead;
+            std::uint64_t tokenization_offset = offset + pad8(cache_entry_overhead + path_length);
+
+            if (tokenization_offset > bytes.size() || bytes.size() - tokenization_offset < tokenization_size) {
+                return Cache{};
+            }
+
+            entry.path = std::string_view{
+                reinterpret_cast<const char*>(bytes.data() + path_offset),
+                path_length
+            };
+
+            entry.tokenization = bytes.subspan(tokenization_offset, tokenization_size);
+
+            offset = tokenization_offset + pad8(tokenization_size);
+        }
+
+        return ret;
     }
 
     std::vector<std::byte> serialize_cache(const Cache& cache) {
-        std::size_t ret_size = 0;
-
+        std::size_t ret_size = cache_header_size;
+        for (const auto& entry : cache.entries) {
+            ret_size += pad8(cache_entry_overhead + entry.path.size());
+            ret_size += pad8(entry.tokenization.size());
+        }
 
+        // Zero-initialized so that padding bytes need not be written
         std::vector<std::byte> ret;
         ret.resize(ret_size);
-        //TODO: implement
-        return {};
+
+        std::byte* output_ptr = ret.data();
+
+        std::memcpy(output_ptr, cache_magic_bytes.data(), cache_magic_bytes.size());
+        output_ptr += cache_magic_bytes.size();
+
+        std::uint32_t version = to_int(cache_serialization_version);
+        std::memcpy(output_ptr, &version, sizeof(std::uint32_t));
+        output_ptr += 2 * sizeof(std::uint32_t);
+
+        std::uint64_t entry_count = cache.entries.size();
+        std::memcpy(output_ptr, &entry_count, sizeof(std::uint64_t));
+        output_ptr += sizeof(std::uint64_t);
+
+        for (const auto& entry : cache.entries) {
+            std::uint64_t tokenization_size = entry.tokenization.size();
+            std::uint32_t path_length = entry.path.size();
+
+            std::memcpy(output_ptr, &entry.time_stamp, sizeof(std::uint64_t));
+            std::memcpy(output_ptr + 8, &tokenization_size, sizeof(std::uint64_t));
+            std::memcpy(output_ptr + 16, &path_length, sizeof(std::uint32_t));
+            std::memcpy(output_ptr + cache_entry_overhead, entry.path.data(), entry.path.size());
+            output_ptr += pad8(cache_entry_overhead + entry.path.size());
+
+            if (!entry.tokenization.empty()) {
+                std::memcpy(output_ptr, entry.tokenization.data(), entry.tokenization.size());
+            }
+            output_ptr += pad8(entry.tokenization.size());
+        }
+
+        return ret;
     }
 
     Cache parse_text_cache(std::string_view cahce) {
         Cache ret;
 
-        
+
 
         return ret;
     }
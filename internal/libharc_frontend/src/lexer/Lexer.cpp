@@ -1,12 +1,19 @@
 #include <harc/lexer/Lexer.hpp>
+#include <harc/lexer/Pairing.hpp>
 #include <harc/lexer/Tokens.hpp>
+#include <harc/lexer/Utils.hpp>
+
+#include <harc/unicode/Unicode.hpp>
 
 //#include <harc/Logging.hpp>
 //#include <harc/Error_reporting.hpp>
 
 #include <vector>
-#include <bitset>
+#include <algorithm>
+#include <bit>
+#include <cassert>
 #include <cstdlib>
+#include <span>
 #include <utility>
 
 namespace harc::lex {
@@ -17,7 +24,7 @@ namespace harc::lex {
     constexpr std::uint8_t spaced = 0x03; // Whitespace on both sides
     constexpr std::uint8_t unused = 0x04; // Unused
     constexpr std::uint8_t accord = 0x05; // Whitespace on both sides or neither
-    constexpr std::uint8_t attach = 0x06; // Whitespace on at least one side
+    constexpr std::uint8_t attach = 0x06; // No whitespace on at least one side
     constexpr std::uint8_t ignore = 0x07; // Token is not whitespace sensitive
 
     constexpr std::array<std::uint8_t, 3> encode(char x, char y, char z, std::uint8_t sensitivity) {
@@ -58,7 +65,7 @@ namespace harc::lex {
         encode('+',  '+', 0x0, suffix), // 0x11 SUFFIX_INCREMENT
         encode('+',  '=', 0x0, spaced), // 0x12 SPACED_PLUS_EQUALS
         encode('+',  0x0, 0x0, spaced), // 0x13 SPACED_PLUS
-        encode('+',  0x0, 0x0, spaced), // 0x14 PREFIX_PLUS
+        encode('+',  0x0, 0x0, prefix), // 0x14 PREFIX_PLUS
         encode(',',  0x0, 0x0, ignore), // 0x15 COMMA
         encode('-',  '-', 0x0, prefix), // 0x16 PREFIX_DECREMENT
         encode('-',  '-', 0x0, suffix), // 0x17 SUFFIX_DECREMENT
@@ -109,13 +116,249 @@ namespace harc::lex {
         encode('~',  0x0, 0x0, prefix)  // 0x44 PREFIX_TILDE
     };
 
+    ///
+    /// \param entry Entry from token_table
+    /// \return Whitespace sensitivity encoded in the high bits of the entry
+    constexpr std::uint8_t sensitivity_of(const std::array<std::uint8_t, 3>& entry) {
+        return
+            ((entry[0] >> 7) & 0x1) |
+            ((entry[1] >> 6) & 0x2) |
+            ((entry[2] >> 5) & 0x4);
+    }
+
+    ///
+    /// \param sensitivity Whitespace sensitivity of a token
+    /// \param x Whether whitespace precedes the token
+    /// \param y Whether whitespace follows the token
+    /// \return True if the surrounding whitespace is permitted for the token
+    constexpr bool test_whitespace(std::uint8_t sensitivity, bool x, bool y) {
+        switch (sensitivity) {
+            case joined: return !x && !y;
+            case prefix: return !y;
+            case suffix: return !x;
+            case spaced: return x && y;
+            case accord: return x == y;
+            case attach: return !(x && y);
+            case ignore: return true;
+            default: return false;
+        }
+    }
+
+    ///
+    /// A spelling shared by one or more fixed-length tokens
+    ///
+    struct Token_spelling {
+
+        ///
+        /// Bytes of the spelling packed in little-endian order
+        ///
+        std::uint32_t pattern = 0;
+
+        ///
+        /// Mask selecting the bytes of pattern which belong to the spelling
+        ///
+        std::uint32_t mask = 0;
 
+        std::uint8_t width = 0;
 
+        ///
+        /// True if the surrounding whitespace selects between several tokens
+        ///
+        bool is_whitespace_sensitive = false;
 
+        ///
+        /// Token selected by each combination of surrounding whitespace,
+        /// indexed by (whitespace before << 1) | whitespace after
+        ///
+        std::array<Token_type, 4> types{};
+
+    };
+
+    ///
+    /// Range of spellings which begin with a particular byte
+    ///
+    struct Spelling_range {
+        std::uint8_t begin = 0;
+        std::uint8_t end = 0;
+    };
 
     ///
+    /// Tables used to identify fixed-length tokens. The leading byte of a
+    /// token selects a short range of spellings which are tested in order,
+    /// after which the surrounding whitespace selects among the tokens
+    /// sharing the matched spelling.
+    ///
+    struct Token_dispatch_table {
+        std::array<Spelling_range, 256> leads{};
+        std::array<Token_spelling, token_table.size()> spellings{};
+    };
+
+    constexpr Token_dispatch_table make_token_dispatch_table() {
+        Token_dispatch_table ret{};
+        std::uint8_t spelling_count = 0;
+
+        auto is_same_spelling = [] (const auto& a, const auto& b) {
+            return
+                (a[0] & 0x7f) == (b[0] & 0x7f) &&
+                (a[1] & 0x7f) == (b[1] & 0x7f) &&
+                (a[2] & 0x7f) == (b[2] & 0x7f);
+        };
+
+        for (std::size_t i = 1; i < token_table.size();) {
+            const auto& entry = token_table[i];
+
+            // Entries which share a spelling are adjacent in the table
+            std::size_t j = i + 1;
+            while (j < token_table.size() && is_same_spelling(token_table[j], entry)) {
+                ++j;
+            }
+
+            Token_spelling spelling{};
+            for (std::uint8_t w = 0; w < 3 && (entry[w] & 0x7f) != 0; ++w) {
+                spelling.pattern |= std::uint32_t(entry[w] & 0x7f) << (8 * w);
+                spelling.mask |= std::uint32_t{0xff} << (8 * w);
+                spelling.width = w + 1;
+            }
+
+            // As with the longest match, the first token to accept the
+            // whitespace is chosen, and otherwise the first token overall
+            for (std::uint8_t ws = 0; ws < 4; ++ws) {
+                bool x = ws & 0x2;
+                bool y = ws & 0x1;
+
+                spelling.types[ws] = static_cast<Token_type>(i);
+                for (std::size_t k = i; k < j; ++k) {
+                    if (test_whitespace(sensitivity_of(token_table[k]), x, y)) {
+                        spelling.types[ws] = static_cast<Token_type>(k);
+                        break;
+                    }
+                }
+
+                spelling.is_whitespace_sensitive |= (spelling.types[ws] != spelling.types[0]);
+            }
+
+            auto& range = ret.leads[entry[0] & 0x7f];
+            if (range.begin == range.end) {
+                range.begin = spelling_count;
+            }
+            range.end = spelling_count + 1;
+
+            ret.spellings[spelling_count++] = spelling;
+            i = j;
+        }
+
+        return ret;
+    }
+
+    constexpr Token_dispatch_table token_dispatch_table = make_token_dispatch_table();
+
     ///
+    /// Category of a byte found at the beginning of a token. Used to
+    /// dispatch to the appropriate routine in the core tokenization loop.
     ///
+    enum class Lead_class : std::uint8_t {
+        INVALID,
+        WHITESPACE,
+        IDENTIFIER,
+        DIGIT,
+        DOUBLE_QUOTE,
+        SINGLE_QUOTE,
+        SLASH,
+        PUNCTUATION,
+        NON_ASCII
+    };
+
+    constexpr std::array<Lead_class, 256> make_lead_classes() {
+        std::array<Lead_class, 256> ret{};
+
+        for (std::size_t i = 0; i < ret.size(); ++i) {
+            char c = static_cast<char>(i);
+
+            if (i >= 0x80) {
+                ret[i] = Lead_class::NON_ASCII;
+            } else if (c == ' ' || ('\t' <= c && c <= '\r')) {
+                ret[i] = Lead_class::WHITESPACE;
+            } else if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_') {
+                ret[i] = Lead_class::IDENTIFIER;
+            } else if ('0' <= c && c <= '9') {
+                ret[i] = Lead_class::DIGIT;
+            } else if (c == '"') {
+                ret[i] = Lead_class::DOUBLE_QUOTE;
+            } else if (c == '\'') {
+                ret[i] = Lead_class::SINGLE_QUOTE;
+            } else if (c == '/') {
+                ret[i] = Lead_class::SLASH;
+            } else if (0x21 <= i && i <= 0x7e) {
+                ret[i] = Lead_class::PUNCTUATION;
+            } else {
+                ret[i] = Lead_class::INVALID;
+            }
+        }
+
+        return ret;
+    }
+
+    constexpr std::array<Lead_class, 256> lead_classes = make_lead_classes();
+
+    ///
+    /// \param c Arbitrary byte
+    /// \return Lead class of c
+    constexpr Lead_class lead_class_of(char c) {
+        return lead_classes[static_cast<std::uint8_t>(c)];
+    }
+
+    ///
+    /// Upper bounds on the number of tokens and lines within a source
+    ///
+    struct Source_bounds {
+        std::size_t token_count = 0;
+        std::size_t line_count = 0;
+    };
+
+    ///
+    /// Every token begins with a byte which is neither whitespace nor an
+    /// identifier byte preceded by another identifier byte, so counting such
+    /// bytes gives an upper bound on the number of tokens. Text and numeric
+    /// literals only end at non-identifier bytes, so no token begins within
+    /// a run of identifier bytes. Shift tokens which are split into two
+    /// template brackets span two such bytes.
+    ///
+    /// \param source Source to bound
+    /// \return Upper bounds on number of tokens and lines in source
+    Source_bounds count_upper_bounds(std::string_view source) {
+        Source_bounds ret{0, 1};
+
+        // Whether the last byte of the previous block was an identifier byte
+        std::uint64_t carry = 0;
+
+        for (std::size_t i = 0; i < source.size(); i += block_width) {
+            auto block = classify_partial_block(source.data() + i, source.size() - i);
+
+            std::uint64_t continuations = block.identifier & ((block.identifier << 1) | carry);
+            std::uint64_t valid = (source.size() - i >= block_width) ? ~std::uint64_t{0} : (std::uint64_t{1} << (source.size() - i)) - 1;
+
+            ret.token_count += std::popcount(~block.whitespace & ~continuations & valid);
+            ret.line_count += std::popcount(block.newlines);
+
+            carry = block.identifier >> (block_width - 1);
+        }
+
+        return ret;
+    }
+
+    ///
+    /// Tokenizer which operates directly on UTF-8 encoded source.
+    ///
+    /// The source is classified in blocks of block_width bytes at a time,
+    /// producing bitmasks which are used to skip over runs of whitespace,
+    /// identifier bytes, and literal contents without examining bytes
+    /// individually. Non-ASCII codepoints are decoded and categorized only
+    /// where they are encountered.
+    ///
+    /// \tparam is_ascii_only If true, the source is known to consist solely
+    /// of ASCII characters. All multi-byte decoding is compiled out and any
+    /// byte with its MSB set is reported as an error.
+    template<bool is_ascii_only>
     class Tokenizer {
     private:
 
@@ -138,14 +381,54 @@ namespace harc::lex {
 
         Tokenization ret;
 
-        std::array<char, 5> window{};
-        std::uint32_t byte_index = 0;
-        std::bitset<5> is_ws = 0;
-        const char* it = nullptr;
-        std::array<std::uint32_t, 2> pos{};
-        std::uint32_t line_begin_index = 0;
+        ///
+        /// Index of first byte in the currently classified block
+        ///
+        std::size_t block_index = 0;
+
+        ///
+        /// Classification of the block_width bytes beginning at block_index
+        ///
+        Block_classification block{};
+
         std::vector<Stack_entry> balancing_stack{};
 
+        std::uint32_t error_count = 0;
+
+        ///
+        /// True if line starts were supplied up front rather than being
+        /// recorded as blocks are classified
+        ///
+        bool has_line_indices = false;
+
+        ///
+        /// Index of first byte to lex. Only non-zero when lexing a chunk, in
+        /// which case source ends where the chunk ends.
+        ///
+        std::size_t begin_index = 0;
+
+        ///
+        /// Line starts of the whole source when lexing a chunk
+        ///
+        std::span<const std::uint32_t> chunk_line_indices{};
+
+        ///
+        /// True when lexing a chunk. Brackets are then left unpaired so that
+        /// they may be paired across chunk boundaries once stitched together.
+        ///
+        bool defers_pairing = false;
+
+        ///
+        /// Set if a block comment was still open at the end of the source
+        ///
+        bool ends_in_comment = false;
+
+        ///
+        /// Indices of shift tokens whose lexing depends on brackets which may
+        /// have been opened in an earlier chunk
+        ///
+        std::vector<std::uint32_t> deferred_shifts{};
+
     public:
 
         //=================================================
@@ -155,992 +438,971 @@ namespace harc::lex {
         Tokenizer(
             std::string_view source_id,
             std::string_view source,
-            const Config& config
+            const Config& config,
+            std::vector<std::uint32_t> line_indices = {}
         ):
             source_id(source_id),
             source(source),
-            config(&config)
-        {}
+            config(&config),
+            has_line_indices(!line_indices.empty())
+        {
+            ret.line_indices = std::move(line_indices);
+        }
+
+        ///
+        /// Constructs a tokenizer which lexes a single chunk of source
+        ///
+        Tokenizer(
+            std::string_view source_id,
+            std::string_view source,
+            const Config& config,
+            Source_chunk chunk,
+            std::span<const std::uint32_t> line_indices
+        ):
+            source_id(source_id),
+            source(source.substr(0, chunk.end)),
+            config(&config),
+            has_line_indices(true),
+            begin_index(chunk.begin),
+            chunk_line_indices(line_indices),
+            defers_pairing(true) {}
 
         //=================================================
         // Misc.
         //=================================================
 
-        std::uint32_t estimate_bytes_per_token() {
-            const std::uint32_t bytes_per_token_estimate = 5;
-            auto token_count_estimate = source.size() / bytes_per_token_estimate;
-
-            return token_count_estimate;
-        }
-
-        std::uint32_t estimate_line_count() {
-            const std::uint32_t bytes_per_line_estimate = 8;
-            auto line_count_estimate = source.size() / bytes_per_line_estimate;
-
-            return line_count_estimate;
-        }
-
-        void emplace_token(
-            Token_type type,
-            std::uint32_t index,
-            std::uint32_t length,
-            std::array<std::uint32_t, 2> location,
-            std::uint32_t pair_index
-        ) {
-            ret.types.push_back(type);
-            ret.source_indices.push_back(index);
-            ret.lengths.push_back(length);
-            ret.pair_indices.push_back(index);
-        }
-
-        void emplace_token(
-            Token_type type,
-            std::uint32_t index,
-            std::uint32_t length,
-            std::array<std::uint32_t, 2> location
-        ) {
-            emplace_token(type, index, length, location, ret.pair_indices.size());
-        }
+        Tokenization tokenize() {
+            ret.source = source;
 
-        static bool is_whitespace(char c) {
-            return
-                c == ' '  ||
-                c == '\n' ||
-                c == '\t' ||
-                c == '\v';
-        }
+            // Reserve space for data upfront so that arrays never grow
+            auto bounds = count_upper_bounds(source.substr(begin_index));
+            ret.reserve(bounds.token_count);
 
-        void advance_window(unsigned o = 1) {
-            if (source.end() - it < o) [[unlikely]] {
-                return; //Special handling
+            if (!has_line_indices) {
+                ret.line_indices.reserve(bounds.line_count);
+                ret.line_indices.push_back(0);
             }
 
-            // Skip forward the indicated amount
-            std::shift_left(window.begin(), window.end(), o);
-            is_ws >>= o;
+            // Guess maximum nesting depth
+            balancing_stack.reserve(32);
 
-            for (std::uint32_t i = 5 - o; i < 5; ++i) {
-                window[i] = *it;
-                ++it;
-                ++byte_index;
-                is_ws[i] = is_whitespace(window[i]);
+            if (begin_index < source.size()) {
+                load_block(begin_index);
             }
 
-            // Skip whitespace
-            while (is_ws[1] && (it != source.end())) {
-                std::shift_left(window.begin(), window.end(), 1);
-                is_ws >>= 1;
+            // Core tokenization loop
+            std::size_t i = begin_index;
+            while (true) {
+                i = find_first_not(i, &Block_classification::whitespace);
+                if (i >= source.size()) {
+                    break;
+                }
 
-                window[4] = *it;
-                ++it;
-                is_ws[4] = is_whitespace(window[4]);
-
-                // Special handling for newlines
-                if (window[1] == '\n') {
-                    pos[0] +=  1;
-                    pos[1] = 0;
-                    line_begin_index = it - source.begin() - 4;
-                    ret.line_indices.push_back(line_begin_index);
+                switch (lead_class_of(source[i])) {
+                    case Lead_class::IDENTIFIER:
+                        i = consume_text_token(i);
+                        break;
+                    case Lead_class::DIGIT:
+                        i = consume_numeric_literal(i);
+                        break;
+                    case Lead_class::DOUBLE_QUOTE:
+                        i = consume_quoted_literal(i, Token_type::STRING_LITERAL);
+                        break;
+                    case Lead_class::SINGLE_QUOTE:
+                        i = consume_quoted_literal(i, Token_type::CODEPOINT_LITERAL);
+                        break;
+                    case Lead_class::SLASH: {
+                        char d = (i + 1 < source.size()) ? source[i + 1] : '\0';
+                        if (d == '/') {
+                            i = consume_single_line_comment(i);
+                        } else if (d == '*') {
+                            i = consume_left_comment_bracket(i);
+                        } else {
+                            i = consume_fixed_length_token(i);
+                        }
+                        break;
+                    }
+                    case Lead_class::PUNCTUATION:
+                        i = consume_fixed_length_token(i);
+                        break;
+                    case Lead_class::NON_ASCII:
+                        i = consume_non_ascii(i);
+                        break;
+                    default:
+                        report_error("Unrecognized character", i);
+                        i += 1;
                 }
             }
-        }
 
-        static constexpr std::array<std::uint8_t, 3> encode_token(char x, char y, char z, std::uint8_t sensitivity) {
-            return std::array<std::uint8_t, 3> {
-                std::uint8_t(x | ((sensitivity & 0x01) << 7)),
-                std::uint8_t(y | ((sensitivity & 0x02) << 6)),
-                std::uint8_t(z | ((sensitivity & 0x04) << 5))
-            };
+            return finish();
+        }
 
+        ///
+        /// Lexes the chunk which the tokenizer was constructed with
+        ///
+        /// \return Tokens within chunk
+        Chunk_tokenization tokenize_chunk() {
+            Chunk_tokenization chunk{};
+            chunk.chunk = Source_chunk{std::uint32_t(begin_index), std::uint32_t(source.size())};
+            chunk.tokenization = tokenize();
+            chunk.error_count = error_count;
+            chunk.ends_in_comment = ends_in_comment;
+            chunk.deferred_shifts = std::move(deferred_shifts);
+            return chunk;
         }
 
-        static bool test_whitespace(bool a, bool b, bool c, bool x, bool y) {
-            //TODO: Simplify this further
-            bool t0 = a & b;
-            bool t1 = x | y;
+    private:
 
-            bool s0 = !((x ^ a) | (y | c) | b);
-            bool s1 = t0 & (c | t1);
-            bool s2 = (t0 & !c) & t1;
+        ///
+        /// Reports any brackets which were never closed
+        ///
+        /// \return Tokenization results
+        Tokenization finish() {
+            // Any left tokens still on the stack were never closed
+            for (auto& entry : balancing_stack) {
+                report_unpaired(entry.type, ret.source_indices[entry.index]);
+            }
+            balancing_stack.clear();
 
-            return s0 | s1 | s2;
-        }
+            ret.success = (error_count == 0);
 
-        Token_type identify_next_token() {
-            // TODO: Address the large amount of branching
-            if (('0' <= window[1]) && (window[1] <= '9')) {
-                return Token_type::NUMERIC_LITERAL;
-            }
+            return std::move(ret);
+        }
 
-            if (
-                (('a' <= window[1]) && (window[1] <= 'z')) ||
-                (('A' <= window[1]) && (window[1] <= 'Z')) ||
-                window[1] == '_'
-            ) {
-                return Token_type::TEXT;
-            }
+        //=================================================
+        // Block classification
+        //=================================================
 
-            if (window[1] == '/' && window[2] == '/') {
-                if (window[3] == '/') {
-                    return Token_type::DOC_TEXT;
-                } else {
-                    return Token_type::SINGLE_LINE_COMMENT;
-                }
+        ///
+        /// Classifies the block beginning at the specified index and records
+        /// the start of every line which begins within it, unless line starts
+        /// were supplied up front.
+        ///
+        /// \param index Index of first byte in block
+        void load_block(std::size_t index) {
+            block_index = index;
+            block = classify_partial_block(source.data() + index, source.size() - index);
+
+            if (has_line_indices) {
+                return;
             }
 
-            if (window[1] == '\"') {
-                return Token_type::STRING_LITERAL;
+            std::uint64_t newlines = block.newlines;
+            while (newlines != 0) {
+                auto bit = std::countr_zero(newlines);
+                ret.line_indices.push_back(index + bit + 1);
+                newlines &= newlines - 1;
             }
+        }
 
-            if (window[1] == '\'') {
-                return Token_type::CODEPOINT_LITERAL;
+        ///
+        /// Classifies blocks until the current block contains the specified
+        /// index. Blocks are always visited in order so that no line is
+        /// skipped.
+        ///
+        /// \param index Index of byte which should be in current block
+        void seek(std::size_t index) {
+            while (block_index + block_width <= index) {
+                load_block(block_index + block_width);
             }
+        }
 
-            Token_type type =  Token_type::NULL_TOKEN;
-            for (std::size_t i = 1; i < token_table.size(); ++i) {
-                std::uint8_t cdpt0 = token_table[i][0] & 0x7f;
-                std::uint8_t cdpt1 = token_table[i][1] & 0x7f;
-                std::uint8_t cdpt2 = token_table[i][2] & 0x7f;
-
-                bool codepoint_match =
-                    (cdpt0 == 0x0) | (cdpt0 == window[1]) &
-                        (cdpt1 == 0x0) | (cdpt1 == window[1]) &
-                        (cdpt2 == 0x0) | (cdpt2 == window[1]);
-
-                int end_index = 0;
-
-                bool x = is_ws[0];
-                bool y = is_ws[end_index];
-
-                bool a = token_table[i][0] >> 7;
-                bool b = token_table[i][1] >> 7;
-                bool c = token_table[i][2] >> 7;
-
-                bool whitespace_match = test_whitespace(a, b, c, x, y);
-
-                if (codepoint_match && whitespace_match) {
-                    type = static_cast<Token_type>(i);
-                    break;
+        ///
+        /// \param index Index to begin search at
+        /// \param mask Pointer to mask to search
+        /// \return Index of first byte at or after index which is set in
+        /// mask, or source.size() if no such byte exists
+        std::size_t find_first(std::size_t index, std::uint64_t Block_classification::* mask) {
+            while (index < source.size()) {
+                seek(index);
+
+                std::uint64_t bits = (block.*mask) >> (index - block_index);
+                if (bits != 0) {
+                    return std::min(index + std::countr_zero(bits), source.size());
                 }
+
+                index = block_index + block_width;
             }
 
-            //TODO: Consider alternatives:
-            // Binary search
-            // SIMD vectorized search
-            return type;
+            return source.size();
         }
 
-        void consume_single_line_comment() {
-            while (true) {
-                if (window[1] == 0x00) {
-                    return; //Return once end of file is reached
-                }
-
-                if (window[1] == '\n') {
-                    return;
+        ///
+        /// \param index Index to begin search at
+        /// \param mask Pointer to mask to search
+        /// \return Index of first byte at or after index which is not set in
+        /// mask, or source.size() if no such byte exists
+        std::size_t find_first_not(std::size_t index, std::uint64_t Block_classification::* mask) {
+            while (index < source.size()) {
+                seek(index);
+
+                std::uint64_t bits = (~(block.*mask)) >> (index - block_index);
+                if (bits != 0) {
+                    return std::min(index + std::countr_zero(bits), source.size());
                 }
 
-                advance_window();
+                index = block_index + block_width;
             }
-        }
-
-        void consume_left_comment_bracket() {
-            //TODO: Implement
-        }
 
-        void consume_doc_text() {
-            //TODO: Implement
+            return source.size();
         }
 
-        void consume_text_token() {
-            std::uint32_t starting_index = byte_index;
-            while (true) {
-                if (window[1] == 0x00) {
-                    break; // Return once end of file is reached
-                }
-
-                bool is_digit = '0' <= window[1] && window[1] <= '9';
-                bool is_lowercase = 'a' <= window[1] && window[1] <= 'z';
-                bool is_uppercase = 'A' <= window[1] && window[1] <= 'Z';
-                bool is_underscore = window[1] == '_';
+        //=================================================
+        // Whitespace tests
+        //=================================================
 
-                bool is_text_codepoint = is_digit | is_lowercase | is_underscore | is_underscore;
-                if (!is_text_codepoint) {
-                    break;
-                }
+        ///
+        /// \param index Index of first byte of a codepoint
+        /// \return True if the codepoint at the index is whitespace or if the
+        /// index is at the end of the source
+        bool is_whitespace_at(std::size_t index) const {
+            if (index >= source.size()) {
+                return true;
+            }
 
-                advance_window();
+            char c = source[index];
+            if (is_ascii_only || !(c & 0x80)) {
+                return lead_class_of(c) == Lead_class::WHITESPACE;
             }
 
-            emplace_token(
-                Token_type::TEXT,
-                byte_index,
-                byte_index - starting_index,
-                pos
-            );
-        }
+            std::uint32_t codepoint = 0;
+            if (decode_utf8(source.data() + index, source.size() - index, codepoint) == 0) {
+                return false;
+            }
 
-        void consume_left_token(Token_type type) {
-            balancing_stack.emplace_back(type);
-            //TODO: Implement
+            return categorized_codepoint(codepoint) == Codepoint_category::OTHER_WHITESPACE;
         }
 
-        void consume_right_token(Token_type type) {
-            
-            //TODO: Implement
-        }
+        ///
+        /// \param index Index of first byte of a codepoint
+        /// \return True if the codepoint before the index is whitespace or if
+        /// the index is at the beginning of the source
+        bool is_whitespace_before(std::size_t index) const {
+            if (index == 0) {
+                return true;
+            }
 
-        void consume_fixed_length_token(Token_type type) {
-            auto width = token_width(type);
+            char c = source[index - 1];
+            if (is_ascii_only || !(c & 0x80)) {
+                return lead_class_of(c) == Lead_class::WHITESPACE;
+            }
 
-            // Handle typical fixed-width tokens
-            emplace_token(
-                type,
-                byte_index,
-                width,
-                pos
-            );
+            // Step back over continuation bytes to the leading byte
+            std::size_t begin = index - 1;
+            while (begin > 0 && (index - begin) < 4 && (source[begin] & 0xc0) == 0x80) {
+                --begin;
+            }
 
-            advance_window(width);
+            return is_whitespace_at(begin);
         }
 
-        Tokenization tokenize() {
-            ret.source = source;
+        //=================================================
+        // Token emission
+        //=================================================
 
-            // Reserve space for data upfront
-            std::uint32_t token_count_estimate = estimate_bytes_per_token();
-            ret.types.reserve(token_count_estimate);
-            ret.lengths.reserve(token_count_estimate);
-            ret.source_indices.reserve(token_count_estimate);
+        void emplace_token(
+            Token_type type,
+            std::size_t index,
+            std::size_t length,
+            std::uint32_t pair_index
+        ) {
+            // The columns were reserved using count_upper_bounds and never
+            // grow, so running out of room means the bound is wrong
+            assert(ret.types.size() < ret.capacity());
 
-            // Guess number of lines and reserve enough space
-            std::uint32_t line_count_estimate = estimate_line_count();
-            ret.line_indices.reserve(line_count_estimate);
-            ret.line_indices.push_back(0);
+            ret.types.push_back(type);
+            ret.source_indices.push_back(index);
+            ret.lengths.push_back(length);
+            ret.pair_indices.push_back(pair_index);
+            ret.keywords.push_back(Keyword::NONE);
+        }
 
-            // Guess maximum nesting depth
-            balancing_stack.reserve(32);
+        void emplace_token(
+            Token_type type,
+            std::size_t index,
+            std::size_t length
+        ) {
+            emplace_token(type, index, length, ret.pair_indices.size());
+        }
 
-            // Initialize window and context
-            it = source.begin();
-            for (int i = 1; i < 5 && (it != source.end()); ++i) {
-                window[i] = *it;
-                ++it;
-                is_ws[i] = is_whitespace(*it);
+        ///
+        /// Emplaces a left or right token, pairing right tokens with the
+        /// most recent unpaired left token.
+        ///
+        void emplace_balanced_token(Token_type type, std::size_t index, std::size_t length) {
+            std::uint32_t token_index = ret.types.size();
+
+            if (is_left_token(type)) {
+                balancing_stack.push_back(Stack_entry{type, token_index});
+                emplace_token(type, index, length);
+                return;
             }
-            byte_index = 0;
 
-            // Core tokenization loop
-            while (window[1] != 0x00) {
-                Token_type type = identify_next_token();
-
-                if (Token_type::NULL_TOKEN == type) {
-                    //TODO: Handle unrecognized token, including non-ascii text
-                } else if (Token_type::SINGLE_LINE_COMMENT == type) {
-                    consume_single_line_comment();
-                } else if (Token_type::LEFT_COMMENT_BRACKET == type) {
-                    consume_left_comment_bracket();
-                } else if (Token_type::DOC_TEXT == type) {
-                    consume_doc_text();
-                } else if (is_textual(type)) {
-                    consume_text_token();
-                } else if (is_left_token(type)) {
-                    consume_left_token(type);
-                } else if (is_right_token(type)) {
-                    consume_right_token(type);
-                } else {
-                    consume_fixed_length_token(type);
-                }
+            bool is_match =
+                !balancing_stack.empty() &&
+                balancing_stack.back().type == matching_token_type(type);
+
+            if (!is_match) {
+                report_unpaired(type, index);
+                emplace_token(type, index, length);
+                return;
             }
 
-            return std::move(ret);
-        }
+            auto left_index = balancing_stack.back().index;
+            balancing_stack.pop_back();
 
-    };
+            // Chunks are paired once stitched together. The stack is still
+            // maintained since it determines how shift tokens are lexed.
+            if (defers_pairing) {
+                emplace_token(type, index, length);
+                return;
+            }
 
-    /*
-    //=========================================================================
-    // Tokenization helper functions
-    //=========================================================================
+            ret.pair_indices[left_index] = token_index;
+            emplace_token(type, index, length, left_index);
+        }
 
-    constexpr std::array<std::uint8_t, 3> encode(char x, char y, char z, std::uint8_t sensitivity) {
-        return std::array<std::uint8_t, 3> {
-            std::uint8_t(x | ((sensitivity & 0x01) << 7)),
-            std::uint8_t(y | ((sensitivity & 0x02) << 6)),
-            std::uint8_t(z | ((sensitivity & 0x04) << 5))
-        };
+        //=================================================
+        // Error reporting
+        //=================================================
 
-    }
+        void report_error(std::string_view message, std::size_t index) {
+            if (error_count++ >= config->max_errors) {
+                return;
+            }
 
-    bool test_whitespace(bool a, bool b, bool c, bool x, bool y) {
-        //TODO: Simplify this further
-        bool t0 = a & b;
-        bool t1 = x | y;
+            std::span<const std::uint32_t> line_indices = ret.line_indices;
+            if (!chunk_line_indices.empty()) {
+                line_indices = chunk_line_indices;
+            }
 
-        bool s0 = !((x ^ a) | (y | c) | b);
-        bool s1 = t0 & (c | t1);
-        bool s2 = (t0 & !c) & t1;
+            auto it = std::upper_bound(line_indices.begin(), line_indices.end(), index);
+            std::uint32_t line = it - line_indices.begin();
+            std::uint32_t column = index - *(it - 1) + 1;
 
-        return s0 | s1 | s2;
-    }
+            ret.message_buffer.error(message, source_id, line, column);
+        }
 
-    ///
-    /// \param is_last_whitespace Did previous codepoint contain whitespace?
-    /// \param w First code point
-    /// \param x Second code point
-    /// \param y Third code point
-    /// \param z Fourth code point
-    /// \return Type of token. If the token cannot be categorized, then
-    /// Token_type::NULL_TOKEN is returned.
-    [[nodiscard]]
-    Token_type identify_token(
-        const std::array<UChar32, 5> codepoints,
-        const std::bitset<5> codepoint_categories
-    ) {
-        constexpr std::uint8_t joined = 0x00; // No whitespace on either side
-        constexpr std::uint8_t prefix = 0x01; // No whitespace after
-        constexpr std::uint8_t suffix = 0x02; // No whitespace before
-        constexpr std::uint8_t spaced = 0x03; // Whitespace on both sides
-        constexpr std::uint8_t unused = 0x04; // Unused
-        constexpr std::uint8_t accord = 0x05; // Whitespace on both sides or neither
-        constexpr std::uint8_t attach = 0x06; // Whitespace on at least one side
-        constexpr std::uint8_t ignore = 0x07; // Token is not whitespace sensitive
-
-        // Table containing the representation for all non-textual codepoints
-        // Each sequence of three bytes encode the token's representation
-        // The low 7 bits of each byte indicate the codepoint value that is
-        // required to comprise the operator.
-        //
-        // This list is ordered by the codepoint value of the nth token, with
-        // longer tokens being placed first so that in a linear scan, the
-        // longest match occurs first.
-        constexpr std::array<std::array<std::uint8_t, 3>, 69> token_table {
-            encode(0x0,  0x0, 0x0,      0), // 0x00 NULL_TOKEN
-            encode('!',  '=', 0x0, spaced), // 0x01 SPACED_COMPARE_NE
-            encode('!',  0x0, 0x0, prefix), // 0x02 PREFIX_EXCLAMATION
-            encode('#',  0x0, 0x0, ignore), // 0x03 HASH
-            encode('%',  '=', 0x0, spaced), // 0x04 SPACED_REM_EQUALS
-            encode('%',  0x0, 0x0, spaced), // 0x05 SPACED_PERCENT
-            encode('&',  '&', '=', spaced), // 0x06 SPACED_LOGICAL_AND_EQUALS
-            encode('&',  '&', 0x0, spaced), // 0x07 SPACED_LOGICAL_AND
-            encode('&',  '=', 0x0, spaced), // 0x08 SPACED_BITWISE_AND_EQUALS
-            encode('&',  0x0, 0x0, spaced), // 0x09 SPACED_AMPERSAND
-            encode('&',  0x0, 0x0, suffix), // 0x0a SUFFIX_AMPERSAND
-            encode('(',  0x0, 0x0, ignore), // 0x0b LEFT_PARENTHESIS
-            encode(')',  0x0, 0x0, ignore), // 0x0c RIGHT_PARENTHESIS
-            encode('*',  '/', 0x0, ignore), // 0x0d RIGHT_COMMENT_BRACKET
-            encode('*',  '=', 0x0, spaced), // 0x0e SPACED_TIMES_EQUALS
-            encode('*',  0x0, 0x0, spaced), // 0x0f SPACED_ASTERISK
-            encode('+',  '+', 0x0, prefix), // 0x10 PREFIX_INCREMENT
-            encode('+',  '+', 0x0, suffix), // 0x11 SUFFIX_INCREMENT
-            encode('+',  '=', 0x0, spaced), // 0x12 SPACED_PLUS_EQUALS
-            encode('+',  0x0, 0x0, spaced), // 0x13 SPACED_PLUS
-            encode('+',  0x0, 0x0, spaced), // 0x14 PREFIX_PLUS
-            encode(',',  0x0, 0x0, ignore), // 0x15 COMMA
-            encode('-',  '-', 0x0, prefix), // 0x16 PREFIX_DECREMENT
-            encode('-',  '-', 0x0, suffix), // 0x17 SUFFIX_DECREMENT
-            encode('-',  '=', 0x0, spaced), // 0x18 SPACED_MINUS_EQUALS
-            encode('-',  '>', 0x0, joined), // 0x19 JOINED_SINGLE_ARROW
-            encode('-',  0x0, 0x0, spaced), // 0x1a SPACED_MINUS
-            encode('-',  0x0, 0x0, prefix), // 0x1b PREFIX_MINUS
-            encode('.',  '.', '.', suffix), // 0x1c SUFFIX_TRIPLE_PERIOD
-            encode('.',  '.', 0x0, joined), // 0x1d JOINED_DOUBLE_PERIOD
-            encode('.',  0x0, 0x0, joined), // 0x1e JOINED_PERIOD
-            encode('/',  '*', 0x0, ignore), // 0x1f LEFT_COMMENT_BRACKET
-            encode('/',  '=', 0x0, spaced), // 0x20 SPACED_DIVIDE_EQUALS
-            encode('/',  0x0, 0x0, spaced), // 0x21 SPACED_SLASH
-            encode(':',  ':', 0x0, joined), // 0x22 JOINED_DOUBLE_COLON
-            encode(':',  0x0, 0x0, accord), // 0x23 COLON
-            encode(';',  0x0, 0x0, ignore), // 0x24 SEMICOLON
-            encode('<',  '|', '=', spaced), // 0x25 SPACED_SATURATING_LEFT_SHIFT_EQUALS
-            encode('<',  '<', '=', spaced), // 0x26 SPACED_MODULAR_LEFT_SHIFT_EQUALS
-            encode('<',  '<', 0x0, spaced), // 0x27 SPACED_MODULAR_LEFT_SHIFT
-            encode('<',  '=', 0x0, spaced), // 0x28 SPACED_COMPARE_LE
-            encode('<',  '|', 0x0, spaced), // 0x29 SPACED_SATURATING_LEFT_SHIFT
-            encode('<',  0x0, 0x0, spaced), // 0x2a SPACED_COMPARE_LT
-            encode('<',  0x0, 0x0, attach), // 0x2b LEFT_TEMPLATE_BRACKET
-            encode('=',  '=', 0x0, spaced), // 0x2c SPACED_COMPARE_EQ
-            encode('=',  '>', 0x0, spaced), // 0x2d SPACED_DOUBLE_ARROW
-            encode('=',  0x0, 0x0, spaced), // 0x2e SPACED_EQUALS
-            encode('>',  '>', '=', spaced), // 0x2f SPACED_MODULAR_RIGHT_SHIFT_EQUALS
-            encode('>',  '=', 0x0, spaced), // 0x30 SPACED_COMPARE_GE
-            encode('>',  '>', 0x0, spaced), // 0x31 SPACED_MODULAR_RIGHT_SHIFT
-            encode('>',  0x0, 0x0, spaced), // 0x32 SPACED_COMPARE_GT
-            encode('>',  0x0, 0x0, attach), // 0x33 RIGHT_TEMPLATE_BRACKET
-            encode('@',  0x0, 0x0, ignore), // 0x34 AT_SIGN
-            encode('[',  0x0, 0x0, ignore), // 0x35 LEFT_SQUARE_BRACKET
-            encode(']',  0x0, 0x0, ignore), // 0x36 RIGHT_SQUARE_BRACKET
-            encode('^',  '^', '=', spaced), // 0x37 SPACED_LOGICAL_XOR_EQUALS
-            encode('^',  '=', 0x0, spaced), // 0x38 SPACED_BITWISE_XOR_EQUALS
-            encode('^',  '^', 0x0, spaced), // 0x39 SPACED_LOGICAL_XOR
-            encode('^',  0x0, 0x0, spaced), // 0x3a SPACED_CARET
-            encode('^',  0x0, 0x0, suffix), // 0x3b SUFFIX_CARET
-            encode('{',  0x0, 0x0, ignore), // 0x3c LEFT_CURLY_BRACKET
-            encode('|',  '>', '=', spaced), // 0x3d SPACED_SATURATING_RIGHT_SHIFT_EQUALS
-            encode('|',  '|', '=', spaced), // 0x3e SPACED_LOGICAL_OR_EQUALS
-            encode('|',  '=', 0x0, spaced), // 0x3f SPACED_BITWISE_OR_EQUALS
-            encode('|',  '|', 0x0, spaced), // 0x40 SPACED_LOGICAL_OR
-            encode('|',  '>', 0x0, spaced), // 0x41 SPACED_SATURATING_RIGHT_SHIFT
-            encode('|',  0x0, 0x0, spaced), // 0x42 SPACED_PIPE
-            encode('}',  0x0, 0x0, ignore), // 0x43 RIGHT_CURLY_BRACKET
-            encode('~',  0x0, 0x0, prefix)  // 0x44 PREFIX_TILDE
-        };
+        void report_unpaired(Token_type type, std::size_t index) {
+            // The brackets of chunks are paired, and reported if unpaired,
+            // once the chunks are stitched together
+            if (defers_pairing && type != Token_type::LEFT_COMMENT_BRACKET) {
+                return;
+            }
 
-        if (('0' <= codepoints[1]) && (codepoints[1] <= '9')) {
-            return Token_type::NUMERIC_LITERAL;
+            report_error(unpaired_token_message(type), index);
         }
 
-        if (
-            (('a' <= codepoints[1]) && ( codepoints[1] <= 'z')) ||
-            (('A' <= codepoints[1]) && ( codepoints[1] <= 'Z')) ||
-            codepoints[1] == '_'
-        ) {
-            return Token_type::TEXT;
-        }
+        //=================================================
+        // Token consumption
+        //=================================================
 
-        Token_type ret =  Token_type::NULL_TOKEN;
+        ///
+        /// \param index Index of a non-ASCII byte at which a token begins
+        /// \return Index one past the end of the consumed codepoints
+        std::size_t consume_non_ascii(std::size_t index) {
+            if constexpr (is_ascii_only) {
+                report_error("Invalid ASCII value greater than 127", index);
+                return index + 1;
+            }
 
-        for (std::size_t i = 1; i < token_table.size(); ++i) {
-            std::uint8_t cdpt0 = token_table[i][0] & 0x7f;
-            std::uint8_t cdpt1 = token_table[i][1] & 0x7f;
-            std::uint8_t cdpt2 = token_table[i][2] & 0x7f;
+            std::uint32_t codepoint = 0;
+            auto length = decode_utf8(source.data() + index, source.size() - index, codepoint);
+            if (length == 0) {
+                report_error("Invalid UTF-8 sequence", index);
+                return index + 1;
+            }
 
-            bool codepoint_match =
-                (cdpt0 == 0x0) | (cdpt0 == codepoints[1]) &
-                (cdpt1 == 0x0) | (cdpt1 == codepoints[1]) &
-                (cdpt2 == 0x0) | (cdpt2 == codepoints[1]);
+            switch (categorized_codepoint(codepoint)) {
+                case Codepoint_category::OTHER_WHITESPACE:
+                    return index + length;
+                case Codepoint_category::IDENTIFIER_START:
+                    return consume_text_token(index);
+                default:
+                    report_error("Unrecognized codepoint", index);
+                    return index + length;
+            }
+        }
 
-            int end_index = 0;
+        ///
+        /// \param index Index one past the first codepoint of an identifier
+        /// \return Index one past the last codepoint of the identifier
+        std::size_t find_text_end(std::size_t index) {
+            while (true) {
+                index = find_first_not(index, &Block_classification::identifier);
+                if (is_ascii_only || index >= source.size() || !(source[index] & 0x80)) {
+                    return index;
+                }
 
-            bool x = codepoint_categories[0];
-            bool y = codepoint_categories[end_index];
+                // Identifiers may continue with non-ASCII codepoints
+                std::uint32_t codepoint = 0;
+                auto length = decode_utf8(source.data() + index, source.size() - index, codepoint);
+                if (length == 0) {
+                    return index;
+                }
 
-            bool a = token_table[i][0] >> 7;
-            bool b = token_table[i][1] >> 7;
-            bool c = token_table[i][2] >> 7;
+                auto category = categorized_codepoint(codepoint);
+                bool is_identifier =
+                    (category == Codepoint_category::IDENTIFIER_START) ||
+                    (category == Codepoint_category::IDENTIFIER_CONTINUE);
 
-            bool whitespace_match = test_whitespace(a, b, c, x, y);
+                if (!is_identifier) {
+                    return index;
+                }
 
-            if (codepoint_match && whitespace_match) {
-                ret = static_cast<Token_type>(i);
-                break;
+                index += length;
             }
         }
 
-        //TODO: Consider alternatives:
-        // Binary search
-        // SIMD vectorized search
-        return ret;
-    }
-
-    void find_single_line_comment_end(
-        std::array<UChar32, 5>& context,
-        std::bitset<5>& context_category,
-        icu::StringCharacterIterator& it
-    ) {
-        // context[0] is irrelevant
-        // context[1] is /
-        // context[2] is /
-        // context[3] is unknown
-        // context[4] is unknown
-
-        // Iterate until z is a newline
-        for (; context[1] != icu::StringCharacterIterator::DONE; context[1] = it.next32PostInc()) {
-            if (context[1] == '\n') {
-                break;
+        std::size_t consume_text_token(std::size_t begin) {
+            std::size_t first_length = 1;
+            if (!is_ascii_only && (source[begin] & 0x80)) {
+                std::uint32_t codepoint = 0;
+                first_length = decode_utf8(source.data() + begin, source.size() - begin, codepoint);
             }
-        }
 
-        // Perform one shift left of chars to ensure context[1] is one past the new line
-        context[0] = context[1];
-        context[1] = context[2];
-        context[2] = context[3];
-        context[3] = context[4];
-        context[4] = it.next32PostInc();
-
-        // Recompute whitespace categorization
-        context_category[0] = context[1] == '\n';
-        for (int i = 1; i < 5; ++i) {
-            context_category[i] = u_isWhitespace(context[i]);
+            std::size_t end = find_text_end(begin + first_length);
+            emplace_text_token(begin, end);
+
+            return end;
         }
-    }
 
-    void find_numeric_literal_end(
-        UChar32& x,
-        UChar32& y,
-        UChar32& z,
-        icu::StringCharacterIterator& it
-    ) {
-        // x is a digit
-        // y is unknown
-        // z is unknown
+        void emplace_text_token(std::size_t begin, std::size_t end) {
+            emplace_token(Token_type::TEXT, begin, end - begin);
 
-        if (y == icu::StringCharacterIterator::DONE || !(u_isdigit(y) || u_isalpha(y) || y == '_' || y == '.')) {
-            return;
+            auto keyword = identify_keyword(source.substr(begin, end - begin));
+            ret.keywords[ret.keywords.size() - 1] = keyword;
+
+            // No balanced tokens may enclose a function or struct declaration
+            // so the balancing stack can be reset when one is encountered
+            bool is_stack_reset = (keyword == Keyword::FUNC || keyword == Keyword::STRUCT);
+            if (is_stack_reset && !balancing_stack.empty()) {
+                for (auto& entry : balancing_stack) {
+                    report_unpaired(entry.type, ret.source_indices[entry.index]);
+                }
+                balancing_stack.clear();
+            }
         }
 
-        while (z != icu::StringCharacterIterator::DONE) {
-            if (!(u_isdigit(z) || u_isalpha(z) || z == '_' || z == '.')) {
-                break;
+        std::size_t consume_numeric_literal(std::size_t begin) {
+            std::size_t end = find_first_not(begin, &Block_classification::identifier);
+
+            // Periods continue the literal only if followed by a digit so
+            // that ranges such as 0..7 are not consumed
+            while (
+                end + 1 < source.size() &&
+                source[end] == '.' &&
+                lead_class_of(source[end + 1]) == Lead_class::DIGIT
+            ) {
+                end = find_first_not(end + 1, &Block_classification::identifier);
             }
 
-            z = it.next32PostInc();
+            emplace_token(Token_type::NUMERIC_LITERAL, begin, end - begin);
+            return end;
         }
 
-        y = z;
-        z = it.next32PostInc();
-    }
+        ///
+        /// \param begin Index of opening quote
+        /// \param type Either STRING_LITERAL or CODEPOINT_LITERAL
+        /// \return Index one past the closing quote
+        std::size_t consume_quoted_literal(std::size_t begin, Token_type type) {
+            char quote = source[begin];
 
-    void find_string_literal_end(UChar32& x, UChar32& y, UChar32& z, icu::StringCharacterIterator& it) {
-        // x is "
-        // y is unknown
-        // z is unknown
+            std::size_t i = begin + 1;
+            while (true) {
+                i = find_first(i, &Block_classification::literal_delimiters);
 
-        if (y == icu::StringCharacterIterator::DONE || y == '"' || y == '\n') {
-            y = z;
-            z = it.next32PostInc();
+                if (i >= source.size() || source[i] == '\n') {
+                    if (type == Token_type::STRING_LITERAL) {
+                        report_error("Unmatched double quotes", begin);
+                    } else {
+                        report_error("Unmatched single quote", begin);
+                    }
+                    return i;
+                }
 
-            return;
-        }
+                if (source[i] == '\\') {
+                    i += 2;
+                    continue;
+                }
 
-        bool is_codepoint_escaped = y == '\\';
+                if (source[i] == quote) {
+                    break;
+                }
 
-        while (z != icu::StringCharacterIterator::DONE) {
-            if ((z == '"' && !is_codepoint_escaped) || y == '\n') {
-                break;
+                ++i;
             }
 
-            is_codepoint_escaped = (z == '\\') && !is_codepoint_escaped;
-
-            z = it.next32PostInc();
+            std::size_t end = i + 1;
+            emplace_token(type, begin, end - begin);
+            return end;
         }
 
-        y = z;
-        z = it.next32PostInc();
-
-        y = z;
-        z = it.next32PostInc();
-    }
+        ///
+        /// \param begin Index of first slash
+        /// \return Index of the newline which ends the comment
+        std::size_t consume_single_line_comment(std::size_t begin) {
+            std::size_t end = find_first(begin, &Block_classification::newlines);
 
-    void find_char_literal_end(UChar32& x, UChar32& y, UChar32& z, icu::StringCharacterIterator& it) {
-        // x is '
-        // y is unknown
-        // z is unknown
+            bool is_doc_text =
+                (begin + 2 < source.size()) &&
+                (source[begin + 2] == '/');
 
-        if (y == icu::StringCharacterIterator::DONE || y == '\'') {
-            y = z;
-            z = it.next32PostInc();
+            if (is_doc_text) {
+                emplace_token(Token_type::DOC_TEXT, begin, end - begin);
+            }
 
-            return;
+            return end;
         }
 
-        bool is_codepoint_escaped = y == '\\';
+        ///
+        /// \param begin Index of the opening comment bracket
+        /// \return Index one past the matching closing comment bracket
+        std::size_t consume_left_comment_bracket(std::size_t begin) {
+            std::uint32_t depth = 1;
+
+            std::size_t i = begin + 2;
+            while (depth != 0) {
+                // Both bytes of each comment bracket are punctuation
+                i = find_first(i, &Block_classification::punctuation);
+                if (i + 1 >= source.size()) {
+                    ends_in_comment = true;
+                    report_unpaired(Token_type::LEFT_COMMENT_BRACKET, begin);
+                    return source.size();
+                }
 
-        while (z != icu::StringCharacterIterator::DONE) {
-            if (z == '\'' && !is_codepoint_escaped) {
-                break;
+                if (source[i] == '*' && source[i + 1] == '/') {
+                    --depth;
+                    i += 2;
+                } else if (source[i] == '/' && source[i + 1] == '*') {
+                    ++depth;
+                    i += 2;
+                } else {
+                    ++i;
+                }
             }
 
-            is_codepoint_escaped = (z == '\\') && !is_codepoint_escaped;
-
-            z = it.next32PostInc();
+            return i;
         }
 
-        y = z;
-        z = it.next32PostInc();
+        ///
+        /// \param index Index of first byte of token
+        /// \param width Object to write token's width to
+        /// \return Type of token beginning at index. The longest spelling
+        /// which matches is used, with whitespace selecting among tokens which
+        /// share that spelling. NULL_TOKEN if no token matches.
+        Token_type identify_fixed_length_token(std::size_t index, std::uint32_t& width) const {
+            std::size_t remaining = source.size() - index;
+
+            // Bytes past the end of the source are left as zero, which no
+            // spelling contains
+            std::uint32_t next = 0;
+            for (std::size_t w = 0; w < 3 && w < remaining; ++w) {
+                next |= std::uint32_t(std::uint8_t(source[index + w])) << (8 * w);
+            }
 
-        y = z;
-        z = it.next32PostInc();
-    }
+            auto range = token_dispatch_table.leads[next & 0xff];
+            for (auto s = range.begin; s < range.end; ++s) {
+                const auto& spelling = token_dispatch_table.spellings[s];
+                if ((next & spelling.mask) != spelling.pattern) {
+                    continue;
+                }
 
-    void find_text_token_end(UChar32& x, UChar32& y, UChar32& z, icu::StringCharacterIterator& it) {
-        // x is codepoint which may begin identifier
-        // y is unknown
-        // z is unknown
+                width = spelling.width;
+                if (!spelling.is_whitespace_sensitive) {
+                    return spelling.types[0];
+                }
 
-        if (y == icu::StringCharacterIterator::DONE || !u_hasBinaryProperty(y, UProperty::UCHAR_ID_CONTINUE)) {
-            return;
+                bool x = is_whitespace_before(index);
+                bool y = is_whitespace_at(index + width);
+                return spelling.types[(x << 1) | y];
+            }
+
+            return Token_type::NULL_TOKEN;
         }
 
-        while (z != icu::StringCharacterIterator::DONE) {
-            if (!u_hasBinaryProperty(z, UProperty::UCHAR_ID_CONTINUE)) {
-                break;
+        std::size_t consume_fixed_length_token(std::size_t index) {
+            std::uint32_t width = 0;
+            Token_type type = identify_fixed_length_token(index, width);
+
+            if (Token_type::NULL_TOKEN == type) {
+                report_error("Unrecognized token type", index);
+                return index + 1;
             }
 
-            z = it.next32PostInc();
+            return emplace_fixed_length_token(type, index, width);
         }
 
-        y = z;
-        z = it.next32PostInc();
-    }
+        ///
+        /// \param type Type of fixed-length token
+        /// \param index Index of first byte of token
+        /// \param width Width of token's spelling
+        /// \return Index one past the end of the token
+        std::size_t emplace_fixed_length_token(Token_type type, std::size_t index, std::uint32_t width) {
+            // Template brackets opened before a chunk may be closed by a
+            // shift token within it. Since a shift which is split pops
+            // brackets from before the chunk, every later shift in the chunk
+            // depends on them too, so all are left to stitch_chunks().
+            bool is_deferred_shift =
+                defers_pairing &&
+                (begin_index != 0) &&
+                (type == Token_type::SPACED_MODULAR_RIGHT_SHIFT);
+
+            if (is_deferred_shift) {
+                deferred_shifts.push_back(ret.types.size());
+                emplace_token(type, index, width);
+                return index + width;
+            }
 
-    void find_doc_text_end(UChar32& x, UChar32& y, UChar32& z, icu::StringCharacterIterator& it) {
-        // x is /
-        // y is /
-        // z is /
+            // Two consecutive right angle brackets close two template
+            // brackets rather than form a shift when both are open
+            bool is_double_template_close =
+                (type == Token_type::SPACED_MODULAR_RIGHT_SHIFT) &&
+                (balancing_stack.size() >= 2) &&
+                (balancing_stack.end()[-1].type == Token_type::LEFT_TEMPLATE_BRACKET) &&
+                (balancing_stack.end()[-2].type == Token_type::LEFT_TEMPLATE_BRACKET);
+
+            if (is_double_template_close) {
+                emplace_balanced_token(Token_type::RIGHT_TEMPLATE_BRACKET, index + 0, 1);
+                emplace_balanced_token(Token_type::RIGHT_TEMPLATE_BRACKET, index + 1, 1);
+                return index + 2;
+            }
 
-        while (z != icu::StringCharacterIterator::DONE) {
-            if (z == '\n') {
-                break;
+            bool is_balanced =
+                (is_left_token(type) || is_right_token(type)) &&
+                (type != Token_type::RIGHT_COMMENT_BRACKET);
+
+            if (is_balanced) {
+                emplace_balanced_token(type, index, width);
+            } else {
+                emplace_token(type, index, width);
             }
 
-            z = it.next32PostInc();
+            return index + width;
         }
 
-        y = z;
-        z = it.next32PostInc();
-    }
+    };
 
-    std::uint32_t estimate_bytes_per_token(std::string_view source) {
-        const std::uint32_t bytes_per_token_estimate = 5;
-        auto token_count_estimate = source.size() / bytes_per_token_estimate;
+    //=====================================================
+    // Tokenization
+    //=====================================================
+
+    Tokenization::Tokenization(Tokenization&& other) noexcept:
+        source(other.source),
+        types(std::exchange(other.types, {})),
+        source_indices(std::exchange(other.source_indices, {})),
+        lengths(std::exchange(other.lengths, {})),
+        line_indices(std::move(other.line_indices)),
+        pair_indices(std::exchange(other.pair_indices, {})),
+        keywords(std::exchange(other.keywords, {})),
+        message_buffer(std::move(other.message_buffer)),
+        success(other.success),
+        storage(std::move(other.storage)),
+        token_capacity(std::exchange(other.token_capacity, 0)) {}
+
+    Tokenization& Tokenization::operator=(Tokenization&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
 
-        return token_count_estimate;
+        source = other.source;
+        types = std::exchange(other.types, {});
+        source_indices = std::exchange(other.source_indices, {});
+        lengths = std::exchange(other.lengths, {});
+        line_indices = std::move(other.line_indices);
+        pair_indices = std::exchange(other.pair_indices, {});
+        keywords = std::exchange(other.keywords, {});
+        message_buffer = std::move(other.message_buffer);
+        success = other.success;
+        storage = std::move(other.storage);
+        token_capacity = std::exchange(other.token_capacity, 0);
+
+        return *this;
     }
 
-    std::uint32_t estimate_line_count(std::string_view source) {
-        const std::uint32_t bytes_per_line_estimate = 8;
-        auto line_count_estimate = source.size() / bytes_per_line_estimate;
+    void Tokenization::reserve(std::size_t token_count) {
+        if (token_count <= token_capacity) {
+            return;
+        }
 
-        return line_count_estimate;
-    }
+        constexpr std::size_t bytes_per_token = 3 * sizeof(std::uint32_t) + sizeof(Token_type) + sizeof(Keyword);
+        auto new_storage = std::make_unique_for_overwrite<std::byte[]>(token_count * bytes_per_token);
 
-    //=========================================================================
-    // Tokenization subroutine
-    //=========================================================================
+        // Arrays of wider elements come first so that all are aligned
+        std::byte* p = new_storage.get();
+        auto relocate = [&p, token_count] <class T> (Token_column<T>& column) {
+            auto* data = reinterpret_cast<T*>(p);
+            std::copy(column.begin(), column.end(), data);
+            column.ptr = data;
+            p += token_count * sizeof(T);
+        };
 
-    struct Stack_entry {
-        Token_type type;
-        std::uint32_t index;
-    };
+        relocate(source_indices);
+        relocate(lengths);
+        relocate(pair_indices);
+        relocate(types);
+        relocate(keywords);
 
-     */
+        storage = std::move(new_storage);
+        token_capacity = token_count;
+    }
 
+    //=====================================================
+    // Lexing
+    //=====================================================
 
     Tokenization lex(std::string_view source_id, std::string_view source, const Config& config) {
-        Tokenizer tokenizer{source_id, source, config};
+        Tokenizer<false> tokenizer{source_id, source, config};
         return tokenizer.tokenize();
     }
 
-    /*
-    Tokenization lex(std::string_view source_id, std::string_view source, const Config& config) {
-        Tokenizer tokenizer{source_id, source, config};
+    Tokenization lex_ascii(std::string_view source_id, std::string_view source, const Config& config) {
+        Tokenizer<true> tokenizer{source_id, source, config};
         return tokenizer.tokenize();
+    }
 
-        //TODO: Add hot/cold path for ASCII/UTF-8 data
-        //TODO: Remove use of ICU library
+    Tokenization lex(
+        std::string_view source_id,
+        std::string_view source,
+        std::vector<std::uint32_t> line_indices,
+        const Config& config
+    ) {
+        Tokenizer<false> tokenizer{source_id, source, config, std::move(line_indices)};
+        return tokenizer.tokenize();
+    }
 
+    Tokenization lex_ascii(
+        std::string_view source_id,
+        std::string_view source,
+        std::vector<std::uint32_t> line_indices,
+        const Config& config
+    ) {
+        Tokenizer<true> tokenizer{source_id, source, config, std::move(line_indices)};
+        return tokenizer.tokenize();
+    }
 
-        Tokenization ret;
-        ret.source = source;
+    std::vector<Source_chunk> split_into_chunks(
+        std::string_view source,
+        std::span<const std::uint32_t> line_indices,
+        std::uint32_t chunk_size
+    ) {
+        std::vector<Source_chunk> ret;
 
-        // Reserve space for data upfront
-        std::uint32_t token_count_estimate = estimate_bytes_per_token(source);
-        ret.types.reserve(token_count_estimate);
-        ret.lengths.reserve(token_count_estimate);
-        ret.source_indices.reserve(token_count_estimate);
-
-        // Guess number of lines and reserve enough space
-        std::uint32_t line_count_estimate = estimate_line_count(source);
-        ret.line_indices.reserve(line_count_estimate);
-        ret.line_indices.push_back(0);
-
-
-        // Helper lambda to make emplacing tokens more terse
-        auto emplace_token =
-            [&ret] (
-                Token_type type,
-                std::uint32_t index,
-                std::uint32_t length,
-                std::array<std::uint32_t, 2> location,
-                std::uint32_t pair_index = UINT32_MAX
-            ) {
-                ret.types.push_back(type);
-                ret.source_indices.push_back(index);
-                ret.lengths.push_back(length);
+        auto size = static_cast<std::uint32_t>(source.size());
 
-                if (pair_index == UINT32_MAX) {
-                    ret.pair_indices.push_back(index);
-                } else {
-                    ret.pair_indices.push_back(pair_index);
-                }
-            };
+        // A backslash escapes the newline which follows it when inside a
+        // literal, so lines following one are never used as a boundary
+        auto is_boundary = [source, size] (std::uint32_t index) {
+            return
+                (0 < index && index < size) &&
+                (source[index - 1] == '\n') &&
+                !(index >= 2 && source[index - 2] == '\\');
+        };
 
+        std::uint32_t begin = 0;
+        auto it = line_indices.begin();
+        while (true) {
+            std::uint64_t target = std::uint64_t{begin} + std::max(chunk_size, std::uint32_t{1});
 
-        //TODO: Replace use of ICU library with internal UTF-8 handling
-        // The current approach does not meet Harmonia's requirement that
-        // source files may be up to at least 2^32-1 bytes in size
-        icu::UnicodeString ustring{source.data(), static_cast<std::int32_t>(source.size()), "utf-8"};
+            it = std::lower_bound(it, line_indices.end(), target);
+            while (it != line_indices.end() && *it < size && !is_boundary(*it)) {
+                ++it;
+            }
 
-        // Append two more empty characters so that getting the indices from the
-        // iterator continue to be incremented even after reaching the end of
-        // the string.
-        ustring += eof_codepoint;
-        ustring += eof_codepoint;
-        ustring += eof_codepoint;
-        ustring += eof_codepoint;
+            if (it == line_indices.end() || *it >= size) {
+                ret.push_back(Source_chunk{begin, size});
+                break;
+            }
 
-        // Index of codepoint which begins current line
-        std::uint32_t line_begin_index = 0;
+            ret.push_back(Source_chunk{begin, *it});
+            begin = *it;
+        }
 
-        // Track current line number
-        std::uint32_t line = 1;
+        return ret;
+    }
 
-        // Codepoint iterator
-        icu::StringCharacterIterator it{ustring};
+    Chunk_tokenization lex_chunk(
+        std::string_view source_id,
+        std::string_view source,
+        Source_chunk chunk,
+        std::span<const std::uint32_t> line_indices,
+        bool is_ascii,
+        const Config& config
+    ) {
+        if (is_ascii) {
+            Tokenizer<true> tokenizer{source_id, source, config, chunk, line_indices};
+            return tokenizer.tokenize_chunk();
+        } else {
+            Tokenizer<false> tokenizer{source_id, source, config, chunk, line_indices};
+            return tokenizer.tokenize_chunk();
+        }
+    }
 
-        // Stack which is used to identify unpaired tokens
-        std::vector<Stack_entry> balancing_stack;
+    ///
+    /// Decides whether each deferred shift token closes two template
+    /// brackets, tracking brackets across every chunk by the same rules as
+    /// the lexer. Runs in a single pass over the chunks' tokens.
+    ///
+    /// \param chunks Lexed chunks, in order. The deferred shifts of each are
+    /// reduced to those which must be split.
+    /// \return Number of shifts which must be split
+    std::size_t resolve_deferred_shifts(std::vector<Chunk_tokenization>& chunks) {
+        bool has_deferred_shifts = std::ranges::any_of(chunks, [] (const Chunk_tokenization& chunk) {
+            return !chunk.deferred_shifts.empty();
+        });
+
+        if (!has_deferred_shifts) {
+            return 0;
+        }
 
-        // Guess maximum nesting depth
+        std::vector<Token_type> balancing_stack;
         balancing_stack.reserve(32);
 
-        // Location of current codepoint
-        //std::array<std::uint32_t, 2> location = {line, it.getIndex() - 2 - line_begin_index};
+        std::size_t split_count = 0;
+        for (auto& chunk : chunks) {
+            const auto& tokens = chunk.tokenization;
+            auto& shifts = chunk.deferred_shifts;
 
-        // Stores windows of relevant codepoints. Index 1 is considered the current codepoint
-        std::array<UChar32, 5> context{
-            0x00,
-            it.next32PostInc(),
-            it.next32PostInc(),
-            it.next32PostInc(),
-            it.next32PostInc()
-        };
-
-        // Indicates whether the corresponding entry in context is a whitespace codepoint or not
-        std::bitset<5> context_category{};
-        context_category[0] = true; // Treat start of file as whitespace
-        context_category[1] = (u_isWhitespace(context[1]) != 0) | (context[1] == eof_codepoint);
-        context_category[2] = (u_isWhitespace(context[2]) != 0) | (context[2] == eof_codepoint);
-        context_category[3] = (u_isWhitespace(context[3]) != 0) | (context[3] == eof_codepoint);
-        context_category[4] = (u_isWhitespace(context[4]) != 0) | (context[4] == eof_codepoint);
-
-        // Lambda useful for moving window forward.
-        // o is the minimum number of codepoint to advance by.
-        // The advance will also cover any whitespace which may come thereafter.
-        auto advance_window = [&] (unsigned o = 1) {
-            // Skip forward the indicated amount
-            std::shift_left(context.begin(), context.end(), o);
-            context_category >>= o;
-
-            for (std::size_t i = 5 - o; i < 5; ++i) {
-                context[i] = it.next32PostInc();
-                context_category[i] = u_isWhitespace(context[i]) || (context[i] == eof_codepoint);
-            }
+            std::size_t next_shift = 0;
+            std::size_t kept_count = 0;
+            for (std::uint32_t i = 0; i < tokens.types.size(); ++i) {
+                auto type = tokens.types[i];
 
-            // Skip whitespace
-            while (context_category[1] && (context[1] != eof_codepoint)) {
-                std::shift_left(context.begin(), context.end(), 1);
-                context_category >>= 1;
-
-                context[4] = it.next32PostInc();
-                context_category[4] = u_isWhitespace(context[4]) || (context[4] == eof_codepoint);
-
-                // Special handling for newlines
-                if (context[1] == '\n') {
-                    line += 1;
-                    line_begin_index = it.getIndex() - 4;
-                    ret.line_indices.push_back(line_begin_index);
-                }
-            }
-        };
-
-        while (context[1] != eof_codepoint) {
-            // Identify type of current token
-            Token_type type = identify_token(context, context_category);
-
-            // Handle case where token was not recognized
-            if (type == Token_type::NULL_TOKEN) {
-                ret.message_buffer.error(
-                    "Unrecognized token type",
-                    source_id,
-                    line,
-                    it.getIndex() - 2 - line_begin_index
-                );
-                continue;
-            }
-
-            // Handle single line comment
-            if (type == Token_type::SINGLE_LINE_COMMENT) {
-                find_single_line_comment_end(context, context_category, it);
-                continue;
-            }
+                if (next_shift < shifts.size() && shifts[next_shift] == i) {
+                    ++next_shift;
 
-            // Handle multiline comment
-            if (type == Token_type::LEFT_COMMENT_BRACKET) {
-                //TODO: Update implementation to handle comment brackets
-                //TODO: Consider ignoring template brackets which are found
-                // within string literals
+                    bool is_double_template_close =
+                        (balancing_stack.size() >= 2) &&
+                        (balancing_stack.end()[-1] == Token_type::LEFT_TEMPLATE_BRACKET) &&
+                        (balancing_stack.end()[-2] == Token_type::LEFT_TEMPLATE_BRACKET);
 
-                balancing_stack.push_back(
-                    Stack_entry{
-                        Token_type::LEFT_COMMENT_BRACKET,
-                        static_cast<std::uint32_t>(it.getIndex())
+                    if (is_double_template_close) {
+                        balancing_stack.resize(balancing_stack.size() - 2);
+                        shifts[kept_count++] = i;
                     }
-                );
+                    continue;
+                }
 
-                std::shift_left(context.begin(), context.end(), 1);
-                context[4] = it.next32PostInc();
+                if (type == Token_type::RIGHT_COMMENT_BRACKET) {
+                    continue;
+                }
 
-                while (context[1] != eof_codepoint) {
-                    if (context[1] == '\n') {
-                        line += 1;
-                        line_begin_index = it.getIndex() - 2;
-                        ret.line_indices.push_back(line_begin_index);
-                    }
+                if (is_left_token(type)) {
+                    balancing_stack.push_back(type);
+                } else if (is_right_token(type)) {
+                    bool is_match =
+                        !balancing_stack.empty() &&
+                        balancing_stack.back() == matching_token_type(type);
 
-                    if (context[1] == '*' && context[2] == '/') {
-                        if (balancing_stack.size() == 1) {
-                            balancing_stack.pop_back();
-                            break;
-                        }
-                    } else if (context[1] == '/' && context[2] == '*') {
-                        balancing_stack.push_back(
-                            Stack_entry{
-                                Token_type::LEFT_COMMENT_BRACKET,
-                                static_cast<std::uint32_t>(it.getIndex())
-                            }
-                        );
+                    if (is_match) {
+                        balancing_stack.pop_back();
                     }
+                } else if (tokens.keywords[i] == Keyword::FUNC || tokens.keywords[i] == Keyword::STRUCT) {
+                    balancing_stack.clear();
                 }
-                continue;
             }
 
-            // Handle textural tokens, whose lengths are variable
-            if (is_textual(type)) {
-                auto starting_index = it.getIndex() - 3;
-                switch (type) {
-                    case Token_type::NUMERIC_LITERAL: {
-                        find_numeric_literal_end(x, y, z, it);
-                        break;
-                    }
-                    case Token_type::STRING_LITERAL: {
-                        find_string_literal_end(x, y, z, it);
-                        if (y == icu::StringCharacterIterator::DONE) {
-                            ret.message_buffer.error(
-                                "Unmatched double quotes",
-                                source_id,
-                                line,
-                                it.getIndex() - line_begin_index - 1
-                            );
-                            continue;
-                        }
-                        break;
-                    }
-                    case Token_type::CHAR_LITERAL: {
-                        find_char_literal_end(x, y, z, it);
-                        if (y == icu::StringCharacterIterator::DONE) {
-                            ret.message_buffer.error(
-                                "Unmatched single quote",
-                                source_id,
-                                line,
-                                it.getIndex() - line_begin_index - 1
-                            );
-                            continue;
-                        }
-
-                        break;
-                    }
-                    case Token_type::TEXT: {
-                        find_text_token_end(x, y, z, it);
-
-                        // Reset the balancing stack if the text token
-                        // introduces a new function or struct
-                        auto token_text = std::string_view{
-                            source.data() + starting_index,
-                            std::size_t(it.getIndex() - starting_index - 2)
-                        };
-
-                        if (token_text == "struct" || token_text == "func") {
-                            if (!balancing_stack.empty()) {
-                                //TODO: Handle lack of properly balanced tokens
-                                balancing_stack.clear();
-                            }
-                        }
-
-                        break;
-                    }
-                    case Token_type::DOC_TEXT: {
-                        find_doc_text_end(x, y, z, it);
-                        break;
-                    }
-                    default: {
-                        // TODO: Report internal compiler error
-                        return ret;
-                    }
-                }
+            shifts.resize(kept_count);
+            split_count += kept_count;
+        }
 
-                auto curr_index = it.getIndex();
-                emplace_token(
-                    type,
-                    starting_index,
-                    curr_index - starting_index - 2,
-                    {line, starting_index - line_begin_index + 1}
-                );
+        return split_count;
+    }
 
+    template<bool is_ascii_only>
+    Tokenization stitch_chunks_impl(
+        std::string_view source_id,
+        std::string_view source,
+        std::vector<Chunk_tokenization>& chunks,
+        std::vector<std::uint32_t> line_indices,
+        const Config& config,
+        const Parallel_for& parallel_for
+    ) {
+        // A chunk which ended inside a block comment means that the chunk
+        // after it began inside that comment, so both are lexed again as one
+        for (std::size_t i = 0; i + 1 < chunks.size();) {
+            if (!chunks[i].ends_in_comment) {
+                ++i;
                 continue;
             }
 
-            // Handle non-textual tokens, whose lengths are at most 3 code points
-            auto width = token_width(type);
+            Source_chunk merged{chunks[i].chunk.begin, chunks[i + 1].chunk.end};
+            Tokenizer<is_ascii_only> tokenizer{source_id, source, config, merged, line_indices};
+            chunks[i] = tokenizer.tokenize_chunk();
+            chunks.erase(chunks.begin() + i + 1);
+        }
 
+        auto split_count = resolve_deferred_shifts(chunks);
 
-            // Handle balancing tokens
-            auto expected_match = matching_token_type(type);
+        Tokenization ret;
+        ret.source = source;
+        ret.line_indices = std::move(line_indices);
 
-            //TODO: Handle mismatched tokens and attempt to identify which
-            // those are.
+        std::size_t token_count = 0;
+        std::uint32_t error_count = 0;
+        for (const auto& chunk : chunks) {
+            token_count += chunk.tokenization.types.size();
+            error_count += chunk.error_count;
+        }
 
-            std::uint32_t matching_index = UINT32_MAX;
-            if (expected_match != Token_type::NULL_TOKEN) {
-                if (is_left_token(type)) {
-                    Stack_entry b{};
-                    b.type = type;
-                    b.index = ret.lengths.size();
-                    balancing_stack.push_back(b);
-                } else {
-                    auto stack_top = balancing_stack.back();
-                    if (expected_match == stack_top.type) {
-                        balancing_stack.pop_back();
-                        matching_index = stack_top.index;
+        ret.reserve(token_count + split_count);
 
-                        ret.pair_indices[stack_top.index] = ret.lengths.size();
-                    } else {
-                        std::string_view error_message;
-                        switch (stack_top.type) {
-                            case Token_type::LEFT_PARENTHESIS:      error_message = "Unpaired parenthesis"; break;
-                            case Token_type::LEFT_SQUARE_BRACKET:   error_message = "Unpaired square bracket"; break;
-                            case Token_type::LEFT_CURLY_BRACKET:    error_message = "Unpaired curly bracket"; break;
-                            case Token_type::LEFT_TEMPLATE_BRACKET: error_message = "Unpaired template bracket"; break;
-                            default: {
-                                //TODO: Report internal compiler error
-                            }
-                        }
+        auto append_tokens = [&ret] (const Tokenization& tokens, std::size_t begin, std::size_t end) {
+            auto count = end - begin;
+            ret.types.append({tokens.types.data() + begin, count});
+            ret.source_indices.append({tokens.source_indices.data() + begin, count});
+            ret.lengths.append({tokens.lengths.data() + begin, count});
+            ret.keywords.append({tokens.keywords.data() + begin, count});
+        };
 
-                        ret.message_buffer.error(
-                            error_message,
-                            source_id,
-                            line,
-                            it.getIndex() + 1
-                        );
-                    }
+        for (auto& chunk : chunks) {
+            auto& tokens = chunk.tokenization;
+
+            // Shifts which close two template brackets become two
+            // one-byte brackets
+            std::size_t begin = 0;
+            for (auto shift : chunk.deferred_shifts) {
+                append_tokens(tokens, begin, shift);
+
+                auto index = tokens.source_indices[shift];
+                for (std::uint32_t half = 0; half < 2; ++half) {
+                    ret.types.push_back(Token_type::RIGHT_TEMPLATE_BRACKET);
+                    ret.source_indices.push_back(index + half);
+                    ret.lengths.push_back(1);
+                    ret.keywords.push_back(Keyword::NONE);
                 }
-            }
 
-            emplace_token(
-                type,
-                it.getIndex() - 3,
-                width,
-                location,
-                matching_index
-            );
+                begin = shift + 1;
+            }
 
-            // Move context window left
-            advance_window(width);
+            append_tokens(tokens, begin, tokens.types.size());
+            ret.message_buffer.append(std::move(tokens.message_buffer));
         }
 
+        // Errors reported by the chunks count against the limit
+        Config pairing_config = config;
+        pairing_config.max_errors -= std::min(error_count, config.max_errors);
+
+        error_count += pair_brackets(ret, source_id, pairing_config, parallel_for);
+
+        ret.success = (error_count == 0);
         return ret;
     }
-    */
+
+    Tokenization stitch_chunks(
+        std::string_view source_id,
+        std::string_view source,
+        std::vector<Chunk_tokenization> chunks,
+        std::vector<std::uint32_t> line_indices,
+        bool is_ascii,
+        const Config& config,
+        const Parallel_for& parallel_for
+    ) {
+        if (is_ascii) {
+            return stitch_chunks_impl<true>(source_id, source, chunks, std::move(line_indices), config, parallel_for);
+        } else {
+            return stitch_chunks_impl<false>(source_id, source, chunks, std::move(line_indices), config, parallel_for);
+        }
+    }
 
 }
@@ -0,0 +1,312 @@
+#include <harc/lexer/Pairing.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace harc::lex {
+
+    ///
+    /// Number of tokens handled by each unit of work in the block-wise pass
+    ///
+    constexpr std::size_t pairing_block_size = 1 << 16;
+
+    ///
+    /// Greatest nesting depth which the block-wise pass handles. Deeper
+    /// sources are paired using a stack since the pass keeps per-block
+    /// counts for each depth.
+    ///
+    constexpr std::int64_t max_block_pairing_depth = 1024;
+
+    ///
+    /// Net change in nesting depth over a block of tokens
+    ///
+    struct Block_depths {
+
+        std::int64_t delta = 0;
+
+        ///
+        /// Lowest depth reached, relative to the start of the block
+        ///
+        std::int64_t min = 0;
+
+        ///
+        /// Highest depth reached, relative to the start of the block
+        ///
+        std::int64_t max = 0;
+
+    };
+
+    ///
+    /// \param type Arbitrary token type
+    /// \return 1 for left tokens, -1 for right tokens, 0 otherwise. Comment
+    /// brackets are never paired.
+    std::int32_t depth_delta(Token_type type) {
+        if (type == Token_type::LEFT_COMMENT_BRACKET || type == Token_type::RIGHT_COMMENT_BRACKET) {
+            return 0;
+        }
+
+        if (is_left_token(type)) {
+            return 1;
+        }
+
+        if (is_right_token(type)) {
+            return -1;
+        }
+
+        return 0;
+    }
+
+    ///
+    /// \return True if the token is a keyword which no bracket may enclose
+    bool is_stack_reset(const Tokenization& tokenization, std::size_t i) {
+        auto keyword = tokenization.keywords[i];
+        return keyword == Keyword::FUNC || keyword == Keyword::STRUCT;
+    }
+
+    ///
+    /// \param tokenization Tokenization to pair
+    /// \param parallel_for Function which runs the work of each block
+    /// \return True if every token was paired. False if the tokens are not
+    /// balanced, in which case pair_indices are left in an unspecified state.
+    bool pair_balanced_brackets(Tokenization& tokenization, const Parallel_for& parallel_for) {
+        auto& types = tokenization.types;
+        auto& pair_indices = tokenization.pair_indices;
+
+        std::size_t token_count = types.size();
+        std::size_t block_count = (token_count + pairing_block_size - 1) / pairing_block_size;
+
+        auto block_begin = [] (std::size_t b) {
+            return b * pairing_block_size;
+        };
+
+        auto block_end = [token_count] (std::size_t b) {
+            return std::min((b + 1) * pairing_block_size, token_count);
+        };
+
+        // Depth changes within each block
+        std::vector<Block_depths> blocks(block_count);
+        parallel_for(block_count, [&] (std::size_t b) {
+            Block_depths depths{};
+            for (std::size_t i = block_begin(b); i < block_end(b); ++i) {
+                depths.delta += depth_delta(types[i]);
+                depths.min = std::min(depths.min, depths.delta);
+                depths.max = std::max(depths.max, depths.delta);
+            }
+            blocks[b] = depths;
+        });
+
+        // Depth at the start of each block. Depth may never drop below zero
+        // and must return to zero by the end.
+        std::vector<std::int64_t> initial_depths(block_count + 1);
+        std::int64_t max_depth = 0;
+        for (std::size_t b = 0; b < block_count; ++b) {
+            if (initial_depths[b] + blocks[b].min < 0) {
+                return false;
+            }
+
+            max_depth = std::max(max_depth, initial_depths[b] + blocks[b].max);
+            initial_depths[b + 1] = initial_depths[b] + blocks[b].delta;
+        }
+
+        if (initial_depths[block_count] != 0 || max_depth > max_block_pairing_depth) {
+            return false;
+        }
+
+        // A left token and its right token share the depth outside of them,
+        // referred to as their level. Brackets are counted per level per
+        // block.
+        auto level_count = static_cast<std::size_t>(max_depth);
+        std::vector<std::uint32_t> levels(token_count);
+        std::vector<std::uint32_t> counts(block_count * level_count);
+        std::atomic<bool> is_balanced = true;
+
+        parallel_for(block_count, [&] (std::size_t b) {
+            auto depth = initial_depths[b];
+            auto* block_counts = counts.data() + b * level_count;
+
+            for (std::size_t i = block_begin(b); i < block_end(b); ++i) {
+                pair_indices[i] = i;
+
+                auto delta = depth_delta(types[i]);
+                if (delta > 0) {
+                    levels[i] = depth;
+                    ++block_counts[depth];
+                    ++depth;
+                } else if (delta < 0) {
+                    --depth;
+                    levels[i] = depth;
+                    ++block_counts[depth];
+                } else if (depth != 0 && is_stack_reset(tokenization, i)) {
+                    is_balanced.store(false, std::memory_order_relaxed);
+                }
+            }
+        });
+
+        if (!is_balanced.load()) {
+            return false;
+        }
+
+        // Gathering brackets by level, in order of level and then position,
+        // places each left token immediately before its right token
+        std::vector<std::uint32_t> offsets(block_count * level_count);
+        std::uint32_t bracket_count = 0;
+        for (std::size_t level = 0; level < level_count; ++level) {
+            for (std::size_t b = 0; b < block_count; ++b) {
+                offsets[b * level_count + level] = bracket_count;
+                bracket_count += counts[b * level_count + level];
+            }
+        }
+
+        std::vector<std::uint32_t> brackets(bracket_count);
+        parallel_for(block_count, [&] (std::size_t b) {
+            auto* block_offsets = offsets.data() + b * level_count;
+
+            for (std::size_t i = block_begin(b); i < block_end(b); ++i) {
+                if (depth_delta(types[i]) != 0) {
+                    brackets[block_offsets[levels[i]]++] = i;
+                }
+            }
+        });
+
+        std::size_t pair_count = bracket_count / 2;
+        std::size_t pair_block_count = (pair_count + pairing_block_size - 1) / pairing_block_size;
+        parallel_for(pair_block_count, [&] (std::size_t b) {
+            auto end = std::min((b + 1) * pairing_block_size, pair_count);
+
+            for (std::size_t p = b * pairing_block_size; p < end; ++p) {
+                auto left = brackets[2 * p + 0];
+                auto right = brackets[2 * p + 1];
+
+                if (matching_token_type(types[right]) != types[left]) {
+                    is_balanced.store(false, std::memory_order_relaxed);
+                    return;
+                }
+
+                pair_indices[left] = right;
+                pair_indices[right] = left;
+            }
+        });
+
+        return is_balanced.load();
+    }
+
+    ///
+    /// Pairs tokens using a stack, following the same rules as the lexer
+    ///
+    /// \return Number of unpaired tokens
+    std::uint32_t pair_brackets_serially(
+        Tokenization& tokenization,
+        std::string_view source_id,
+        const Config& config
+    ) {
+        struct Stack_entry {
+            Token_type type;
+            std::uint32_t index;
+        };
+
+        const auto& types = tokenization.types;
+        auto& pair_indices = tokenization.pair_indices;
+        const auto& line_indices = tokenization.line_indices;
+
+        std::uint32_t error_count = 0;
+        auto report_unpaired = [&] (std::uint32_t token_index) {
+            if (error_count++ >= config.max_errors) {
+                return;
+            }
+
+            auto index = tokenization.source_indices[token_index];
+            auto it = std::upper_bound(line_indices.begin(), line_indices.end(), index);
+            std::uint32_t line = it - line_indices.begin();
+            std::uint32_t column = index - *(it - 1) + 1;
+
+            auto message = unpaired_token_message(types[token_index]);
+            tokenization.message_buffer.error(message, source_id, line, column);
+        };
+
+        std::vector<Stack_entry> balancing_stack;
+        balancing_stack.reserve(32);
+
+        for (std::uint32_t i = 0; i < types.size(); ++i) {
+            pair_indices[i] = i;
+
+            auto type = types[i];
+            auto delta = depth_delta(type);
+
+            if (delta > 0) {
+                balancing_stack.push_back(Stack_entry{type, i});
+                continue;
+            }
+
+            if (delta < 0) {
+                bool is_match =
+                    !balancing_stack.empty() &&
+                    balancing_stack.back().type == matching_token_type(type);
+
+                if (!is_match) {
+                    report_unpaired(i);
+                    continue;
+                }
+
+                auto left_index = balancing_stack.back().index;
+                balancing_stack.pop_back();
+
+                pair_indices[left_index] = i;
+                pair_indices[i] = left_index;
+                continue;
+            }
+
+            if (is_stack_reset(tokenization, i)) {
+                for (auto& entry : balancing_stack) {
+                    report_unpaired(entry.index);
+                }
+                balancing_stack.clear();
+            }
+        }
+
+        // Any left tokens still on the stack were never closed
+        for (auto& entry : balancing_stack) {
+            report_unpaired(entry.index);
+        }
+
+        return error_count;
+    }
+
+    std::string_view unpaired_token_message(Token_type type) {
+        switch (type) {
+            case Token_type::LEFT_PARENTHESIS:
+            case Token_type::RIGHT_PARENTHESIS:
+                return "Unpaired parenthesis";
+            case Token_type::LEFT_SQUARE_BRACKET:
+            case Token_type::RIGHT_SQUARE_BRACKET:
+                return "Unpaired square bracket";
+            case Token_type::LEFT_CURLY_BRACKET:
+            case Token_type::RIGHT_CURLY_BRACKET:
+                return "Unpaired curly bracket";
+            case Token_type::LEFT_TEMPLATE_BRACKET:
+            case Token_type::RIGHT_TEMPLATE_BRACKET:
+                return "Unpaired template bracket";
+            default:
+                return "Unpaired comment bracket";
+        }
+    }
+
+    std::uint32_t pair_brackets(
+        Tokenization& tokenization,
+        std::string_view source_id,
+        const Config& config,
+        const Parallel_for& parallel_for
+    ) {
+        tokenization.pair_indices.resize(tokenization.types.size());
+
+        // On a single thread, the stack is faster than the block-wise pass
+        if (parallel_for && pair_balanced_brackets(tokenization, parallel_for)) {
+            return 0;
+        }
+
+        // Unbalanced tokens are rare enough that precise reporting is worth
+        // a second, serial pass
+        return pair_brackets_serially(tokenization, source_id, config);
+    }
+
+}
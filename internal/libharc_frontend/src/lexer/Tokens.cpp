@@ -5,6 +5,70 @@
 
 namespace harc {
 
+    ///
+    /// Spellings of keywords, indexed by Keyword
+    ///
+    constexpr std::array<std::string_view, 17> keyword_spellings {
+        "",
+        "alias",
+        "as",
+        "do",
+        "else",
+        "for",
+        "func",
+        "if",
+        "in",
+        "is",
+        "lambda",
+        "let",
+        "module",
+        "return",
+        "struct",
+        "var",
+        "while"
+    };
+
+    constexpr std::size_t min_keyword_length = 2;
+
+    constexpr std::size_t max_keyword_length = 6;
+
+    ///
+    /// Hash function which is perfect over the keyword spellings, i.e. no
+    /// two keywords share a hash
+    ///
+    /// \param text Non-empty text
+    /// \return Hash of text in the range [0, 32)
+    constexpr std::uint32_t keyword_hash(std::string_view text) {
+        auto first = static_cast<std::uint8_t>(text.front());
+        auto last = static_cast<std::uint8_t>(text.back());
+        return (first * 7 + last * 26 + text.size()) % 32;
+    }
+
+    constexpr std::array<Keyword, 32> make_keyword_hash_table() {
+        std::array<Keyword, 32> ret{};
+
+        for (std::size_t i = 1; i < keyword_spellings.size(); ++i) {
+            ret[keyword_hash(keyword_spellings[i])] = static_cast<Keyword>(i);
+        }
+
+        return ret;
+    }
+
+    constexpr std::array<Keyword, 32> keyword_hash_table = make_keyword_hash_table();
+
+    static_assert(
+        [] () {
+            // Every keyword must occupy its own slot
+            for (std::size_t i = 1; i < keyword_spellings.size(); ++i) {
+                if (keyword_hash_table[keyword_hash(keyword_spellings[i])] != static_cast<Keyword>(i)) {
+                    return false;
+                }
+            }
+            return true;
+        }(),
+        "keyword_hash is not perfect over keyword_spellings"
+    );
+
     bool is_textual(Token_type type) {
         constexpr std::array<Token_type, 6> textual_tokens{
             Token_type::TEXT,
@@ -12,7 +76,7 @@ namespace harc {
             Token_type::CODEPOINT_LITERAL,
             Token_type::STRING_LITERAL,
             Token_type::SINGLE_LINE_COMMENT,
-            Token_type::SINGLE_LINE_COMMENT
+            Token_type::DOC_TEXT
         };
 
         bool is_textual = false;
@@ -282,4 +346,26 @@ namespace harc {
         }
     }
 
+    Keyword identify_keyword(std::string_view text) {
+        if (text.size() < min_keyword_length || max_keyword_length < text.size()) {
+            return Keyword::NONE;
+        }
+
+        auto keyword = keyword_hash_table[keyword_hash(text)];
+        if (keyword_spellings[static_cast<std::uint8_t>(keyword)] != text) {
+            return Keyword::NONE;
+        }
+
+        return keyword;
+    }
+
+    std::string_view to_string(Keyword keyword) {
+        auto i = static_cast<std::uint8_t>(keyword);
+        if (i >= keyword_spellings.size()) {
+            return {};
+        }
+
+        return keyword_spellings[i];
+    }
+
 }
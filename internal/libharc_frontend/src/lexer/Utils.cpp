@@ -1,6 +1,287 @@
-#include <span>
-#include <string_view>
+#include <harc/lexer/Utils.hpp>
+
+#include <array>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
 
 namespace harc::lex {
 
-}
\ No newline at end of file
+    //=====================================================
+    // Scalar classification
+    //=====================================================
+
+    constexpr std::uint8_t whitespace_bit         = 0x01;
+    constexpr std::uint8_t newline_bit            = 0x02;
+    constexpr std::uint8_t identifier_bit         = 0x04;
+    constexpr std::uint8_t punctuation_bit        = 0x08;
+    constexpr std::uint8_t literal_delimiter_bit  = 0x10;
+    constexpr std::uint8_t non_ascii_bit          = 0x20;
+
+    constexpr std::array<std::uint8_t, 256> make_byte_classes() {
+        std::array<std::uint8_t, 256> ret{};
+
+        for (std::size_t i = 0; i < ret.size(); ++i) {
+            char c = static_cast<char>(i);
+            std::uint8_t cls = 0;
+
+            if (c == ' ' || ('\t' <= c && c <= '\r')) {
+                cls |= whitespace_bit;
+            }
+
+            if (c == '\n') {
+                cls |= newline_bit | literal_delimiter_bit;
+            }
+
+            bool is_identifier =
+                ('a' <= c && c <= 'z') ||
+                ('A' <= c && c <= 'Z') ||
+                ('0' <= c && c <= '9') ||
+                (c == '_');
+
+            if (is_identifier) {
+                cls |= identifier_bit;
+            } else if (0x21 <= i && i <= 0x7e) {
+                cls |= punctuation_bit;
+            }
+
+            if (c == '"' || c == '\'' || c == '\\') {
+                cls |= literal_delimiter_bit;
+            }
+
+            if (i >= 0x80) {
+                cls |= non_ascii_bit;
+            }
+
+            ret[i] = cls;
+        }
+
+        return ret;
+    }
+
+    constexpr std::array<std::uint8_t, 256> byte_classes = make_byte_classes();
+
+    [[maybe_unused]]
+    Block_classification classify_block_scalar(const char* ptr) {
+        Block_classification ret{};
+
+        for (std::size_t i = 0; i < block_width; ++i) {
+            std::uint8_t cls = byte_classes[static_cast<std::uint8_t>(ptr[i])];
+            std::uint64_t bit = std::uint64_t{1} << i;
+
+            ret.whitespace         |= (cls & whitespace_bit)        ? bit : 0;
+            ret.newlines           |= (cls & newline_bit)           ? bit : 0;
+            ret.identifier         |= (cls & identifier_bit)        ? bit : 0;
+            ret.punctuation        |= (cls & punctuation_bit)       ? bit : 0;
+            ret.literal_delimiters |= (cls & literal_delimiter_bit) ? bit : 0;
+            ret.non_ascii          |= (cls & non_ascii_bit)         ? bit : 0;
+        }
+
+        return ret;
+    }
+
+    //=====================================================
+    // AVX2 classification
+    //=====================================================
+
+    #if defined(__AVX2__)
+
+    ///
+    /// \return Mask of lanes for which a <= b when treated as unsigned bytes
+    inline __m256i cmple_epu8(__m256i a, __m256i b) {
+        return _mm256_cmpeq_epi8(_mm256_min_epu8(a, b), a);
+    }
+
+    inline std::uint64_t movemask(__m256i x) {
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(x));
+    }
+
+    void classify_half(__m256i v, Block_classification& ret, unsigned shift) {
+        __m256i newlines = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+
+        __m256i whitespace = _mm256_or_si256(
+            _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+            cmple_epu8(_mm256_sub_epi8(v, _mm256_set1_epi8('\t')), _mm256_set1_epi8('\r' - '\t'))
+        );
+
+        __m256i lowered = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        __m256i letters = cmple_epu8(_mm256_sub_epi8(lowered, _mm256_set1_epi8('a')), _mm256_set1_epi8('z' - 'a'));
+        __m256i digits  = cmple_epu8(_mm256_sub_epi8(v, _mm256_set1_epi8('0')), _mm256_set1_epi8('9' - '0'));
+        __m256i underscores = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+        __m256i identifier = _mm256_or_si256(_mm256_or_si256(letters, digits), underscores);
+
+        __m256i printable = cmple_epu8(_mm256_sub_epi8(v, _mm256_set1_epi8(0x21)), _mm256_set1_epi8(0x7e - 0x21));
+        __m256i punctuation = _mm256_andnot_si256(identifier, printable);
+
+        __m256i delimiters = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')),
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\''))
+            ),
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\')),
+                newlines
+            )
+        );
+
+        ret.whitespace         |= movemask(whitespace)  << shift;
+        ret.newlines           |= movemask(newlines)    << shift;
+        ret.identifier         |= movemask(identifier)  << shift;
+        ret.punctuation        |= movemask(punctuation) << shift;
+        ret.literal_delimiters |= movemask(delimiters)  << shift;
+        ret.non_ascii          |= movemask(v)           << shift;
+    }
+
+    Block_classification classify_block(const char* ptr) {
+        Block_classification ret{};
+
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + 32));
+
+        classify_half(lo, ret, 0);
+        classify_half(hi, ret, 32);
+
+        return ret;
+    }
+
+    //=====================================================
+    // SSE4.2 classification
+    //=====================================================
+
+    #elif defined(__SSE4_2__)
+
+    ///
+    /// \param set Set of byte values or ranges to match against
+    /// \param set_size Number of bytes in set
+    /// \param v Bytes to classify
+    /// \return 16-bit mask of bytes in v which match set
+    template<int mode>
+    inline std::uint64_t match_set(__m128i set, int set_size, __m128i v) {
+        constexpr int flags = _SIDD_UBYTE_OPS | _SIDD_BIT_MASK | mode;
+        __m128i mask = _mm_cmpestrm(set, set_size, v, 16, flags);
+        return static_cast<std::uint16_t>(_mm_cvtsi128_si32(mask));
+    }
+
+    Block_classification classify_block(const char* ptr) {
+        Block_classification ret{};
+
+        const __m128i whitespace_ranges  = _mm_setr_epi8('\t', '\r', ' ', ' ', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i identifier_ranges  = _mm_setr_epi8('a', 'z', 'A', 'Z', '0', '9', '_', '_', 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i printable_ranges   = _mm_setr_epi8(0x21, 0x7e, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i delimiter_set      = _mm_setr_epi8('"', '\'', '\\', '\n', 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+        for (unsigned i = 0; i < block_width; i += 16) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + i));
+
+            std::uint64_t identifier = match_set<_SIDD_CMP_RANGES>(identifier_ranges, 8, v);
+            std::uint64_t printable  = match_set<_SIDD_CMP_RANGES>(printable_ranges, 2, v);
+            std::uint64_t newlines   = static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))));
+
+            ret.whitespace         |= match_set<_SIDD_CMP_RANGES>(whitespace_ranges, 4, v) << i;
+            ret.newlines           |= newlines << i;
+            ret.identifier         |= identifier << i;
+            ret.punctuation        |= (printable & ~identifier) << i;
+            ret.literal_delimiters |= match_set<_SIDD_CMP_EQUAL_ANY>(delimiter_set, 4, v) << i;
+            ret.non_ascii          |= std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(v))) << i;
+        }
+
+        return ret;
+    }
+
+    #else
+
+    Block_classification classify_block(const char* ptr) {
+        return classify_block_scalar(ptr);
+    }
+
+    #endif
+
+    Block_classification classify_partial_block(const char* ptr, std::size_t n) {
+        if (n >= block_width) {
+            return classify_block(ptr);
+        }
+
+        // Zero bytes do not belong to any class, so padding with them
+        // terminates every run at the end of the range
+        alignas(64) std::array<char, block_width> buffer{};
+        std::memcpy(buffer.data(), ptr, n);
+
+        return classify_block(buffer.data());
+    }
+
+    //=====================================================
+    // UTF-8 decoding
+    //=====================================================
+
+    std::uint32_t decode_utf8(const char* ptr, std::size_t n, std::uint32_t& codepoint) {
+        if (n == 0) {
+            return 0;
+        }
+
+        auto byte = [ptr] (std::size_t i) {
+            return static_cast<std::uint32_t>(static_cast<std::uint8_t>(ptr[i]));
+        };
+
+        auto is_continuation = [&byte] (std::size_t i) {
+            return (byte(i) & 0xc0) == 0x80;
+        };
+
+        std::uint32_t b0 = byte(0);
+        if (b0 < 0x80) {
+            codepoint = b0;
+            return 1;
+        }
+
+        if ((b0 & 0xe0) == 0xc0) {
+            if (n < 2 || !is_continuation(1)) {
+                return 0;
+            }
+
+            std::uint32_t c = ((b0 & 0x1f) << 6) | (byte(1) & 0x3f);
+            if (c < 0x80) {
+                return 0;
+            }
+
+            codepoint = c;
+            return 2;
+        }
+
+        if ((b0 & 0xf0) == 0xe0) {
+            if (n < 3 || !is_continuation(1) || !is_continuation(2)) {
+                return 0;
+            }
+
+            std::uint32_t c = ((b0 & 0x0f) << 12) | ((byte(1) & 0x3f) << 6) | (byte(2) & 0x3f);
+            if (c < 0x800 || (0xd800 <= c && c <= 0xdfff)) {
+                return 0;
+            }
+
+            codepoint = c;
+            return 3;
+        }
+
+        if ((b0 & 0xf8) == 0xf0) {
+            if (n < 4 || !is_continuation(1) || !is_continuation(2) || !is_continuation(3)) {
+                return 0;
+            }
+
+            std::uint32_t c =
+                ((b0 & 0x07) << 18) |
+                ((byte(1) & 0x3f) << 12) |
+                ((byte(2) & 0x3f) << 6) |
+                (byte(3) & 0x3f);
+
+            if (c < 0x10000 || c > 0x10ffff) {
+                return 0;
+            }
+
+            codepoint = c;
+            return 4;
+        }
+
+        return 0;
+    }
+
+}